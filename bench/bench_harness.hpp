@@ -0,0 +1,154 @@
+#ifndef ROCKETGE__BENCH_HARNESS_HPP
+#define ROCKETGE__BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rocket::bench {
+    /// @brief Keep the compiler from dropping a result that is never read
+    template<typename T>
+    inline void do_not_optimize(const T &value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        static const void *volatile sink;
+        sink = &value;
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+
+    struct result_t {
+        std::string name;
+        /// @brief Iterations per repetition
+        uint64_t iterations = 0;
+        /// @brief Median over the repetitions
+        double ns_per_op = 0.0;
+        double min_ns_per_op = 0.0;
+        double max_ns_per_op = 0.0;
+        double stddev_ns_per_op = 0.0;
+        double ops_per_second = 0.0;
+    };
+
+    struct options_t {
+        /// @brief Only run benchmarks whose name contains this
+        std::string filter;
+        /// @brief Seconds each repetition should take
+        double min_time = 0.2;
+        int repetitions = 5;
+    };
+
+    class runner_t {
+    private:
+        options_t options;
+        std::vector<result_t> results;
+
+        using clock = std::chrono::steady_clock;
+
+        static double time_ns(const std::function<void(uint64_t)> &fn, uint64_t iterations) {
+            const auto start = clock::now();
+            fn(iterations);
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        }
+    public:
+        const std::vector<result_t> &get_results() const { return results; }
+
+        /// @brief Time fn, which has to run its body exactly iterations times
+        /// @note Setup inside fn is counted too, keep it outside the loop and cheap
+        void run(const std::string &name, const std::function<void(uint64_t iterations)> &fn) {
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                return;
+            }
+
+            // Grow until a run is long enough to scale from, then aim for min_time
+            const double target_ns = options.min_time * 1e9;
+            uint64_t iterations = 1;
+            double elapsed = time_ns(fn, iterations);
+            while (elapsed < target_ns / 10.0 && iterations < (1ull << 40)) {
+                iterations *= elapsed < target_ns / 100.0 ? 10 : 2;
+                elapsed = time_ns(fn, iterations);
+            }
+            const double per_op = std::max(elapsed / static_cast<double>(iterations), 1e-3);
+            iterations = std::max<uint64_t>(1, static_cast<uint64_t>(target_ns / per_op));
+
+            std::vector<double> samples;
+            for (int i = 0; i < std::max(options.repetitions, 1); ++i) {
+                samples.push_back(time_ns(fn, iterations) / static_cast<double>(iterations));
+            }
+            std::sort(samples.begin(), samples.end());
+
+            result_t result;
+            result.name = name;
+            result.iterations = iterations;
+            result.ns_per_op = samples[samples.size() / 2];
+            result.min_ns_per_op = samples.front();
+            result.max_ns_per_op = samples.back();
+            double mean = 0.0;
+            for (double s : samples) mean += s;
+            mean /= static_cast<double>(samples.size());
+            double variance = 0.0;
+            for (double s : samples) variance += (s - mean) * (s - mean);
+            result.stddev_ns_per_op = std::sqrt(variance / static_cast<double>(samples.size()));
+            result.ops_per_second = result.ns_per_op > 0.0 ? 1e9 / result.ns_per_op : 0.0;
+
+            std::cout << std::left << std::setw(40) << name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(1) << result.ns_per_op << " ns/op"
+                      << std::setw(16) << std::setprecision(0) << result.ops_per_second << " op/s"
+                      << "  (+-" << std::setprecision(1) << result.stddev_ns_per_op << ", " << iterations << " it)\n";
+            results.push_back(result);
+        }
+
+        /// @brief Results as JSON, read by helper-scripts.py --compare-bench
+        bool write_json(const std::string &path, const std::string &engine_version) const {
+            std::ofstream out(path, std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            auto escape = [](const std::string &s) {
+                std::string escaped;
+                for (char c : s) {
+                    if (c == '"' || c == '\\') escaped += '\\';
+                    escaped += c;
+                }
+                return escaped;
+            };
+
+            out << std::setprecision(17);
+            out << "{\n";
+            out << "  \"version\": 1,\n";
+            out << "  \"context\": {\n";
+            out << "    \"engine\": \"" << escape(engine_version) << "\",\n";
+            out << "    \"threads\": " << std::thread::hardware_concurrency() << ",\n";
+            out << "    \"min_time\": " << options.min_time << ",\n";
+            out << "    \"repetitions\": " << options.repetitions << "\n";
+            out << "  },\n";
+            out << "  \"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); ++i) {
+                const result_t &r = results[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    { \"name\": \"" << escape(r.name) << "\""
+                    << ", \"iterations\": " << r.iterations
+                    << ", \"ns_per_op\": " << r.ns_per_op
+                    << ", \"min_ns_per_op\": " << r.min_ns_per_op
+                    << ", \"max_ns_per_op\": " << r.max_ns_per_op
+                    << ", \"stddev_ns_per_op\": " << r.stddev_ns_per_op
+                    << ", \"ops_per_second\": " << r.ops_per_second << " }";
+            }
+            out << "\n  ]\n}\n";
+            return out.good();
+        }
+    public:
+        explicit runner_t(options_t options = {}) : options(std::move(options)) {}
+    };
+}
+
+#endif
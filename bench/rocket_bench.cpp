@@ -0,0 +1,353 @@
+#include "bench_harness.hpp"
+#include "rocket/asset.hpp"
+#include "rocket/culling.hpp"
+#include "rocket/headless.hpp"
+#include "rocket/io.hpp"
+#include "rocket/particles.hpp"
+#include "rocket/persistence.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include "data_structures.hpp"
+#include "shader.hpp"
+#include "util.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <rocket/runtime.hpp>
+
+// Microbenchmarks for the hot paths of the runtime.
+//   rocket_bench [--bench-filter name] [--bench-out file.json] [--bench-min-time seconds] [--bench-gl]
+// Compare two runs with helper-scripts.py --compare-bench BASELINE CURRENT
+
+static constexpr int draws_per_frame = 1024;
+
+static std::shared_ptr<rocket::texture_t> make_texture(int size) {
+    auto texture = std::make_shared<rocket::texture_t>();
+    texture->size = { size, size };
+    texture->channels = 4;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            texture->data.push_back(static_cast<uint8_t>(x * 4));
+            texture->data.push_back(static_cast<uint8_t>(y * 4));
+            texture->data.push_back(128);
+            texture->data.push_back(255);
+        }
+    }
+    return texture;
+}
+
+/// @brief Draw calls in frames of draws_per_frame, one op is one draw call
+static void bench_draws(rocket::bench::runner_t &runner, const std::string &backend, rocket::renderer_2d_i *r, std::function<void()> after_frame = nullptr) {
+    auto texture = make_texture(64);
+    rocket::text_t text("Hello RocketGE", 16, rocket::rgb_color::white());
+    const rocket::vec2f_t vp = r->get_viewport_size();
+
+    auto frames = [&](uint64_t iterations, const std::function<void(uint64_t)> &draw) {
+        uint64_t i = 0;
+        while (i < iterations) {
+            r->begin_frame();
+            const uint64_t end = std::min<uint64_t>(iterations, i + draws_per_frame);
+            for (; i < end; ++i) {
+                draw(i);
+            }
+            r->end_frame();
+            if (after_frame) {
+                after_frame();
+            }
+        }
+    };
+    auto position = [&](uint64_t i) {
+        return rocket::vec2f_t{
+            static_cast<float>((i * 37) % static_cast<uint64_t>(std::max(vp.x - 64.f, 1.f))),
+            static_cast<float>((i * 17) % static_cast<uint64_t>(std::max(vp.y - 64.f, 1.f)))
+        };
+    };
+
+    runner.run("draw_rectangle/" + backend, [&](uint64_t iterations) {
+        frames(iterations, [&](uint64_t i) {
+            r->draw_rectangle({ position(i), { 32, 32 } }, { 200, 80, static_cast<uint8_t>(i), 255 });
+        });
+    });
+    runner.run("draw_rectangle_rotated/" + backend, [&](uint64_t iterations) {
+        frames(iterations, [&](uint64_t i) {
+            r->draw_rectangle({ position(i), { 32, 32 } }, { 80, 200, 120, 180 }, static_cast<float>(i % 360), 0.25f);
+        });
+    });
+    runner.run("draw_texture/" + backend, [&](uint64_t iterations) {
+        frames(iterations, [&](uint64_t i) {
+            r->draw_texture(texture, { position(i), { 64, 64 } });
+        });
+    });
+    runner.run("draw_text/" + backend, [&](uint64_t iterations) {
+        frames(iterations, [&](uint64_t i) {
+            r->draw_text(text, position(i));
+        });
+    });
+}
+
+static void bench_renderers(rocket::bench::runner_t &runner, bool with_gl) {
+    const rocket::renderer_flags_t flags = {
+        .share_renderer_as_global = false,
+        .show_splash = false
+    };
+
+    {
+        rocket::null_window_t window({ 1280, 720 }, "RocketGE - Bench");
+        rocket::null_renderer_2d r(&window, rocket::cst::fps_uncapped, flags);
+        bench_draws(runner, "null", &r);
+    }
+    {
+        // Stands in for an offscreen target, runs without a display or GPU
+        rocket::headless_renderer_t headless({ 1280, 720 }, flags);
+        bench_draws(runner, "software", headless.get_renderer());
+    }
+    if (with_gl) {
+        rocket::window_t window({ 1280, 720 }, "RocketGE - Bench", {
+            .vsync = false,
+            .hidden = true
+        });
+        rocket::opengl_renderer_2d r(&window, rocket::cst::fps_uncapped, flags);
+        bench_draws(runner, "opengl", &r, [&]() { window.poll_events(); });
+        r.close();
+        window.close();
+    }
+}
+
+static void bench_assets(rocket::bench::runner_t &runner) {
+    const std::string png_path = "rocket_bench_texture.png";
+    std::vector<rocket::rgba_color> pixels(16 * 16, { 120, 60, 200, 255 });
+    if (!rocket::write_image(png_path, pixels, { 16, 16 })) {
+        rocket::log("could not write " + png_path + ", skipping asset benchmarks", "rocket_bench", "bench_assets", "warn");
+        return;
+    }
+    std::vector<uint8_t> png_bytes;
+    {
+        std::ifstream file(png_path, std::ios::binary);
+        png_bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Loaded textures stay around until the manager goes, one manager per run
+    runner.run("asset_manager/load_texture_file", [&](uint64_t iterations) {
+        rocket::asset_manager_t am;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(am.load_texture(png_path));
+        }
+    });
+    runner.run("asset_manager/load_texture_memory", [&](uint64_t iterations) {
+        rocket::asset_manager_t am;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(am.load_texture(png_bytes));
+        }
+    });
+
+    rocket::asset_manager_t am;
+    std::vector<rocket::assetid_t> ids;
+    for (int i = 0; i < 256; ++i) {
+        ids.push_back(am.load_texture(png_bytes));
+    }
+    runner.run("asset_manager/get_texture_256", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(am.get_texture(ids[i % ids.size()]));
+        }
+    });
+
+    std::error_code ec;
+    std::filesystem::remove(png_path, ec);
+}
+
+static void bench_logging(rocket::bench::runner_t &runner) {
+    // Console output would measure the terminal, the formatting and the
+    // callback path are what the runtime pays for
+    rocket::set_log_level(rocket::log_level_t::none);
+    runner.run("log/filtered", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::log("frame submitted", "rocket_bench", "bench_logging", "debug");
+        }
+    });
+
+    rocket::set_log_level(rocket::log_level_t::all);
+    runner.run("log/unfiltered_format", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(util::format_log("frame submitted", "rocket_bench", "bench_logging", "info"));
+        }
+    });
+
+    uint64_t received = 0;
+    rocket::set_log_callback([&](std::string, std::string, std::string, std::string) { received++; });
+    runner.run("log/unfiltered_callback", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::log("frame submitted", "rocket_bench", "bench_logging", "info");
+        }
+    });
+    rocket::bench::do_not_optimize(received);
+    rocket::set_log_callback(nullptr);
+    rocket::set_log_level(rocket::log_level_t::info);
+}
+
+static void bench_storage(rocket::bench::runner_t &runner) {
+    // Never touch the real per-user storage
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "rocket_bench_storage";
+    rocket::storage::init("rocket_bench", directory);
+    runner.run("storage/store", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::storage::store("key_" + std::to_string(i % 64), static_cast<int64_t>(i));
+        }
+    });
+    runner.run("storage/flush_64", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::storage::flush();
+        }
+    });
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+}
+
+static void bench_compression(rocket::bench::runner_t &runner) {
+    // 64 KiB of mostly repeating bytes, compresses like typical game data
+    std::vector<uint8_t> data(64 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>((i / 64) ^ (i % 7));
+    }
+
+    rocket::compressed_data_t compressed;
+    runner.run("compressed_data/set_64k", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            compressed.set(data);
+        }
+    });
+    compressed.set(data);
+    runner.run("compressed_data/get_64k", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(compressed.get());
+        }
+    });
+}
+
+static void bench_rlsl(rocket::bench::runner_t &runner, const std::string &working_dir) {
+    const std::filesystem::path path = working_dir + "resources/custom_shader.rlsl";
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        rocket::log("could not open " + path.string() + ", skipping rlsl_parse", "rocket_bench", "bench_rlsl", "warn");
+        return;
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+
+    // The null backend parses everything but skips the GL version query
+    runner.run("rlsl_parse/custom_shader", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::bench::do_not_optimize(rocket::rlsl_parse(lines, path.parent_path(), rocket::renderer_backend_t::null, nullptr));
+        }
+    });
+}
+
+static void bench_culling(rocket::bench::runner_t &runner) {
+    // 100k sprites over a 4x4 screen world, every fifth one rotated
+    rocket::cull_soa_t bounds;
+    bounds.reserve(100000);
+    for (uint32_t i = 0; i < 100000; ++i) {
+        bounds.push({
+            { static_cast<float>((i * 7919) % 5120), static_cast<float>((i * 104729) % 2880) },
+            { static_cast<float>(16 + i % 48), static_cast<float>(16 + i % 32) }
+        }, i % 5 == 0 ? static_cast<float>(i % 360) : 0.f);
+    }
+    std::vector<uint32_t> visible;
+    runner.run("cull_rects/100k", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            rocket::cull_rects(bounds, { { 0, 0 }, { 1280, 720 } }, visible);
+            rocket::bench::do_not_optimize(visible.size());
+        }
+    });
+}
+
+static void bench_particles(rocket::bench::runner_t &runner) {
+    // 200k live particles, one 60 FPS step per iteration
+    rocket::particle_emitter_config_t config;
+    config.max_particles = 200000;
+    config.rate = 100000.f;
+    config.lifetime_min = 1.5f;
+    config.lifetime_max = 2.5f;
+    config.acceleration = { 0, 98 };
+    config.drag = 0.1f;
+    config.size_easing = rocket::particle_easing_t::cubic_out;
+    rocket::particle_emitter_t emitter(config);
+    for (int i = 0; i < 240; ++i) {
+        emitter.update(1.f / 60.f);
+    }
+    runner.run("particles_update/200k", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            emitter.update(1.f / 60.f);
+            rocket::bench::do_not_optimize(emitter.get_particle_count());
+        }
+    });
+}
+
+static void bench_input(rocket::bench::runner_t &runner) {
+    uint64_t handled = 0;
+    std::vector<rocket::io::listener_id_t> listeners;
+    for (int i = 0; i < 8; ++i) {
+        listeners.push_back(rocket::io::add_listener([&](rocket::io::key_event_t event) {
+            if (event.state.down()) handled++;
+        }));
+    }
+
+    runner.run("input/dispatch_key_8_listeners", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            util::dispatch_event(rocket::io::key_event_t{
+                .key = rocket::io::keyboard_key::space,
+                .state = (i & 1) ? rocket::io::keystate_t::make_released() : rocket::io::keystate_t::make_pressed(),
+                .scancode = 0
+            });
+        }
+    });
+    rocket::bench::do_not_optimize(handled);
+
+    for (auto id : listeners) {
+        rocket::io::remove_listener(id);
+    }
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t args) {
+    rocket::bench::options_t options;
+    std::string out_path = "bench_output.json";
+    bool with_gl = false;
+
+    rocket::register_argument("bench-filter", [&](std::string value) {
+        options.filter = value;
+    }, "Only run benchmarks whose name contains this", "str");
+    rocket::register_argument("bench-out", [&](std::string value) {
+        out_path = value;
+    }, "Write results as JSON to this relative path (bench_output.json)", "path");
+    rocket::register_argument("bench-min-time", [&](std::string value) {
+        options.min_time = std::max(std::atof(value.c_str()), 0.01);
+    }, "Seconds per repetition (0.2)", "float");
+    rocket::register_argument("bench-gl", [&]() {
+        with_gl = true;
+    }, "Also run the renderer benchmarks on OpenGL, needs a display");
+    rocket::init(argc, argv);
+
+    rocket::bench::runner_t runner(options);
+    bench_renderers(runner, with_gl);
+    bench_assets(runner);
+    bench_logging(runner);
+    bench_storage(runner);
+    bench_compression(runner);
+    bench_rlsl(runner, args.working_dir);
+    bench_input(runner);
+    bench_culling(runner);
+    bench_particles(runner);
+
+    if (!runner.write_json(out_path, ROCKETGE__VERSION)) {
+        rocket::log("failed to write " + out_path, "rocket_bench", "rocket_main", "error");
+        return 1;
+    }
+    rocket::log("wrote " + std::to_string(runner.get_results().size()) + " results to " + out_path, "rocket_bench", "rocket_main", "info");
+    return 0;
+}
+
+DEFINE_PLATFORM_MAIN
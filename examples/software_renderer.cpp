@@ -9,17 +9,10 @@
 #include <rocket/rgl.hpp>
 #include <cmath>
 
-/// @brief Contiguous
-using framebuffer_t = std::vector<rocket::rgba_color>;
-
-rocket::rgba_color &access_framebuffer_pixel(framebuffer_t *fb, int x, int y, int width) {
-    return (*fb)[(x + y * width)];
-}
-
 /// @brief Chess Grid
-void render(framebuffer_t *fb, rocket::renderer_2d *r) {
-    const int width = r->get_viewport_size().x;
-    const int height = r->get_viewport_size().y;
+void render(rocket::framebuffer_canvas_t &canvas, rocket::renderer_2d *r) {
+    const int width = canvas.get_size().x;
+    const int height = canvas.get_size().y;
 
     static float t = 0.f;  // animation timer
     t += 5.f * r->get_delta_time();
@@ -35,9 +28,11 @@ void render(framebuffer_t *fb, rocket::renderer_2d *r) {
             float value = std::sin(nx*50 + t) * std::cos(ny*50 + t);
             value = (value > 0) ? 1.f : 0.f;
             uint8_t col = static_cast<uint8_t>(value * 255);
-            access_framebuffer_pixel(fb, x, y, width) = { 255, col, 255, 255 };
+            canvas.at(x, y) = { 255, col, 255, 255 };
         }
     }
+    // Everything moves, static parts would only mark what changed
+    canvas.mark_all_dirty();
 }
 
 
@@ -59,9 +54,8 @@ int rocket_main(int argc, char **argv, rocket_arguments_t) {
         r.clear();
         {
             if (i >= h) {
-                framebuffer_t fb = r.get_framebuffer();
-                render(&fb, &r);
-                r.push_framebuffer(fb);
+                render(r.get_canvas(), &r);
+                r.push_canvas();
             }
             i++;
         }
@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 import argparse
+import json
 import subprocess
 import sys
 import shutil
@@ -25,6 +26,12 @@ parser.add_argument("-g", "--glfnldr-backend", action="store", help="Which glfnl
 parser.add_argument("--build-editor", action="store_true", help="Whether to build editor \
         (Very finicky and requires Qt)")
 parser.add_argument("--smoke-vulkan", action="store_true", help="Runs the Windows Vulkan backend smoke tests")
+parser.add_argument("--run-bench", action="store_true", help="Runs rocket_bench, results go to \
+        bench_output.json")
+parser.add_argument("--compare-bench", action="store", nargs=2, metavar=("BASELINE", "CURRENT"), \
+        help="Compares two rocket_bench JSON files, fails on regressions")
+parser.add_argument("--bench-threshold", action="store", type=float, default=10.0, help="Slowdown \
+        in percent counted as a regression by --compare-bench")
 
 
 def is_windows_env() -> bool:
@@ -337,6 +344,65 @@ def run_vulkan_smoke() -> int:
     return 1 if failed else 0
 
 
+def run_bench() -> int:
+    root_dir = Path(__file__).resolve().parent
+    suffix = ".exe" if is_windows_env() else ""
+    bench = root_dir / "bin" / "bench" / ("rocket_bench" + suffix)
+    if not bench.is_file():
+        print(f"Benchmark '{bench}' not found, build with -DBUILD_BENCH=ON")
+        return 1
+
+    print("RocketGE: Benchmark Runner")
+    result = subprocess.run(
+        [str(bench.resolve()), "--bench-out", "bench_output.json"],
+        cwd=str(root_dir)
+    )
+    return result.returncode
+
+
+def compare_bench(baseline_path: str, current_path: str, threshold: float) -> int:
+    def load(path: str) -> dict[str, float]:
+        with open(path, "r", encoding="utf-8") as f:
+            data = json.load(f)
+        return {b["name"]: float(b["ns_per_op"]) for b in data.get("benchmarks", [])}
+
+    try:
+        baseline = load(baseline_path)
+        current = load(current_path)
+    except (OSError, ValueError, KeyError) as exc:
+        print(f"Could not read benchmark results: {exc}")
+        return 1
+
+    print("RocketGE: Benchmark Compare")
+    print(f"Baseline: {baseline_path}")
+    print(f"Current: {current_path}")
+    print(f"Threshold: {threshold:.1f}%")
+    print(f"{'benchmark':<40}{'baseline ns':>14}{'current ns':>14}{'change':>10}")
+
+    regressions = []
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print(f"{name:<40}{baseline[name]:>14.1f}{'-':>14}{'gone':>10}")
+            continue
+        if name not in baseline:
+            print(f"{name:<40}{'-':>14}{current[name]:>14.1f}{'new':>10}")
+            continue
+        old = baseline[name]
+        new = current[name]
+        change = ((new - old) / old) * 100.0 if old > 0 else 0.0
+        mark = ""
+        if change > threshold:
+            regressions.append(name)
+            mark = "  <- regression"
+        print(f"{name:<40}{old:>14.1f}{new:>14.1f}{change:>+9.1f}%{mark}")
+
+    if regressions:
+        print("FAIL: " + ", ".join(regressions))
+        return 1
+    print("No regressions")
+    return 0
+
+
 def init_cmake(args):
     commands = ["cmake"]
     for command in commands:
@@ -459,6 +525,10 @@ _  _, _// /_/ / /__ _  ,<  /  __/ /_ / /_/ / _  /___
         return_codes.append(run_tests())
     if args.smoke_vulkan:
         return_codes.append(run_vulkan_smoke())
+    if args.run_bench:
+        return_codes.append(run_bench())
+    if args.compare_bench:
+        return_codes.append(compare_bench(args.compare_bench[0], args.compare_bench[1], args.bench_threshold))
 
     return max(return_codes, default=1)
 
@@ -75,8 +75,8 @@ namespace rocket {
 
         bool loaded = false;
 
-        bool playing = false;
-        std::thread finish_thread;
+        /// @brief Shared with the audio service, cleared once the source stops
+        std::shared_ptr<std::atomic_bool> playing = std::make_shared<std::atomic_bool>(false);
     public:
         /// @brief AssetID
         assetid_t id;
@@ -126,10 +126,14 @@ namespace rocket {
         float line_height;
         
         bool loaded = false;
+        /// @brief One of the font_default_monospace fonts
+        bool default_monospace = false;
 
         friend class renderer_2d_i;
         friend class opengl_renderer_2d;
         friend class vulkan_renderer_2d;
+        friend class software_renderer_2d;
+        friend struct recording_renderer_2d_impl_t;
         friend class asset_manager_t;
         friend class text_t;
     private:
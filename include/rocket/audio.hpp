@@ -3,6 +3,8 @@
 
 #include "rocket/types.hpp"
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -14,6 +16,8 @@ extern "C" struct ALCdevice;
 extern "C" struct ALCcontext;
 
 namespace rocket::audio {
+    class sound_engine_t;
+
     enum class capabilities_t {
         mono16 = 0, stereo16
     };
@@ -58,26 +62,78 @@ namespace rocket::audio {
 
     struct sound_t {
     private:
-        [[maybe_unused]]
+        /// @brief Persistent AL buffer, uploaded once and shared by all voices
         unsigned int handle = 0;
+        /// @brief Engine the handle was uploaded by
+        sound_engine_t *owner = nullptr;
         [[maybe_unused]]
         bool flat_2d = true;
+        friend class sound_engine_t;
     public:
         assetid_t id = -1;
         bool loaded = false;
         void reload();
         void set_unloaded();
+    public:
+        /// @brief Higher priority voices may steal sources from lower ones
+        uint8_t priority = 128;
+        /// @brief Max voices of this sound playing at once, 0 is unlimited
+        /// @note The oldest instance is stopped to make room
+        uint16_t max_instances = 0;
     public:
         buffer_t buffer;
     };
 
     struct source_t {
-        bool in_use = false;
+        std::atomic_bool in_use = false;
+        /// @brief Bumped every time the source changes owner
+        std::atomic<uint32_t> generation = 0;
         unsigned int source = 0;
     };
 
+    /// @brief Which voice gives up its source when all are busy
+    enum class steal_policy_t {
+        /// @brief Never steal, new voices start virtual
+        none = 0,
+        /// @brief Lowest effective gain
+        quietest,
+        /// @brief Longest playing
+        oldest,
+    };
+
+    struct voice_config_t {
+        steal_policy_t steal_policy = steal_policy_t::quietest;
+        /// @brief Spatial voices further than this from the listener are virtualized
+        float virtualize_distance = 64.f;
+        /// @brief Max voices kept without a source, the lowest priority ones are dropped
+        size_t max_virtual_voices = 256;
+    };
+
     using sound_finish_callback_t = std::function<void()>;
 
+    /// @brief Thread that finish callbacks are dispatched on
+    enum class callback_thread_t {
+        /// @brief Main thread at frame-end (see thread_t::schedule)
+        main = 0,
+        /// @brief The audio service thread itself
+        /// @note Callbacks must be short and must not block
+        audio,
+    };
+
+    /// @brief Audio service configuration
+    struct service_config_t {
+        /// @brief How often all playing sources are polled
+        std::chrono::milliseconds poll_interval = std::chrono::milliseconds(10);
+        /// @brief Where finish callbacks are run
+        callback_thread_t callback_thread = callback_thread_t::main;
+    };
+
+    /// @brief Configure the audio service thread
+    /// @note Thread-Safe, applied on the next poll
+    void set_service_config(service_config_t config);
+    /// @brief Get the current audio service configuration
+    service_config_t get_service_config();
+
     struct streaming_sound_t {
     private:
         stb_vorbis *vorbis = nullptr;
@@ -95,25 +151,159 @@ namespace rocket::audio {
         source_t *source;
     };
 
+    /// @brief Resampling quality of the software mixer
+    enum class resampler_t {
+        linear = 0,
+        /// @brief Catmull-Rom, 4 taps
+        cubic,
+    };
+
+    /// @brief Where the software mixer writes its output
+    enum class sink_type_t {
+        /// @brief Discard, for benchmarks and headless runs
+        null = 0,
+        /// @brief 16-bit stereo PCM WAV file
+        wav,
+        callback,
+    };
+
+    /// @brief Receives interleaved stereo float frames in [-1, 1]
+    using sink_callback_t = std::function<void(const float *frames, size_t frame_count)>;
+
+    struct mixer_config_t {
+        int sample_rate = 48000;
+        /// @brief Frames per processed block
+        size_t block_frames = 256;
+        resampler_t resampler = resampler_t::linear;
+        sink_type_t sink = sink_type_t::null;
+        /// @brief Output path for sink_type_t::wav
+        std::string wav_path;
+        /// @brief Output for sink_type_t::callback
+        sink_callback_t callback;
+    };
+
+    struct software_mixer_impl_t;
+
+    /// @brief Deterministic software mixer, needs no audio device
+    /// @note Not Thread-Safe, drive it from one thread
+    class software_mixer_t {
+    public:
+        using pcm_handle_t = uint32_t;
+        using voice_handle_t = uint32_t;
+    private:
+        software_mixer_impl_t *impl = nullptr;
+    public:
+        /// @brief Copy int16 samples into the mixer, returns 0 on failure
+        pcm_handle_t upload(const buffer_t &buffer);
+        /// @brief Copy interleaved float samples into the mixer, returns 0 on failure
+        pcm_handle_t upload(const float *samples, size_t frame_count, int channels, int sample_rate);
+        /// @brief Frees the samples and finishes voices still playing them
+        /// @note The handle stays invalid, it is not reused
+        void release(pcm_handle_t pcm);
+
+        /// @param pan -1 is left, 1 is right
+        voice_handle_t play(pcm_handle_t pcm, float gain = 1.f, float pan = 0.f, bool loop = false, sound_finish_callback_t cb = nullptr);
+        void stop(voice_handle_t voice);
+        void set_gain(voice_handle_t voice, float gain);
+        void set_pan(voice_handle_t voice, float pan);
+        bool is_playing(voice_handle_t voice) const;
+        size_t get_voice_count() const;
+
+        /// @brief Mix and write block_count blocks to the sink
+        void process(size_t block_count = 1);
+        /// @brief Process as many whole blocks as fit in elapsed, the rest carries over
+        void process_for(std::chrono::nanoseconds elapsed);
+
+        /// @brief Total frames written to the sink
+        uint64_t get_frames_processed() const;
+        const mixer_config_t &get_config() const;
+    public:
+        software_mixer_t(mixer_config_t config = {});
+        software_mixer_t(const software_mixer_t &) = delete;
+        software_mixer_t &operator=(const software_mixer_t &) = delete;
+    public:
+        ~software_mixer_t();
+    };
+
+    /// @brief A playing instance of a sound
+    /// @note Virtual voices (source == nullptr) keep time but are inaudible
+    struct voice_t {
+        const sound_t *sound = nullptr;
+        unsigned int buffer = 0;
+        source_t *source = nullptr;
+        uint32_t generation = 0;
+
+        uint8_t priority = 128;
+        float gain = 1.f;
+        bool loop = false;
+        bool spatial = false;
+        vec3f_t position = { 0, 0, 0 };
+
+        std::chrono::steady_clock::time_point started;
+        float duration = 0.f;
+        sound_finish_callback_t cb;
+    };
+
     class sound_engine_t {
     private:
         device_t *device = nullptr;
         ALCcontext *ctx;
         std::array<source_t, 32> sources = {{}};
         std::vector<std::shared_ptr<streaming_sound_t>> streaming_sounds;
+
+        std::vector<voice_t> voices;
+        voice_config_t voice_config;
+        listener_t listener = {};
+        std::vector<unsigned int> uploaded_buffers;
+
+        /// @brief Software backend, replaces OpenAL when set
+        software_mixer_t *mixer = nullptr;
+        std::chrono::steady_clock::time_point last_mix;
+    private:
+        friend struct sound_t;
+        unsigned int upload(sound_t &sound);
+        /// @brief Stops voices of the sound and frees its buffer
+        void release(sound_t &sound);
+        /// @brief Drops finished voices, firing callbacks of virtual ones
+        void reap_voices();
+        void play_voice(voice_t voice);
+        bool is_alive(const voice_t &voice) const;
+        float loudness(const voice_t &voice) const;
+        bool attach(voice_t &voice, source_t *source);
+        void virtualize(voice_t &voice);
     public:
         void set_device(device_t *device);
+        void set_voice_config(voice_config_t config);
+        /// @brief Applies the listener and uses it for virtualization
+        void set_listener(const listener_t &listener);
     public:
         // @brief Play a Sound
         // @note Volume is in percentage
         void play(sound_t &sound, bool loop = false, sound_finish_callback_t = nullptr, float volume = 30.f);
+        // @brief Play a Sound at a position in world space
+        // @note Volume is in percentage
+        void play_at(sound_t &sound, vec3f_t position, bool loop = false, sound_finish_callback_t = nullptr, float volume = 30.f);
         void play(std::shared_ptr<streaming_sound_t> sound, bool loop = false, sound_finish_callback_t = nullptr);
         std::shared_ptr<streaming_sound_t> stream(std::string file_path, bool loop = false, sound_finish_callback_t = nullptr);
 
         /// @brief Updates and plays music streams
         void update_music_streams();
+
+        /// @brief (De)virtualizes by distance and hands free sources to virtual voices
+        /// @note Call once per frame from the main thread, finished voices
+        ///         are also reaped by play() without it
+        void update_voices();
+
+        /// @brief Voices currently holding a source
+        size_t get_active_voice_count() const;
+        /// @brief Voices currently without a source
+        size_t get_virtual_voice_count() const;
     public:
         sound_engine_t(device_t *device);
+        /// @brief Play through a software mixer instead of an audio device
+        /// @note Priorities, stealing and instance limits only apply to OpenAL,
+        ///         update_voices() advances the mixer by wall-clock time
+        explicit sound_engine_t(software_mixer_t *mixer);
     public:
         ~sound_engine_t();
     };
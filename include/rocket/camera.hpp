@@ -0,0 +1,57 @@
+#ifndef ROCKETGE__CAMERA_HPP
+#define ROCKETGE__CAMERA_HPP
+
+#include "types.hpp"
+#include <glm/mat4x4.hpp>
+
+namespace rocket {
+    /// @brief World to screen transform of a camera: rotate, scale, move
+    /// @note Uniform zoom keeps rects rects, draws stay the same primitive
+    struct camera_transform_t {
+        /// @brief Screen position of the world origin
+        vec2f_t translation = { 0, 0 };
+        float zoom = 1.f;
+        /// @brief Rotation applied to the world, in degrees
+        float rotation = 0.f;
+        float cs = 1.f;
+        float sn = 0.f;
+
+        vec2f_t apply(vec2f_t world) const;
+        /// @brief Transform a rect around its center
+        /// @note Pair with apply_rotation, the rect itself turns with the camera
+        fbounding_box apply(fbounding_box rect) const;
+        float apply_rotation(float degrees) const { return degrees + this->rotation; }
+        float apply_length(float length) const { return length * this->zoom; }
+        /// @brief Same transform as a matrix
+        glm::mat4 get_matrix() const;
+    };
+
+    /// @brief 2D camera, used by draws between begin_render_mode(render_mode_t::camera)
+    ///        and end_render_mode(render_mode_t::camera)
+    /// @note Read when camera mode begins, changes show up the next time it begins
+    struct camera_2d {
+        /// @brief World position shown at the center of the viewport
+        vec2f_t position = { 0, 0 };
+        /// @brief Scale, 2 shows everything twice as big
+        float zoom = 1.f;
+        /// @brief Rotation in degrees, the world turns the other way
+        float rotation = 0.f;
+        /// @brief Screen region the camera looks through
+        /// @note Size { -1, -1 } for the whole renderer viewport
+        /// @note Draws are not clipped to it, use scissor mode for split screen
+        fbounding_box viewport = { { 0, 0 }, { -1, -1 } };
+
+        /// @brief Get the world to screen transform
+        /// @param viewport_size Renderer viewport, used when viewport is unset
+        camera_transform_t get_transform(vec2f_t viewport_size) const;
+        /// @brief Get the view matrix, world to screen pixels
+        glm::mat4 get_view_matrix(vec2f_t viewport_size) const;
+        /// @brief Axis-aligned world-space bounds of what the camera sees
+        fbounding_box get_world_bounds(vec2f_t viewport_size) const;
+
+        vec2f_t world_to_screen(vec2f_t world, vec2f_t viewport_size) const;
+        vec2f_t screen_to_world(vec2f_t screen, vec2f_t viewport_size) const;
+    };
+}
+
+#endif
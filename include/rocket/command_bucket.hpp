@@ -0,0 +1,202 @@
+#ifndef ROCKETGE__COMMAND_BUCKET_HPP
+#define ROCKETGE__COMMAND_BUCKET_HPP
+
+#include "asset.hpp"
+#include "culling.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rocket {
+    class renderer_2d_i;
+    struct render_cache_t;
+
+    /// @brief 64-bit draw sort key
+    /// @note From most to least significant:
+    ///       pass (1), layer (8), sequence (20), shader (4), texture (12), depth (19)
+    /// @note Draws into render caches are pass 0, so a cache is filled before the screen samples it
+    /// @note sequence numbers the runs of a bucket's draws that may be reordered,
+    ///       shader and texture only batch inside a run, see command_bucket_t
+    struct sort_key_t {
+        static constexpr int depth_bits = 19;
+        static constexpr int texture_bits = 12;
+        static constexpr int shader_bits = 4;
+        static constexpr int sequence_bits = 20;
+        static constexpr int layer_bits = 8;
+        static constexpr int pass_bits = 1;
+
+        static constexpr int depth_shift = 0;
+        static constexpr int texture_shift = depth_shift + depth_bits;
+        static constexpr int shader_shift = texture_shift + texture_bits;
+        static constexpr int sequence_shift = shader_shift + shader_bits;
+        static constexpr int layer_shift = sequence_shift + sequence_bits;
+        static constexpr int pass_shift = layer_shift + layer_bits;
+
+        static constexpr uint32_t max_depth = (1u << depth_bits) - 1;
+        static constexpr uint32_t max_sequence = (1u << sequence_bits) - 1;
+        static constexpr uint16_t max_texture = (1u << texture_bits) - 1;
+        static constexpr uint8_t max_shader = (1u << shader_bits) - 1;
+
+        /// @brief Render cache targets
+        static constexpr uint8_t pass_offscreen = 0;
+        static constexpr uint8_t pass_screen = 1;
+
+        /// @brief Pack a key, every field is clamped to its maximum
+        static constexpr uint64_t make(uint8_t pass, uint8_t layer, uint32_t sequence, uint8_t shader, uint16_t texture, uint32_t depth) {
+            return (static_cast<uint64_t>(pass != 0 ? 1 : 0) << pass_shift)
+                | (static_cast<uint64_t>(layer) << layer_shift)
+                | (static_cast<uint64_t>(sequence < max_sequence ? sequence : max_sequence) << sequence_shift)
+                | (static_cast<uint64_t>(shader < max_shader ? shader : max_shader) << shader_shift)
+                | (static_cast<uint64_t>(texture < max_texture ? texture : max_texture) << texture_shift)
+                | (static_cast<uint64_t>(depth < max_depth ? depth : max_depth) << depth_shift);
+        }
+
+        static constexpr uint8_t get_pass(uint64_t key) { return static_cast<uint8_t>(key >> pass_shift) & 1; }
+        static constexpr uint8_t get_layer(uint64_t key) { return static_cast<uint8_t>(key >> layer_shift); }
+        static constexpr uint32_t get_sequence(uint64_t key) { return static_cast<uint32_t>(key >> sequence_shift) & max_sequence; }
+        static constexpr uint8_t get_shader(uint64_t key) { return static_cast<uint8_t>(key >> shader_shift) & max_shader; }
+        static constexpr uint16_t get_texture(uint64_t key) { return static_cast<uint16_t>(key >> texture_shift) & max_texture; }
+        static constexpr uint32_t get_depth(uint64_t key) { return static_cast<uint32_t>(key >> depth_shift) & max_depth; }
+    };
+
+    enum class bucket_op_t : uint8_t {
+        rectangle,
+        circle,
+        polygon,
+        texture,
+        atlas_texture,
+        text,
+        pixel,
+        render_cache,
+    };
+
+    /// @brief One recorded draw, each op reads the fields it needs
+    struct bucket_command_t {
+        uint64_t key = 0;
+        bucket_op_t op = bucket_op_t::rectangle;
+        uint8_t flag = 0;
+        /// @brief Index into the bucket's targets, 0 is the screen
+        uint16_t target = 0;
+        /// @brief Index into the bucket's textures, texts or caches
+        uint32_t ref = 0;
+        int32_t ival = 0;
+        float f0 = 0.f;
+        float f1 = 0.f;
+        fbounding_box rect = {};
+        vec2f_t a = {};
+        vec2f_t b = {};
+        rgba_color color = {};
+    };
+
+    /// @brief Draw calls recorded off the graphics thread
+    /// @note One bucket per thread, a bucket itself is not Thread-Safe
+    /// @note Hand it over with renderer_2d_i::submit_bucket,
+    ///       draws are sorted by key and submitted at end_frame
+    /// @note Within a layer draws keep their recording order wherever it is visible:
+    ///       a draw that overlaps an earlier one of its run with another shader or texture
+    ///       starts a new run, and so does set_target
+    /// @note Equal keys keep their recording order, buckets keep the order they were submitted in:
+    ///       within a layer a bucket's runs follow those of every bucket submitted before it
+    class command_bucket_t {
+    private:
+        /// @brief Bounds of the draws in the current run with one shader and texture
+        struct run_state_t {
+            uint8_t shader;
+            uint16_t texture;
+            fbounding_box bounds;
+        };
+        /// @brief A run with more states starts over, overlap checks stay cheap
+        static constexpr size_t max_run_states = 16;
+
+        std::vector<bucket_command_t> commands;
+        std::vector<std::shared_ptr<texture_t>> textures;
+        std::vector<text_t> texts;
+        std::vector<render_cache_t *> caches;
+        /// @brief Slot 0 is the screen
+        std::vector<render_cache_t *> targets = { nullptr };
+
+        /// @brief Texture, font or cache to its texture id, first seen first
+        std::unordered_map<const void *, uint16_t> texture_ids;
+        std::vector<run_state_t> run;
+
+        uint8_t layer = 0;
+        uint32_t depth = 0;
+        uint16_t target = 0;
+        uint32_t sequence = 0;
+
+        friend class command_bucket_queue_t;
+    private:
+        bucket_command_t &push(bucket_op_t op);
+        /// @brief Key a filled in command, advancing the run if it has to stay in order
+        void assign_key(bucket_command_t &c, uint8_t shader, const void *texture);
+        uint16_t texture_id(const void *texture);
+        uint32_t add_texture(const std::shared_ptr<texture_t> &texture);
+    public:
+        /// @brief Set the layer of the next draws, layers draw lowest first
+        void set_layer(uint8_t layer);
+        /// @brief Set the depth of the next draws [0-sort_key_t::max_depth]
+        /// @note Only orders draws of one run with the same shader and texture
+        void set_depth(uint32_t depth);
+        /// @brief Draw the next draws into a render cache, nullptr for the screen
+        /// @note The cache must stay alive until the frame ends
+        void set_target(render_cache_t *cache);
+
+        uint8_t get_layer() const { return this->layer; }
+        uint32_t get_depth() const { return this->depth; }
+
+        void draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false);
+        void draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false);
+        void draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int thickness = 0);
+        void draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int sides = 3, float rotation = 0.f);
+        void draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation = 0.f, float roundedness = 0.f);
+        void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f);
+        /// @brief Draw text
+        /// @note The text is copied
+        void draw_text(const rocket::text_t &text, vec2f_t position);
+        void draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color);
+        /// @brief Draw contents of a render cache
+        /// @note The cache must stay alive until the frame ends
+        void draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox);
+    public:
+        /// @brief Number of recorded draws
+        size_t size() const { return this->commands.size(); }
+        bool empty() const { return this->commands.empty(); }
+        /// @brief Drop all draws and reset layer, depth and target
+        /// @note Keeps the capacity
+        void clear();
+    };
+
+    /// @brief Buckets handed to a renderer, one per renderer
+    class command_bucket_queue_t {
+    private:
+        struct entry_t {
+            uint64_t key;
+            uint32_t bucket;
+            uint32_t index;
+        };
+
+        std::mutex mtx;
+        std::vector<command_bucket_t> pending;
+        /// @brief Emptied buckets, their capacity is handed back on submit
+        std::vector<command_bucket_t> spare;
+
+        std::vector<entry_t> entries;
+        std::vector<entry_t> scratch;
+        std::vector<command_bucket_t> drawing;
+        cull_soa_t bounds;
+        std::vector<uint32_t> visible;
+    public:
+        /// @brief Take over the contents of a bucket
+        /// @note Thread-Safe, leaves the bucket empty
+        void push(command_bucket_t &bucket);
+        /// @brief Merge, cull, radix-sort and draw everything pushed so far
+        /// @note Culling runs once over all draws, before the sort
+        /// @return Number of draws submitted
+        size_t submit(renderer_2d_i *ren);
+    };
+}
+
+#endif
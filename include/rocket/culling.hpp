@@ -0,0 +1,52 @@
+#ifndef ROCKETGE__CULLING_HPP
+#define ROCKETGE__CULLING_HPP
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rocket {
+    /// @brief Bounds of many draws, one array per component
+    struct cull_soa_t {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> w;
+        std::vector<float> h;
+        /// @brief Rotation around the center in degrees
+        /// @note Stays empty until a rotated rect is pushed
+        std::vector<float> rotation;
+
+        void push(fbounding_box rect, float rotation = 0.f);
+        void reserve(size_t count);
+        void clear();
+        size_t size() const { return this->x.size(); }
+    };
+
+    /// @brief Write the indices of the rects that intersect view to out, in order
+    /// @param rotation Degrees per rect, may be nullptr
+    /// @note Same test as fbounding_box::intersects,
+    ///       a rotated rect is tested by the square around its circumscribed circle
+    /// @note out needs room for count indices
+    /// @note Uses AVX2, SSE2 or NEON when available
+    /// @return Number of visible rects
+    size_t cull_rects(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, fbounding_box view, uint32_t *out);
+    /// @brief Replace visible with the indices of the rects in bounds that intersect view
+    void cull_rects(const cull_soa_t &bounds, fbounding_box view, std::vector<uint32_t> &visible);
+
+    /// @brief Code paths of cull_rects
+    enum class cull_path_t {
+        /// @brief The widest path the CPU has
+        automatic,
+        scalar,
+        sse2,
+        avx2,
+        neon,
+    };
+    /// @brief Force a cull_rects path, for tests and benchmarks
+    /// @note Not Thread-Safe, nothing may be culling while it changes
+    /// @return false if the path is not built in or the CPU lacks it, the current one stays
+    bool set_cull_path(cull_path_t path);
+}
+
+#endif
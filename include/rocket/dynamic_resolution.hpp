@@ -0,0 +1,58 @@
+#ifndef ROCKETGE__DYNAMIC_RESOLUTION_HPP
+#define ROCKETGE__DYNAMIC_RESOLUTION_HPP
+
+namespace rocket {
+    /// @brief How a scene rendered below native resolution is scaled to the window
+    enum class upscale_filter_t {
+        bilinear,
+        /// @brief Bilinear with an unsharp mask
+        sharpen,
+        fxaa,
+    };
+
+    /// @brief Render the scene at a lower resolution when frames run over budget
+    /// @note OpenGL only, draws in render_mode_t::ui stay at native resolution
+    struct dynamic_resolution_t {
+        bool enabled = false;
+        /// @brief Scale range per axis [0-1]
+        float min_scale = 0.5f;
+        float max_scale = 1.f;
+        /// @brief Frame rate to hold, 0 for the renderer's target fps (60 when uncapped)
+        float target_fps = 0.f;
+        upscale_filter_t filter = upscale_filter_t::fxaa;
+        /// @brief Strength of upscale_filter_t::sharpen
+        float sharpness = 0.5f;
+    };
+
+    /// @brief Picks a render scale from frame times
+    /// @note Cost is assumed to follow pixel count, so the scale moves with the square root of the load
+    class dynamic_resolution_controller_t {
+    private:
+        float scale = 1.f;
+        /// @brief Smoothed frame time over budget
+        float load = -1.f;
+        int headroom_frames = 0;
+        int cooldown_frames = 0;
+    public:
+        /// @brief Frames after a change whose times are ignored, GPU times arrive late
+        static constexpr int cooldown = 4;
+        /// @brief Frames under budget before the scale steps up
+        static constexpr int headroom = 30;
+        /// @brief Scales are multiples of this, the target is only reallocated on real changes
+        static constexpr float step = 1.f / 16.f;
+
+        /// @brief Feed one frame
+        /// @param frame_time Seconds of CPU or GPU work in the frame, whichever is larger
+        /// @param budget Seconds per frame at the target fps
+        /// @return Scale for the next frame
+        float update(float frame_time, float budget, float min_scale, float max_scale);
+        /// @brief Forget the history and start over at scale
+        void reset(float scale = 1.f);
+
+        float get_scale() const { return this->scale; }
+        /// @brief Smoothed frame time over budget, 1 is exactly on budget
+        float get_load() const { return this->load < 0.f ? 0.f : this->load; }
+    };
+}
+
+#endif
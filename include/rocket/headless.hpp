@@ -0,0 +1,80 @@
+#ifndef ROCKETGE__HEADLESS_HPP
+#define ROCKETGE__HEADLESS_HPP
+
+#include "renderer.hpp"
+#include "types.hpp"
+#include "window.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace rocket {
+    /// @brief Offscreen rendering without a display or GPU
+    /// @note A null window paired with software_renderer_2d, frames only exist in memory
+    class headless_renderer_t {
+    private:
+        null_window_t window;
+        software_renderer_2d renderer;
+    public:
+        renderer_2d_i *get_renderer() { return &renderer; }
+        window_backend_i *get_window() { return &window; }
+        rocket::vec2i_t get_size() const { return window.get_size(); }
+
+        /// @brief Render frames back to back and return the last one
+        /// @note draw gets the frame index, animate off that instead of delta time
+        ///       so every run produces the same pixels
+        std::vector<rgba_color> render(int frames, const std::function<void(renderer_2d_i *ren, uint64_t frame)> &draw);
+    public:
+        headless_renderer_t(rocket::vec2i_t size = { 640, 360 }, renderer_flags_t flags = {
+            .share_renderer_as_global = false,
+            .show_splash = false
+        });
+    };
+
+    /// @brief How far apart two images are
+    struct image_diff_t {
+        /// @brief Sizes differ, nothing else is filled in
+        bool size_mismatch = false;
+        /// @brief Pixels with any channel off by more than the tolerance
+        size_t differing_pixels = 0;
+        /// @brief Largest difference of any channel
+        int max_channel_error = 0;
+        /// @brief Mean absolute difference over all channels
+        double mean_error = 0.0;
+        /// @brief Peak signal to noise ratio in dB, infinity when identical
+        double psnr = 0.0;
+
+        /// @brief Same size and no differing pixels
+        bool identical() const { return !size_mismatch && differing_pixels == 0; }
+    };
+
+    struct golden_tolerance_t {
+        /// @brief Channel difference still counted as equal
+        int channel_tolerance = 2;
+        /// @brief Share of differing pixels allowed [0-1]
+        float max_differing_ratio = 0.001f;
+    };
+
+    /// @brief Compare two images of the same size
+    image_diff_t compare_images(const std::vector<rgba_color> &expected, const std::vector<rgba_color> &actual, rocket::vec2i_t size, int channel_tolerance = 0);
+
+    /// @brief Write RGBA8 pixels, PNG for .png, raw rows top to bottom otherwise
+    bool write_image(const std::string &path, const std::vector<rgba_color> &pixels, rocket::vec2i_t size);
+    /// @brief Read an image as RGBA8
+    bool read_image(const std::string &path, std::vector<rgba_color> &pixels, rocket::vec2i_t &size);
+
+    /// @brief Compare pixels against golden_dir/name.png
+    /// @note The golden is recorded instead with --update-golden, a missing golden fails,
+    ///       on mismatch the actual and diff images go to --golden-output (golden_output/)
+    bool check_golden(
+        const std::string &golden_dir,
+        const std::string &name,
+        const std::vector<rgba_color> &pixels,
+        rocket::vec2i_t size,
+        golden_tolerance_t tolerance = {},
+        image_diff_t *diff = nullptr
+    );
+}
+
+#endif
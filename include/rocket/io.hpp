@@ -3,8 +3,11 @@
 
 #include "types.hpp"
 #include "constants.hpp"
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <string>
+#include <variant>
 
 namespace rocket {
     namespace io {
@@ -116,14 +119,74 @@ namespace rocket {
             rocket::vec2d_t offset = { 0, 0 };
         };
 
+        struct gamepad_event_t {
+            /// @brief Gamepad index, in connection order
+            uint8_t gamepad = 0;
+            /// @brief gpad::button_t or gpad::axis_t value, see axis
+            int index = 0;
+            bool axis = false;
+            /// @brief 0 or 1 for buttons, -1 to 1 for axes
+            float value = 0.f;
+        };
+
+        /// @brief Timestamped input event
+        struct input_event_t {
+            using data_t = std::variant<key_event_t, mouse_event_t, mouse_move_event_t, scroll_offset_event_t, gamepad_event_t>;
+
+            /// @brief Nanoseconds on the input clock, see event_clock_ns
+            uint64_t timestamp_ns = 0;
+            /// @brief Strictly increasing across frames
+            uint64_t sequence = 0;
+            data_t data;
+            /// @brief Injected through io::simulate, never recorded
+            bool simulated = false;
+        };
+
+        /// @brief Events received during the last window poll, ordered by timestamp
+        /// @note Valid until the next poll_events, nothing is copied
+        /// @note Devices only record state changes, held keys do not repeat
+        std::span<const input_event_t> get_frame_events();
+
+        /// @brief Current time on the input clock (steady clock, ns)
+        uint64_t event_clock_ns();
+
+        /// @brief Starts a thread polling gamepads at rate_hz
+        /// @note Its events show up in get_frame_events with their own timestamps
+        void start_gamepad_thread(int rate_hz = 1000);
+        /// @brief Stops the gamepad thread, if running
+        void stop_gamepad_thread();
+
+        /// @brief Record device input of every frame into a file
+        /// @return false if the file could not be opened
+        bool start_recording(const std::string &path);
+        /// @brief Stop recording, the file stays valid
+        void stop_recording();
+
+        /// @brief Replay a recording from the next frame on
+        /// @note Live device input is ignored and get_delta_time
+        ///         returns a fixed value while replaying
+        /// @param exit_when_done calls rocket::exit(0) after the last frame
+        /// @return false if the file could not be read
+        bool start_replay(const std::string &path, bool exit_when_done = false);
+        /// @brief Checks if a recording is being replayed
+        bool is_replaying();
+
+        /// @brief Listener handle
+        using listener_id_t = uint32_t;
+
         /// @brief Add a key event listener
-        void add_listener(std::function<void(key_event_t)>);
+        listener_id_t add_listener(std::function<void(key_event_t)>);
         /// @brief Add a mouse event listener
-        void add_listener(std::function<void(mouse_event_t)>);
+        listener_id_t add_listener(std::function<void(mouse_event_t)>);
         /// @brief Add a mouse move event listener
-        void add_listener(std::function<void(mouse_move_event_t)>);
+        listener_id_t add_listener(std::function<void(mouse_move_event_t)>);
         /// @brief Add a scroll offset event listener
-        void add_listener(std::function<void(scroll_offset_event_t)>);
+        listener_id_t add_listener(std::function<void(scroll_offset_event_t)>);
+
+        /// @brief Remove a listener
+        /// @note Safe to call from inside a listener
+        /// @return false if no listener has that id
+        bool remove_listener(listener_id_t id);
 
         // IMMD IO
 
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <rocket/camera.hpp>
+#include <rocket/command_bucket.hpp>
+#include <rocket/culling.hpp>
+#include <rocket/particles.hpp>
+#include <rocket/tilemap.hpp>
 #include <rocket/shader.hpp>
 #include <rocket/types.hpp>
 #include <functional>
@@ -53,17 +58,43 @@ namespace rocket {
 
         renderer_2d_impl_t *impl = nullptr;
 
+        framebuffer_canvas_t canvas;
+
+        command_bucket_queue_t command_buckets;
+
+        /// @brief Snapshot of cam while render_mode_t::camera is active
+        bool camera_active = false;
+        camera_transform_t camera_xf;
+        rocket::fbounding_box camera_world_bounds = {};
+
+        /// @brief Size of the sized render cache being drawn into, culling uses it over the viewport
+        rocket::vec2f_t render_cache_extent = { -1, -1 };
+
         friend window_backend_i* __r2d_get_window(rocket::renderer_2d_i*);
         friend class shader_i;
         friend class renderer_3d;
         friend class font_t;
         friend class asset_manager_t;
+        friend class recording_renderer_2d;
+        friend class threaded_renderer_2d;
+        friend class tilemap_t;
+        friend class particle_emitter_t;
     protected:
         enum class gfx_chk_result {
             not_drawable,
             drawable,
         };
         virtual gfx_chk_result check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) = 0;
+        /// @brief Draw the submitted command buckets in key order
+        /// @note Backends call this first thing in end_frame
+        void flush_command_buckets();
+        /// @brief Snapshot the camera, backends call this when render_mode_t::camera begins
+        /// @note No-op without a camera
+        void begin_camera_mode();
+        void end_camera_mode();
+        /// @brief What viewport culling tests against
+        /// @note The camera's world bounds in camera mode, else the viewport
+        rocket::fbounding_box get_culling_bounds();
     private:
         virtual api_object_t upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) = 0;
         virtual void clean_gpu_resource(api_object_t object) = 0;
@@ -83,13 +114,27 @@ namespace rocket {
         /// @brief Begin render mode
         virtual void begin_render_mode(render_mode_t) = 0;
         /// @brief Get a contiguous block of pixels
-        /// @brief adjusted to viewport size
-        /// @brief VERY SLOW use only for SOFTWARE rendering
+        /// @brief adjusted to viewport size, rows top to bottom
+        /// @note Synchronous, waits for the GPU to finish drawing
+        /// @note Use request_framebuffer_readback to not stall
         virtual std::vector<rgba_color> get_framebuffer() = 0;
         /// @brief Push a contiguous block of pixels
         /// @brief adjusted to viewport size
         /// @brief ONLY for SOFTWARE rendering
         virtual void push_framebuffer(const std::vector<rgba_color> &framebuffer) = 0;
+        /// @brief Persistent CPU canvas the size of the viewport
+        /// @note Resized (and fully dirtied) when the viewport changes
+        /// @note Write into it and call push_canvas, nothing is copied
+        framebuffer_canvas_t &get_canvas();
+        /// @brief Upload the dirty parts of the canvas and draw it over the frame
+        virtual void push_canvas() = 0;
+        /// @brief Read back this frame's pixels when it ends, without waiting on the GPU
+        /// @param region Viewport pixels, size { -1, -1 } for the whole viewport
+        /// @note Collect with poll_framebuffer_readback a few frames later
+        virtual void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) = 0;
+        /// @brief Take the oldest finished readback
+        /// @return false if none is ready yet, never blocks
+        virtual bool poll_framebuffer_readback(framebuffer_readback_t &out) = 0;
         /// @brief Get the size of the viewport
         virtual vec2f_t get_viewport_size() = 0;
         /// @brief Begin scissor mode
@@ -151,6 +196,15 @@ namespace rocket {
         /// @param rotation Rotation in degrees
         /// @param roundedness Roundedness [0-1]
         virtual void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f) = 0;
+        /// @brief Draw one chunk of a tilemap, used by tilemap_t::draw
+        /// @note Draws every tile with draw_atlas_texture,
+        ///       backends with vertex buffers keep the chunk on the GPU and draw it in one call
+        /// @param position Where the top-left of the map goes
+        virtual void draw_tilemap_chunk(tilemap_chunk_t &chunk, const std::shared_ptr<rocket::texture_t> &atlas, rocket::vec2f_t position);
+        /// @brief Draw the particles of an emitter, used by particle_emitter_t::draw
+        /// @note Draws every particle with draw_rectangle,
+        ///       backends with instancing upload the batch and draw it in one call
+        virtual void draw_particles(particle_batch_t &batch);
 
         /// @brief Make a texture ready for drawing
         /// @note Not needed to be called before drawing
@@ -167,9 +221,25 @@ namespace rocket {
         /// @param pos Position
         /// @param color Color
         virtual void draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) = 0;
+
+        /// @brief Hand over draws recorded on another thread
+        /// @note Thread-Safe, the bucket is left empty to be refilled
+        /// @note All buckets are merged, sorted by key and drawn at end_frame
+        void submit_bucket(command_bucket_t &bucket);
+        /// @brief Cull many draws at once against what viewport culling tests against
+        /// @note Replaces visible with the indices of the draws that are kept, in order
+        /// @note Keeps everything when viewport culling is off
+        void cull_visible(const cull_soa_t &bounds, std::vector<uint32_t> &visible);
     public:
         /// @brief Draw FPS at the top left
         virtual void draw_fps(vec2f_t pos = { 10, 10 }) = 0;
+    public:
+        /// @brief Begin a named GPU timing region, nests
+        /// @note name must outlive the renderer (string literals)
+        /// @note No-op unless GPU timing is enabled (--gpu-timing)
+        virtual void begin_gpu_region(const char *name) = 0;
+        /// @brief End the innermost GPU timing region
+        virtual void end_gpu_region() = 0;
     public:
         /// @brief Set Wireframe State
         virtual void set_wireframe(bool) = 0;
@@ -236,9 +306,15 @@ namespace rocket {
         virtual float get_current_fps() = 0;
     public:
         /// @brief Create a render cache to draw into
-        virtual render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb) = 0;
-        /// @brief Invalidate the render cache and force a redraw
+        /// @param size Size in pixels, draw_cb draws from 0, 0 to size.
+        ///             -1, -1 for a viewport-sized cache, redrawn when the viewport resizes
+        /// @note Small sized caches are packed into shared atlas textures where the backend has them
+        virtual render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) = 0;
+        /// @brief Invalidate the render cache
+        /// @note Only marks it, draw_cb reruns before the cache is drawn or begun next
         virtual void invalidate_render_cache(render_cache_t *c) = 0;
+        /// @brief Rerun draw_cb now if the cache was invalidated
+        virtual void update_render_cache(render_cache_t *c) = 0;
         /// @brief Begins rendering to render_cache
         virtual void begin_render_cache(render_cache_t *c) = 0;
         /// @brief Ends rendering to render_cache
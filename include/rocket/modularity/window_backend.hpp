@@ -32,7 +32,9 @@ namespace rocket {
         friend class renderer_2d_i;
         friend class opengl_renderer_2d;
         friend class vulkan_renderer_2d;
+        friend class software_renderer_2d;
         friend class renderer_3d;
+        friend class threaded_renderer_2d;
         friend std::vector<std::string> rgl::init_gl(rocket::vec2f_t viewport_size, glfnldr::backend_t);
     public:
         windowflags_t get_flags() const { return this->flags; }
@@ -44,6 +46,9 @@ namespace rocket {
         virtual bool create_vk_surface(void *vk_instance, const void *allocator, void *surface) const = 0;
     protected:
         virtual void swap_buffers() const = 0;
+        /// @brief Bind the graphics context to the calling thread, or release it
+        /// @note A context is current on one thread at a time
+        virtual void make_context_current(bool current) const = 0;
     public:
         virtual ~window_backend_i() = default;
     public:
@@ -0,0 +1,141 @@
+#ifndef ROCKETGE__PARTICLES_HPP
+#define ROCKETGE__PARTICLES_HPP
+
+#include "culling.hpp"
+#include "macros.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rocket {
+    class renderer_2d_i;
+
+    /// @brief Curve of a value over a particle's life
+    enum class particle_easing_t {
+        linear,
+        quadratic_in,
+        quadratic_out,
+        cubic_in,
+        cubic_out,
+        sinusoidal_in_out,
+        exponential_out,
+    };
+
+    struct particle_emitter_config_t {
+        /// @brief Where particles spawn
+        vec2f_t position = { 0, 0 };
+        /// @brief Particles spawn anywhere in this area, centered on position
+        vec2f_t spawn_area = { 0, 0 };
+        /// @brief Particles per second, 0 for bursts only
+        float rate = 100.f;
+        /// @brief Live particles are capped at this, spawns over it are dropped
+        size_t max_particles = 10000;
+
+        /// @brief Lifetime in seconds, picked per particle
+        float lifetime_min = 1.f;
+        float lifetime_max = 1.f;
+        /// @brief Start velocity in pixels per second, picked per particle
+        vec2f_t velocity_min = { -50, -50 };
+        vec2f_t velocity_max = { 50, 50 };
+        /// @brief Constant acceleration, e.g. gravity
+        vec2f_t acceleration = { 0, 0 };
+        /// @brief Fraction of velocity lost per second [0-1]
+        float drag = 0.f;
+
+        /// @brief Quad size at birth and at death
+        float size_start = 4.f;
+        float size_end = 0.f;
+        particle_easing_t size_easing = particle_easing_t::linear;
+        rgba_color color_start = { 255, 255, 255, 255 };
+        rgba_color color_end = { 255, 255, 255, 0 };
+        particle_easing_t color_easing = particle_easing_t::linear;
+
+        /// @brief Same seed, same particles
+        uint32_t seed = 0x9e3779b9u;
+    };
+
+    /// @brief One particle as the renderer gets it, a square centered on x, y
+    struct particle_instance_t {
+        float x;
+        float y;
+        float size;
+        /// @brief RGBA8, red in the lowest byte
+        uint32_t color;
+    };
+
+    /// @brief What an emitter hands to the renderer each frame
+    struct particle_batch_t {
+        std::vector<particle_instance_t> instances;
+        /// @brief Area covered by all instances
+        fbounding_box bounds;
+        /// @brief Bumped on every update
+        uint64_t revision = 0;
+
+        /// @brief Backend-side copy of the instances, for backends that keep one
+        api_object_t gpu = ROCKETGE__InvalidNumber;
+        uint64_t gpu_revision = 0;
+        renderer_2d_i *gpu_owner = nullptr;
+    };
+
+    /// @brief Spawns, simulates and draws particles
+    /// @note Particles live in one structure-of-arrays block taken from a shared pool,
+    ///       updates run with SIMD and split across the job pool for large emitters
+    /// @note Destroy it before the renderer it was drawn with
+    class particle_emitter_t {
+    private:
+        particle_emitter_config_t config;
+        size_t capacity = 0;
+        size_t count = 0;
+        /// @brief x, y, vx, vy, age, inv_life, capacity rounded up per array
+        float *arena = nullptr;
+        size_t stride = 0;
+
+        float spawn_accumulator = 0.f;
+        size_t pending_burst = 0;
+        bool emitting = true;
+        uint32_t rng;
+
+        std::vector<float> size_lut;
+        std::vector<uint32_t> color_lut;
+
+        particle_batch_t batch;
+        cull_soa_t batch_bounds;
+        std::vector<uint32_t> visible;
+    private:
+        float *field(size_t index) const { return this->arena + index * this->stride; }
+        float random(float lo, float hi);
+        void build_luts();
+        void spawn(size_t amount);
+        void remove_dead();
+    public:
+        explicit particle_emitter_t(const particle_emitter_config_t &config);
+        ~particle_emitter_t();
+
+        particle_emitter_t(const particle_emitter_t &) = delete;
+        particle_emitter_t &operator=(const particle_emitter_t &) = delete;
+
+        /// @brief Age, move and spawn particles
+        /// @param dt Seconds since the last update
+        void update(float dt);
+        /// @brief Spawn this many particles on the next update
+        void burst(size_t amount);
+        /// @brief Draw every live particle
+        /// @note The whole emitter is culled against the viewport or camera
+        void draw(renderer_2d_i *ren);
+
+        /// @brief Move the spawn point, live particles stay where they are
+        void set_position(vec2f_t position) { this->config.position = position; }
+        void set_rate(float rate) { this->config.rate = rate; }
+        /// @brief Stop or resume continuous spawning, bursts still spawn
+        void set_emitting(bool emitting) { this->emitting = emitting; }
+
+        const particle_emitter_config_t &get_config() const { return this->config; }
+        size_t get_particle_count() const { return this->count; }
+        size_t get_capacity() const { return this->capacity; }
+        /// @brief Instances of the last update
+        const particle_batch_t &get_batch() const { return this->batch; }
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define RocketGE__persistence_hpp
 
 #include <cstdint>
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -23,6 +24,10 @@ namespace rocket::storage {
     using data_t = std::unordered_map<std::string, variable_t>;
 
     void init(std::string name);
+    /// @brief Keep the storage in directory instead of the per-user data directory
+    void init(std::string name, const std::filesystem::path &directory);
+    /// @brief Directory the storage lives in, shared RocketGE directory before init
+    std::filesystem::path get_storage_path();
     data_t* load();
     void store(const std::string &name, const variable_t &value);
     variable_t& get(const std::string &name);
@@ -0,0 +1,71 @@
+#ifndef ROCKETGE__PROFILER_HPP
+#define ROCKETGE__PROFILER_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace rocket::profiler {
+    /// @brief Nanoseconds on the profiler clock (steady)
+    uint64_t now_ns();
+
+    /// @brief Records one zone on the calling thread
+    /// @note name must outlive the capture (string literals)
+    /// @note Lock-free, each thread writes to its own buffer
+    void record_zone(const char *name, uint64_t start_ns, uint64_t end_ns);
+
+    /// @brief Start capturing zones, clears the previous capture
+    void start_capture();
+    /// @brief Stop capturing zones, the capture is kept until the next start_capture
+    void stop_capture();
+    /// @brief Whether zones are being captured
+    bool is_capturing();
+
+    /// @brief Write the capture as Chrome trace event JSON (Perfetto, chrome://tracing)
+    /// @note Call after stop_capture, zones recorded while writing may be missing
+    bool write_chrome_trace(const std::string &path);
+
+    /// @brief Capture from now on and write the trace to path when the runtime exits
+    /// @note Used by --profile-trace
+    void capture_until_exit(const std::string &path);
+
+    /// @brief Whether ROCKET_PROFILE_SCOPE was compiled in (ROCKETGE__PROFILER)
+    constexpr bool enabled() {
+#ifdef ROCKETGE__PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    class scope_t {
+    private:
+        const char *name;
+        uint64_t start_ns;
+    public:
+        explicit scope_t(const char *name) : name(name), start_ns(is_capturing() ? now_ns() : 0) {}
+        ~scope_t() {
+            if (start_ns != 0) {
+                record_zone(name, start_ns, now_ns());
+            }
+        }
+
+        scope_t(const scope_t &) = delete;
+        scope_t &operator=(const scope_t &) = delete;
+    };
+}
+
+#define ROCKETGE__PROFILE_CONCAT_(a, b) a##b
+#define ROCKETGE__PROFILE_CONCAT(a, b) ROCKETGE__PROFILE_CONCAT_(a, b)
+
+#ifdef ROCKETGE__PROFILER
+/// @brief Time the rest of the enclosing scope as a zone called name
+/// @note name must be a string literal or otherwise outlive the capture
+#define ROCKET_PROFILE_SCOPE(name) ::rocket::profiler::scope_t ROCKETGE__PROFILE_CONCAT(__rge_profile_scope_, __LINE__)(name)
+/// @brief Zone named after the enclosing function
+#define ROCKET_PROFILE_FUNCTION() ROCKET_PROFILE_SCOPE(__func__)
+#else
+#define ROCKET_PROFILE_SCOPE(name) ((void)0)
+#define ROCKET_PROFILE_FUNCTION() ((void)0)
+#endif
+
+#endif//ROCKETGE__PROFILER_HPP
@@ -0,0 +1,194 @@
+#ifndef ROCKETGE__RECORDING_HPP
+#define ROCKETGE__RECORDING_HPP
+
+#include "asset.hpp"
+#include "renderer.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rocket {
+    /// @brief Captured renderer calls in a compact binary form
+    /// @note Native byte order, replay on the kind of machine that recorded it
+    struct command_stream_t {
+        std::vector<uint8_t> data;
+
+        bool empty() const { return data.empty(); }
+        /// @brief Write the stream to a file
+        bool save(const std::string &path) const;
+        /// @brief Read a stream written by save
+        static bool load(const std::string &path, command_stream_t &out);
+    };
+
+    struct recording_options_t {
+        /// @brief Put texture pixels and custom font files into the stream
+        /// @note Without it replay needs resolvers to find them by asset ID
+        bool embed_assets = true;
+    };
+
+    struct recording_renderer_2d_impl_t;
+
+    /// @brief Forwards every call to another renderer and records it
+    /// @note Textures and fonts are written once and referenced after,
+    ///       shaders and cameras are forwarded but not recorded
+    class recording_renderer_2d : public renderer_2d_i {
+    protected:
+        renderer_2d_i *inner = nullptr;
+        recording_renderer_2d_impl_t *rec_impl = nullptr;
+    protected:
+        gfx_chk_result check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+    private:
+        api_object_t upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) override;
+        void clean_gpu_resource(api_object_t object) override;
+    public:
+        /// @brief The renderer calls are forwarded to
+        renderer_2d_i *get_inner() const { return this->inner; }
+
+        /// @brief Start capturing with the next begin_frame
+        /// @param frames Stop by itself after this many frames, -1 to run until stop_recording
+        /// @note Render caches made before are redrawn so the capture has their contents
+        void start_recording(int frames = -1);
+        /// @brief Check if frames are being captured (or will be from the next frame)
+        bool is_recording() const;
+        /// @brief Frames captured so far
+        uint32_t get_recorded_frames() const;
+        /// @brief Stop and take the capture
+        /// @note Only complete frames are kept
+        command_stream_t stop_recording();
+    public:
+        bool has_frame_began() override;
+        void begin_frame() override;
+        void show_splash() override;
+        void begin_render_mode(render_mode_t) override;
+        std::vector<rgba_color> get_framebuffer() override;
+        void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Push the dirty parts of this renderer's canvas
+        /// @note Copied into the inner renderer's canvas first
+        void push_canvas() override;
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
+        vec2f_t get_viewport_size() override;
+        void begin_scissor_mode(rocket::fbounding_box rect) override;
+        void begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) override;
+        void begin_scissor_mode(float x, float y, float sx, float sy) override;
+        void clear(rocket::rgba_color color = { 255, 255, 255, 255 }) override;
+
+        /// @brief Draw a shader
+        /// @note Recorded as a marker only, replay skips it
+        void draw_shader(const shader_i &shader) override;
+
+        void draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+        void draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+        void draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int thickness = 0) override;
+        void draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int sides = 3, float rotation = 0.f) override;
+        void draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation = 0.f, float roundedness = 0.f) override;
+        void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f) override;
+        void make_ready_texture(std::shared_ptr<rocket::texture_t> texture) override;
+        void draw_text(const rocket::text_t &text, vec2f_t position) override;
+        void draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) override;
+    public:
+        void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        void begin_gpu_region(const char *name) override;
+        void end_gpu_region() override;
+    public:
+        void set_wireframe(bool) override;
+        void set_vsync(bool) override;
+        void set_fps(int fps = 60) override;
+        void end_scissor_mode() override;
+        void end_render_mode(render_mode_t mode) override;
+        void end_frame() override;
+        bool has_frame_ended() override;
+        void set_graphics_settings(graphics_settings_t graphics) override;
+        void set_viewport_size(vec2f_t size) override;
+        void set_viewport_offset(vec2f_t zero_pos) override;
+        void set_camera(camera_2d *cam) override;
+        /// @brief Close the renderer2d
+        /// @note Closes the inner renderer too
+        void close() override;
+    public:
+        bool get_wireframe() override;
+        bool get_vsync() override;
+        int get_fps() override;
+        double get_delta_time() override;
+        uint64_t get_framecount() override;
+        int get_drawcalls() override;
+        rgl::draw_metrics_t get_draw_metrics() override;
+        const graphics_settings_t &get_graphics_settings() override;
+        api_object_t get_framebuffer_texture() override;
+        camera_2d *get_camera() override;
+        glm::mat4 get_camera_matrix() override;
+    public:
+        float get_current_fps() override;
+    public:
+        /// @brief Create a render cache to draw into
+        /// @note draw_cb gets this renderer, so the cache contents are recorded too
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        void invalidate_render_cache(render_cache_t *c) override;
+        void update_render_cache(render_cache_t *c) override;
+        void begin_render_cache(render_cache_t *c) override;
+        void end_render_cache(render_cache_t *c) override;
+        void draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+        void draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) override;
+        void destroy_render_cache(render_cache_t *&c) override;
+    public:
+        /// @brief Wrap a renderer
+        /// @param inner Renderer every call goes to, must outlive this one
+        recording_renderer_2d(renderer_2d_i *inner, recording_options_t options = {});
+    public:
+        ~recording_renderer_2d() override;
+    };
+
+    struct replay_options_t {
+        /// @brief Texture for an asset ID that was not embedded
+        std::function<std::shared_ptr<texture_t>(assetid_t id)> texture_resolver = nullptr;
+        /// @brief Font for an asset ID that was not embedded
+        /// @note Missing fonts fall back to the default font
+        std::function<std::shared_ptr<font_t>(assetid_t id, float size)> font_resolver = nullptr;
+    };
+
+    struct replay_stats_t {
+        uint64_t frames = 0;
+        /// @brief Calls pushed into the renderer
+        uint64_t commands = 0;
+        /// @brief Calls dropped, unsupported or missing their texture or cache
+        uint64_t skipped = 0;
+    };
+
+    struct command_replayer_impl_t;
+
+    /// @brief Pushes a command stream into any renderer
+    /// @note Assets are decoded up front, playback only issues the calls.
+    ///       Set the target to rocket::cst::fps_uncapped to replay as fast as possible
+    class command_replayer_t {
+    private:
+        command_replayer_impl_t *impl = nullptr;
+    public:
+        /// @brief Check if the stream could be read
+        bool is_valid() const;
+        /// @brief Complete frames in the stream
+        size_t get_frame_count() const;
+        /// @brief Replay a single frame, begin_frame to end_frame
+        /// @note Frames that set up render caches have to be replayed first
+        bool replay_frame(renderer_2d_i *ren, size_t frame);
+        /// @brief Replay every frame in order
+        replay_stats_t replay(renderer_2d_i *ren, int loops = 1);
+        /// @brief Totals over everything replayed so far
+        const replay_stats_t &get_stats() const;
+        /// @brief Destroy the render caches made on the target
+        /// @note Call before the target renderer goes away
+        void release();
+    public:
+        command_replayer_t(const command_stream_t &stream, replay_options_t options = {});
+        command_replayer_t(const command_replayer_t &) = delete;
+        command_replayer_t &operator=(const command_replayer_t &) = delete;
+    public:
+        ~command_replayer_t();
+    };
+}
+
+#endif
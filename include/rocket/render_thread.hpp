@@ -0,0 +1,154 @@
+#ifndef ROCKETGE__RENDER_THREAD_HPP
+#define ROCKETGE__RENDER_THREAD_HPP
+
+#include "asset.hpp"
+#include "renderer.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rocket {
+    struct threaded_renderer_options_t {
+        /// @brief Frames the game may run ahead of the render thread [1-2]
+        /// @note 1 renders frame N while frame N+1 is built, 2 buffers one more
+        int latency = 1;
+    };
+
+    struct threaded_renderer_2d_impl_t;
+
+    /// @brief Runs another renderer on a dedicated render thread
+    /// @note Draw calls are recorded into a command list per frame, the render
+    ///       thread owns the graphics context and replays frame N while the
+    ///       game builds frame N+1. end_frame is the fence, it waits once more
+    ///       than latency frames are in flight
+    /// @note Render cache callbacks, scheduled GL work and plugin frame
+    ///       events run on the render thread
+    class threaded_renderer_2d : public renderer_2d_i {
+    protected:
+        renderer_2d_i *inner = nullptr;
+        threaded_renderer_2d_impl_t *thr_impl = nullptr;
+    protected:
+        gfx_chk_result check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+    private:
+        api_object_t upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) override;
+        void clean_gpu_resource(api_object_t object) override;
+
+        static void render_thread_main(threaded_renderer_2d *self);
+        /// @brief Run fn on the render thread and wait for it
+        void run_sync(std::function<void()> fn);
+        /// @brief Send the calls recorded so far to the render thread
+        void submit(bool ends_frame);
+        void stop();
+    public:
+        /// @brief The renderer running on the render thread
+        /// @note Only touch it from the render thread or after close
+        renderer_2d_i *get_inner() const { return this->inner; }
+        /// @brief Frames submitted but not rendered yet
+        int get_frames_in_flight() const;
+        /// @brief Block until the render thread has caught up
+        void wait_idle();
+    public:
+        bool has_frame_began() override;
+        void begin_frame() override;
+        /// @brief Show the splash ignoring flags
+        /// @note Runs on the calling thread, it polls the window
+        void show_splash() override;
+        void begin_render_mode(render_mode_t) override;
+        /// @brief Get a contiguous block of pixels
+        /// @note Waits for the render thread to draw everything up to here
+        std::vector<rgba_color> get_framebuffer() override;
+        void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Push the dirty parts of this renderer's canvas
+        /// @note The dirty pixels are copied into the command list
+        void push_canvas() override;
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
+        /// @brief Get the size of the viewport
+        /// @note As of the last rendered frame unless overridden
+        vec2f_t get_viewport_size() override;
+        void begin_scissor_mode(rocket::fbounding_box rect) override;
+        void begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) override;
+        void begin_scissor_mode(float x, float y, float sx, float sy) override;
+        void clear(rocket::rgba_color color = { 255, 255, 255, 255 }) override;
+
+        /// @brief Draw a shader
+        /// @note The shader must stay alive until the frame is rendered
+        void draw_shader(const shader_i &shader) override;
+
+        void draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+        void draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+        void draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int thickness = 0) override;
+        void draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int sides = 3, float rotation = 0.f) override;
+        void draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation = 0.f, float roundedness = 0.f) override;
+        void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f) override;
+        void make_ready_texture(std::shared_ptr<rocket::texture_t> texture) override;
+        void draw_text(const rocket::text_t &text, vec2f_t position) override;
+        void draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) override;
+    public:
+        void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        void begin_gpu_region(const char *name) override;
+        void end_gpu_region() override;
+    public:
+        void set_wireframe(bool) override;
+        void set_vsync(bool) override;
+        void set_fps(int fps = 60) override;
+        void end_scissor_mode() override;
+        void end_render_mode(render_mode_t mode) override;
+        /// @brief End frame and hand it to the render thread
+        /// @note Waits while more than latency frames are in flight
+        void end_frame() override;
+        bool has_frame_ended() override;
+        void set_graphics_settings(graphics_settings_t graphics) override;
+        void set_viewport_size(vec2f_t size) override;
+        void set_viewport_offset(vec2f_t zero_pos) override;
+        /// @brief Sets the camera
+        /// @note The camera is read on the render thread, don't change it mid-frame
+        void set_camera(camera_2d *cam) override;
+        /// @brief Close the renderer2d
+        /// @note Closes the inner renderer and stops the render thread,
+        ///       the graphics context goes back to the calling thread
+        void close() override;
+    public:
+        bool get_wireframe() override;
+        bool get_vsync() override;
+        int get_fps() override;
+        /// @brief Get Delta Time
+        /// @note Of the last rendered frame
+        double get_delta_time() override;
+        /// @brief Get number of frames rendered since first frame
+        uint64_t get_framecount() override;
+        int get_drawcalls() override;
+        rgl::draw_metrics_t get_draw_metrics() override;
+        const graphics_settings_t &get_graphics_settings() override;
+        api_object_t get_framebuffer_texture() override;
+        camera_2d *get_camera() override;
+        glm::mat4 get_camera_matrix() override;
+    public:
+        float get_current_fps() override;
+    public:
+        /// @brief Create a render cache to draw into
+        /// @note Waits for the render thread, draw_cb runs there with the inner renderer
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        void invalidate_render_cache(render_cache_t *c) override;
+        void update_render_cache(render_cache_t *c) override;
+        void begin_render_cache(render_cache_t *c) override;
+        void end_render_cache(render_cache_t *c) override;
+        void draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+        void draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) override;
+        void destroy_render_cache(render_cache_t *&c) override;
+    public:
+        /// @brief Move a renderer onto its own thread
+        /// @param inner Renderer made on this thread, must outlive this one
+        /// @note Takes the graphics context from the calling thread
+        threaded_renderer_2d(renderer_2d_i *inner, threaded_renderer_options_t options = {});
+        threaded_renderer_2d(const threaded_renderer_2d &) = delete;
+        threaded_renderer_2d &operator=(const threaded_renderer_2d &) = delete;
+    public:
+        ~threaded_renderer_2d() override;
+    };
+}
+
+#endif
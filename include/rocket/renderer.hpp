@@ -42,6 +42,16 @@ namespace rocket {
     private:
         api_object_t upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) override;
         void clean_gpu_resource(api_object_t object) override;
+        void redraw_render_cache(render_cache_t *c);
+        void bind_render_cache_target(render_cache_t *c);
+        /// @brief Sets the GL scissor from scissor_rect and the target
+        /// @note Inside a render cache it never leaves the cache's region
+        void apply_scissor();
+        void begin_scene_target();
+        void resolve_scene_target();
+        /// @brief Shader is linked, false while the driver still builds it
+        /// @note Waits inside a render cache, its contents would be missing until the next redraw
+        bool shader_ready(shader_id_t id);
     public:
         /// @brief Check if frame has begun
         bool has_frame_began() override;
@@ -52,13 +62,21 @@ namespace rocket {
         /// @brief Begin render mode
         void begin_render_mode(render_mode_t) override;
         /// @brief Get a contiguous block of pixels
-        /// @brief adjusted to viewport size
-        /// @brief VERY SLOW use only for SOFTWARE rendering
+        /// @brief adjusted to viewport size, rows top to bottom
+        /// @note Synchronous, waits for the GPU to finish drawing
         std::vector<rgba_color> get_framebuffer() override;
         /// @brief Push a contiguous block of pixels
         /// @brief adjusted to viewport size
         /// @brief ONLY for SOFTWARE rendering
         void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Upload the dirty parts of the canvas and draw it over the frame
+        void push_canvas() override;
+        /// @brief Read back this frame's pixels when it ends, without waiting on the GPU
+        /// @param region Viewport pixels, size { -1, -1 } for the whole viewport
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        /// @brief Take the oldest finished readback
+        /// @return false if none is ready yet, never blocks
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
         /// @brief Get the size of the viewport
         vec2f_t get_viewport_size() override;
         /// @brief Begin scissor mode
@@ -121,6 +139,13 @@ namespace rocket {
         /// @param roundedness Roundedness [0-1]
         void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f) override;
 
+        /// @brief Draw one chunk of a tilemap
+        /// @note The chunk is uploaded to a vertex buffer once per rebuild and drawn in one call
+        void draw_tilemap_chunk(tilemap_chunk_t &chunk, const std::shared_ptr<rocket::texture_t> &atlas, rocket::vec2f_t position) override;
+        /// @brief Draw the particles of an emitter
+        /// @note The instances are uploaded once per update and drawn with one instanced call
+        void draw_particles(particle_batch_t &batch) override;
+
         /// @brief Make a texture ready for drawing
         /// @note Not needed to be called before drawing
         /// @note Pass render_mode_t::texture_filter_none for GL_NEAREST texture filtering
@@ -139,6 +164,12 @@ namespace rocket {
     public:
         /// @brief Draw FPS at the top left
         void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        /// @brief Begin a named GPU timing region, nests
+        /// @note name must outlive the renderer (string literals)
+        void begin_gpu_region(const char *name) override;
+        /// @brief End the innermost GPU timing region
+        void end_gpu_region() override;
     public:
         /// @brief Set Wireframe State
         void set_wireframe(bool) override;
@@ -188,10 +219,11 @@ namespace rocket {
         rgl::draw_metrics_t get_draw_metrics() override;
         /// @brief Get graphics settings
         const graphics_settings_t &get_graphics_settings() override;
-        /// @brief Get the current framebuffer texture
-        /// @note Allocates a new texture and destroys every frame
-        /// @note Use render_cache_t::get_texture() to avoid performance
-        ///       degradation
+        /// @brief Scale the scene renders at under dynamic resolution, 1 at native resolution
+        float get_render_scale();
+        /// @brief Copy the current framebuffer into a texture
+        /// @note The texture is reused, the next call overwrites it
+        /// @note Use render_cache_t::get_texture() to skip the copy
         /// @brief Is stored on GPU only 
         /// @brief Lifetime managed automatically
         api_object_t get_framebuffer_texture() override;
@@ -205,9 +237,11 @@ namespace rocket {
         float get_current_fps() override;
     public:
         /// @brief Create a render cache to draw into
-        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb) override;
-        /// @brief Invalidate the render cache and force a redraw
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        /// @brief Invalidate the render cache, it is redrawn before it is drawn or begun next
         void invalidate_render_cache(render_cache_t *c) override;
+        /// @brief Redraw the render cache now if it was invalidated
+        void update_render_cache(render_cache_t *c) override;
         /// @brief Begins rendering to render_cache
         void begin_render_cache(render_cache_t *c) override;
         /// @brief Ends rendering to render_cache
@@ -256,6 +290,14 @@ namespace rocket {
         /// @brief adjusted to viewport size
         /// @brief ONLY for SOFTWARE rendering
         void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Upload the dirty parts of the canvas and draw it over the frame
+        void push_canvas() override;
+        /// @brief Read back this frame's pixels when it ends, without waiting on the GPU
+        /// @param region Viewport pixels, size { -1, -1 } for the whole viewport
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        /// @brief Take the oldest finished readback
+        /// @return false if none is ready yet, never blocks
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
         /// @brief Get the size of the viewport
         vec2f_t get_viewport_size() override;
         /// @brief Begin scissor mode
@@ -336,6 +378,12 @@ namespace rocket {
     public:
         /// @brief Draw FPS at the top left
         void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        /// @brief Begin a named GPU timing region, nests
+        /// @note name must outlive the renderer (string literals)
+        void begin_gpu_region(const char *name) override;
+        /// @brief End the innermost GPU timing region
+        void end_gpu_region() override;
     public:
         /// @brief Set Wireframe State
         void set_wireframe(bool) override;
@@ -402,9 +450,11 @@ namespace rocket {
         float get_current_fps() override;
     public:
         /// @brief Create a render cache to draw into
-        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb) override;
-        /// @brief Invalidate the render cache and force a redraw
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        /// @brief Invalidate the render cache, it is redrawn before it is drawn or begun next
         void invalidate_render_cache(render_cache_t *c) override;
+        /// @brief Redraw the render cache now if it was invalidated
+        void update_render_cache(render_cache_t *c) override;
         /// @brief Begins rendering to render_cache
         void begin_render_cache(render_cache_t *c) override;
         /// @brief Ends rendering to render_cache
@@ -465,6 +515,14 @@ namespace rocket {
         /// @brief adjusted to viewport size
         /// @brief ONLY for SOFTWARE rendering
         void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Upload the dirty parts of the canvas and draw it over the frame
+        void push_canvas() override;
+        /// @brief Read back this frame's pixels when it ends, without waiting on the GPU
+        /// @param region Viewport pixels, size { -1, -1 } for the whole viewport
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        /// @brief Take the oldest finished readback
+        /// @return false if none is ready yet, never blocks
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
         /// @brief Get the size of the viewport
         vec2f_t get_viewport_size() override;
         /// @brief Begin scissor mode
@@ -545,6 +603,12 @@ namespace rocket {
     public:
         /// @brief Draw FPS at the top left
         void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        /// @brief Begin a named GPU timing region, nests
+        /// @note name must outlive the renderer (string literals)
+        void begin_gpu_region(const char *name) override;
+        /// @brief End the innermost GPU timing region
+        void end_gpu_region() override;
     public:
         /// @brief Set Wireframe State
         void set_wireframe(bool) override;
@@ -611,9 +675,11 @@ namespace rocket {
         float get_current_fps() override;
     public:
         /// @brief Create a render cache to draw into
-        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb) override;
-        /// @brief Invalidate the render cache and force a redraw
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        /// @brief Invalidate the render cache, it is redrawn before it is drawn or begun next
         void invalidate_render_cache(render_cache_t *c) override;
+        /// @brief Redraw the render cache now if it was invalidated
+        void update_render_cache(render_cache_t *c) override;
         /// @brief Begins rendering to render_cache
         void begin_render_cache(render_cache_t *c) override;
         /// @brief Ends rendering to render_cache
@@ -636,10 +702,235 @@ namespace rocket {
         ~vulkan_renderer_2d() override;
     };
 
+    struct software_renderer_2d_impl_t;
+
+    /// @brief CPU rasterizer, draws are binned into tiles and rasterized on worker threads
+    /// @note Pixel-exact across machines, usable without a GPU
+    class software_renderer_2d : public renderer_2d_i {
+    protected:
+        software_renderer_2d_impl_t *bk_impl;
+
+        friend class renderer_3d;
+        friend class font_t;
+    protected:
+        gfx_chk_result check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+    private:
+        api_object_t upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) override;
+        void clean_gpu_resource(api_object_t object) override;
+        void redraw_render_cache(render_cache_t *c);
+    public:
+        software_renderer_2d_impl_t *get_backend_impl() const { return this->bk_impl; }
+    public:
+        /// @brief Check if frame has begun
+        bool has_frame_began() override;
+        /// @brief Begin frame
+        void begin_frame() override;
+        /// @brief Show the splash ignoring flags
+        void show_splash() override;
+        /// @brief Begin render mode
+        void begin_render_mode(render_mode_t) override;
+        /// @brief Get a contiguous block of pixels
+        /// @brief adjusted to viewport size, rows top to bottom
+        /// @note Finishes the draws recorded so far
+        std::vector<rgba_color> get_framebuffer() override;
+        /// @brief Push a contiguous block of pixels
+        /// @brief adjusted to viewport size
+        /// @brief ONLY for SOFTWARE rendering
+        void push_framebuffer(const std::vector<rgba_color> &framebuffer) override;
+        /// @brief Upload the dirty parts of the canvas and draw it over the frame
+        void push_canvas() override;
+        /// @brief Read back this frame's pixels when it ends, without waiting on the GPU
+        /// @param region Viewport pixels, size { -1, -1 } for the whole viewport
+        void request_framebuffer_readback(rocket::fbounding_box region = { { 0, 0 }, { -1, -1 } }) override;
+        /// @brief Take the oldest finished readback
+        /// @return false if none is ready yet, never blocks
+        bool poll_framebuffer_readback(framebuffer_readback_t &out) override;
+        /// @brief Get the size of the viewport
+        vec2f_t get_viewport_size() override;
+        /// @brief Begin scissor mode
+        void begin_scissor_mode(rocket::fbounding_box rect) override;
+        /// @brief Begin scissor mode
+        void begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) override;
+        /// @brief Begin scissor mode
+        void begin_scissor_mode(float x, float y, float sx, float sy) override;
+        /// @brief Clear the screen
+        void clear(rocket::rgba_color color = { 255, 255, 255, 255 }) override;
+
+        /// @brief Draw a shader
+        /// @note Not supported, shaders are skipped
+        void draw_shader(const shader_i &shader) override;
+
+        /// @brief Draw a rectangle
+        /// @param rect Rectangle
+        /// @param color Color
+        /// @param rotation Rotation in degrees
+        /// @param roundedness Roundedness [0-1]
+        /// @param lines Draw lines
+        void draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+
+        /// @brief Draw a rectangle
+        /// @param pos Position
+        /// @param size Size
+        /// @param color Color
+        /// @param rotation Rotation in degrees
+        /// @param roundedness Roundedness [0-1]
+        /// @param lines Draw lines
+        void draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color = { 0, 0, 0, 255 }, float rotation = 0.f, float roundedness = 0.f, bool lines = false) override;
+
+        /// @brief Draw a circle
+        /// @param pos Position
+        /// @param radius Radius
+        /// @param color Color
+        /// @param thickness <=0 if solid, >0 if ring
+        void draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int thickness = 0) override;
+
+        /// @brief Draw a polygon
+        /// @param pos Position
+        /// @param radius Radius
+        /// @param color Color
+        /// @note Uses [sides] many triangles
+        void draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color = { 0, 0, 0, 255 }, int sides = 3, float rotation = 0.f) override;
+
+        /// @brief Draw a texture
+        /// @param texture Texture
+        /// @param rect Rectangle
+        /// @param rotation Rotation in degrees
+        /// @param roundedness Roundedness [0-1]
+        void draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation = 0.f, float roundedness = 0.f) override;
+
+        /// @brief Draw a texture using atlas
+        /// @param texture Texture Atlas
+        /// @param rect Rectangle
+        /// @param texture_position_in_atlas Texture Position
+        /// @param texture_size_in_atlas Texture Size
+        /// @param rotation Rotation in degrees
+        /// @param roundedness Roundedness [0-1]
+        void draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation = 0.f, float roundedness = 0.f) override;
+
+        /// @brief Make a texture ready for drawing
+        /// @note Not needed to be called before drawing
+        /// @note Pass render_mode_t::texture_filter_none for GL_NEAREST texture filtering
+        void make_ready_texture(std::shared_ptr<rocket::texture_t> texture) override;
+
+        /// @brief Draw text
+        /// @note Does text.length drawcalls, use render cache to reduce to 1 drawcall
+        /// @param text Text
+        /// @param position Position
+        void draw_text(const rocket::text_t &text, vec2f_t position) override;
+
+        /// @brief Draw a singular pixel
+        /// @param pos Position
+        /// @param color Color
+        void draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) override;
+    public:
+        /// @brief Draw FPS at the top left
+        void draw_fps(vec2f_t pos = { 10, 10 }) override;
+    public:
+        /// @brief Begin a named GPU timing region, nests
+        /// @note name must outlive the renderer (string literals)
+        void begin_gpu_region(const char *name) override;
+        /// @brief End the innermost GPU timing region
+        void end_gpu_region() override;
+    public:
+        /// @brief Set Wireframe State
+        void set_wireframe(bool) override;
+        /// @brief Set Vsync
+        void set_vsync(bool) override;
+        /// @brief Set FPS
+        void set_fps(int fps = 60) override;
+        /// @brief End scissor mode
+        void end_scissor_mode() override;
+        /// @brief End render mode
+        void end_render_mode(render_mode_t mode) override;
+        /// @brief End frame
+        void end_frame() override;
+        /// @brief Check if frame has ended
+        bool has_frame_ended() override;
+        /// @brief Set graphics settings
+        void set_graphics_settings(graphics_settings_t graphics) override;
+        /// @brief Set viewport size
+        void set_viewport_size(vec2f_t size) override;
+        /// @brief Set viewport offset
+        /// @param zero_pos The offset (zero position)
+        void set_viewport_offset(vec2f_t zero_pos) override;
+        /// @brief Sets the camera
+        void set_camera(camera_2d *cam) override;
+        /// @brief Close the renderer2d
+        /// @note Does not close the OpenGL Context fully
+        void close() override;
+    public:
+        /// @brief Get Wireframe State
+        bool get_wireframe() override;
+        /// @brief Get Vsync
+        bool get_vsync() override;
+        /// @brief Get FPS
+        /// @note Gives the TARGET FPS,
+        /// @note NOT the current fps
+        int get_fps() override;
+        /// @brief Get Delta Time
+        double get_delta_time() override;
+        /// @brief Get number of frames elapsed since first frame
+        uint64_t get_framecount() override;
+        /// @brief For proper drawcall tracking,
+        /// @brief you should probably call this
+        /// @brief after end_frame() or just before
+        int get_drawcalls() override;
+        /// @brief Gets the draw metrics
+        ///         contains Avg, Max, Min: FPS, Frametime
+        rgl::draw_metrics_t get_draw_metrics() override;
+        /// @brief Get graphics settings
+        const graphics_settings_t &get_graphics_settings() override;
+        /// @brief Get the current framebuffer texture
+        /// @note Allocates a new texture and destroys every frame
+        /// @note Use render_cache_t::get_texture() to avoid performance
+        ///       degradation
+        /// @brief Is stored on GPU only 
+        /// @brief Lifetime managed automatically
+        api_object_t get_framebuffer_texture() override;
+        /// @brief Get the active camera
+        /// @note may return nullptr
+        camera_2d *get_camera() override;
+        /// @brief Get the active camera (if any) matrix
+        glm::mat4 get_camera_matrix() override;
+    public:
+        /// @brief Get Current FPS
+        float get_current_fps() override;
+    public:
+        /// @brief Create a render cache to draw into
+        render_cache_t* create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size = { -1, -1 }) override;
+        /// @brief Invalidate the render cache, it is redrawn before it is drawn or begun next
+        void invalidate_render_cache(render_cache_t *c) override;
+        /// @brief Redraw the render cache now if it was invalidated
+        void update_render_cache(render_cache_t *c) override;
+        /// @brief Begins rendering to render_cache
+        void begin_render_cache(render_cache_t *c) override;
+        /// @brief Ends rendering to render_cache
+        void end_render_cache(render_cache_t *c) override;
+        /// @brief Draw contents of render_cache to screen
+        void draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) override;
+        /// @brief Draw contents of render_cache to screen
+        void draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) override;
+        /// @brief Destroy the render cache and free it's resources
+        /// @note Any operations on that cache after destruction
+        ///       is Undefined Behaviour
+        /// @note Is a reference, so modifies your ptr to nullptr
+        void destroy_render_cache(render_cache_t *&c) override;
+    public:
+        /// @brief Initialize the renderer
+        /// @param window Window, presented through its OpenGL context if it has one
+        /// @param fps FPS = 60
+        /// @note Without an OpenGL context frames are only kept in memory,
+        ///       read them with get_framebuffer or request_framebuffer_readback
+        software_renderer_2d(window_backend_i *window, int fps = 60, renderer_flags_t flags = {});
+    public:
+        ~software_renderer_2d() override;
+    };
+
     namespace renderer_choice {
-        constexpr uint8_t vulkan  = 0b100000;
-        constexpr uint8_t opengl  = 0b010000;
-        constexpr uint8_t try_all = 0b111111;
+        constexpr uint8_t vulkan   = 0b100000;
+        constexpr uint8_t opengl   = 0b010000;
+        constexpr uint8_t software = 0b001000;
+        constexpr uint8_t try_all  = 0b111111;
     }
 
     /// @brief Creates a Renderer2D Interface with selected backend
@@ -3,7 +3,10 @@
 #include <rocket/glfnldr.hpp>
 #include <rocket/types.hpp>
 #include <rocket/constants.hpp>
+#include <rocket/dynamic_resolution.hpp>
+#include <cstdint>
 #include <functional>
+#include <vector>
 
 namespace rocket {
     struct renderer_flags_t {
@@ -13,20 +16,30 @@ namespace rocket {
         /// @brief (Advanced) Change Glfnldr backend if available
         /// @note List available backends with glfnldr::get_backends()
         glfnldr::backend_t glfnldr_backend = ROCKETGE__GLFNLDR_BACKEND_ENUM;
+        /// @brief (OpenGL) Submit all default shaders at startup instead of on first use
+        /// @note Work done after the renderer is created overlaps the compile, draws are skipped until their shader is ready
+        bool async_shader_compile = true;
+        /// @brief (Software) Raster worker threads, 0 for one per core
+        int software_threads = 0;
     };
     enum class render_mode_t {
         texture_filter_none,
         camera,
+        /// @brief UI and text, drawn at native resolution under dynamic resolution
+        /// @note Upscales the scene when it begins, the rest of the frame stays native
+        ui,
     };
 
     struct graphics_settings_t {
         bool viewport_culling = true;
+        dynamic_resolution_t dynamic_resolution;
     };
 
     enum class renderer_backend_t {
         null,
         opengl,
         vulkan,
+        software,
     };
 
     /// @brief API-agnostic Framebuffer Object
@@ -48,16 +61,87 @@ namespace rocket {
         ~framebuffer_t();
     };
 
+    /// @brief Pixels read back from the framebuffer
+    struct framebuffer_readback_t {
+        /// @brief Frame the pixels were captured in
+        uint64_t frame = 0;
+        /// @brief Region in viewport pixels, top-left origin
+        rocket::vec2i_t offset = { 0, 0 };
+        rocket::vec2i_t size = { 0, 0 };
+        /// @brief Rows top to bottom
+        std::vector<rgba_color> pixels;
+    };
+
+    /// @brief Pixel rectangle, top-left origin
+    struct canvas_rect_t {
+        int x = 0, y = 0, w = 0, h = 0;
+    };
+
+    /// @brief CPU pixels kept by the renderer for software rendering
+    /// @note Write into data() directly and mark what changed,
+    ///       renderer_2d_i::push_canvas only uploads the dirty rectangles
+    class framebuffer_canvas_t {
+    private:
+        rocket::vec2i_t size = { 0, 0 };
+        std::vector<rgba_color> pixels;
+        std::vector<canvas_rect_t> dirty;
+    public:
+        /// @brief Dirty rectangles kept apart before they collapse into their bounds
+        static constexpr size_t max_dirty_rects = 16;
+
+        /// @brief Rows top to bottom, get_size().x pixels each
+        rgba_color *data() { return pixels.data(); }
+        const rgba_color *data() const { return pixels.data(); }
+        rocket::vec2i_t get_size() const { return size; }
+
+        /// @brief Pixel at x, y
+        /// @note Does not mark it dirty
+        rgba_color &at(int x, int y) { return pixels[static_cast<size_t>(y) * size.x + x]; }
+
+        /// @brief Mark a region changed, clamped to the canvas
+        void mark_dirty(canvas_rect_t rect);
+        /// @brief Mark a region changed, clamped to the canvas
+        void mark_dirty(rocket::fbounding_box rect);
+        /// @brief Mark the whole canvas changed
+        void mark_all_dirty();
+        /// @brief Fill the canvas and mark it changed
+        void fill(rgba_color color);
+
+        bool is_dirty() const { return !dirty.empty(); }
+        /// @brief Non-overlapping regions changed since the last clear_dirty
+        const std::vector<canvas_rect_t> &get_dirty_rects() const { return dirty; }
+        void clear_dirty() { dirty.clear(); }
+
+        /// @brief Resize, keeps the overlapping pixels and marks everything changed
+        void resize(rocket::vec2i_t new_size);
+    };
+
     class renderer_2d_i;
 
     struct render_cache_t {
     private:
         api_object_t fbo = ROCKETGE__InvalidNumber;
         std::function<void(rocket::renderer_2d_i *ren)> draw = nullptr;
+        /// @brief Requested size, -1, -1 follows the viewport
+        rocket::vec2i_t size = { -1, -1 };
+        /// @brief Where the contents are in the texture, origin bottom-left
+        rocket::fbounding_box region = { { 0, 0 }, { 0, 0 } };
+        /// @brief Shared atlas page the region is in, -1 for an own texture
+        int atlas_page = -1;
+        bool dirty = false;
         friend class renderer_2d_i;
         friend class opengl_renderer_2d;
         friend class vulkan_renderer_2d;
+        friend class software_renderer_2d;
     public:
+        /// @note Small sized caches share the texture, see get_texture_region
         api_object_t get_texture() const;
+        /// @brief Area of get_texture() holding this cache in pixels, origin bottom-left
+        rocket::fbounding_box get_texture_region() const { return this->region; }
+        /// @brief Size in pixels, -1, -1 if it follows the viewport
+        rocket::vec2i_t get_size() const { return this->size; }
+        bool follows_viewport() const { return this->size.x < 0 || this->size.y < 0; }
+        /// @brief Invalidated, the draw callback reruns before the cache is drawn or begun next
+        bool is_dirty() const { return this->dirty; }
     };
 }
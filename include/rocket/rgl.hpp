@@ -7,8 +7,14 @@
 #endif
 #include "rocket/types.hpp"
 #include "glfnldr.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <glm/fwd.hpp>
+#include <span>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <rocket/macros.hpp>
 #define rGL_TXID_INVALID ROCKETGE__InvalidNumber
@@ -198,7 +204,10 @@ namespace rgl {
     shader_location_t get_shader_location(shader_program_t sp, const char *name);
     shader_location_t get_shader_location(shader_program_t sp, std::string name);
 
+    /// @brief FBO with a viewport-sized color texture
     fbo_t create_fbo();
+    /// @brief FBO with a color texture of size pixels
+    fbo_t create_fbo(rocket::vec2i_t size);
     void use_fbo(fbo_t fbo);
     void reset_to_default_fbo();
     void delete_fbo(fbo_t fbo);
@@ -207,9 +216,31 @@ namespace rgl {
 
     rocket::vec2f_t get_viewport_size();
 
+    /// @brief Binding point of the rocket_camera uniform block
+    constexpr unsigned int camera_block_binding = 0;
+    /// @brief Set the view matrix used by the built-in shaders
+    /// @note One uniform block update, no geometry is rebuilt
+    void set_view_matrix(const glm::mat4 &view);
+    const glm::mat4 &get_view_matrix();
+    /// @brief Hook a program's rocket_camera block up to the shared view-projection
+    /// @note No-op for programs without one
+    void bind_camera_block(shader_program_t pg);
+
     /// @brief Use this as an alternative to glDrawArrays(...)
     /// @note Tracks Triangle Count and Drawcalls
     void gl_draw_arrays(unsigned int mode, int first, int count);
+    /// @brief Use this as an alternative to glDrawArraysInstanced(...)
+    /// @note Tracks Triangle Count and Drawcalls
+    void gl_draw_arrays_instanced(unsigned int mode, int first, int count, int instances);
+
+    struct gpu_region_time_t {
+        const char *name = nullptr;
+        /// @brief Seconds
+        float time = 0;
+    };
+
+    /// @brief Regions kept per frame in draw_metrics_t, later ones are dropped
+    constexpr size_t max_gpu_regions = 32;
 
     struct draw_metrics_t {
         float avg_frametime = 0;
@@ -220,24 +251,110 @@ namespace rgl {
 
         float min_frametime = 0;
         float max_fps = 0;
+
+        /// @brief Wake-up minus frame deadline in seconds, positive when late
+        float pacing_error = 0;
+        /// @brief Smoothed absolute pacing error (jitter)
+        float avg_pacing_error = 0;
+        float max_pacing_error = 0;
+
+        /// @brief GPU time of a frame in seconds, 0 without GPU timing
+        /// @note Read back a few frames late, see gpu_frame
+        float gpu_frametime = 0;
+        float avg_gpu_frametime = 0;
+        float max_gpu_frametime = 0;
+        /// @brief GPU time of render cache redraws in that frame
+        float gpu_render_cache_time = 0;
+        /// @brief Frame the GPU times belong to
+        uint64_t gpu_frame = 0;
+        /// @brief Named regions of that frame, in begin order
+        /// @note Fixed size, copying the metrics every frame must not allocate
+        std::array<gpu_region_time_t, max_gpu_regions> gpu_regions = {};
+        size_t gpu_region_count = 0;
+
+        std::span<const gpu_region_time_t> get_gpu_regions() const { return { gpu_regions.data(), gpu_region_count }; }
     };
 
     struct frame_metrics_t {
         int drawcalls = 0;
         int tricount = 0;
         int skipped_drawcalls = 0;
+        /// @brief Texture and buffer uploads
+        int uploads = 0;
+    };
+
+    struct frame_record_t {
+        uint64_t frame = 0;
+        /// @brief Seconds from begin_frame to end_frame
+        float cpu_time = 0;
+        /// @brief Seconds after that, swap and frame pacing
+        float wait_time = 0;
+        int drawcalls = 0;
+        int tricount = 0;
+        int skipped_drawcalls = 0;
+        int uploads = 0;
+    };
+
+    struct percentiles_t {
+        float p50 = 0;
+        float p95 = 0;
+        float p99 = 0;
+        float max = 0;
+    };
+
+    struct frame_stats_t {
+        size_t frames = 0;
+        percentiles_t cpu_time;
+        /// @brief cpu_time + wait_time
+        percentiles_t frame_time;
+        /// @brief Average FPS of the slowest 1% of frames
+        float low_1_percent_fps = 0;
+        /// @brief Frames slower than hitch_factor times the median
+        int hitches = 0;
+    };
+
+    enum class frame_export_format_t {
+        csv,
+        json_lines,
     };
 
     void update_draw_metrics_data(float frametime, float fps);
+    void update_pacing_metrics_data(float pacing_error);
     draw_metrics_t get_draw_metrics();
 
     void update_frame_metrics_data(frame_metrics_t metrics);
     void add_frame_metrics_data_drawcalls(int);
     void add_frame_metrics_data_tricount(int);
     void add_frame_metrics_data_skipped_drawcalls(int);
+    void add_frame_metrics_data_uploads(int);
     frame_metrics_t get_frame_metrics();
     void reset_frame_metrics();
 
+    /// @brief Size of the rolling frame history, clears it
+    void set_frame_history_capacity(size_t frames);
+    /// @brief Appends a finished frame to the history (and export, if any)
+    void push_frame_record(const frame_record_t &record);
+    /// @brief Percentiles over the last window frames, 0 for the whole history
+    frame_stats_t get_frame_stats(size_t window = 0, float hitch_factor = 2.f);
+    /// @brief Stream every frame record to a file
+    bool start_frame_export(const std::string &path, frame_export_format_t format);
+    void stop_frame_export();
+
+    /// @brief Region name used for render cache redraws
+    constexpr const char *gpu_region_render_cache = "render_cache";
+
+    /// @brief Enable GPU timer queries (GL_TIMESTAMP)
+    /// @return false if the context has no timer queries
+    bool set_gpu_timing(bool enabled);
+    bool is_gpu_timing_enabled();
+    /// @brief Called by the renderer around a frame
+    /// @note Also reads back finished frames, never waits on the GPU
+    void gpu_timer_begin_frame(uint64_t frame);
+    void gpu_timer_end_frame();
+    /// @brief Nestable named regions inside a frame
+    void gpu_timer_begin_region(const char *name);
+    void gpu_timer_end_region();
+
     rgl::shader_program_t get_fxaa_simplified_shader();
 
     rgl::glstate_t save_state();
@@ -246,6 +363,36 @@ namespace rgl {
     /// @brief Compiles all default shaders
     /// @note Can take a variable amount of time
     void compile_all_default_shaders();
+    /// @brief Submit all default shaders without waiting for the driver
+    /// @note Draws that need one that is not done yet are skipped, see poll_default_shaders
+    void compile_all_default_shaders_async();
+    /// @brief Finish the default shaders the driver is done with, never blocks
+    /// @note Called by the renderer every frame
+    /// @return true once all are ready
+    bool poll_default_shaders();
+    /// @brief GL_KHR_parallel_shader_compile or the ARB variant is present
+    /// @note Without it a program always reads as ready, checking its status waits for it
+    bool is_parallel_shader_compile_supported();
+    /// @brief Compile and link of pg are done, never blocks with parallel compile
+    bool is_program_ready(shader_program_t pg);
+
+    /// @brief Hash of the GL vendor, renderer and version strings
+    /// @note Needs a current context, computed once
+    uint64_t program_cache_driver();
+    /// @brief Key of a program in the program binary cache, also its file name
+    /// @note The driver is part of it, GPUs sharing a cache keep separate entries
+    uint64_t program_cache_key(std::string_view vs, std::string_view fs, std::string_view rlsl_version, uint64_t driver);
+    /// @brief Create a program from a cached binary
+    /// @note Entries from another driver or format are dropped
+    /// @return 0 on a miss, compile from source then
+    shader_program_t program_cache_load(uint64_t key);
+    /// @brief Call between glCreateProgram and glLinkProgram of programs that will be stored
+    void program_cache_prepare(shader_program_t pg);
+    /// @brief Write a linked program to the cache
+    void program_cache_store(uint64_t key, shader_program_t pg);
+    /// @brief Directory of the program binary cache, empty disables it
+    /// @note Defaults to shader_cache in the storage directory
+    void set_program_cache_path(const std::string &path);
 
     void gl_uniform1f(shader_program_t prog, int location, float v0);
     void gl_uniform2f(shader_program_t prog, int location, float v0, float v1);
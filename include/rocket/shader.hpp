@@ -11,7 +11,11 @@ namespace rocket {
     enum class shader_id_t;
     struct vk_shader_t;
     uint32_t gl_get_shader(rocket::shader_id_t shid);
+    uint32_t gl_try_get_shader(rocket::shader_id_t shid);
     vk_shader_t vk_get_shader(rocket::shader_id_t shid);
+    class opengl_shader_t;
+    bool gl_finish_shader(opengl_shader_t &shader, bool wait);
+    void shader_provider_submit_all_gl();
 }
 
 namespace rgl {
@@ -64,11 +68,25 @@ namespace rocket {
         uint32_t vao = ROCKETGE__InvalidNumber;
         uint32_t vbo = ROCKETGE__InvalidNumber;
 
+        uint64_t cache_key = 0;
+        /// @brief Compiled and linked without asking for the result yet
+        bool pending = false;
+        /// @brief shader_init only submits, shader_finish is called by the owner
+        bool deferred = false;
+
         friend rgl::shader_program_t get_shader(shader_id_t shid);
         friend uint32_t rocket::gl_get_shader(shader_id_t shid);
+        friend uint32_t rocket::gl_try_get_shader(shader_id_t shid);
+        friend bool rocket::gl_finish_shader(opengl_shader_t &shader, bool wait);
+        friend void rocket::shader_provider_submit_all_gl();
         friend class opengl_renderer_2d;
     private:
         void shader_init() override;
+        /// @brief Start compile and link, the driver may build on its own threads
+        void shader_submit();
+        /// @brief Check the results of shader_submit
+        /// @param wait Block until the driver is done, otherwise return false while it is busy
+        bool shader_finish(bool wait);
         void parse(const std::vector<std::string> &lines, std::filesystem::path shader_workingdir) override;
     public:
         void set_parameter(std::string name, float value) override;
@@ -86,6 +104,9 @@ namespace rocket {
         opengl_shader_t(shader_type type, std::filesystem::path rlsl_shader_path);
         opengl_shader_t(shader_type type, const std::string &rlsl_source);
         opengl_shader_t();
+    private:
+        /// @brief Submit only, see deferred
+        opengl_shader_t(shader_type type, const std::string &rlsl_source, bool deferred);
     public:
         ~opengl_shader_t() override;
     };
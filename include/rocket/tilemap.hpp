@@ -0,0 +1,99 @@
+#ifndef ROCKETGE__TILEMAP_HPP
+#define ROCKETGE__TILEMAP_HPP
+
+#include "asset.hpp"
+#include "culling.hpp"
+#include "macros.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rocket {
+    class renderer_2d_i;
+
+    /// @brief Index of a tile in the atlas, row by row
+    using tile_id_t = int32_t;
+    /// @brief Empty cell
+    constexpr tile_id_t tile_none = -1;
+
+    /// @brief One tile of a built chunk
+    struct tilemap_quad_t {
+        /// @brief Position and size in map pixels
+        fbounding_box rect;
+        /// @brief Top-left pixel of the tile in the atlas
+        vec2f_t atlas_pos;
+    };
+
+    /// @brief Cached geometry of a square of tiles
+    struct tilemap_chunk_t {
+        /// @brief Area of the chunk in map pixels
+        fbounding_box bounds;
+        /// @brief Non-empty tiles, rebuilt only when a tile of this chunk changes
+        std::vector<tilemap_quad_t> quads;
+        /// @brief Size of every tile in the atlas
+        vec2f_t atlas_tile_size;
+        /// @brief Bumped on every rebuild
+        uint64_t revision = 0;
+
+        /// @brief Backend-side copy of the quads, for backends that keep one
+        api_object_t gpu = ROCKETGE__InvalidNumber;
+        uint64_t gpu_revision = 0;
+        renderer_2d_i *gpu_owner = nullptr;
+    };
+
+    /// @brief Grid of tiles from one atlas, drawn chunk by chunk
+    /// @note Chunks outside the viewport (or camera) are culled as a whole,
+    ///       a visible chunk is one draw call on backends with vertex buffers
+    /// @note Destroy it before the renderer it was drawn with
+    class tilemap_t {
+    private:
+        std::shared_ptr<texture_t> atlas;
+        vec2i_t tile_size;
+        vec2i_t map_size;
+        int chunk_tiles;
+        vec2i_t chunk_grid;
+        int atlas_columns;
+
+        std::vector<tile_id_t> tiles;
+        std::vector<tilemap_chunk_t> chunks;
+        std::vector<bool> dirty;
+
+        cull_soa_t chunk_bounds;
+        vec2f_t chunk_bounds_position = { 0, 0 };
+        std::vector<uint32_t> visible;
+    private:
+        void rebuild_chunk(size_t index);
+        void rebuild_chunk_bounds(vec2f_t position);
+    public:
+        /// @brief Create an empty tilemap
+        /// @param atlas Atlas, tiles are laid out row by row
+        /// @param tile_size Size of one tile in the atlas, tiles are drawn at this size
+        /// @param map_size Map size in tiles
+        /// @param chunk_tiles Width and height of a chunk in tiles
+        tilemap_t(std::shared_ptr<texture_t> atlas, vec2i_t tile_size, vec2i_t map_size, int chunk_tiles = 32);
+        ~tilemap_t();
+
+        tilemap_t(const tilemap_t &) = delete;
+        tilemap_t &operator=(const tilemap_t &) = delete;
+
+        /// @brief Set one tile, marks its chunk for a rebuild
+        void set_tile(vec2i_t cell, tile_id_t tile);
+        /// @return tile_none outside the map
+        tile_id_t get_tile(vec2i_t cell) const;
+        /// @brief Set every tile
+        void fill(tile_id_t tile);
+
+        /// @brief Draw the visible chunks
+        /// @param position Where the top-left of the map goes, in screen or camera space
+        void draw(renderer_2d_i *ren, vec2f_t position = { 0, 0 });
+
+        vec2i_t get_map_size() const { return this->map_size; }
+        vec2i_t get_tile_size() const { return this->tile_size; }
+        size_t get_chunk_count() const { return this->chunks.size(); }
+        /// @brief Chunks drawn by the last draw
+        size_t get_visible_chunk_count() const { return this->visible.size(); }
+    };
+}
+
+#endif
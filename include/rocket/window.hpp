@@ -54,6 +54,7 @@ namespace rocket {
         glfw_window_impl_t *impl = nullptr;
     protected:
         void swap_buffers() const override;
+        void make_context_current(bool current) const override;
     private:
         bool create_vk_surface(void *vk_instance, const void *allocator, void *surface) const override;
     public:
@@ -126,6 +127,7 @@ namespace rocket {
     class null_window_t : public window_backend_i {
     protected:
         void swap_buffers() const override;
+        void make_context_current(bool current) const override;
     public:
         void set_size(const rocket::vec2i_t& size) override;
         void set_title(const std::string& title) override;
@@ -186,6 +188,7 @@ namespace rocket {
         android_app_impl_t *impl = nullptr;
     protected:
         void swap_buffers() const override;
+        void make_context_current(bool current) const override;
     private:
         bool create_vk_surface(void *vk_instance, const void *allocator, void *surface) const override;
     private:
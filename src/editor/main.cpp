@@ -101,6 +101,14 @@ public:
 
 protected:
     void swap_buffers() const override {}
+    void make_context_current(bool current) const override {
+        auto *self = const_cast<qt_widget_t *>(this);
+        if (current) {
+            self->makeCurrent();
+        } else {
+            self->doneCurrent();
+        }
+    }
 
 public:
     void register_on_close(std::function<void()> fn) override {}
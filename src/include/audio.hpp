@@ -1,5 +1,54 @@
 #pragma once
 
+#include <functional>
+#include <rocket/audio.hpp>
+
 namespace rocket::audio {
     void __sound_engine_no_destruction_cleanup_once();
 }
+
+namespace rocket::audio::service {
+    enum class command_type_t {
+        none = 0,
+        /// @brief Bind buffer (if any), start playback and watch the source
+        /// @note A previous watch on the same source is released first
+        play,
+        /// @brief Stop the source, watchers finish on the next poll
+        stop,
+        /// @brief Seek the source to an offset in seconds
+        seek,
+        /// @brief Detach the buffer from watched sources and delete it
+        delete_buffer,
+    };
+
+    struct command_t {
+        command_type_t type = command_type_t::none;
+        unsigned int source = 0;
+        /// @brief Buffer bound to the source before playing, 0 keeps the current one
+        /// @note The buffer to delete for delete_buffer
+        unsigned int buffer = 0;
+        bool loop = false;
+        float gain = 1.f;
+        /// @brief Seek target, or start offset for play
+        float offset_seconds = 0.f;
+        /// @brief Positioned in world space instead of relative to the listener
+        bool spatial = false;
+        vec3f_t position = { 0, 0, 0 };
+        /// @brief Always run on the audio thread once the source stops
+        std::function<void()> on_release;
+        /// @brief Dispatched to the configured callback thread once the source stops
+        sound_finish_callback_t on_finish;
+    };
+
+    /// @brief Queue a command for the audio service thread
+    /// @note Thread-Safe, starts the service thread if needed
+    void submit(command_t cmd);
+
+    /// @brief Run a finish callback on the configured callback thread
+    void dispatch(sound_finish_callback_t cb);
+
+    /// @brief Stops the audio service thread
+    /// @note Pending release hooks are run, finish callbacks are dropped
+    /// @note Must be called before the OpenAL context is destroyed
+    void stop();
+}
@@ -1,9 +1,14 @@
 #ifndef ROCKETGE__DATA_STRUCTURES_HPP
 #define ROCKETGE__DATA_STRUCTURES_HPP
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <utility>
 #include <vector>
+#include <rocket/types.hpp>
 namespace rocket {
     /// @brief A Compressed Array in Memory
     class compressed_data_t {
@@ -29,6 +34,101 @@ namespace rocket {
     public:
         ~compressed_data_t();
     };
+
+    /// @brief A bounded lock-free multi-producer queue
+    /// @note Capacity must be a power of two
+    template<typename T, size_t capacity>
+    class mpsc_ring_t {
+        static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    private:
+        struct cell_t {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        alignas(64) std::array<cell_t, capacity> cells;
+        alignas(64) std::atomic<size_t> head = 0;
+        alignas(64) std::atomic<size_t> tail = 0;
+    public:
+        /// @brief Push a value
+        /// @note Thread-Safe, returns false if the queue is full
+        bool try_push(T value) {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            cell_t *cell = nullptr;
+            while (true) {
+                cell = &cells[pos & (capacity - 1)];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Pop a value
+        /// @note Only ONE thread may consume
+        std::optional<T> try_pop() {
+            size_t pos = head.load(std::memory_order_relaxed);
+            cell_t &cell = cells[pos & (capacity - 1)];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+                return std::nullopt;
+            }
+
+            head.store(pos + 1, std::memory_order_relaxed);
+            std::optional<T> value = std::move(cell.value);
+            cell.value = T();
+            cell.sequence.store(pos + capacity, std::memory_order_release);
+            return value;
+        }
+
+        /// @brief Approximate amount of queued values
+        size_t size_approx() const {
+            return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+        }
+    public:
+        mpsc_ring_t() {
+            for (size_t i = 0; i < capacity; ++i) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /// @brief Packs rectangles into a fixed-size page row by row, freed space is reused
+    /// @note Rows (shelves) are 8px multiples, a rectangle goes into a row at most 1.5x its height
+    class shelf_packer_t {
+    private:
+        struct shelf_t {
+            int y = 0;
+            int height = 0;
+            /// @brief Free spans as x, width, sorted by x
+            std::vector<std::pair<int, int>> free;
+            int used = 0;
+        };
+
+        vec2i_t size;
+        std::vector<shelf_t> shelves;
+        /// @brief First row not taken by a shelf
+        int top = 0;
+    public:
+        /// @return Top-left of the rectangle, nullopt if the page is full
+        std::optional<vec2i_t> allocate(vec2i_t rect);
+        /// @brief Give back a rectangle from allocate
+        void free(vec2i_t pos, vec2i_t rect);
+        bool empty() const { return this->shelves.empty(); }
+    public:
+        explicit shelf_packer_t(vec2i_t size) : size(size) {}
+    };
 }
 
 #endif//ROCKETGE__DATA_STRUCTURES_HPP
@@ -10,6 +10,10 @@
 #include <rocket/rgl.hpp>
 #include <rocket/window.hpp>
 #include <util.hpp>
+#include "data_structures.hpp"
+#include <array>
+#include <memory>
+#include <optional>
 #include <variant>
 #include <string>
 #include <stack>
@@ -62,19 +66,108 @@ namespace rocket {
 
     enum class gl_object_type_t {
         texture,
-        fbo
+        fbo,
+        vertex_buffer
+    };
+
+    /// @brief Vertex array with its buffer, e.g. a tilemap chunk
+    struct gl_vertex_buffer_t {
+        _GLuint vao = 0;
+        _GLuint vbo = 0;
+        int vertex_count = 0;
     };
 
     struct gl_object_t {
         gl_object_type_t type;
         std::variant<
             _GLuint,
-            rgl::fbo_t
+            rgl::fbo_t,
+            gl_vertex_buffer_t
         > value;
     };
 
+    constexpr size_t gl_readback_slots = 3;
+
+    struct gl_readback_slot_t {
+        _GLuint pbo = 0;
+        /// @brief GLsync, set while the copy is in flight
+        void *fence = nullptr;
+        size_t capacity = 0;
+        /// @brief Everything but the pixels
+        framebuffer_readback_t info;
+    };
+
+    constexpr size_t gl_upload_slots = 3;
+
+    struct gl_upload_slot_t {
+        _GLuint pbo = 0;
+        size_t capacity = 0;
+    };
+
+    /// @brief Texture owned by the renderer and rewritten from CPU pixels
+    struct gl_stream_texture_t {
+        _GLuint texture = 0;
+        rocket::vec2i_t size = { 0, 0 };
+    };
+
+    /// @brief Side of a shared render cache atlas page
+    constexpr int gl_cache_atlas_size = 1024;
+    /// @brief Sized caches up to this on both sides go into atlas pages
+    constexpr int gl_cache_atlas_max_cache = 256;
+
+    /// @brief FBO shared by small sized render caches
+    struct gl_cache_atlas_page_t {
+        /// @brief FBO object in opengl_renderer_2d_impl_t::objects
+        api_object_t fbo = ROCKETGE__InvalidNumber;
+        rocket::shelf_packer_t packer = rocket::shelf_packer_t({ gl_cache_atlas_size, gl_cache_atlas_size });
+        int caches = 0;
+    };
+
     struct opengl_renderer_2d_impl_t {
         std::unordered_map<api_object_t, gl_object_t> objects;
+
+        /// @brief Indexed by render_cache_t::atlas_page, empty pages are freed and their slot reused
+        std::vector<std::unique_ptr<gl_cache_atlas_page_t>> cache_atlas_pages;
+        /// @brief Screen target saved when the first render cache is begun
+        rgl::fbo_t screen_fbo = rGL_FBO_INVALID;
+        /// @brief begin_scissor_mode rectangle in the current target's space
+        std::optional<rocket::fbounding_box> scissor_rect;
+        /// @brief Scissor of each target a render cache was begun over
+        std::vector<std::optional<rocket::fbounding_box>> saved_scissor_rects;
+        int screen_gl_viewport[4] = { 0, 0, 0, 0 };
+        rocket::vec2f_t screen_viewport_size = { 0, 0 };
+
+        /// @brief Scene target of dynamic resolution, sized to the scaled viewport
+        rgl::fbo_t scene_fbo = rGL_FBO_INVALID;
+        rocket::vec2i_t scene_fbo_size = { 0, 0 };
+        /// @brief The scene is drawn into scene_fbo and not upscaled yet
+        bool scene_active = false;
+        int scene_gl_viewport[4] = { 0, 0, 0, 0 };
+        rocket::dynamic_resolution_controller_t resolution;
+        /// @brief Fullscreen quad of the upscale pass, clip-space position and uv
+        _GLuint upscale_vao = 0;
+        _GLuint upscale_vbo = 0;
+
+        /// @brief PBO ring, written round-robin and collected oldest first
+        std::array<gl_readback_slot_t, gl_readback_slots> readback_slots;
+        size_t readback_write = 0;
+        size_t readback_read = 0;
+        /// @brief Regions requested this frame, captured in end_frame
+        std::vector<rocket::fbounding_box> readback_requests;
+
+        /// @brief Reused by get_framebuffer_texture
+        _GLuint framebuffer_texture = 0;
+        rocket::vec2i_t framebuffer_texture_size = { 0, 0 };
+        /// @brief Handle of framebuffer_texture in objects
+        api_object_t framebuffer_texture_handle = 0;
+
+        /// @brief Target of push_framebuffer
+        gl_stream_texture_t pushed_framebuffer;
+        /// @brief Target of push_canvas, only dirty rectangles are rewritten
+        gl_stream_texture_t canvas;
+        /// @brief PBO ring for canvas uploads, one slot per push
+        std::array<gl_upload_slot_t, gl_upload_slots> upload_slots;
+        size_t upload_write = 0;
     };
 
     enum class vk_object_type_t {
@@ -119,6 +212,19 @@ namespace rocket {
         void *native_state = nullptr;
     };
 
+    /// @brief Texture, render cache or framebuffer of the software renderer
+    struct sw_texture_t {
+        rocket::vec2i_t size = { 0, 0 };
+        /// @brief Rows top to bottom, fonts are white with the glyph in alpha
+        std::vector<rocket::rgba_color> pixels;
+    };
+
+    struct software_renderer_2d_impl_t {
+        std::unordered_map<api_object_t, sw_texture_t> objects;
+        /// @brief Raster state, owned by software_renderer.cpp
+        void *raster_state = nullptr;
+    };
+
     struct glfw_window_impl_t {
         glfw_window_t *obj;
     };
@@ -2,6 +2,7 @@
 #define ROCKETGE__RNATIVE_HPP
 
 #include <rocket/macros.hpp>
+#include <chrono>
 #include <string>
 #ifdef ROCKETGE__Platform_Linux
 #include <GLFW/glfw3.h>
@@ -32,6 +33,10 @@ namespace rnative {
 
     typedef void (*proc_address_t)(void);
 
+    /// @brief Sleep until an absolute point on the steady clock
+    /// @note clock_nanosleep(TIMER_ABSTIME) on Linux, no drift from relative sleeps
+    void sleep_until(std::chrono::steady_clock::time_point deadline);
+
     inline void intrin_cpu_minfreq() {
 #if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
         _mm_pause();
@@ -22,9 +22,12 @@ namespace rocket_resource {
     layout(location = 0) in vec2 aPos;
     out vec2 v_uv;
     uniform mat4 u_transform;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
     void main() {
         v_uv = aPos; // 0→1 quad coords
-        gl_Position = u_transform * vec4(aPos, 0.0, 1.0);
+        gl_Position = u_view_projection * u_transform * vec4(aPos, 0.0, 1.0);
     }
 =End
 =Begin FragmentShader
@@ -0,0 +1,42 @@
+namespace rocket_resource {
+    const char *shader_particles_rlsl = R"(
+=LangProperty NoPropertyOverride true
+=Set Name "Particles"
+=Set Version 1.4
+=EnterNamespace API
+    =Add SupportedAPIs GL
+    =Add SupportedAPIs GLES
+=ExitNamespace
+=EnterNamespace API
+    =EnterNamespace VK
+        =Set MinimumVersion 1.1
+    =ExitNamespace
+    =EnterNamespace GLES
+        =Set MinimumVersion 3.0
+    =ExitNamespace
+    =EnterNamespace GL
+        =Set MinimumVersion 3.3
+    =ExitNamespace
+=ExitNamespace
+=Begin VertexShader
+    layout(location = 0) in vec3 aPosSize; // per instance: center, size
+    layout(location = 1) in vec4 aColor;   // per instance
+    out vec4 v_color;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
+    void main() {
+        // Triangle strip over the quad corners (0,0) (1,0) (0,1) (1,1)
+        vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) - 0.5;
+        v_color = aColor;
+        gl_Position = u_view_projection * vec4(aPosSize.xy + corner * aPosSize.z, 0.0, 1.0);
+    }
+=End
+=Begin FragmentShader
+    in vec4 v_color;
+    out vec4 FragColor;
+    void main() {
+        FragColor = v_color;
+    }
+=End)";
+}
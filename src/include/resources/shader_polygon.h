@@ -18,9 +18,12 @@ namespace rocket_resource {
 =Begin VertexShader
     layout (location = 0) in vec2 aPos;
     uniform vec4 uColor;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
     out vec4 vColor;
     void main() {
-        gl_Position = vec4(aPos, 0.0, 1.0);
+        gl_Position = u_view_projection * vec4(aPos, 0.0, 1.0); // pixels
         vColor = uColor;
     }
 =End
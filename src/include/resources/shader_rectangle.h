@@ -25,11 +25,14 @@ namespace rocket_resource {
 =Begin VertexShader
     layout(location = 0) in vec2 aPos; // 0→1 quad coords
     uniform mat4 u_transform;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
     out vec2 v_local;
 
     void main() {
         v_local = aPos; // normalized quad coordinates
-        gl_Position = u_transform * vec4(aPos, 0.0, 1.0);
+        gl_Position = u_view_projection * u_transform * vec4(aPos, 0.0, 1.0);
     }
 =End
 
@@ -19,8 +19,11 @@ namespace rocket_resource {
     layout(location = 0) in vec2 aPos;
     layout(location = 1) in vec2 aTex;
     out vec2 TexCoord;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
     void main() {
-        gl_Position = vec4(aPos.xy, 0.0, 1.0);
+        gl_Position = u_view_projection * vec4(aPos.xy, 0.0, 1.0); // pixels
         TexCoord = aTex;
     }
 =End
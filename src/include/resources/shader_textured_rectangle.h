@@ -19,11 +19,14 @@ namespace rocket_resource {
     layout(location = 0) in vec2 aPos;
     out vec2 v_uv;
     uniform mat4 u_transform;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
     uniform float u_flip_y;
     void main() {
         float uv_y = mix(aPos.y, 1.0 - aPos.y, u_flip_y);
         v_uv = vec2(aPos.x, uv_y);
-        gl_Position = u_transform * vec4(aPos, 0.0, 1.0);
+        gl_Position = u_view_projection * u_transform * vec4(aPos, 0.0, 1.0);
     }
 =End
 =Begin FragmentShader
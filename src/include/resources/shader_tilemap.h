@@ -0,0 +1,42 @@
+namespace rocket_resource {
+    const char *shader_tilemap_rlsl = R"(
+=LangProperty NoPropertyOverride true
+=Set Name "Tilemap"
+=Set Version 1.4
+=EnterNamespace API
+    =Add SupportedAPIs GL
+    =Add SupportedAPIs GLES
+=ExitNamespace
+=EnterNamespace API
+    =EnterNamespace VK
+        =Set MinimumVersion 1.1
+    =ExitNamespace
+    =EnterNamespace GLES
+        =Set MinimumVersion 3.0
+    =ExitNamespace
+    =EnterNamespace GL
+        =Set MinimumVersion 3.3
+    =ExitNamespace
+=ExitNamespace
+=Begin VertexShader
+    layout(location = 0) in vec2 aPos; // map pixels
+    layout(location = 1) in vec2 aTex;
+    out vec2 v_uv;
+    uniform mat4 u_transform;
+    layout(std140) uniform rocket_camera {
+        mat4 u_view_projection;
+    };
+    void main() {
+        v_uv = aTex;
+        gl_Position = u_view_projection * u_transform * vec4(aPos, 0.0, 1.0);
+    }
+=End
+=Begin FragmentShader
+    in vec2 v_uv;
+    out vec4 FragColor;
+    uniform sampler2D u_texture;
+    void main() {
+        FragColor = texture(u_texture, v_uv);
+    }
+=End)";
+}
@@ -0,0 +1,49 @@
+namespace rocket_resource {
+    const char *shader_upscale_rlsl = R"(
+=LangProperty NoPropertyOverride true
+=Set Name "Upscale"
+=Set Version 1.4
+=EnterNamespace API
+    =Add SupportedAPIs GL
+    =Add SupportedAPIs GLES
+=ExitNamespace
+=EnterNamespace API
+    =EnterNamespace GLES
+        =Set MinimumVersion 3.0
+    =ExitNamespace
+    =EnterNamespace GL
+        =Set MinimumVersion 3.3
+    =ExitNamespace
+=ExitNamespace
+=Begin VertexShader
+    layout(location = 0) in vec2 aPos;
+    layout(location = 1) in vec2 aTexCoord;
+    out vec2 vTexCoord;
+    void main() {
+        vTexCoord = aTexCoord;
+        gl_Position = vec4(aPos, 0.0, 1.0);
+    }
+=End
+=Begin FragmentShader
+    in vec2 vTexCoord;
+    out vec4 FragColor;
+    uniform sampler2D uScene;
+    uniform vec2 uResolution; // scene width/height
+    uniform float uSharpness; // 0 for plain bilinear
+    void main() {
+        vec3 center = texture(uScene, vTexCoord).rgb;
+        if (uSharpness <= 0.0) {
+            FragColor = vec4(center, 1.0);
+            return;
+        }
+        // Unsharp mask over the 4 neighbours, undoes some of the upscale blur
+        vec2 texel = 1.0 / uResolution;
+        vec3 n = texture(uScene, vTexCoord + vec2(0.0, -texel.y)).rgb;
+        vec3 s = texture(uScene, vTexCoord + vec2(0.0,  texel.y)).rgb;
+        vec3 e = texture(uScene, vTexCoord + vec2( texel.x, 0.0)).rgb;
+        vec3 w = texture(uScene, vTexCoord + vec2(-texel.x, 0.0)).rgb;
+        vec3 blur = (n + s + e + w) * 0.25;
+        FragColor = vec4(clamp(center + (center - blur) * uSharpness, 0.0, 1.0), 1.0);
+    }
+=End)";
+}
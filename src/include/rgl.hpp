@@ -3,6 +3,11 @@
 #ifndef RocketGL__INT_HPP
 #define RocketGL__INT_HPP
 
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
 namespace rocket {
     struct native_window_t;
 }
@@ -12,6 +17,12 @@ namespace rgl {
     void schedule_gl(std::function<void()> fn);
     void cleanup_all();
     void run_all_scheduled_gl();
+
+    /// @brief Write a program cache entry, header then binary
+    bool program_cache_write(std::ostream &out, uint64_t key, uint64_t driver, uint32_t format, const std::vector<char> &binary);
+    /// @brief Read and validate a program cache entry
+    /// @return Empty if the entry is usable, why it was rejected otherwise
+    std::string program_cache_read(std::istream &in, uint64_t key, uint64_t driver, uint32_t &format, std::vector<char> &binary);
 }
 
 #endif//RocketGL__INT_HPP
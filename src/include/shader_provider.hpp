@@ -14,15 +14,27 @@ namespace rocket {
         circle_lines,
         text,
         polygon,
+        tilemap,
+        particles,
 
         // Screen Space
         fxaa,
         zoom,
+        upscale,
     };
 
+    /// @brief Compiles on first use, waits for a shader that was submitted ahead
     rgl::shader_program_t gl_get_shader(shader_id_t shid);
+    /// @brief Like gl_get_shader, but never waits for a submitted shader
+    /// @return rGL_SHADER_INVALID while the driver is still building it
+    rgl::shader_program_t gl_try_get_shader(shader_id_t shid);
     vk_shader_t vk_get_shader(shader_id_t shid);
     void shader_provider_compile_all_gl();
+    /// @brief Start building every shader without waiting for any
+    void shader_provider_submit_all_gl();
+    /// @brief Finish the submitted shaders the driver is done with
+    /// @return true when none are left
+    bool shader_provider_poll_gl();
     void shader_provider_compile_all_vk();
     void shader_provider_reset();
 }
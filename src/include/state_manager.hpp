@@ -11,20 +11,21 @@
 namespace util {
     std::vector<std::function<void()>> &get_on_close_listeners();
 
-    std::vector<std::function<void(rocket::io::key_event_t)>> &key_listeners();
-    std::vector<std::function<void(rocket::io::mouse_event_t)>> &mouse_listeners();
-    std::vector<std::function<void(rocket::io::mouse_move_event_t)>> &mouse_move_listeners();
-    std::vector<std::function<void(rocket::io::scroll_offset_event_t)>> &scroll_offset_listeners();
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::key_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_move_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::scroll_offset_event_t)>);
+    bool remove_listener(rocket::io::listener_id_t);
 
     void dispatch_event(rocket::io::key_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::mouse_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::mouse_move_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::scroll_offset_event_t, bool add_simulated = false);
 
-    std::vector<rocket::io::key_event_t> get_simulated_kevents();
-    std::vector<rocket::io::mouse_event_t> get_simulated_mevents();
-    std::vector<rocket::io::mouse_move_event_t> get_simulated_mmevents();
-    std::vector<rocket::io::scroll_offset_event_t> get_simulated_sevents();
+    const std::vector<rocket::io::key_event_t> &get_simulated_kevents();
+    const std::vector<rocket::io::mouse_event_t> &get_simulated_mevents();
+    const std::vector<rocket::io::mouse_move_event_t> &get_simulated_mmevents();
+    const std::vector<rocket::io::scroll_offset_event_t> &get_simulated_sevents();
 
     void set_gl_initialized(bool);
     bool get_gl_initialized();
@@ -12,6 +12,7 @@
 #include <functional>
 #include <rocket/modularity/renderer_backend.hpp>
 #include <rocket/renderer_helpers.hpp>
+#include <span>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -56,6 +57,15 @@ namespace util {
         bool notext = false;
         bool forcewayland = false;
         bool software_frame_timer = false;
+        bool legacy_frame_timer = false;
+        bool gpu_timing = false;
+
+        std::string record_input;
+        std::string replay_input;
+        std::string frame_metrics;
+        std::string profile_trace;
+        bool update_golden = false;
+        std::string golden_output;
 
         std::vector<rocket::renderer_backend_t> blacklisted_apis;
     };
@@ -67,20 +77,46 @@ namespace util {
     void close_callback();
     std::vector<std::function<void()>> &get_on_close_listeners();
 
-    std::vector<std::function<void(rocket::io::key_event_t)>> &key_listeners();
-    std::vector<std::function<void(rocket::io::mouse_event_t)>> &mouse_listeners();
-    std::vector<std::function<void(rocket::io::mouse_move_event_t)>> &mouse_move_listeners();
-    std::vector<std::function<void(rocket::io::scroll_offset_event_t)>> &scroll_offset_listeners();
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::key_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_move_event_t)>);
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::scroll_offset_event_t)>);
+    bool remove_listener(rocket::io::listener_id_t);
 
     void dispatch_event(rocket::io::key_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::mouse_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::mouse_move_event_t, bool add_simulated = false);
     void dispatch_event(rocket::io::scroll_offset_event_t, bool add_simulated = false);
 
-    std::vector<rocket::io::key_event_t> get_simulated_kevents();
-    std::vector<rocket::io::mouse_event_t> get_simulated_mevents();
-    std::vector<rocket::io::mouse_move_event_t> get_simulated_mmevents();
-    std::vector<rocket::io::scroll_offset_event_t> get_simulated_sevents();
+    const std::vector<rocket::io::key_event_t> &get_simulated_kevents();
+    const std::vector<rocket::io::mouse_event_t> &get_simulated_mevents();
+    const std::vector<rocket::io::mouse_move_event_t> &get_simulated_mmevents();
+    const std::vector<rocket::io::scroll_offset_event_t> &get_simulated_sevents();
+
+    /// @brief Record an event into the input frame being filled
+    /// @note Main thread only
+    void record_input_event(rocket::io::input_event_t::data_t data, bool simulated = false);
+    /// @brief Record an event from any thread, merged on the next publish
+    /// @note Thread-Safe, lock-free
+    void record_input_event_async(rocket::io::input_event_t::data_t data, uint64_t timestamp_ns);
+    /// @brief Makes the filled input frame visible through io::get_frame_events
+    void publish_input_frame();
+    std::span<const rocket::io::input_event_t> get_input_frame();
+
+    /// @brief Writes a published frame to the active recording, if any
+    void input_record_frame(std::span<const rocket::io::input_event_t> frame);
+    /// @brief Replaces live events in a frame with the next recorded frame
+    /// @return false if no replay is active
+    bool input_replay_frame(std::vector<rocket::io::input_event_t> &frame);
+    bool input_replay_active();
+    /// @brief Fixed delta time while replaying, 0 otherwise
+    double input_replay_delta_time();
+    bool input_replay_key_down(rocket::io::keyboard_key key);
+    bool input_replay_mouse_down(rocket::io::mouse_button button);
+    rocket::vec2d_t input_replay_mouse_pos();
+
+    /// @brief Writes the --profile-trace capture, rocket::exit does not run static destructors
+    void profiler_flush_at_exit();
 
     rocket::vec2d_t get_last_touch_pos();
     void set_last_touch_pos(rocket::vec2d_t pos);
@@ -165,7 +201,9 @@ namespace util {
 
     void draw_debug_overlay(rocket::renderer_2d_i *ren);
 
-    void frame_timer_wait_for(
+    /// @brief Waits out the rest of the frame
+    /// @return Pacing error in seconds, positive when late
+    double frame_timer_wait_for(
         double frame_duration, 
         double frametime_limit, 
         bool software_frame_timer, 
@@ -0,0 +1,113 @@
+#ifndef ROCKETGE__WORKER_POOL_HPP
+#define ROCKETGE__WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <rocket/threads.hpp>
+
+namespace rocket {
+    /// @brief Worker threads for splitting one job into indexed parts, the calling thread works too
+    class worker_pool_t {
+    private:
+        std::vector<std::thread> threads;
+        std::string name;
+        std::mutex mutex;
+        std::mutex run_mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+
+        const std::function<void(int)> *job = nullptr;
+        int job_count = 0;
+        std::atomic<int> next_job = 0;
+        uint64_t generation = 0;
+        int busy = 0;
+        bool stopping = false;
+
+        void drain() {
+            for (int i = next_job.fetch_add(1); i < job_count; i = next_job.fetch_add(1)) {
+                (*job)(i);
+            }
+        }
+
+        void worker() {
+            rocket::thread_t::set_thread_name(name);
+            uint64_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) {
+                        return;
+                    }
+                    seen = generation;
+                }
+                drain();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--busy == 0) {
+                        finished.notify_one();
+                    }
+                }
+            }
+        }
+    public:
+        /// @param name Thread name, on Linux MAX 15 chars
+        explicit worker_pool_t(std::string name) : name(std::move(name)) {}
+
+        void start(int count) {
+            for (int i = 0; i < count; ++i) {
+                threads.emplace_back(&worker_pool_t::worker, this);
+            }
+        }
+
+        size_t size() const { return threads.size(); }
+
+        /// @brief Run fn(0..count-1) across the pool and wait for all of them
+        /// @note Thread-Safe, concurrent runs take turns
+        void run(int count, const std::function<void(int)> &fn) {
+            std::lock_guard<std::mutex> turn(run_mutex);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &fn;
+                job_count = count;
+                next_job.store(0);
+                busy = static_cast<int>(threads.size());
+                generation++;
+            }
+            wake.notify_all();
+            drain();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&] { return busy == 0; });
+            job = nullptr;
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto &t : threads) {
+                t.join();
+            }
+            threads.clear();
+        }
+
+        ~worker_pool_t() {
+            stop();
+        }
+    };
+
+    /// @brief Engine-wide pool for CPU jobs that are not tied to a renderer
+    /// @note One thread per core minus the caller, started on first use
+    worker_pool_t &get_job_pool();
+}
+
+#endif//ROCKETGE__WORKER_POOL_HPP
@@ -9,8 +9,10 @@
 #include <shader.hpp>
 #include <string>
 #include <mutex>
+#include <atomic>
 #include <rocket/macros.hpp>
 #include <rocket/glfnldr.hpp>
+#include <rocket/profiler.hpp>
 #include <cstdlib>
 #include <intl_macros.hpp>
 #include <thread>
@@ -22,6 +24,8 @@
 namespace rocket::globals {
     std::thread::id g_main_thread_id;
     bool g_main_thread_id_set = false;
+    /// Owns the graphics context, the main thread unless a render thread took it
+    std::atomic<std::thread::id> g_graphics_thread_id;
 
     bool g_rocket_entrypoint_used = false;
 }
@@ -423,6 +427,7 @@ namespace rocket {
             exitcb(status_code);
         }
 
+        util::profiler_flush_at_exit();
         rnative::exit_now(status_code);
     }
 
@@ -487,6 +492,11 @@ namespace rocket {
             "viewport-size", "viewportsize", "vp-size", "vpsize",
             "framerate",
             "logfile",
+            "record-input",
+            "replay-input",
+            "frame-metrics",
+            "profile-trace",
+            "golden-output",
         };
 
         auto args = util::get_clistate();
@@ -557,6 +567,8 @@ namespace rocket {
                 args.logall = true;
             } else if (arg == "debugoverlay" || arg == "doverlay" || arg == "debug-overlay") {
                 args.debugoverlay = true;
+            } else if (arg == "gpu-timing") {
+                args.gpu_timing = true;
             } else if (arg == "renderer-backend") {
                 constexpr auto split = [](std::string str, char delim) -> std::vector<std::string> {
                     std::stringstream ss(str);
@@ -595,6 +607,8 @@ namespace rocket {
                     args.renderer_backend = renderer_backend_t::opengl;
                 } else if (backend == "vulkan") {
                     args.renderer_backend = renderer_backend_t::vulkan;
+                } else if (backend == "software") {
+                    args.renderer_backend = renderer_backend_t::software;
                 } else {
                     rocket::log("invalid renderer backend: " + backend, "rocket", "argparse", "fatal");
                     exit = true;
@@ -646,6 +660,18 @@ namespace rocket {
                 }
             } else if (arg == "logfile-overwrite") {
                 logfile_overwrite = true;
+            } else if (arg == "record-input") {
+                args.record_input = value;
+            } else if (arg == "replay-input") {
+                args.replay_input = value;
+            } else if (arg == "frame-metrics") {
+                args.frame_metrics = value;
+            } else if (arg == "profile-trace") {
+                args.profile_trace = value;
+            } else if (arg == "update-golden") {
+                args.update_golden = true;
+            } else if (arg == "golden-output") {
+                args.golden_output = value;
             }
             else if (arg == "version") {
                 exit = true;
@@ -713,8 +739,12 @@ namespace rocket {
                     "   debug-overlay, debugoverlay, doverlay",
                     "   -> shows a debug overlay with rendering information",
                     "",
+                    "   gpu-timing",
+                    "   -> measures GPU frame time with timer queries (OpenGL)",
+                    "",
                     "*  renderer-backend, [name:version] (version fmt: Major.Minor OR 'any')",
                     "   -> forces a specific renderer backend to be used (if available)",
+                    "   -> backends: opengl, vulkan, software",
                     "",
                     "   no-splash, nosplash",
                     "   -> hides splash from being shown in the beginning",
@@ -725,6 +755,24 @@ namespace rocket {
                     "*  framerate [fps]",
                     "   -> forces to use a set framerate (if reachable)",
                     "",
+                    "*  record-input [file_path]",
+                    "   -> records all input to a file for replay-input",
+                    "",
+                    "*  replay-input [file_path]",
+                    "   -> replays recorded input at a fixed delta time, then exits",
+                    "",
+                    "*  frame-metrics [file_path] (.csv, otherwise JSON lines)",
+                    "   -> writes a record of every frame (cpu/wait time, drawcalls, uploads)",
+                    "",
+                    "*  profile-trace [file_path]",
+                    "   -> writes profiler zones as a Chrome trace (Perfetto) on exit",
+                    "",
+                    "   update-golden",
+                    "   -> records golden images instead of comparing against them",
+                    "",
+                    "*  golden-output [dir_path]",
+                    "   -> where mismatching golden images are written (golden_output/)",
+                    "",
                     "   version",
                     "   -> shows version and attribution",
                     "",
@@ -799,6 +847,8 @@ namespace rocket {
                 exit = true;
             } else if (arg == "software-frame-timer") {
                 args.software_frame_timer = true;
+            } else if (arg == "legacy-frame-timer") {
+                args.legacy_frame_timer = true;
             } else if (arg == "mesa-software") {
 #ifdef ROCKETGE__Platform_Linux
                 setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
@@ -855,6 +905,23 @@ namespace rocket {
         }
 
         util::init_clistate(args);
+
+        if (!args.replay_input.empty()) {
+            if (!io::start_replay(args.replay_input, true)) {
+                rocket::exit(1);
+            }
+        } else if (!args.record_input.empty()) {
+            io::start_recording(args.record_input);
+        }
+
+        if (!args.frame_metrics.empty()) {
+            rgl::frame_export_format_t format = args.frame_metrics.ends_with(".csv") ? rgl::frame_export_format_t::csv : rgl::frame_export_format_t::json_lines;
+            rgl::start_frame_export(args.frame_metrics, format);
+        }
+
+        if (!args.profile_trace.empty()) {
+            profiler::capture_until_exit(args.profile_trace);
+        }
     }
 
     void set_cli_arguments(std::vector<std::string> args) {
@@ -941,6 +1008,8 @@ namespace rocket {
                 state.renderer_backend = renderer_backend_t::opengl;
             } else if (value == "Vulkan") {
                 state.renderer_backend = renderer_backend_t::vulkan;
+            } else if (value == "Software") {
+                state.renderer_backend = renderer_backend_t::software;
             }
         });
         do_if_exists_l("Graphics.BlacklistedAPIs", [&state](const std::vector<std::string> &value) {
@@ -949,6 +1018,8 @@ namespace rocket {
                     state.blacklisted_apis.push_back(renderer_backend_t::opengl);
                 } else if (item == "Vulkan") {
                     state.blacklisted_apis.push_back(renderer_backend_t::vulkan);
+                } else if (item == "Software") {
+                    state.blacklisted_apis.push_back(renderer_backend_t::software);
                 }
             }
         });
@@ -1029,6 +1100,7 @@ namespace rocket {
 void __rocket_premain(int argc, char **argv) {
     rocket::globals::g_main_thread_id = std::this_thread::get_id();
     rocket::globals::g_main_thread_id_set = true;
+    rocket::globals::g_graphics_thread_id = rocket::globals::g_main_thread_id;
 
     rocket::globals::g_rocket_entrypoint_used = true;
 
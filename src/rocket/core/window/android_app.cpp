@@ -3,6 +3,7 @@
 #include "window.hpp"
 #include <rocket/io.hpp>
 #include <rocket/modularity/window_backend.hpp>
+#include <rocket/profiler.hpp>
 #include <rocket/runtime.hpp>
 #include <internal_types.hpp>
 #include <rocket/window_helpers.hpp>
@@ -133,11 +134,15 @@ namespace rocket {
             if (action == AMOTION_EVENT_ACTION_DOWN) {
                 util::set_last_touch_state(rocket::io::keystate_t::make_down());
                 util::set_last_touch_pos({x, y});
+                util::record_input_event(rocket::io::mouse_event_t { rocket::io::mouse_button::finger, rocket::io::keystate_t::make_pressed(), {x, y} });
             } else if (action == AMOTION_EVENT_ACTION_UP) {
                 util::set_last_touch_state(rocket::io::keystate_t::make_released());
                 util::set_last_touch_pos({x, y});
+                util::record_input_event(rocket::io::mouse_event_t { rocket::io::mouse_button::finger, rocket::io::keystate_t::make_released(), {x, y} });
             } else if (action == AMOTION_EVENT_ACTION_MOVE) {
+                rocket::vec2d_t old_pos = util::get_last_touch_pos();
                 util::set_last_touch_pos({x, y});
+                util::record_input_event(rocket::io::mouse_move_event_t { old_pos, {x, y} });
             }
                 return 1;
 
@@ -150,6 +155,7 @@ namespace rocket {
                     ? rocket::io::keystate_t::make_down()
                     : rocket::io::keystate_t::make_released();
                 util::dispatch_event(key_event);
+                util::record_input_event(key_event);
                 return 1;
             }
 
@@ -221,12 +227,25 @@ namespace rocket {
     }
 
     void android_app_t::swap_buffers() const {
+        ROCKET_PROFILE_SCOPE("android_app_t::swap_buffers");
 #ifdef ROCKETGE__Platform_Android
         if (this->impl->surface != EGL_NO_SURFACE)
             eglSwapBuffers(this->impl->display, this->impl->surface);
 #endif
     }
 
+    void android_app_t::make_context_current(bool current) const {
+#ifdef ROCKETGE__Platform_Android
+        if (current) {
+            eglMakeCurrent(this->impl->display, this->impl->surface, this->impl->surface, this->impl->context);
+        } else {
+            eglMakeCurrent(this->impl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+#else
+        (void) current;
+#endif
+    }
+
     void android_app_t::set_size(const rocket::vec2i_t& size) {
         this->size = size;
     }
@@ -240,6 +259,7 @@ namespace rocket {
     }
 
     void android_app_t::poll_events() {
+        ROCKET_PROFILE_SCOPE("android_app_t::poll_events");
 #ifdef ROCKETGE__Platform_Android
         EGLint w, h;
         eglQuerySurface(this->impl->display, this->impl->surface, EGL_WIDTH, &w);
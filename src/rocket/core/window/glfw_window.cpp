@@ -12,6 +12,7 @@
 #include "rocket/asset.hpp"
 #include "rocket/io.hpp"
 #include "rocket/macros.hpp"
+#include "rocket/profiler.hpp"
 #include "intl_macros.hpp"
 #include "rocket/runtime.hpp"
 #include "rocket/types.hpp"
@@ -382,9 +383,14 @@ namespace rocket {
         this->title = title;
 
         if (cli_args.renderer_backend_version > 0 &&
-            cli_args.renderer_backend != renderer_backend_t::null) {
+            cli_args.renderer_backend != renderer_backend_t::null &&
+            cli_args.renderer_backend != renderer_backend_t::software) {
             flags.graphics_ctx.backend = cli_args.renderer_backend;
         }
+        // The software renderer presents through an OpenGL context
+        if (flags.graphics_ctx.backend == renderer_backend_t::software) {
+            flags.graphics_ctx.backend = renderer_backend_t::opengl;
+        }
 
         window::glfw_cpl_init();
         GLFWmonitor *monitor = glfwGetPrimaryMonitor();
@@ -488,9 +494,39 @@ namespace rocket {
         glfwSetScrollCallback((GLFWwindow*)this->glfw_window->w, [](GLFWwindow*, double xoffset, double yoffset) {
             rocket::io::scroll_offset_event_t event;
             event.offset = { xoffset, yoffset };
+            util::record_input_event(event);
+            if (util::input_replay_active()) return;
             util::dispatch_event(event);
         });
 
+        // Transitions are timestamped as glfwPollEvents delivers them, listeners still run from poll_events
+        glfwSetKeyCallback((GLFWwindow*)this->glfw_window->w, [](GLFWwindow*, int key, int scancode, int action, int /* mods */) {
+            if (key == GLFW_KEY_UNKNOWN || action == GLFW_REPEAT) return;
+            rocket::io::key_event_t event;
+            event.key = static_cast<rocket::io::keyboard_key>(key);
+            event.state = action == GLFW_PRESS ? rocket::io::keystate_t::make_pressed() : rocket::io::keystate_t::make_released();
+            event.scancode = scancode;
+            util::record_input_event(event);
+        });
+
+        glfwSetMouseButtonCallback((GLFWwindow*)this->glfw_window->w, [](GLFWwindow* window, int button, int action, int /* mods */) {
+            if (button > static_cast<int>(rocket::io::mouse_button::last)) return;
+            rocket::io::mouse_event_t event;
+            event.button = static_cast<rocket::io::mouse_button>(button);
+            event.state = action == GLFW_PRESS ? rocket::io::keystate_t::make_pressed() : rocket::io::keystate_t::make_released();
+            glfwGetCursorPos(window, &event.position.x, &event.position.y);
+            util::record_input_event(event);
+        });
+
+        glfwSetCursorPosCallback((GLFWwindow*)this->glfw_window->w, [](GLFWwindow*, double x, double y) {
+            static rocket::vec2d_t last = { x, y };
+            rocket::io::mouse_move_event_t event;
+            event.old_pos = last;
+            event.pos = { x, y };
+            last = event.pos;
+            util::record_input_event(event);
+        });
+
         if (auto mode = glfwGetVideoMode(glfwaltGetMonitorWithCursor()); !glfw_platform_is_wayland(get_platform())) {
             glfwSetWindowPos((GLFWwindow*)glfw_window->w, (mode->width - size.x) / 2, (mode->height - size.y) / 2);
         }
@@ -587,9 +623,18 @@ namespace rocket {
     }
 
     void glfw_window_t::swap_buffers() const {
+        ROCKET_PROFILE_SCOPE("glfw_window_t::swap_buffers");
         glfwSwapBuffers((GLFWwindow*)this->glfw_window->w);
     }
 
+    void glfw_window_t::make_context_current(bool current) const {
+        // Vulkan has no context to move between threads
+        if (this->flags.graphics_ctx.backend != renderer_backend_t::opengl) {
+            return;
+        }
+        glfwMakeContextCurrent(current ? (GLFWwindow*)this->glfw_window->w : nullptr);
+    }
+
     void glfw_window_t::set_size(const rocket::vec2i_t& size) {
         glfwSetWindowSize((GLFWwindow*)glfw_window->w, size.x, size.y);
         this->size = size;
@@ -605,6 +650,7 @@ namespace rocket {
     }
 
     void glfw_window_t::poll_events() {
+        ROCKET_PROFILE_SCOPE("glfw_window_t::poll_events");
         static bool first_init = false;
         if (!first_init) {
             if (this->flags.graphics_ctx.backend == renderer_backend_t::opengl) {
@@ -627,45 +673,48 @@ namespace rocket {
         // glfwGetFramebufferSize((GLFWwindow*)glfw_window->w, &w, &h);
         // this->size = { w, h };
 
-        for (int i = static_cast<int>(io::keyboard_key::first_key); i <= static_cast<int>(io::keyboard_key::last_key); ++i) {
-            keys[i].previous = keys[i].current;
-            keys[i].current = glfwGetKey((GLFWwindow*)glfw_window->w, i) == GLFW_PRESS;
-
-            io::key_event_t event;
-            event.key = static_cast<io::keyboard_key>(i);
-            event.state = keys[i];
-            event.scancode = glfwGetKeyScancode(i);
-            util::dispatch_event(event);
-        }
-        
-        for (int i = static_cast<int>(io::mouse_button::first); i <= static_cast<int>(io::mouse_button::last); ++i) {
-            bool new_state = glfwGetMouseButton((GLFWwindow*)glfw_window->w, i) == GLFW_PRESS;
-            if (buttons[i].current != new_state) {
-                buttons[i].previous = buttons[i].current;
-                buttons[i].current = new_state;
-            } else {
-                buttons[i].previous = buttons[i].current;
+        // Replays feed listeners with recorded events instead
+        if (!util::input_replay_active()) {
+            for (int i = static_cast<int>(io::keyboard_key::first_key); i <= static_cast<int>(io::keyboard_key::last_key); ++i) {
+                keys[i].previous = keys[i].current;
+                keys[i].current = glfwGetKey((GLFWwindow*)glfw_window->w, i) == GLFW_PRESS;
+
+                io::key_event_t event;
+                event.key = static_cast<io::keyboard_key>(i);
+                event.state = keys[i];
+                event.scancode = glfwGetKeyScancode(i);
+                util::dispatch_event(event);
             }
+        
+            for (int i = static_cast<int>(io::mouse_button::first); i <= static_cast<int>(io::mouse_button::last); ++i) {
+                bool new_state = glfwGetMouseButton((GLFWwindow*)glfw_window->w, i) == GLFW_PRESS;
+                if (buttons[i].current != new_state) {
+                    buttons[i].previous = buttons[i].current;
+                    buttons[i].current = new_state;
+                } else {
+                    buttons[i].previous = buttons[i].current;
+                }
 
-            io::mouse_event_t event;
-            event.button = static_cast<io::mouse_button>(i);
-            event.state = buttons[i];
-            event.position = {};
-            glfwGetCursorPos((GLFWwindow*)glfw_window->w, &event.position.x, &event.position.y);
+                io::mouse_event_t event;
+                event.button = static_cast<io::mouse_button>(i);
+                event.state = buttons[i];
+                event.position = {};
+                glfwGetCursorPos((GLFWwindow*)glfw_window->w, &event.position.x, &event.position.y);
 
-            util::dispatch_event(event);
-        }
+                util::dispatch_event(event);
+            }
 
-        static double last_mouse_x{0}, last_mouse_y{0};
-        double mouse_x{0}, mouse_y{0};
-        glfwGetCursorPos((GLFWwindow*)glfw_window->w, &mouse_x, &mouse_y);
-        if (mouse_x != last_mouse_x || mouse_y != last_mouse_y) {
-            io::mouse_move_event_t event;
-            event.pos = { mouse_x, mouse_y };
-            event.old_pos = { last_mouse_x, last_mouse_y };
-            util::dispatch_event(event);
-            last_mouse_x = mouse_x;
-            last_mouse_y = mouse_y;
+            static double last_mouse_x{0}, last_mouse_y{0};
+            double mouse_x{0}, mouse_y{0};
+            glfwGetCursorPos((GLFWwindow*)glfw_window->w, &mouse_x, &mouse_y);
+            if (mouse_x != last_mouse_x || mouse_y != last_mouse_y) {
+                io::mouse_move_event_t event;
+                event.pos = { mouse_x, mouse_y };
+                event.old_pos = { last_mouse_x, last_mouse_y };
+                util::dispatch_event(event);
+                last_mouse_x = mouse_x;
+                last_mouse_y = mouse_y;
+            }
         }
 
         util::io_update_end_frame();
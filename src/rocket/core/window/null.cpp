@@ -1,8 +1,10 @@
 #include "rocket/window.hpp"
 #include "window.hpp"
 #include <rocket/modularity/window_backend.hpp>
+#include <rocket/profiler.hpp>
 #include <rocket/runtime.hpp>
 #include <internal_types.hpp>
+#include <util.hpp>
 
 namespace rocket {
     void window::null_cpl_init() {
@@ -51,6 +53,10 @@ namespace rocket {
     }
 
     void null_window_t::swap_buffers() const {
+        ROCKET_PROFILE_SCOPE("null_window_t::swap_buffers");
+    }
+
+    void null_window_t::make_context_current(bool) const {
     }
 
     void null_window_t::set_size(const rocket::vec2i_t& size) {
@@ -66,6 +72,8 @@ namespace rocket {
     }
 
     void null_window_t::poll_events() {
+        ROCKET_PROFILE_SCOPE("null_window_t::poll_events");
+        util::io_update_end_frame();
     }
 
     std::string null_window_t::get_title() const {
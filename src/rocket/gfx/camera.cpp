@@ -0,0 +1,119 @@
+#include "rocket/camera.hpp"
+#include "rocket/renderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace rocket {
+    namespace {
+        fbounding_box resolve_viewport(const camera_2d &cam, vec2f_t viewport_size) {
+            if (cam.viewport.size.x < 0.f || cam.viewport.size.y < 0.f) {
+                return { { 0.f, 0.f }, viewport_size };
+            }
+            return cam.viewport;
+        }
+
+        float safe_zoom(float zoom) {
+            return std::max(zoom, 1e-6f);
+        }
+    }
+
+    vec2f_t camera_transform_t::apply(vec2f_t world) const {
+        return {
+            this->translation.x + this->zoom * (world.x * this->cs - world.y * this->sn),
+            this->translation.y + this->zoom * (world.x * this->sn + world.y * this->cs),
+        };
+    }
+
+    fbounding_box camera_transform_t::apply(fbounding_box rect) const {
+        const vec2f_t center = this->apply(vec2f_t{ rect.pos.x + rect.size.x * 0.5f, rect.pos.y + rect.size.y * 0.5f });
+        const vec2f_t size = { rect.size.x * this->zoom, rect.size.y * this->zoom };
+        return { { center.x - size.x * 0.5f, center.y - size.y * 0.5f }, size };
+    }
+
+    glm::mat4 camera_transform_t::get_matrix() const {
+        glm::mat4 m(1.0f);
+        m[0][0] = this->zoom * this->cs;
+        m[0][1] = this->zoom * this->sn;
+        m[1][0] = -this->zoom * this->sn;
+        m[1][1] = this->zoom * this->cs;
+        m[3][0] = this->translation.x;
+        m[3][1] = this->translation.y;
+        return m;
+    }
+
+    camera_transform_t camera_2d::get_transform(vec2f_t viewport_size) const {
+        const fbounding_box vp = resolve_viewport(*this, viewport_size);
+        const vec2f_t vp_center = { vp.pos.x + vp.size.x * 0.5f, vp.pos.y + vp.size.y * 0.5f };
+
+        camera_transform_t xf;
+        xf.zoom = safe_zoom(this->zoom);
+        xf.rotation = -this->rotation;
+        const float radians = xf.rotation * std::numbers::pi_v<float> / 180.f;
+        xf.cs = std::cos(radians);
+        xf.sn = std::sin(radians);
+        // screen = vp_center + zoom * R * (world - position)
+        xf.translation = {
+            vp_center.x - xf.zoom * (this->position.x * xf.cs - this->position.y * xf.sn),
+            vp_center.y - xf.zoom * (this->position.x * xf.sn + this->position.y * xf.cs),
+        };
+        return xf;
+    }
+
+    glm::mat4 camera_2d::get_view_matrix(vec2f_t viewport_size) const {
+        return this->get_transform(viewport_size).get_matrix();
+    }
+
+    vec2f_t camera_2d::world_to_screen(vec2f_t world, vec2f_t viewport_size) const {
+        return this->get_transform(viewport_size).apply(world);
+    }
+
+    vec2f_t camera_2d::screen_to_world(vec2f_t screen, vec2f_t viewport_size) const {
+        const camera_transform_t xf = this->get_transform(viewport_size);
+        const vec2f_t local = { (screen.x - xf.translation.x) / xf.zoom, (screen.y - xf.translation.y) / xf.zoom };
+        // Inverse rotation is the transpose
+        return { local.x * xf.cs + local.y * xf.sn, -local.x * xf.sn + local.y * xf.cs };
+    }
+
+    fbounding_box camera_2d::get_world_bounds(vec2f_t viewport_size) const {
+        const fbounding_box vp = resolve_viewport(*this, viewport_size);
+        const vec2f_t corners[4] = {
+            this->screen_to_world(vp.pos, viewport_size),
+            this->screen_to_world({ vp.pos.x + vp.size.x, vp.pos.y }, viewport_size),
+            this->screen_to_world({ vp.pos.x, vp.pos.y + vp.size.y }, viewport_size),
+            this->screen_to_world({ vp.pos.x + vp.size.x, vp.pos.y + vp.size.y }, viewport_size),
+        };
+
+        vec2f_t lo = corners[0];
+        vec2f_t hi = corners[0];
+        for (const vec2f_t &c : corners) {
+            lo = { std::min(lo.x, c.x), std::min(lo.y, c.y) };
+            hi = { std::max(hi.x, c.x), std::max(hi.y, c.y) };
+        }
+        return { lo, { hi.x - lo.x, hi.y - lo.y } };
+    }
+
+    void renderer_2d_i::begin_camera_mode() {
+        this->camera_active = this->cam != nullptr;
+        if (!this->camera_active) {
+            return;
+        }
+        const vec2f_t viewport_size = this->get_viewport_size();
+        this->camera_xf = this->cam->get_transform(viewport_size);
+        this->camera_world_bounds = this->cam->get_world_bounds(viewport_size);
+    }
+
+    void renderer_2d_i::end_camera_mode() {
+        this->camera_active = false;
+    }
+
+    rocket::fbounding_box renderer_2d_i::get_culling_bounds() {
+        if (this->camera_active) {
+            return this->camera_world_bounds;
+        }
+        if (this->render_cache_extent.x >= 0.f) {
+            return { { 0.f, 0.f }, this->render_cache_extent };
+        }
+        return { { 0.f, 0.f }, this->get_viewport_size() };
+    }
+}
@@ -0,0 +1,434 @@
+#include "rocket/command_bucket.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/renderer.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+namespace rocket {
+    namespace {
+        /// @brief Shader part of the key, draws sharing a program sort together
+        enum shader_key_t : uint8_t {
+            shader_key_quad,
+            shader_key_circle,
+            shader_key_polygon,
+            shader_key_textured,
+            shader_key_text,
+        };
+
+        /// @brief Intersects any view, for draws that are not culled in bulk
+        constexpr fbounding_box never_culled = { { -1e30f, -1e30f }, { 2e30f, 2e30f } };
+
+        /// @brief Bounds of a command in its target, before rotation
+        fbounding_box op_bounds(const bucket_command_t &c) {
+            switch (c.op) {
+                case bucket_op_t::rectangle:
+                case bucket_op_t::texture:
+                case bucket_op_t::atlas_texture:
+                    return c.rect;
+                case bucket_op_t::render_cache:
+                    return c.rect.size.x < 0.f || c.rect.size.y < 0.f ? never_culled : c.rect;
+                case bucket_op_t::circle:
+                case bucket_op_t::polygon:
+                    return { { c.a.x - c.f0, c.a.y - c.f0 }, { c.f0 * 2, c.f0 * 2 } };
+                case bucket_op_t::pixel:
+                    return { c.a, { 1, 1 } };
+                case bucket_op_t::text:
+                    // Measuring here would cost more than the backend's own check
+                    return never_culled;
+            }
+            return never_culled;
+        }
+
+        /// @brief Screen bounds of a command, before rotation
+        fbounding_box command_bounds(const bucket_command_t &c) {
+            // Render caches have their own viewport
+            return c.target != 0 ? never_culled : op_bounds(c);
+        }
+
+        float command_rotation(const bucket_command_t &c) {
+            switch (c.op) {
+                case bucket_op_t::rectangle:
+                case bucket_op_t::texture:
+                case bucket_op_t::atlas_texture:
+                    return c.target == 0 ? c.f0 : 0.f;
+                default:
+                    return 0.f;
+            }
+        }
+
+        /// @brief Bounds that hold a command at any rotation
+        fbounding_box overlap_bounds(const bucket_command_t &c) {
+            fbounding_box box = op_bounds(c);
+            const bool rotates = c.op == bucket_op_t::rectangle || c.op == bucket_op_t::texture || c.op == bucket_op_t::atlas_texture;
+            if (!rotates || c.f0 == 0.f) {
+                return box;
+            }
+            const float radius = std::sqrt(box.size.x * box.size.x + box.size.y * box.size.y) * 0.5f;
+            const vec2f_t center = { box.pos.x + box.size.x * 0.5f, box.pos.y + box.size.y * 0.5f };
+            return { { center.x - radius, center.y - radius }, { radius * 2, radius * 2 } };
+        }
+
+        fbounding_box merge_bounds(const fbounding_box &a, const fbounding_box &b) {
+            const float x0 = std::min(a.pos.x, b.pos.x);
+            const float y0 = std::min(a.pos.y, b.pos.y);
+            const float x1 = std::max(a.pos.x + a.size.x, b.pos.x + b.size.x);
+            const float y1 = std::max(a.pos.y + a.size.y, b.pos.y + b.size.y);
+            return { { x0, y0 }, { x1 - x0, y1 - y0 } };
+        }
+
+        /// @brief Move a key's run past the sequences of earlier buckets
+        uint64_t rebase_sequence(uint64_t key, uint32_t base) {
+            if (base == 0) {
+                return key;
+            }
+            const uint32_t sequence = std::min(sort_key_t::get_sequence(key) + base, sort_key_t::max_sequence);
+            // Out of runs, same as in assign_key
+            const bool saturated = sequence >= sort_key_t::max_sequence;
+            return sort_key_t::make(
+                sort_key_t::get_pass(key),
+                sort_key_t::get_layer(key),
+                sequence,
+                saturated ? 0 : sort_key_t::get_shader(key),
+                saturated ? 0 : sort_key_t::get_texture(key),
+                sort_key_t::get_depth(key)
+            );
+        }
+
+        /// @brief Stable LSD radix sort on T::key
+        /// @note Bytes every key shares are skipped, unused key fields cost nothing
+        template<typename T>
+        void radix_sort_by_key(std::vector<T> &items, std::vector<T> &scratch) {
+            const size_t n = items.size();
+            if (n < 2) {
+                return;
+            }
+
+            std::array<std::array<uint32_t, 256>, 8> counts = {};
+            for (const T &item : items) {
+                for (int b = 0; b < 8; ++b) {
+                    counts[b][(item.key >> (b * 8)) & 0xff]++;
+                }
+            }
+
+            scratch.resize(n);
+            std::vector<T> *src = &items;
+            std::vector<T> *dst = &scratch;
+            for (int b = 0; b < 8; ++b) {
+                const int shift = b * 8;
+                std::array<uint32_t, 256> &count = counts[b];
+                if (count[((*src)[0].key >> shift) & 0xff] == n) {
+                    continue;
+                }
+
+                uint32_t offset = 0;
+                for (uint32_t &c : count) {
+                    const uint32_t here = c;
+                    c = offset;
+                    offset += here;
+                }
+                for (const T &item : *src) {
+                    (*dst)[count[(item.key >> shift) & 0xff]++] = item;
+                }
+                std::swap(src, dst);
+            }
+            if (src != &items) {
+                items.swap(scratch);
+            }
+        }
+    }
+
+    bucket_command_t &command_bucket_t::push(bucket_op_t op) {
+        bucket_command_t &c = this->commands.emplace_back();
+        c.op = op;
+        c.target = this->target;
+        return c;
+    }
+
+    uint16_t command_bucket_t::texture_id(const void *texture) {
+        if (texture == nullptr) {
+            return 0;
+        }
+        // Ids past the maximum share it, equal keys only lose batching
+        auto [it, _] = this->texture_ids.try_emplace(texture, static_cast<uint16_t>(std::min<size_t>(this->texture_ids.size() + 1, sort_key_t::max_texture)));
+        return it->second;
+    }
+
+    void command_bucket_t::assign_key(bucket_command_t &c, uint8_t shader, const void *texture) {
+        uint16_t texture_key = this->texture_id(texture);
+        const fbounding_box bounds = overlap_bounds(c);
+
+        // Reordering is only visible where draws with another state overlap
+        run_state_t *same = nullptr;
+        bool ordered = false;
+        for (run_state_t &r : this->run) {
+            if (r.shader == shader && r.texture == texture_key) {
+                same = &r;
+            } else if (r.bounds.intersects(bounds)) {
+                ordered = true;
+            }
+        }
+        if (ordered || (same == nullptr && this->run.size() >= max_run_states)) {
+            this->sequence++;
+            this->run.clear();
+            same = nullptr;
+        }
+        if (same != nullptr) {
+            same->bounds = merge_bounds(same->bounds, bounds);
+        } else {
+            this->run.push_back({ shader, texture_key, bounds });
+        }
+
+        if (this->sequence >= sort_key_t::max_sequence) {
+            // Out of runs, the rest keep recording order through the stable sort
+            shader = 0;
+            texture_key = 0;
+        }
+        const uint8_t pass = c.target != 0 ? sort_key_t::pass_offscreen : sort_key_t::pass_screen;
+        c.key = sort_key_t::make(pass, this->layer, this->sequence, shader, texture_key, this->depth);
+    }
+
+    uint32_t command_bucket_t::add_texture(const std::shared_ptr<texture_t> &texture) {
+        // Sprites usually come in runs of the same texture
+        if (this->textures.empty() || this->textures.back() != texture) {
+            this->textures.push_back(texture);
+        }
+        return static_cast<uint32_t>(this->textures.size() - 1);
+    }
+
+    void command_bucket_t::set_layer(uint8_t layer) {
+        this->layer = layer;
+    }
+
+    void command_bucket_t::set_depth(uint32_t depth) {
+        this->depth = depth;
+    }
+
+    void command_bucket_t::set_target(render_cache_t *cache) {
+        if (this->targets[this->target] != cache) {
+            // Draws into different targets never share a run
+            this->sequence++;
+            this->run.clear();
+        }
+        for (size_t i = 0; i < this->targets.size(); ++i) {
+            if (this->targets[i] == cache) {
+                this->target = static_cast<uint16_t>(i);
+                return;
+            }
+        }
+        this->target = static_cast<uint16_t>(this->targets.size());
+        this->targets.push_back(cache);
+    }
+
+    void command_bucket_t::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        bucket_command_t &c = this->push(bucket_op_t::rectangle);
+        c.rect = rect;
+        c.color = color;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+        c.flag = lines ? 1 : 0;
+        this->assign_key(c, shader_key_quad, nullptr);
+    }
+
+    void command_bucket_t::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        this->draw_rectangle({ pos, size }, color, rotation, roundedness, lines);
+    }
+
+    void command_bucket_t::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        bucket_command_t &c = this->push(bucket_op_t::circle);
+        c.a = pos;
+        c.f0 = radius;
+        c.color = color;
+        c.ival = thickness;
+        this->assign_key(c, shader_key_circle, nullptr);
+    }
+
+    void command_bucket_t::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int sides, float rotation) {
+        bucket_command_t &c = this->push(bucket_op_t::polygon);
+        c.a = pos;
+        c.f0 = radius;
+        c.f1 = rotation;
+        c.color = color;
+        c.ival = sides;
+        this->assign_key(c, shader_key_polygon, nullptr);
+    }
+
+    void command_bucket_t::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        const uint32_t ref = this->add_texture(texture);
+        bucket_command_t &c = this->push(bucket_op_t::texture);
+        c.ref = ref;
+        c.rect = rect;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+        this->assign_key(c, shader_key_textured, texture.get());
+    }
+
+    void command_bucket_t::draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation, float roundedness) {
+        const uint32_t ref = this->add_texture(texture);
+        bucket_command_t &c = this->push(bucket_op_t::atlas_texture);
+        c.ref = ref;
+        c.rect = rect;
+        c.a = texture_position_in_atlas;
+        c.b = texture_size_in_atlas;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+        this->assign_key(c, shader_key_textured, texture.get());
+    }
+
+    void command_bucket_t::draw_text(const rocket::text_t &text, vec2f_t position) {
+        bucket_command_t &c = this->push(bucket_op_t::text);
+        c.ref = static_cast<uint32_t>(this->texts.size());
+        c.a = position;
+        this->texts.push_back(text);
+        this->assign_key(c, shader_key_text, text.font.get());
+    }
+
+    void command_bucket_t::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        bucket_command_t &c = this->push(bucket_op_t::pixel);
+        c.a = pos;
+        c.color = color;
+        this->assign_key(c, shader_key_quad, nullptr);
+    }
+
+    void command_bucket_t::draw_render_cache(render_cache_t *cache, rocket::fbounding_box bbox) {
+        bucket_command_t &c = this->push(bucket_op_t::render_cache);
+        c.ref = static_cast<uint32_t>(this->caches.size());
+        c.rect = bbox;
+        this->caches.push_back(cache);
+        this->assign_key(c, shader_key_textured, cache);
+    }
+
+    void command_bucket_t::clear() {
+        this->commands.clear();
+        this->textures.clear();
+        this->texts.clear();
+        this->caches.clear();
+        this->targets.assign(1, nullptr);
+        this->texture_ids.clear();
+        this->run.clear();
+        this->layer = 0;
+        this->depth = 0;
+        this->target = 0;
+        this->sequence = 0;
+    }
+
+    void command_bucket_queue_t::push(command_bucket_t &bucket) {
+        if (bucket.empty()) {
+            bucket.clear();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(this->mtx);
+        command_bucket_t &slot = this->pending.emplace_back();
+        if (!this->spare.empty()) {
+            slot = std::move(this->spare.back());
+            this->spare.pop_back();
+        }
+        // The caller gets an empty bucket with capacity left over from an earlier frame
+        std::swap(slot, bucket);
+        bucket.clear();
+    }
+
+    size_t command_bucket_queue_t::submit(renderer_2d_i *ren) {
+        ROCKET_PROFILE_SCOPE("command_bucket_queue_t::submit");
+        {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            if (this->pending.empty()) {
+                return 0;
+            }
+            std::swap(this->drawing, this->pending);
+        }
+
+        // Merged in submission order, the sort is stable so ties keep it.
+        // Sequences are per bucket, each one's runs start after the buckets before it
+        this->entries.clear();
+        uint32_t sequence_base = 0;
+        for (uint32_t b = 0; b < this->drawing.size(); ++b) {
+            const std::vector<bucket_command_t> &commands = this->drawing[b].commands;
+            for (uint32_t i = 0; i < commands.size(); ++i) {
+                this->entries.push_back({ rebase_sequence(commands[i].key, sequence_base), b, i });
+            }
+            sequence_base = std::min(sequence_base + this->drawing[b].sequence + 1, sort_key_t::max_sequence);
+        }
+
+        // Culled draws never reach the sort or the backend
+        this->bounds.clear();
+        this->bounds.reserve(this->entries.size());
+        for (const entry_t &e : this->entries) {
+            const bucket_command_t &c = this->drawing[e.bucket].commands[e.index];
+            this->bounds.push(command_bounds(c), command_rotation(c));
+        }
+        ren->cull_visible(this->bounds, this->visible);
+        if (this->visible.size() != this->entries.size()) {
+            for (size_t i = 0; i < this->visible.size(); ++i) {
+                this->entries[i] = this->entries[this->visible[i]];
+            }
+            this->entries.resize(this->visible.size());
+        }
+        radix_sort_by_key(this->entries, this->scratch);
+
+        render_cache_t *active = nullptr;
+        for (const entry_t &e : this->entries) {
+            const command_bucket_t &bucket = this->drawing[e.bucket];
+            const bucket_command_t &c = bucket.commands[e.index];
+
+            render_cache_t *target = bucket.targets[c.target];
+            if (target != active) {
+                if (active != nullptr) {
+                    ren->end_render_cache(active);
+                }
+                if (target != nullptr) {
+                    ren->begin_render_cache(target);
+                }
+                active = target;
+            }
+
+            switch (c.op) {
+                case bucket_op_t::rectangle:
+                    ren->draw_rectangle(c.rect, c.color, c.f0, c.f1, c.flag != 0);
+                    break;
+                case bucket_op_t::circle:
+                    ren->draw_circle(c.a, c.f0, c.color, c.ival);
+                    break;
+                case bucket_op_t::polygon:
+                    ren->draw_polygon(c.a, c.f0, c.color, c.ival, c.f1);
+                    break;
+                case bucket_op_t::texture:
+                    ren->draw_texture(bucket.textures[c.ref], c.rect, c.f0, c.f1);
+                    break;
+                case bucket_op_t::atlas_texture:
+                    ren->draw_atlas_texture(bucket.textures[c.ref], c.rect, c.a, c.b, c.f0, c.f1);
+                    break;
+                case bucket_op_t::text:
+                    ren->draw_text(bucket.texts[c.ref], c.a);
+                    break;
+                case bucket_op_t::pixel:
+                    ren->draw_pixel(c.a, c.color);
+                    break;
+                case bucket_op_t::render_cache:
+                    ren->draw_render_cache(bucket.caches[c.ref], c.rect);
+                    break;
+            }
+        }
+        if (active != nullptr) {
+            ren->end_render_cache(active);
+        }
+
+        const size_t submitted = this->entries.size();
+        std::lock_guard<std::mutex> lock(this->mtx);
+        for (command_bucket_t &bucket : this->drawing) {
+            bucket.clear();
+            this->spare.push_back(std::move(bucket));
+        }
+        this->drawing.clear();
+        return submitted;
+    }
+
+    void renderer_2d_i::submit_bucket(command_bucket_t &bucket) {
+        this->command_buckets.push(bucket);
+    }
+
+    void renderer_2d_i::flush_command_buckets() {
+        this->command_buckets.submit(this);
+    }
+}
@@ -0,0 +1,288 @@
+#include "rocket/culling.hpp"
+#include "rocket/macros.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/renderer.hpp"
+#include "rgl.hpp"
+#include <bit>
+#include <cmath>
+
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+#include <emmintrin.h>
+#define ROCKETGE__CULL_SSE2
+#if defined(__GNUC__)
+#include <immintrin.h>
+#define ROCKETGE__CULL_AVX2
+#endif
+#elif defined(ROCKETGE__Architecture_arm64)
+#include <arm_neon.h>
+#define ROCKETGE__CULL_NEON
+#endif
+
+namespace rocket {
+    namespace {
+        /// @brief View edges, a rect is visible if x < right && x + w > left (same for y)
+        struct cull_view_t {
+            float left;
+            float top;
+            float right;
+            float bottom;
+        };
+
+        cull_view_t make_view(fbounding_box view) {
+            return { view.pos.x, view.pos.y, view.pos.x + view.size.x, view.pos.y + view.size.y };
+        }
+
+        size_t cull_scalar(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t begin, size_t count, const cull_view_t &v, uint32_t *out, size_t n) {
+            for (size_t i = begin; i < count; ++i) {
+                float bx = x[i];
+                float by = y[i];
+                float bw = w[i];
+                float bh = h[i];
+                if (rotation != nullptr && rotation[i] != 0.f) {
+                    const float half = 0.5f * std::sqrt(bw * bw + bh * bh);
+                    const float cx = bx + bw * 0.5f;
+                    const float cy = by + bh * 0.5f;
+                    bx = cx - half;
+                    by = cy - half;
+                    bw = half + half;
+                    bh = bw;
+                }
+                if (bx < v.right && bx + bw > v.left && by < v.bottom && by + bh > v.top) {
+                    out[n++] = static_cast<uint32_t>(i);
+                }
+            }
+            return n;
+        }
+
+        /// @brief Append base + every set bit of mask
+        inline size_t compact(uint32_t mask, size_t base, uint32_t *out, size_t n) {
+            while (mask != 0) {
+                out[n++] = static_cast<uint32_t>(base + static_cast<size_t>(std::countr_zero(mask)));
+                mask &= mask - 1;
+            }
+            return n;
+        }
+
+#ifdef ROCKETGE__CULL_SSE2
+        size_t cull_sse2(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, const cull_view_t &v, uint32_t *out) {
+            const __m128 left = _mm_set1_ps(v.left);
+            const __m128 top = _mm_set1_ps(v.top);
+            const __m128 right = _mm_set1_ps(v.right);
+            const __m128 bottom = _mm_set1_ps(v.bottom);
+            const __m128 half_one = _mm_set1_ps(0.5f);
+            const __m128 zero = _mm_setzero_ps();
+
+            size_t n = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 bx = _mm_loadu_ps(x + i);
+                __m128 by = _mm_loadu_ps(y + i);
+                __m128 bw = _mm_loadu_ps(w + i);
+                __m128 bh = _mm_loadu_ps(h + i);
+                if (rotation != nullptr) {
+                    const __m128 rotated = _mm_cmpneq_ps(_mm_loadu_ps(rotation + i), zero);
+                    if (_mm_movemask_ps(rotated) != 0) {
+                        const __m128 half = _mm_mul_ps(half_one, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(bw, bw), _mm_mul_ps(bh, bh))));
+                        const __m128 rx = _mm_sub_ps(_mm_add_ps(bx, _mm_mul_ps(bw, half_one)), half);
+                        const __m128 ry = _mm_sub_ps(_mm_add_ps(by, _mm_mul_ps(bh, half_one)), half);
+                        const __m128 rs = _mm_add_ps(half, half);
+                        // No blendv before SSE4.1
+                        bx = _mm_or_ps(_mm_and_ps(rotated, rx), _mm_andnot_ps(rotated, bx));
+                        by = _mm_or_ps(_mm_and_ps(rotated, ry), _mm_andnot_ps(rotated, by));
+                        bw = _mm_or_ps(_mm_and_ps(rotated, rs), _mm_andnot_ps(rotated, bw));
+                        bh = _mm_or_ps(_mm_and_ps(rotated, rs), _mm_andnot_ps(rotated, bh));
+                    }
+                }
+                __m128 visible = _mm_and_ps(_mm_cmplt_ps(bx, right), _mm_cmpgt_ps(_mm_add_ps(bx, bw), left));
+                visible = _mm_and_ps(visible, _mm_cmplt_ps(by, bottom));
+                visible = _mm_and_ps(visible, _mm_cmpgt_ps(_mm_add_ps(by, bh), top));
+                n = compact(static_cast<uint32_t>(_mm_movemask_ps(visible)), i, out, n);
+            }
+            return cull_scalar(x, y, w, h, rotation, i, count, v, out, n);
+        }
+#endif
+
+#ifdef ROCKETGE__CULL_AVX2
+        __attribute__((target("avx2")))
+        size_t cull_avx2(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, const cull_view_t &v, uint32_t *out) {
+            const __m256 left = _mm256_set1_ps(v.left);
+            const __m256 top = _mm256_set1_ps(v.top);
+            const __m256 right = _mm256_set1_ps(v.right);
+            const __m256 bottom = _mm256_set1_ps(v.bottom);
+            const __m256 half_one = _mm256_set1_ps(0.5f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            size_t n = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 bx = _mm256_loadu_ps(x + i);
+                __m256 by = _mm256_loadu_ps(y + i);
+                __m256 bw = _mm256_loadu_ps(w + i);
+                __m256 bh = _mm256_loadu_ps(h + i);
+                if (rotation != nullptr) {
+                    const __m256 rotated = _mm256_cmp_ps(_mm256_loadu_ps(rotation + i), zero, _CMP_NEQ_UQ);
+                    if (_mm256_movemask_ps(rotated) != 0) {
+                        const __m256 half = _mm256_mul_ps(half_one, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(bw, bw), _mm256_mul_ps(bh, bh))));
+                        const __m256 rs = _mm256_add_ps(half, half);
+                        bx = _mm256_blendv_ps(bx, _mm256_sub_ps(_mm256_add_ps(bx, _mm256_mul_ps(bw, half_one)), half), rotated);
+                        by = _mm256_blendv_ps(by, _mm256_sub_ps(_mm256_add_ps(by, _mm256_mul_ps(bh, half_one)), half), rotated);
+                        bw = _mm256_blendv_ps(bw, rs, rotated);
+                        bh = _mm256_blendv_ps(bh, rs, rotated);
+                    }
+                }
+                __m256 visible = _mm256_and_ps(_mm256_cmp_ps(bx, right, _CMP_LT_OQ), _mm256_cmp_ps(_mm256_add_ps(bx, bw), left, _CMP_GT_OQ));
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(by, bottom, _CMP_LT_OQ));
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(by, bh), top, _CMP_GT_OQ));
+                n = compact(static_cast<uint32_t>(_mm256_movemask_ps(visible)), i, out, n);
+            }
+            return cull_scalar(x, y, w, h, rotation, i, count, v, out, n);
+        }
+#endif
+
+#ifdef ROCKETGE__CULL_NEON
+        size_t cull_neon(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, const cull_view_t &v, uint32_t *out) {
+            const float32x4_t left = vdupq_n_f32(v.left);
+            const float32x4_t top = vdupq_n_f32(v.top);
+            const float32x4_t right = vdupq_n_f32(v.right);
+            const float32x4_t bottom = vdupq_n_f32(v.bottom);
+            const float32x4_t half_one = vdupq_n_f32(0.5f);
+            const uint32_t lane_bits_data[4] = { 1, 2, 4, 8 };
+            const uint32x4_t lane_bits = vld1q_u32(lane_bits_data);
+
+            size_t n = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                float32x4_t bx = vld1q_f32(x + i);
+                float32x4_t by = vld1q_f32(y + i);
+                float32x4_t bw = vld1q_f32(w + i);
+                float32x4_t bh = vld1q_f32(h + i);
+                if (rotation != nullptr) {
+                    const uint32x4_t rotated = vmvnq_u32(vceqzq_f32(vld1q_f32(rotation + i)));
+                    if (vmaxvq_u32(rotated) != 0) {
+                        const float32x4_t half = vmulq_f32(half_one, vsqrtq_f32(vaddq_f32(vmulq_f32(bw, bw), vmulq_f32(bh, bh))));
+                        const float32x4_t rs = vaddq_f32(half, half);
+                        bx = vbslq_f32(rotated, vsubq_f32(vaddq_f32(bx, vmulq_f32(bw, half_one)), half), bx);
+                        by = vbslq_f32(rotated, vsubq_f32(vaddq_f32(by, vmulq_f32(bh, half_one)), half), by);
+                        bw = vbslq_f32(rotated, rs, bw);
+                        bh = vbslq_f32(rotated, rs, bh);
+                    }
+                }
+                uint32x4_t visible = vandq_u32(vcltq_f32(bx, right), vcgtq_f32(vaddq_f32(bx, bw), left));
+                visible = vandq_u32(visible, vcltq_f32(by, bottom));
+                visible = vandq_u32(visible, vcgtq_f32(vaddq_f32(by, bh), top));
+                n = compact(vaddvq_u32(vandq_u32(visible, lane_bits)), i, out, n);
+            }
+            return cull_scalar(x, y, w, h, rotation, i, count, v, out, n);
+        }
+#endif
+
+        using cull_fn = size_t (*)(const float *, const float *, const float *, const float *, const float *, size_t, const cull_view_t &, uint32_t *);
+
+        size_t cull_scalar_all(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, const cull_view_t &v, uint32_t *out) {
+            return cull_scalar(x, y, w, h, rotation, 0, count, v, out, 0);
+        }
+
+        [[nodiscard]] cull_fn pick_cull() {
+#ifdef ROCKETGE__CULL_AVX2
+            if (__builtin_cpu_supports("avx2")) {
+                return cull_avx2;
+            }
+#endif
+#if defined(ROCKETGE__CULL_SSE2)
+            return cull_sse2;
+#elif defined(ROCKETGE__CULL_NEON)
+            return cull_neon;
+#else
+            return cull_scalar_all;
+#endif
+        }
+
+        cull_fn cull_impl = pick_cull();
+    }
+
+    bool set_cull_path(cull_path_t path) {
+        switch (path) {
+            case cull_path_t::automatic:
+                cull_impl = pick_cull();
+                return true;
+            case cull_path_t::scalar:
+                cull_impl = cull_scalar_all;
+                return true;
+            case cull_path_t::sse2:
+#ifdef ROCKETGE__CULL_SSE2
+                cull_impl = cull_sse2;
+                return true;
+#else
+                return false;
+#endif
+            case cull_path_t::avx2:
+#ifdef ROCKETGE__CULL_AVX2
+                if (__builtin_cpu_supports("avx2")) {
+                    cull_impl = cull_avx2;
+                    return true;
+                }
+#endif
+                return false;
+            case cull_path_t::neon:
+#ifdef ROCKETGE__CULL_NEON
+                cull_impl = cull_neon;
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    void cull_soa_t::push(fbounding_box rect, float rotation) {
+        this->x.push_back(rect.pos.x);
+        this->y.push_back(rect.pos.y);
+        this->w.push_back(rect.size.x);
+        this->h.push_back(rect.size.y);
+        if (rotation != 0.f && this->rotation.empty()) {
+            this->rotation.resize(this->x.size() - 1, 0.f);
+        }
+        if (!this->rotation.empty()) {
+            this->rotation.push_back(rotation);
+        }
+    }
+
+    void cull_soa_t::reserve(size_t count) {
+        this->x.reserve(count);
+        this->y.reserve(count);
+        this->w.reserve(count);
+        this->h.reserve(count);
+    }
+
+    void cull_soa_t::clear() {
+        this->x.clear();
+        this->y.clear();
+        this->w.clear();
+        this->h.clear();
+        this->rotation.clear();
+    }
+
+    size_t cull_rects(const float *x, const float *y, const float *w, const float *h, const float *rotation, size_t count, fbounding_box view, uint32_t *out) {
+        return cull_impl(x, y, w, h, rotation, count, make_view(view), out);
+    }
+
+    void cull_rects(const cull_soa_t &bounds, fbounding_box view, std::vector<uint32_t> &visible) {
+        visible.resize(bounds.size());
+        const float *rotation = bounds.rotation.empty() ? nullptr : bounds.rotation.data();
+        const size_t n = cull_rects(bounds.x.data(), bounds.y.data(), bounds.w.data(), bounds.h.data(), rotation, bounds.size(), view, visible.data());
+        visible.resize(n);
+    }
+
+    void renderer_2d_i::cull_visible(const cull_soa_t &bounds, std::vector<uint32_t> &visible) {
+        ROCKET_PROFILE_SCOPE("renderer_2d_i::cull_visible");
+        if (!this->get_graphics_settings().viewport_culling) {
+            visible.resize(bounds.size());
+            for (size_t i = 0; i < visible.size(); ++i) {
+                visible[i] = static_cast<uint32_t>(i);
+            }
+            return;
+        }
+        cull_rects(bounds, this->get_culling_bounds(), visible);
+        rgl::add_frame_metrics_data_skipped_drawcalls(static_cast<int>(bounds.size() - visible.size()));
+    }
+}
@@ -0,0 +1,62 @@
+#include "rocket/dynamic_resolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace rocket {
+    namespace {
+        /// @brief Load the scale aims for after going over budget
+        constexpr float target_load = 0.85f;
+        /// @brief Over this the scale drops
+        constexpr float high_load = 0.95f;
+        /// @brief Under this for long enough the scale rises
+        constexpr float low_load = 0.7f;
+        /// @brief Weight of a new frame in the smoothed load
+        constexpr float smoothing = 0.25f;
+    }
+
+    float dynamic_resolution_controller_t::update(float frame_time, float budget, float min_scale, float max_scale) {
+        const float lo = std::clamp(min_scale, step, 1.f);
+        const float hi = std::clamp(max_scale, lo, 1.f);
+        float target = std::clamp(this->scale, lo, hi);
+
+        if (budget > 0.f && frame_time > 0.f && this->cooldown_frames == 0) {
+            const float sample = frame_time / budget;
+            this->load = this->load < 0.f ? sample : this->load + (sample - this->load) * smoothing;
+
+            if (this->load > high_load) {
+                this->headroom_frames = 0;
+                // Pixel count is the square of the scale
+                target = std::floor(this->scale * std::sqrt(target_load / this->load) / step) * step;
+                target = std::clamp(std::min(target, this->scale - step), lo, hi);
+            } else if (this->load < low_load) {
+                if (++this->headroom_frames >= headroom) {
+                    this->headroom_frames = 0;
+                    if (this->scale * std::sqrt(target_load / this->load) >= this->scale + step) {
+                        target = std::clamp(this->scale + step, lo, hi);
+                    }
+                }
+            } else {
+                this->headroom_frames = 0;
+            }
+        } else if (this->cooldown_frames > 0) {
+            this->cooldown_frames--;
+        }
+
+        if (target != this->scale) {
+            if (this->load > 0.f) {
+                const float ratio = target / this->scale;
+                this->load *= ratio * ratio;
+            }
+            this->scale = target;
+            this->cooldown_frames = cooldown;
+        }
+        return this->scale;
+    }
+
+    void dynamic_resolution_controller_t::reset(float scale) {
+        this->scale = scale;
+        this->load = -1.f;
+        this->headroom_frames = 0;
+        this->cooldown_frames = 0;
+    }
+}
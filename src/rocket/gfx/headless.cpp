@@ -0,0 +1,206 @@
+#include "rocket/headless.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/runtime.hpp"
+#include "lib/stb/stb_image.h"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <miniz.h>
+
+namespace rocket {
+    headless_renderer_t::headless_renderer_t(rocket::vec2i_t size, renderer_flags_t flags)
+        : window(size, "RocketGE - Headless"),
+          renderer(&window, rocket::cst::fps_uncapped, flags) {
+    }
+
+    std::vector<rgba_color> headless_renderer_t::render(int frames, const std::function<void(renderer_2d_i *ren, uint64_t frame)> &draw) {
+        ROCKET_PROFILE_SCOPE("headless_renderer_t::render");
+        std::vector<rgba_color> pixels;
+        for (int i = 0; i < frames; ++i) {
+            renderer.begin_frame();
+            draw(&renderer, static_cast<uint64_t>(i));
+            if (i == frames - 1) {
+                pixels = renderer.get_framebuffer();
+            }
+            renderer.end_frame();
+            window.poll_events();
+        }
+        return pixels;
+    }
+
+    image_diff_t compare_images(const std::vector<rgba_color> &expected, const std::vector<rgba_color> &actual, rocket::vec2i_t size, int channel_tolerance) {
+        image_diff_t diff;
+        const size_t count = static_cast<size_t>(std::max(size.x, 0)) * std::max(size.y, 0);
+        if (expected.size() != count || actual.size() != count) {
+            diff.size_mismatch = true;
+            return diff;
+        }
+
+        uint64_t abs_sum = 0;
+        uint64_t sq_sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t *a = &expected[i].x;
+            const uint8_t *b = &actual[i].x;
+            int pixel_error = 0;
+            for (int c = 0; c < 4; ++c) {
+                const int d = std::abs(static_cast<int>(a[c]) - static_cast<int>(b[c]));
+                pixel_error = std::max(pixel_error, d);
+                abs_sum += d;
+                sq_sum += static_cast<uint64_t>(d) * d;
+            }
+            diff.max_channel_error = std::max(diff.max_channel_error, pixel_error);
+            if (pixel_error > channel_tolerance) {
+                diff.differing_pixels++;
+            }
+        }
+
+        const double samples = static_cast<double>(count) * 4.0;
+        if (samples > 0.0) {
+            diff.mean_error = static_cast<double>(abs_sum) / samples;
+            const double mse = static_cast<double>(sq_sum) / samples;
+            diff.psnr = mse == 0.0
+                ? std::numeric_limits<double>::infinity()
+                : 10.0 * std::log10((255.0 * 255.0) / mse);
+        }
+        return diff;
+    }
+
+    bool write_image(const std::string &path, const std::vector<rgba_color> &pixels, rocket::vec2i_t size) {
+        if (pixels.size() != static_cast<size_t>(std::max(size.x, 0)) * std::max(size.y, 0)) {
+            rocket::log("pixel count does not match the size: " + path, "headless", "write_image", "error");
+            return false;
+        }
+        std::filesystem::path fs_path(path);
+        if (fs_path.has_parent_path()) {
+            std::error_code ec;
+            std::filesystem::create_directories(fs_path.parent_path(), ec);
+        }
+
+        std::ofstream file(fs_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            rocket::log("failed to open " + path, "headless", "write_image", "error");
+            return false;
+        }
+
+        if (fs_path.extension() == ".png") {
+            size_t png_size = 0;
+            void *png = tdefl_write_image_to_png_file_in_memory(pixels.data(), size.x, size.y, 4, &png_size);
+            if (png == nullptr) {
+                rocket::log("failed to encode " + path, "miniz", "tdefl_write_image_to_png_file_in_memory", "error");
+                return false;
+            }
+            file.write(static_cast<const char *>(png), static_cast<std::streamsize>(png_size));
+            mz_free(png);
+        } else {
+            // rgba_color is tightly packed RGBA8
+            file.write(reinterpret_cast<const char *>(pixels.data()), static_cast<std::streamsize>(pixels.size() * sizeof(rgba_color)));
+        }
+        return file.good();
+    }
+
+    bool read_image(const std::string &path, std::vector<rgba_color> &pixels, rocket::vec2i_t &size) {
+        int width = 0, height = 0, channels = 0;
+        stbi_uc *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (data == nullptr) {
+            return false;
+        }
+        size = { width, height };
+        pixels.resize(static_cast<size_t>(width) * height);
+        std::memcpy(pixels.data(), data, pixels.size() * sizeof(rgba_color));
+        stbi_image_free(data);
+        return true;
+    }
+
+    /// @brief Differing pixels in red over a faded copy of the expected image
+    static std::vector<rgba_color> make_diff_image(const std::vector<rgba_color> &expected, const std::vector<rgba_color> &actual, int channel_tolerance) {
+        std::vector<rgba_color> out(expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            const uint8_t *a = &expected[i].x;
+            const uint8_t *b = &actual[i].x;
+            int pixel_error = 0;
+            for (int c = 0; c < 4; ++c) {
+                pixel_error = std::max(pixel_error, std::abs(static_cast<int>(a[c]) - static_cast<int>(b[c])));
+            }
+            if (pixel_error > channel_tolerance) {
+                out[i] = { 255, 0, 0, 255 };
+            } else {
+                const uint8_t grey = static_cast<uint8_t>((expected[i].x + expected[i].y + expected[i].z) / 12);
+                out[i] = { grey, grey, grey, 255 };
+            }
+        }
+        return out;
+    }
+
+    bool check_golden(
+        const std::string &golden_dir,
+        const std::string &name,
+        const std::vector<rgba_color> &pixels,
+        rocket::vec2i_t size,
+        golden_tolerance_t tolerance,
+        image_diff_t *diff_out
+    ) {
+        const auto cli_args = util::get_clistate();
+        const std::string golden_path = (std::filesystem::path(golden_dir) / (name + ".png")).string();
+
+        std::vector<rgba_color> expected;
+        vec2i_t expected_size = { 0, 0 };
+        if (cli_args.update_golden) {
+            if (!write_image(golden_path, pixels, size)) {
+                return false;
+            }
+            rocket::log("recorded golden image " + golden_path, "headless", "check_golden", "info");
+            if (diff_out != nullptr) {
+                *diff_out = compare_images(pixels, pixels, size);
+            }
+            return true;
+        }
+
+        const std::filesystem::path output_dir = cli_args.golden_output.empty() ? "golden_output" : cli_args.golden_output;
+        if (!read_image(golden_path, expected, expected_size)) {
+            // Nothing to compare against is a failure, a missing file must not pass CI
+            write_image((output_dir / (name + ".actual.png")).string(), pixels, size);
+            rocket::log(name + ": no golden image at " + golden_path + ", record it with --update-golden", "headless", "check_golden", "error");
+            return false;
+        }
+
+        image_diff_t diff;
+        if (expected_size.x != size.x || expected_size.y != size.y) {
+            diff.size_mismatch = true;
+        } else {
+            diff = compare_images(expected, pixels, size, tolerance.channel_tolerance);
+        }
+        if (diff_out != nullptr) {
+            *diff_out = diff;
+        }
+
+        const size_t allowed = static_cast<size_t>(
+            static_cast<double>(tolerance.max_differing_ratio) * static_cast<double>(pixels.size())
+        );
+        const bool passed = !diff.size_mismatch && diff.differing_pixels <= allowed;
+        if (passed) {
+            return true;
+        }
+
+        write_image((output_dir / (name + ".actual.png")).string(), pixels, size);
+        if (diff.size_mismatch) {
+            rocket::log(
+                name + ": size " + std::to_string(size.x) + "x" + std::to_string(size.y)
+                    + " does not match the golden " + std::to_string(expected_size.x) + "x" + std::to_string(expected_size.y),
+                "headless", "check_golden", "error"
+            );
+        } else {
+            write_image((output_dir / (name + ".diff.png")).string(), make_diff_image(expected, pixels, tolerance.channel_tolerance), size);
+            rocket::log(
+                name + ": " + std::to_string(diff.differing_pixels) + " pixels differ (allowed " + std::to_string(allowed)
+                    + "), max error " + std::to_string(diff.max_channel_error) + ", psnr " + std::to_string(diff.psnr) + " dB",
+                "headless", "check_golden", "error"
+            );
+        }
+        return false;
+    }
+}
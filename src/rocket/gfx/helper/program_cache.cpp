@@ -0,0 +1,232 @@
+#include "rocket/macros.hpp"
+#if defined(ROCKETGE__Platform_Android)
+    #include <GLES3/gl32.h>
+#else
+    #include <lib/glad/glad.h>
+#endif
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "rocket/persistence.hpp"
+#include "rocket/rgl.hpp"
+#include "rocket/runtime.hpp"
+#include "rgl.hpp"
+
+namespace rgl {
+    namespace {
+        /// @brief "RGPB"
+        constexpr uint32_t program_cache_magic = 0x42504752;
+        constexpr uint32_t program_cache_version = 1;
+        /// @brief Larger entries are treated as corrupt
+        constexpr uint32_t program_cache_max_size = 64u << 20;
+
+        struct program_cache_header_t {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t key;
+            /// @brief Vendor, renderer and version string of the driver that wrote it
+            uint64_t driver;
+            uint32_t format;
+            uint32_t size;
+            uint64_t checksum;
+        };
+
+        std::filesystem::path cache_directory;
+        bool cache_directory_set = false;
+        /// @brief -1 until the driver was asked
+        int binaries_supported = -1;
+
+        uint64_t fnv1a(uint64_t hash, std::string_view data) {
+            for (unsigned char c : data) {
+                hash = (hash ^ c) * 1099511628211ull;
+            }
+            // Separator, so "ab" + "c" and "a" + "bc" differ
+            return (hash ^ 0xff) * 1099511628211ull;
+        }
+
+        constexpr uint64_t fnv1a_basis = 14695981039346656037ull;
+
+        const std::filesystem::path &directory() {
+            if (!cache_directory_set) {
+                cache_directory = rocket::storage::get_storage_path() / "shader_cache";
+                cache_directory_set = true;
+            }
+            return cache_directory;
+        }
+
+        bool available() {
+            if (binaries_supported < 0) {
+                binaries_supported = 0;
+#ifdef ROCKETGE__Platform_Desktop
+                // Core since GL 4.1 only
+                if (glProgramBinary != nullptr && glGetProgramBinary != nullptr && glProgramParameteri != nullptr)
+#endif
+                {
+                    GLint formats = 0;
+                    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+                    binaries_supported = formats > 0 ? 1 : 0;
+                }
+                if (binaries_supported == 0) {
+                    rocket::log("Driver has no program binary formats, shaders compile from source", "rgl", "program_cache", "debug");
+                }
+            }
+            return binaries_supported == 1 && !directory().empty();
+        }
+
+        std::filesystem::path entry_path(uint64_t key) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+            return directory() / name;
+        }
+
+        void drop(const std::filesystem::path &path, const std::string &why) {
+            rocket::log("Dropping cached program " + path.filename().string() + ": " + why, "rgl", "program_cache", "debug");
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    uint64_t program_cache_driver() {
+        static const uint64_t hash = [] {
+            uint64_t h = fnv1a_basis;
+            for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+                const char *value = reinterpret_cast<const char *>(glGetString(name));
+                h = fnv1a(h, value != nullptr ? value : "");
+            }
+            return h;
+        }();
+        return hash;
+    }
+
+    uint64_t program_cache_key(std::string_view vs, std::string_view fs, std::string_view rlsl_version, uint64_t driver) {
+        uint64_t h = fnv1a(fnv1a_basis, rlsl_version);
+        h = fnv1a(h, vs);
+        h = fnv1a(h, fs);
+        return fnv1a(h, { reinterpret_cast<const char *>(&driver), sizeof(driver) });
+    }
+
+    bool program_cache_write(std::ostream &out, uint64_t key, uint64_t driver, uint32_t format, const std::vector<char> &binary) {
+        const program_cache_header_t header = {
+            .magic = program_cache_magic,
+            .version = program_cache_version,
+            .key = key,
+            .driver = driver,
+            .format = format,
+            .size = static_cast<uint32_t>(binary.size()),
+            .checksum = fnv1a(fnv1a_basis, { binary.data(), binary.size() }),
+        };
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+        return static_cast<bool>(out);
+    }
+
+    std::string program_cache_read(std::istream &in, uint64_t key, uint64_t driver, uint32_t &format, std::vector<char> &binary) {
+        program_cache_header_t header = {};
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!in || header.magic != program_cache_magic || header.version != program_cache_version || header.key != key) {
+            return "bad header";
+        }
+        if (header.driver != driver) {
+            // Key collision or a hand-copied file, the key already covers the driver
+            return "written by another driver";
+        }
+        if (header.size == 0 || header.size > program_cache_max_size) {
+            return "bad size";
+        }
+        binary.resize(header.size);
+        in.read(binary.data(), header.size);
+        if (!in || fnv1a(fnv1a_basis, { binary.data(), binary.size() }) != header.checksum) {
+            return "truncated or corrupt";
+        }
+        format = header.format;
+        return {};
+    }
+
+    shader_program_t program_cache_load(uint64_t key) {
+        if (!available()) {
+            return 0;
+        }
+        const std::filesystem::path path = entry_path(key);
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) {
+            return 0;
+        }
+
+        uint32_t format = 0;
+        std::vector<char> blob;
+        if (std::string why = program_cache_read(f, key, program_cache_driver(), format, blob); !why.empty()) {
+            drop(path, why);
+            return 0;
+        }
+
+        shader_program_t pg = glCreateProgram();
+        glProgramBinary(pg, format, blob.data(), static_cast<GLsizei>(blob.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(pg, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            glDeleteProgram(pg);
+            drop(path, "rejected by the driver");
+            return 0;
+        }
+        return pg;
+    }
+
+    void program_cache_prepare(shader_program_t pg) {
+        if (available()) {
+            glProgramParameteri(pg, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+    }
+
+    void program_cache_store(uint64_t key, shader_program_t pg) {
+        if (!available()) {
+            return;
+        }
+        GLint length = 0;
+        glGetProgramiv(pg, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0 || static_cast<uint32_t>(length) > program_cache_max_size) {
+            return;
+        }
+        std::vector<char> blob(length);
+        GLsizei written = 0;
+        GLenum format = 0;
+        glGetProgramBinary(pg, length, &written, &format, blob.data());
+        if (written <= 0) {
+            return;
+        }
+        blob.resize(written);
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory(), ec);
+        if (ec) {
+            rocket::log("Program cache directory could not be created: " + ec.message(), "rgl", "program_cache_store", "warning");
+            return;
+        }
+
+        // Written aside and renamed, a crash never leaves half an entry
+        const std::filesystem::path path = entry_path(key);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream f(temp, std::ios::binary | std::ios::trunc);
+            if (!program_cache_write(f, key, program_cache_driver(), static_cast<uint32_t>(format), blob)) {
+                f.close();
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+        }
+    }
+
+    void set_program_cache_path(const std::string &path) {
+        cache_directory = path;
+        cache_directory_set = true;
+    }
+}
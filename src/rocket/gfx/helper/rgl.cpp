@@ -1,3 +1,6 @@
+#include <array>
+#include <cmath>
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <thread>
@@ -9,6 +12,7 @@
     #include <lib/glad/glad.h>
 #endif
 #include <glm/ext/vector_float2.hpp>
+#include <fstream>
 #include <iostream>
 #include "rgl.hpp"
 #include <glm/ext/matrix_clip_space.hpp>
@@ -26,6 +30,7 @@
 #include "rocket/window.hpp"
 #include "util.hpp"
 #include "glfnldr.hpp"
+#include <native.hpp>
 #ifdef ROCKETGE__Platform_Linux
 #include <cpuid.h>
 #else
@@ -161,6 +166,12 @@ namespace rgl {
     rocket::vec2f_t viewport_offset = { 0, 0 };
     int max_tx_size = 0;
 
+    /// @brief rocket_camera uniform block, projection * view of every built-in shader
+    GLuint camera_ubo = 0;
+    glm::mat4 camera_view = glm::mat4(1.0f);
+    rocket::vec2f_t camera_ubo_viewport = { -1, -1 };
+    static void init_camera_block();
+
     rocket::native_window_t *gl_main_ctx;
 
     rocket::native_window_t *get_main_context() {
@@ -393,6 +404,43 @@ namespace rgl {
         glfnldr::init(ROCKETGE__GLFNLDR_BACKEND_ENUM);
         glViewport(0, 0, viewport_size.x, viewport_size.y);
         init_vo_all();
+        init_camera_block();
+    }
+
+    /// @brief GL_COMPLETION_STATUS_KHR, the ARB extension uses the same value
+    constexpr GLenum gl_completion_status = 0x91B1;
+    static bool parallel_shader_compile = false;
+
+    static bool init_parallel_shader_compile(int extension_count) {
+        const char *hint = nullptr;
+        for (int i = 0; i < extension_count && hint == nullptr; ++i) {
+            const char *ext = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+            if (ext == nullptr) {
+                continue;
+            }
+            if (std::strcmp(ext, "GL_KHR_parallel_shader_compile") == 0) {
+                hint = "glMaxShaderCompilerThreadsKHR";
+            } else if (std::strcmp(ext, "GL_ARB_parallel_shader_compile") == 0) {
+                hint = "glMaxShaderCompilerThreadsARB";
+            }
+        }
+        if (hint == nullptr) {
+            return false;
+        }
+
+        // Not in the loader, fetched by hand. Drivers pick a thread count without it
+        using max_shader_compiler_threads_fn = void (*)(GLuint);
+        max_shader_compiler_threads_fn max_threads = nullptr;
+#if defined(ROCKETGE__Platform_Android)
+        max_threads = reinterpret_cast<max_shader_compiler_threads_fn>(eglGetProcAddress(hint));
+#elif defined(ROCKETGE__Platform_Desktop)
+        max_threads = reinterpret_cast<max_shader_compiler_threads_fn>(rnative::load_proc_address(hint));
+#endif
+        if (max_threads != nullptr) {
+            // As many as the driver allows
+            max_threads(0xFFFFFFFF);
+        }
+        return true;
     }
 
     static std::unordered_map<rgl::shader_use_t, rgl::shader_program_t> shader_cache;
@@ -422,6 +470,7 @@ namespace rgl {
 
         glViewport(0, 0, viewport_size.x, viewport_size.y);
         init_vo_all();
+        init_camera_block();
 
         while (glGetError() != GL_NO_ERROR) {};
 
@@ -510,6 +559,7 @@ namespace rgl {
         }
 
         int loaded_extensions = gl_get_integer(GL_NUM_EXTENSIONS);
+        parallel_shader_compile = init_parallel_shader_compile(loaded_extensions);
 
         std::string gpu_name = std::string(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
         std::string gpu_vendor = std::string(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
@@ -525,6 +575,7 @@ namespace rgl {
             "" + std::to_string(loaded_extensions) + " extensions loaded",
             "Multisampling: " + bool_to_str(gl_multisample) + (gl_samples > 0 ? (" (" + std::to_string(gl_samples) + "x)") : ""),
             "Context Verifier: " + bool_to_str(flags & GL_CONTEXT_FLAG_DEBUG_BIT),
+            "Parallel Shader Compile: " + bool_to_str(parallel_shader_compile),
             "GPU:",
             "  Name: " + gpu_name,
             "  Vendor: "  + gpu_vendor
@@ -601,13 +652,17 @@ namespace rgl {
     }
 
     fbo_t create_fbo() {
+        return create_fbo({ static_cast<int>(viewport_size.x), static_cast<int>(viewport_size.y) });
+    }
+
+    fbo_t create_fbo(rocket::vec2i_t size) {
         fbo_t fbo;
         glGenFramebuffers(1, &fbo.fbo);
         glBindFramebuffer(GL_FRAMEBUFFER, fbo.fbo);
 
         glGenTextures(1, &fbo.color_tex);
         glBindTexture(GL_TEXTURE_2D, fbo.color_tex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, viewport_size.x, viewport_size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -644,6 +699,11 @@ namespace rgl {
     }
 
     static rgl::shader_program_t load_shader_generic(const char *vsrc, const char *fsrc) {
+        const uint64_t key = program_cache_key(vsrc, fsrc, "", program_cache_driver());
+        if (rgl::shader_program_t cached = program_cache_load(key); cached != 0) {
+            return cached;
+        }
+
         GLuint vs = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vs, 1, &vsrc, nullptr);
         glCompileShader(vs);
@@ -675,6 +735,7 @@ namespace rgl {
         rgl::shader_program_t pg = glCreateProgram();
         glAttachShader(pg, vs);
         glAttachShader(pg, fs);
+        program_cache_prepare(pg);
         glLinkProgram(pg);
 
         glGetProgramiv(pg, GL_LINK_STATUS, &success);
@@ -684,7 +745,9 @@ namespace rgl {
             std::string log(logLen, '\0');
             glGetProgramInfoLog(pg, logLen, nullptr, log.data());
             rocket::log("Shader program link failed: " + log, "OpenGL", "ShaderCompiler", "error");
-        } 
+        } else {
+            program_cache_store(key, pg);
+        }
 
         glDeleteShader(vs);
         glDeleteShader(fs);
@@ -747,13 +810,11 @@ namespace rgl {
     ) {
         rgl::shader_program_t pg = init_shader(rgl::shader_use_t::rect);
 
-        glm::mat4 projection = glm::ortho(0.f, viewport_size.x, viewport_size.y, 0.f, -1.f, 1.f);
-
         float cx = pos.x + size.x * 0.5f;
         float cy = pos.y + size.y * 0.5f;
 
-        glm::mat4 transform = projection
-            * glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
+        // Model only, rocket_camera holds projection * view
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f))
             * glm::translate(glm::mat4(1.0f), glm::vec3(-size.x * 0.5f, -size.y * 0.5f, 0.0f))
             * glm::scale(glm::mat4(1.0f), glm::vec3(size.x, size.y, 1.0f));
@@ -777,13 +838,11 @@ namespace rgl {
     ) {
         rgl::shader_program_t pg = init_shader(rgl::shader_use_t::textured_rect);
 
-        glm::mat4 projection = glm::ortho(0.f, viewport_size.x, viewport_size.y, 0.f, -1.f, 1.f);
-
         float cx = pos.x + size.x * 0.5f;
         float cy = pos.y + size.y * 0.5f;
 
-        glm::mat4 transform = projection
-            * glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
+        // Model only, rocket_camera holds projection * view
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f))
             * glm::translate(glm::mat4(1.0f), glm::vec3(-size.x * 0.5f, -size.y * 0.5f, 0.0f))
             * glm::scale(glm::mat4(1.0f), glm::vec3(size.x, size.y, 1.0f));
@@ -856,9 +915,49 @@ namespace rgl {
         gl_draw_arrays(GL_TRIANGLES, 0, 6);
     }
 
+    static void upload_camera_block() {
+        if (camera_ubo == 0) {
+            return;
+        }
+        glm::mat4 view_projection = glm::ortho(0.f, viewport_size.x, viewport_size.y, 0.f, -1.f, 1.f) * camera_view;
+        glBindBuffer(GL_UNIFORM_BUFFER, camera_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(view_projection));
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        camera_ubo_viewport = viewport_size;
+    }
+
+    static void init_camera_block() {
+        glGenBuffers(1, &camera_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, camera_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, camera_block_binding, camera_ubo);
+        camera_view = glm::mat4(1.0f);
+        upload_camera_block();
+    }
+
+    void set_view_matrix(const glm::mat4 &view) {
+        camera_view = view;
+        upload_camera_block();
+    }
+
+    const glm::mat4 &get_view_matrix() {
+        return camera_view;
+    }
+
+    void bind_camera_block(shader_program_t pg) {
+        GLuint index = glGetUniformBlockIndex(pg, "rocket_camera");
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(pg, index, camera_block_binding);
+        }
+    }
+
     void update_viewport(const rocket::vec2f_t &size) {
         viewport_size = size;
         glViewport(0, 0, size.x, size.y);
+        if (!(camera_ubo_viewport == viewport_size)) {
+            upload_camera_block();
+        }
     }
 
     void update_viewport(const rocket::vec2f_t &offset, const rocket::vec2f_t &size) {
@@ -871,6 +970,9 @@ namespace rgl {
         int flipped_y = size.y - (offset.y + size.y);
 
         glViewport(offset.x, flipped_y, size.x, size.y);
+        if (!(camera_ubo_viewport == viewport_size)) {
+            upload_camera_block();
+        }
     }
 
     void gl_viewport(const rocket::vec2f_t &offset, const rocket::vec2f_t &size) {
@@ -901,6 +1003,14 @@ namespace rgl {
         glDrawArrays(mode, first, count);
     }
 
+    void gl_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+        add_frame_metrics_data_drawcalls(1);
+        // Strips and fans have count - 2 triangles, lists count / 3
+        const int tris = mode == GL_TRIANGLES ? count / 3 : std::max(count - 2, 0);
+        add_frame_metrics_data_tricount(tris * instances);
+        glDrawArraysInstanced(mode, first, count, instances);
+    }
+
     void run_all_scheduled_gl() {
         std::queue<std::function<void()>> local;
         {
@@ -987,6 +1097,27 @@ namespace rgl {
         rocket::shader_provider_compile_all_gl();
     }
 
+    void compile_all_default_shaders_async() {
+        rocket::shader_provider_submit_all_gl();
+    }
+
+    bool poll_default_shaders() {
+        return rocket::shader_provider_poll_gl();
+    }
+
+    bool is_parallel_shader_compile_supported() {
+        return parallel_shader_compile;
+    }
+
+    bool is_program_ready(shader_program_t pg) {
+        if (!parallel_shader_compile) {
+            return true;
+        }
+        GLint done = GL_FALSE;
+        glGetProgramiv(pg, gl_completion_status, &done);
+        return done == GL_TRUE;
+    }
+
     draw_metrics_t metrics;
 
     void update_draw_metrics_data(float frametime, float fps) {
@@ -1013,6 +1144,14 @@ namespace rgl {
         metrics.avg_frametime = metrics.avg_frametime + alpha * (frametime - metrics.avg_frametime);
     }
 
+    void update_pacing_metrics_data(float pacing_error) {
+        static float alpha = 0.1;
+
+        metrics.pacing_error = pacing_error;
+        metrics.avg_pacing_error = metrics.avg_pacing_error + alpha * (std::abs(pacing_error) - metrics.avg_pacing_error);
+        metrics.max_pacing_error = std::max(metrics.max_pacing_error, std::abs(pacing_error));
+    }
+
     frame_metrics_t fmetrics;
 
     void update_frame_metrics_data(frame_metrics_t metrics) {
@@ -1027,6 +1166,9 @@ namespace rgl {
     void add_frame_metrics_data_skipped_drawcalls(int n) {
         fmetrics.skipped_drawcalls += n;
     }
+    void add_frame_metrics_data_uploads(int n) {
+        fmetrics.uploads += n;
+    }
     frame_metrics_t get_frame_metrics() {
         return fmetrics;
     }
@@ -1034,6 +1176,313 @@ namespace rgl {
         fmetrics = {};
     }
 
+    constexpr size_t default_frame_history_capacity = 3600;
+
+    struct frame_history_t {
+        std::vector<frame_record_t> records = std::vector<frame_record_t>(default_frame_history_capacity);
+        size_t head = 0;
+        size_t count = 0;
+
+        std::ofstream export_file;
+        frame_export_format_t export_format = frame_export_format_t::csv;
+    };
+
+    static frame_history_t frame_history;
+
+    void set_frame_history_capacity(size_t frames) {
+        frame_history.records.assign(std::max<size_t>(1, frames), {});
+        frame_history.head = 0;
+        frame_history.count = 0;
+    }
+
+    void push_frame_record(const frame_record_t &record) {
+        auto &h = frame_history;
+        h.records[h.head] = record;
+        h.head = (h.head + 1) % h.records.size();
+        h.count = std::min(h.count + 1, h.records.size());
+
+        if (!h.export_file.is_open()) {
+            return;
+        }
+        if (h.export_format == frame_export_format_t::csv) {
+            h.export_file << record.frame << ',' << record.cpu_time * 1000.f << ',' << record.wait_time * 1000.f << ','
+                << record.drawcalls << ',' << record.tricount << ',' << record.skipped_drawcalls << ',' << record.uploads << '\n';
+        } else {
+            h.export_file << "{\"frame\":" << record.frame
+                << ",\"cpu_ms\":" << record.cpu_time * 1000.f
+                << ",\"wait_ms\":" << record.wait_time * 1000.f
+                << ",\"drawcalls\":" << record.drawcalls
+                << ",\"tricount\":" << record.tricount
+                << ",\"skipped_drawcalls\":" << record.skipped_drawcalls
+                << ",\"uploads\":" << record.uploads << "}\n";
+        }
+        // rocket::exit does not unwind, keep the file complete
+        h.export_file.flush();
+    }
+
+    static percentiles_t compute_percentiles(std::vector<float> &sorted) {
+        // Nearest rank
+        auto rank = [&sorted](float p) {
+            size_t i = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+            return sorted[std::clamp<size_t>(i, 1, sorted.size()) - 1];
+        };
+        return { rank(0.50f), rank(0.95f), rank(0.99f), sorted.back() };
+    }
+
+    frame_stats_t get_frame_stats(size_t window, float hitch_factor) {
+        const auto &h = frame_history;
+        frame_stats_t stats;
+        stats.frames = window == 0 ? h.count : std::min(window, h.count);
+        if (stats.frames == 0) {
+            return stats;
+        }
+
+        std::vector<float> cpu, total;
+        cpu.reserve(stats.frames);
+        total.reserve(stats.frames);
+        for (size_t i = 0; i < stats.frames; ++i) {
+            const frame_record_t &r = h.records[(h.head + h.records.size() - 1 - i) % h.records.size()];
+            cpu.push_back(r.cpu_time);
+            total.push_back(r.cpu_time + r.wait_time);
+        }
+
+        std::sort(cpu.begin(), cpu.end());
+        std::sort(total.begin(), total.end());
+        stats.cpu_time = compute_percentiles(cpu);
+        stats.frame_time = compute_percentiles(total);
+
+        size_t slowest = std::max<size_t>(1, total.size() / 100);
+        double slowest_sum = 0;
+        for (size_t i = total.size() - slowest; i < total.size(); ++i) {
+            slowest_sum += total[i];
+        }
+        stats.low_1_percent_fps = slowest_sum > 0 ? static_cast<float>(static_cast<double>(slowest) / slowest_sum) : 0.f;
+
+        const float hitch_threshold = stats.frame_time.p50 * hitch_factor;
+        stats.hitches = static_cast<int>(total.end() - std::upper_bound(total.begin(), total.end(), hitch_threshold));
+        return stats;
+    }
+
+    bool start_frame_export(const std::string &path, frame_export_format_t format) {
+        stop_frame_export();
+
+        frame_history.export_file.open(path, std::ios::trunc);
+        if (!frame_history.export_file) {
+            rocket::log("failed to open frame metrics file: " + path, "rgl", "start_frame_export", "error");
+            return false;
+        }
+
+        frame_history.export_format = format;
+        if (format == frame_export_format_t::csv) {
+            frame_history.export_file << "frame,cpu_ms,wait_ms,drawcalls,tricount,skipped_drawcalls,uploads\n";
+        }
+        return true;
+    }
+
+    void stop_frame_export() {
+        if (frame_history.export_file.is_open()) {
+            frame_history.export_file.close();
+        }
+    }
+
+    // GPU timing uses GL_TIMESTAMP counters rather than GL_TIME_ELAPSED, elapsed
+    // queries can not nest. Each frame slot owns its query objects and is only
+    // reused once its results were read, a slot still in flight drops the frame.
+    constexpr size_t gpu_timer_frames_in_flight = 4;
+    constexpr uint32_t gpu_timer_open_region = ~0u;
+
+    struct gpu_timer_region_t {
+        const char *name = nullptr;
+        uint32_t begin = 0;
+        uint32_t end = gpu_timer_open_region;
+    };
+
+    struct gpu_timer_frame_t {
+        uint64_t frame = 0;
+        bool pending = false;
+        std::vector<GLuint> queries;
+        uint32_t used = 0;
+        /// @brief Region 0 is the whole frame
+        std::vector<gpu_timer_region_t> regions;
+        std::vector<size_t> open;
+    };
+
+    struct gpu_timer_t {
+        bool enabled = false;
+        bool in_frame = false;
+        size_t current = 0;
+        std::array<gpu_timer_frame_t, gpu_timer_frames_in_flight> frames;
+        std::vector<GLuint64> results;
+    };
+
+    static gpu_timer_t gpu_timer;
+
+    static bool gpu_timer_supported() {
+#ifdef ROCKETGE__Platform_Android
+        // GLES only has EXT_disjoint_timer_query
+        return false;
+#else
+        return glQueryCounter != nullptr && glGetQueryObjectui64v != nullptr;
+#endif
+    }
+
+    static uint32_t gpu_timer_timestamp(gpu_timer_frame_t &slot) {
+#ifndef ROCKETGE__Platform_Android
+        if (slot.used == slot.queries.size()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            slot.queries.push_back(query);
+        }
+        glQueryCounter(slot.queries[slot.used], GL_TIMESTAMP);
+#endif
+        return slot.used++;
+    }
+
+    /// @brief Reads the slot back if the GPU is done with it
+    static bool gpu_timer_collect(gpu_timer_frame_t &slot) {
+#ifdef ROCKETGE__Platform_Android
+        return false;
+#else
+        if (!slot.pending) {
+            return true;
+        }
+
+        // Queries complete in order, the last one being ready means all are
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(slot.queries[slot.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            return false;
+        }
+
+        auto &results = gpu_timer.results;
+        results.resize(slot.used);
+        for (uint32_t i = 0; i < slot.used; ++i) {
+            glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &results[i]);
+        }
+        slot.pending = false;
+
+        auto seconds = [&](const gpu_timer_region_t &region) -> float {
+            if (region.end == gpu_timer_open_region || results[region.end] < results[region.begin]) {
+                return 0.f;
+            }
+            return static_cast<float>(static_cast<double>(results[region.end] - results[region.begin]) / 1e9);
+        };
+
+        static float alpha = 0.1;
+        float frametime = seconds(slot.regions[0]);
+        metrics.gpu_frame = slot.frame;
+        metrics.gpu_frametime = frametime;
+        metrics.avg_gpu_frametime = metrics.avg_gpu_frametime + alpha * (frametime - metrics.avg_gpu_frametime);
+        metrics.max_gpu_frametime = std::max(metrics.max_gpu_frametime, frametime);
+        metrics.gpu_render_cache_time = 0;
+        metrics.gpu_region_count = 0;
+        for (size_t i = 1; i < slot.regions.size(); ++i) {
+            float time = seconds(slot.regions[i]);
+            if (std::strcmp(slot.regions[i].name, gpu_region_render_cache) == 0) {
+                metrics.gpu_render_cache_time += time;
+            }
+            if (metrics.gpu_region_count < max_gpu_regions) {
+                metrics.gpu_regions[metrics.gpu_region_count++] = { slot.regions[i].name, time };
+            }
+        }
+        return true;
+#endif
+    }
+
+    bool set_gpu_timing(bool enabled) {
+        if (enabled && !gpu_timer_supported()) {
+            rocket::log("timer queries are not supported by this context", "rgl", "set_gpu_timing", "warn");
+            return false;
+        }
+        if (!enabled && gpu_timer.enabled) {
+            for (auto &slot : gpu_timer.frames) {
+#ifndef ROCKETGE__Platform_Android
+                if (!slot.queries.empty()) {
+                    glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+                }
+#endif
+                slot = {};
+            }
+            gpu_timer.in_frame = false;
+        }
+        gpu_timer.enabled = enabled;
+        return true;
+    }
+
+    bool is_gpu_timing_enabled() {
+        return gpu_timer.enabled;
+    }
+
+    void gpu_timer_begin_frame(uint64_t frame) {
+        if (!gpu_timer.enabled) {
+            return;
+        }
+
+        // Oldest first, so the newest finished frame is what ends up in the metrics
+        for (size_t i = 0; i < gpu_timer_frames_in_flight; ++i) {
+            if (!gpu_timer_collect(gpu_timer.frames[(gpu_timer.current + i) % gpu_timer_frames_in_flight])) {
+                break;
+            }
+        }
+
+        gpu_timer_frame_t &slot = gpu_timer.frames[gpu_timer.current];
+        if (slot.pending) {
+            // GPU is more than frames_in_flight behind, skip timing this frame
+            gpu_timer.in_frame = false;
+            return;
+        }
+
+        slot.frame = frame;
+        slot.used = 0;
+        slot.regions.clear();
+        slot.open.clear();
+        slot.regions.push_back({ "frame", gpu_timer_timestamp(slot) });
+        slot.open.push_back(0);
+        gpu_timer.in_frame = true;
+    }
+
+    void gpu_timer_end_frame() {
+        if (!gpu_timer.enabled || !gpu_timer.in_frame) {
+            return;
+        }
+
+        gpu_timer_frame_t &slot = gpu_timer.frames[gpu_timer.current];
+        uint32_t end = gpu_timer_timestamp(slot);
+        // Regions left open end with the frame
+        for (size_t index : slot.open) {
+            slot.regions[index].end = end;
+        }
+        slot.open.clear();
+        slot.pending = true;
+
+        gpu_timer.current = (gpu_timer.current + 1) % gpu_timer_frames_in_flight;
+        gpu_timer.in_frame = false;
+    }
+
+    void gpu_timer_begin_region(const char *name) {
+        if (!gpu_timer.enabled || !gpu_timer.in_frame) {
+            return;
+        }
+
+        gpu_timer_frame_t &slot = gpu_timer.frames[gpu_timer.current];
+        slot.open.push_back(slot.regions.size());
+        slot.regions.push_back({ name, gpu_timer_timestamp(slot) });
+    }
+
+    void gpu_timer_end_region() {
+        if (!gpu_timer.enabled || !gpu_timer.in_frame) {
+            return;
+        }
+
+        gpu_timer_frame_t &slot = gpu_timer.frames[gpu_timer.current];
+        // Never close the frame region here
+        if (slot.open.size() <= 1) {
+            return;
+        }
+        slot.regions[slot.open.back()].end = gpu_timer_timestamp(slot);
+        slot.open.pop_back();
+    }
+
     draw_metrics_t get_draw_metrics() {
         return metrics;
     }
@@ -1047,6 +1496,8 @@ namespace rgl {
         gl_main_ctx = nullptr;
         fmetrics = {};
         metrics = {};
+        // Queries die with the context
+        gpu_timer = {};
 
         rectVO = {};
         textureVO = {};
@@ -1055,6 +1506,10 @@ namespace rgl {
         viewport_size = {};
         viewport_offset = {};
         max_tx_size = 0;
+        // Dies with the context like the queries
+        camera_ubo = 0;
+        camera_view = glm::mat4(1.0f);
+        camera_ubo_viewport = { -1, -1 };
         
         shader_cache.clear();
         cachecmp_shader_cache.clear();
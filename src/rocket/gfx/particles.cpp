@@ -0,0 +1,458 @@
+#include "rocket/particles.hpp"
+#include "rocket/macros.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/renderer.hpp"
+#include "lib/tweeny/tweeny.h"
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+#include <emmintrin.h>
+#define ROCKETGE__PARTICLES_SSE2
+#if defined(__GNUC__)
+#include <immintrin.h>
+#define ROCKETGE__PARTICLES_AVX2
+#endif
+#elif defined(ROCKETGE__Architecture_arm64)
+#include <arm_neon.h>
+#define ROCKETGE__PARTICLES_NEON
+#endif
+
+namespace rocket {
+    namespace {
+        enum particle_field_t : size_t {
+            field_x = 0,
+            field_y,
+            field_vx,
+            field_vy,
+            field_age,
+            field_inv_life,
+            field_count,
+        };
+
+        /// @brief Emitters with fewer live particles update on the calling thread
+        constexpr size_t particle_parallel_min = 32768;
+        /// @brief Particles per job-pool job
+        constexpr size_t particle_job_size = 16384;
+        constexpr size_t particle_lut_size = 256;
+        constexpr size_t particle_arena_alignment = 64;
+        /// @brief Free arenas kept per size class
+        constexpr size_t particle_arena_pool_depth = 4;
+
+        /// @brief Arenas are recycled by size class, so short-lived emitters (explosions) don't hit the allocator
+        struct particle_arena_pool_t {
+            std::mutex mutex;
+            std::unordered_map<size_t, std::vector<float *>> free;
+
+            static size_t size_class(size_t capacity) {
+                return std::bit_ceil(std::max<size_t>(capacity, 64));
+            }
+
+            float *acquire(size_t stride) {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    auto &blocks = this->free[stride];
+                    if (!blocks.empty()) {
+                        float *block = blocks.back();
+                        blocks.pop_back();
+                        return block;
+                    }
+                }
+                return static_cast<float *>(::operator new(stride * field_count * sizeof(float), std::align_val_t{ particle_arena_alignment }));
+            }
+
+            void release(float *block, size_t stride) {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    auto &blocks = this->free[stride];
+                    if (blocks.size() < particle_arena_pool_depth) {
+                        blocks.push_back(block);
+                        return;
+                    }
+                }
+                ::operator delete(block, std::align_val_t{ particle_arena_alignment });
+            }
+
+            ~particle_arena_pool_t() {
+                for (auto &[stride, blocks] : this->free) {
+                    for (float *block : blocks) {
+                        ::operator delete(block, std::align_val_t{ particle_arena_alignment });
+                    }
+                }
+            }
+        };
+
+        particle_arena_pool_t &arena_pool() {
+            static particle_arena_pool_t pool;
+            return pool;
+        }
+
+        /// @brief Per-update constants of the integration kernel
+        struct particle_step_t {
+            float dt;
+            /// @brief acceleration * dt
+            float dvx;
+            float dvy;
+            /// @brief Velocity multiplier for drag over dt
+            float damp;
+        };
+
+        struct particle_arrays_t {
+            float *x;
+            float *y;
+            float *vx;
+            float *vy;
+            float *age;
+        };
+
+        void integrate_scalar(const particle_arrays_t &p, size_t begin, size_t end, const particle_step_t &s) {
+            for (size_t i = begin; i < end; ++i) {
+                p.vx[i] = (p.vx[i] + s.dvx) * s.damp;
+                p.vy[i] = (p.vy[i] + s.dvy) * s.damp;
+                p.x[i] += p.vx[i] * s.dt;
+                p.y[i] += p.vy[i] * s.dt;
+                p.age[i] += s.dt;
+            }
+        }
+
+#ifdef ROCKETGE__PARTICLES_SSE2
+        void integrate_sse2(const particle_arrays_t &p, size_t begin, size_t end, const particle_step_t &s) {
+            const __m128 dt = _mm_set1_ps(s.dt);
+            const __m128 dvx = _mm_set1_ps(s.dvx);
+            const __m128 dvy = _mm_set1_ps(s.dvy);
+            const __m128 damp = _mm_set1_ps(s.damp);
+
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p.vx + i), dvx), damp);
+                const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(p.vy + i), dvy), damp);
+                _mm_storeu_ps(p.vx + i, vx);
+                _mm_storeu_ps(p.vy + i, vy);
+                _mm_storeu_ps(p.x + i, _mm_add_ps(_mm_loadu_ps(p.x + i), _mm_mul_ps(vx, dt)));
+                _mm_storeu_ps(p.y + i, _mm_add_ps(_mm_loadu_ps(p.y + i), _mm_mul_ps(vy, dt)));
+                _mm_storeu_ps(p.age + i, _mm_add_ps(_mm_loadu_ps(p.age + i), dt));
+            }
+            integrate_scalar(p, i, end, s);
+        }
+#endif
+
+#ifdef ROCKETGE__PARTICLES_AVX2
+        __attribute__((target("avx2")))
+        void integrate_avx2(const particle_arrays_t &p, size_t begin, size_t end, const particle_step_t &s) {
+            const __m256 dt = _mm256_set1_ps(s.dt);
+            const __m256 dvx = _mm256_set1_ps(s.dvx);
+            const __m256 dvy = _mm256_set1_ps(s.dvy);
+            const __m256 damp = _mm256_set1_ps(s.damp);
+
+            size_t i = begin;
+            for (; i + 8 <= end; i += 8) {
+                const __m256 vx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p.vx + i), dvx), damp);
+                const __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(p.vy + i), dvy), damp);
+                _mm256_storeu_ps(p.vx + i, vx);
+                _mm256_storeu_ps(p.vy + i, vy);
+                _mm256_storeu_ps(p.x + i, _mm256_add_ps(_mm256_loadu_ps(p.x + i), _mm256_mul_ps(vx, dt)));
+                _mm256_storeu_ps(p.y + i, _mm256_add_ps(_mm256_loadu_ps(p.y + i), _mm256_mul_ps(vy, dt)));
+                _mm256_storeu_ps(p.age + i, _mm256_add_ps(_mm256_loadu_ps(p.age + i), dt));
+            }
+            integrate_scalar(p, i, end, s);
+        }
+#endif
+
+#ifdef ROCKETGE__PARTICLES_NEON
+        void integrate_neon(const particle_arrays_t &p, size_t begin, size_t end, const particle_step_t &s) {
+            const float32x4_t dt = vdupq_n_f32(s.dt);
+            const float32x4_t dvx = vdupq_n_f32(s.dvx);
+            const float32x4_t dvy = vdupq_n_f32(s.dvy);
+            const float32x4_t damp = vdupq_n_f32(s.damp);
+
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                const float32x4_t vx = vmulq_f32(vaddq_f32(vld1q_f32(p.vx + i), dvx), damp);
+                const float32x4_t vy = vmulq_f32(vaddq_f32(vld1q_f32(p.vy + i), dvy), damp);
+                vst1q_f32(p.vx + i, vx);
+                vst1q_f32(p.vy + i, vy);
+                vst1q_f32(p.x + i, vmlaq_f32(vld1q_f32(p.x + i), vx, dt));
+                vst1q_f32(p.y + i, vmlaq_f32(vld1q_f32(p.y + i), vy, dt));
+                vst1q_f32(p.age + i, vaddq_f32(vld1q_f32(p.age + i), dt));
+            }
+            integrate_scalar(p, i, end, s);
+        }
+#endif
+
+        using integrate_fn = void (*)(const particle_arrays_t &, size_t, size_t, const particle_step_t &);
+
+        [[nodiscard]] integrate_fn pick_integrate() {
+#ifdef ROCKETGE__PARTICLES_AVX2
+            if (__builtin_cpu_supports("avx2")) {
+                return integrate_avx2;
+            }
+#endif
+#if defined(ROCKETGE__PARTICLES_SSE2)
+            return integrate_sse2;
+#elif defined(ROCKETGE__PARTICLES_NEON)
+            return integrate_neon;
+#else
+            return integrate_scalar;
+#endif
+        }
+
+        const integrate_fn integrate_impl = pick_integrate();
+
+        tweeny::easing::enumerated to_tweeny(particle_easing_t easing) {
+            switch (easing) {
+                case particle_easing_t::quadratic_in: return tweeny::easing::enumerated::quadraticIn;
+                case particle_easing_t::quadratic_out: return tweeny::easing::enumerated::quadraticOut;
+                case particle_easing_t::cubic_in: return tweeny::easing::enumerated::cubicIn;
+                case particle_easing_t::cubic_out: return tweeny::easing::enumerated::cubicOut;
+                case particle_easing_t::sinusoidal_in_out: return tweeny::easing::enumerated::sinusoidalInOut;
+                case particle_easing_t::exponential_out: return tweeny::easing::enumerated::exponentialOut;
+                case particle_easing_t::linear:
+                default: return tweeny::easing::enumerated::linear;
+            }
+        }
+
+        /// @brief Eased 0..1 over the table, entry i is at life i / (size - 1)
+        std::vector<float> ease_table(particle_easing_t easing) {
+            auto tween = tweeny::from(0.f).to(1.f).during(static_cast<uint32_t>(particle_lut_size - 1)).via(to_tweeny(easing));
+            std::vector<float> table(particle_lut_size);
+            for (size_t i = 0; i < particle_lut_size; ++i) {
+                table[i] = tween.seek(static_cast<float>(i) / (particle_lut_size - 1));
+            }
+            return table;
+        }
+
+        uint32_t pack_color(rgba_color color) {
+            return static_cast<uint32_t>(color.x)
+                | static_cast<uint32_t>(color.y) << 8
+                | static_cast<uint32_t>(color.z) << 16
+                | static_cast<uint32_t>(color.w) << 24;
+        }
+
+        rgba_color unpack_color(uint32_t color) {
+            return {
+                static_cast<uint8_t>(color & 0xff),
+                static_cast<uint8_t>((color >> 8) & 0xff),
+                static_cast<uint8_t>((color >> 16) & 0xff),
+                static_cast<uint8_t>(color >> 24),
+            };
+        }
+
+        /// @brief Min/max corners of a range of instances
+        struct particle_extent_t {
+            float x0 = std::numeric_limits<float>::max();
+            float y0 = std::numeric_limits<float>::max();
+            float x1 = std::numeric_limits<float>::lowest();
+            float y1 = std::numeric_limits<float>::lowest();
+
+            void add(const particle_instance_t &p) {
+                const float half = p.size * 0.5f;
+                this->x0 = std::min(this->x0, p.x - half);
+                this->y0 = std::min(this->y0, p.y - half);
+                this->x1 = std::max(this->x1, p.x + half);
+                this->y1 = std::max(this->y1, p.y + half);
+            }
+
+            void add(const particle_extent_t &o) {
+                this->x0 = std::min(this->x0, o.x0);
+                this->y0 = std::min(this->y0, o.y0);
+                this->x1 = std::max(this->x1, o.x1);
+                this->y1 = std::max(this->y1, o.y1);
+            }
+        };
+    }
+
+    particle_emitter_t::particle_emitter_t(const particle_emitter_config_t &config) {
+        this->config = config;
+        this->capacity = config.max_particles;
+        this->stride = particle_arena_pool_t::size_class(this->capacity);
+        this->arena = arena_pool().acquire(this->stride);
+        this->rng = config.seed != 0 ? config.seed : 1;
+        this->batch.instances.reserve(this->capacity);
+        this->build_luts();
+    }
+
+    particle_emitter_t::~particle_emitter_t() {
+        arena_pool().release(this->arena, this->stride);
+        if (this->batch.gpu_owner != nullptr) {
+            this->batch.gpu_owner->clean_gpu_resource(this->batch.gpu);
+        }
+    }
+
+    float particle_emitter_t::random(float lo, float hi) {
+        // xorshift32, 24 bits of it for the mantissa
+        this->rng ^= this->rng << 13;
+        this->rng ^= this->rng >> 17;
+        this->rng ^= this->rng << 5;
+        return lo + (hi - lo) * static_cast<float>(this->rng >> 8) * (1.f / 16777216.f);
+    }
+
+    void particle_emitter_t::build_luts() {
+        const std::vector<float> size_ease = ease_table(this->config.size_easing);
+        const std::vector<float> color_ease = ease_table(this->config.color_easing);
+        const rgba_color a = this->config.color_start;
+        const rgba_color b = this->config.color_end;
+        auto mix = [](uint8_t from, uint8_t to, float t) {
+            return static_cast<uint8_t>(std::clamp(std::lround(from + (to - from) * t), 0l, 255l));
+        };
+
+        this->size_lut.resize(particle_lut_size);
+        this->color_lut.resize(particle_lut_size);
+        for (size_t i = 0; i < particle_lut_size; ++i) {
+            this->size_lut[i] = this->config.size_start + (this->config.size_end - this->config.size_start) * size_ease[i];
+            const float t = color_ease[i];
+            this->color_lut[i] = pack_color({ mix(a.x, b.x, t), mix(a.y, b.y, t), mix(a.z, b.z, t), mix(a.w, b.w, t) });
+        }
+    }
+
+    void particle_emitter_t::burst(size_t amount) {
+        this->pending_burst += amount;
+    }
+
+    void particle_emitter_t::spawn(size_t amount) {
+        amount = std::min(amount, this->capacity - this->count);
+        float *x = this->field(field_x);
+        float *y = this->field(field_y);
+        float *vx = this->field(field_vx);
+        float *vy = this->field(field_vy);
+        float *age = this->field(field_age);
+        float *inv_life = this->field(field_inv_life);
+
+        const particle_emitter_config_t &c = this->config;
+        const float life_lo = std::max(std::min(c.lifetime_min, c.lifetime_max), 0.001f);
+        const float life_hi = std::max(std::max(c.lifetime_min, c.lifetime_max), 0.001f);
+        for (size_t n = 0; n < amount; ++n) {
+            const size_t i = this->count++;
+            x[i] = c.position.x + this->random(-0.5f, 0.5f) * c.spawn_area.x;
+            y[i] = c.position.y + this->random(-0.5f, 0.5f) * c.spawn_area.y;
+            vx[i] = this->random(c.velocity_min.x, c.velocity_max.x);
+            vy[i] = this->random(c.velocity_min.y, c.velocity_max.y);
+            age[i] = 0.f;
+            inv_life[i] = 1.f / this->random(life_lo, life_hi);
+            this->batch.instances.push_back({ x[i], y[i], this->size_lut[0], this->color_lut[0] });
+        }
+    }
+
+    void particle_emitter_t::remove_dead() {
+        float *fields[field_count];
+        for (size_t f = 0; f < field_count; ++f) {
+            fields[f] = this->field(f);
+        }
+        const float *age = fields[field_age];
+        const float *inv_life = fields[field_inv_life];
+
+        // Swap-remove, particle order does not matter
+        size_t i = 0;
+        while (i < this->count) {
+            if (age[i] * inv_life[i] < 1.f) {
+                ++i;
+                continue;
+            }
+            const size_t last = --this->count;
+            for (size_t f = 0; f < field_count; ++f) {
+                fields[f][i] = fields[f][last];
+            }
+            this->batch.instances[i] = this->batch.instances[last];
+        }
+        this->batch.instances.resize(this->count);
+    }
+
+    void particle_emitter_t::update(float dt) {
+        ROCKET_PROFILE_SCOPE("particle_emitter_t::update");
+        dt = std::max(dt, 0.f);
+        const particle_step_t step = {
+            dt,
+            this->config.acceleration.x * dt,
+            this->config.acceleration.y * dt,
+            std::pow(1.f - std::clamp(this->config.drag, 0.f, 1.f), dt),
+        };
+        const particle_arrays_t arrays = {
+            this->field(field_x),
+            this->field(field_y),
+            this->field(field_vx),
+            this->field(field_vy),
+            this->field(field_age),
+        };
+        const float *inv_life = this->field(field_inv_life);
+        particle_instance_t *instances = this->batch.instances.data();
+        const float *size_lut = this->size_lut.data();
+        const uint32_t *color_lut = this->color_lut.data();
+
+        // Integrate and rebuild instances in one pass, dying particles are removed after
+        auto run_range = [&](size_t begin, size_t end, particle_extent_t &extent) {
+            integrate_impl(arrays, begin, end, step);
+            for (size_t i = begin; i < end; ++i) {
+                const float life = std::min(arrays.age[i] * inv_life[i], 1.f);
+                const size_t slot = static_cast<size_t>(life * (particle_lut_size - 1) + 0.5f);
+                instances[i] = { arrays.x[i], arrays.y[i], size_lut[slot], color_lut[slot] };
+                extent.add(instances[i]);
+            }
+        };
+
+        particle_extent_t extent;
+        worker_pool_t &pool = get_job_pool();
+        if (this->count < particle_parallel_min || pool.size() == 0) {
+            run_range(0, this->count, extent);
+        } else {
+            const size_t jobs = (this->count + particle_job_size - 1) / particle_job_size;
+            std::vector<particle_extent_t> extents(jobs);
+            pool.run(static_cast<int>(jobs), [&](int job) {
+                const size_t begin = static_cast<size_t>(job) * particle_job_size;
+                run_range(begin, std::min(begin + particle_job_size, this->count), extents[job]);
+            });
+            for (const particle_extent_t &e : extents) {
+                extent.add(e);
+            }
+        }
+
+        this->remove_dead();
+
+        size_t amount = this->pending_burst;
+        this->pending_burst = 0;
+        if (this->emitting && this->config.rate > 0.f) {
+            this->spawn_accumulator += this->config.rate * dt;
+            const float whole = std::floor(this->spawn_accumulator);
+            this->spawn_accumulator -= whole;
+            amount += static_cast<size_t>(whole);
+        }
+        const size_t first_new = this->count;
+        this->spawn(amount);
+        for (size_t i = first_new; i < this->count; ++i) {
+            extent.add(this->batch.instances[i]);
+        }
+
+        this->batch.bounds = this->count == 0
+            ? fbounding_box{ { 0, 0 }, { 0, 0 } }
+            : fbounding_box{ { extent.x0, extent.y0 }, { extent.x1 - extent.x0, extent.y1 - extent.y0 } };
+        this->batch.revision++;
+    }
+
+    void particle_emitter_t::draw(renderer_2d_i *ren) {
+        ROCKET_PROFILE_SCOPE("particle_emitter_t::draw");
+        if (this->batch.instances.empty()) {
+            return;
+        }
+        this->batch_bounds.clear();
+        this->batch_bounds.push(this->batch.bounds);
+        ren->cull_visible(this->batch_bounds, this->visible);
+        if (this->visible.empty()) {
+            return;
+        }
+        ren->draw_particles(this->batch);
+    }
+
+    void renderer_2d_i::draw_particles(particle_batch_t &batch) {
+        for (const particle_instance_t &p : batch.instances) {
+            if (p.size <= 0.f) {
+                continue;
+            }
+            const float half = p.size * 0.5f;
+            this->draw_rectangle({ { p.x - half, p.y - half }, { p.size, p.size } }, unpack_color(p.color));
+        }
+    }
+}
@@ -0,0 +1,1258 @@
+#include "rocket/recording.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/runtime.hpp"
+#include "intl_macros.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace rocket {
+    namespace {
+        // "RGEC"
+        constexpr uint32_t stream_magic = 0x43454752;
+        constexpr uint32_t stream_version = 3;
+
+        enum class op_t : uint8_t {
+            begin_frame = 1,
+            end_frame,
+            clear,
+            scissor_begin,
+            scissor_end,
+            render_mode_begin,
+            render_mode_end,
+            rectangle,
+            circle,
+            polygon,
+            texture,
+            atlas_texture,
+            make_ready_texture,
+            text,
+            pixel,
+            fps,
+            gpu_region_begin,
+            gpu_region_end,
+            wireframe,
+            viewport_size,
+            viewport_offset,
+            graphics_settings,
+            push_framebuffer,
+            push_canvas,
+            shader,
+            define_texture,
+            define_font,
+            /// Contents drawn by a render cache callback, up to cache_contents_end
+            cache_contents_begin,
+            cache_contents_end,
+            cache_begin,
+            cache_end,
+            cache_draw,
+            cache_destroy,
+        };
+
+        enum class font_kind_t : uint8_t {
+            builtin,
+            builtin_monospace,
+            custom,
+        };
+
+        template<typename T>
+        void put(std::vector<uint8_t> &out, const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const size_t offset = out.size();
+            out.resize(offset + sizeof(T));
+            std::memcpy(out.data() + offset, &value, sizeof(T));
+        }
+
+        void put_bytes(std::vector<uint8_t> &out, const void *bytes, size_t size) {
+            put(out, static_cast<uint32_t>(size));
+            const uint8_t *begin = static_cast<const uint8_t *>(bytes);
+            out.insert(out.end(), begin, begin + size);
+        }
+
+        void put_op(std::vector<uint8_t> &out, op_t op) {
+            put(out, static_cast<uint8_t>(op));
+        }
+
+        struct reader_t {
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+            size_t pos = 0;
+            bool ok = true;
+
+            template<typename T>
+            T get() {
+                T value{};
+                if (!ok || size - pos < sizeof(T)) {
+                    ok = false;
+                    return value;
+                }
+                std::memcpy(&value, data + pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
+
+            const uint8_t *get_bytes(size_t &count) {
+                count = get<uint32_t>();
+                if (!ok || size - pos < count) {
+                    ok = false;
+                    count = 0;
+                    return nullptr;
+                }
+                const uint8_t *bytes = data + pos;
+                pos += count;
+                return bytes;
+            }
+
+            bool done() const { return !ok || pos >= size; }
+        };
+
+        /// One decoded call, fields are filled in by op
+        struct command_t {
+            op_t op = op_t::begin_frame;
+            uint32_t handle = 0;
+            rocket::fbounding_box box = {};
+            rocket::rgba_color color = {};
+            rocket::rgb_color text_color = {};
+            rocket::vec2f_t pos = {};
+            rocket::vec2f_t size = {};
+            float radius = 0.f;
+            float rotation = 0.f;
+            float roundedness = 0.f;
+            int32_t count = 0;
+            uint8_t flag = 0;
+            graphics_settings_t settings = {};
+            assetid_t asset = 0;
+            rocket::vec2i_t asset_size = {};
+            int32_t channels = 0;
+            /// Text, region names, embedded assets and pixels, point into the stream
+            const uint8_t *bytes = nullptr;
+            size_t byte_count = 0;
+        };
+
+        bool read_command(reader_t &r, command_t &c) {
+            c.op = static_cast<op_t>(r.get<uint8_t>());
+            switch (c.op) {
+                case op_t::begin_frame:
+                case op_t::end_frame:
+                case op_t::scissor_end:
+                case op_t::gpu_region_end:
+                case op_t::shader:
+                    break;
+                case op_t::clear:
+                    c.color = r.get<rgba_color>();
+                    break;
+                case op_t::scissor_begin:
+                    c.box = r.get<fbounding_box>();
+                    break;
+                case op_t::render_mode_begin:
+                case op_t::render_mode_end:
+                case op_t::wireframe:
+                    c.flag = r.get<uint8_t>();
+                    break;
+                case op_t::rectangle:
+                    c.box = r.get<fbounding_box>();
+                    c.color = r.get<rgba_color>();
+                    c.rotation = r.get<float>();
+                    c.roundedness = r.get<float>();
+                    c.flag = r.get<uint8_t>();
+                    break;
+                case op_t::circle:
+                    c.pos = r.get<vec2f_t>();
+                    c.radius = r.get<float>();
+                    c.color = r.get<rgba_color>();
+                    c.count = r.get<int32_t>();
+                    break;
+                case op_t::polygon:
+                    c.pos = r.get<vec2f_t>();
+                    c.radius = r.get<float>();
+                    c.color = r.get<rgba_color>();
+                    c.count = r.get<int32_t>();
+                    c.rotation = r.get<float>();
+                    break;
+                case op_t::texture:
+                    c.handle = r.get<uint32_t>();
+                    c.box = r.get<fbounding_box>();
+                    c.rotation = r.get<float>();
+                    c.roundedness = r.get<float>();
+                    break;
+                case op_t::atlas_texture:
+                    c.handle = r.get<uint32_t>();
+                    c.box = r.get<fbounding_box>();
+                    c.pos = r.get<vec2f_t>();
+                    c.size = r.get<vec2f_t>();
+                    c.rotation = r.get<float>();
+                    c.roundedness = r.get<float>();
+                    break;
+                case op_t::cache_contents_begin:
+                    c.handle = r.get<uint32_t>();
+                    c.asset_size = r.get<vec2i_t>();
+                    break;
+                case op_t::make_ready_texture:
+                case op_t::cache_contents_end:
+                case op_t::cache_begin:
+                case op_t::cache_end:
+                case op_t::cache_destroy:
+                    c.handle = r.get<uint32_t>();
+                    break;
+                case op_t::text:
+                    c.handle = r.get<uint32_t>();
+                    c.radius = r.get<float>();
+                    c.text_color = r.get<rgb_color>();
+                    c.pos = r.get<vec2f_t>();
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::pixel:
+                    c.pos = r.get<vec2f_t>();
+                    c.color = r.get<rgba_color>();
+                    break;
+                case op_t::fps:
+                case op_t::viewport_size:
+                case op_t::viewport_offset:
+                    c.pos = r.get<vec2f_t>();
+                    break;
+                case op_t::gpu_region_begin:
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::graphics_settings:
+                    c.settings = r.get<graphics_settings_t>();
+                    break;
+                case op_t::push_framebuffer:
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::push_canvas:
+                    c.asset_size = r.get<vec2i_t>();
+                    c.count = r.get<int32_t>();
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::define_texture:
+                    c.handle = r.get<uint32_t>();
+                    c.asset = r.get<assetid_t>();
+                    c.asset_size = r.get<vec2i_t>();
+                    c.channels = r.get<int32_t>();
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::define_font:
+                    c.handle = r.get<uint32_t>();
+                    c.flag = r.get<uint8_t>();
+                    c.asset = r.get<assetid_t>();
+                    c.radius = r.get<float>();
+                    c.bytes = r.get_bytes(c.byte_count);
+                    break;
+                case op_t::cache_draw:
+                    c.handle = r.get<uint32_t>();
+                    c.box = r.get<fbounding_box>();
+                    break;
+                default:
+                    r.ok = false;
+                    break;
+            }
+            return r.ok;
+        }
+
+        /// GPU region names have to outlive the renderer
+        const char *intern_region_name(std::string_view name) {
+            static std::unordered_set<std::string> names;
+            static std::mutex mutex;
+            std::lock_guard<std::mutex> _(mutex);
+            return names.emplace(name).first->c_str();
+        }
+    }
+
+    bool command_stream_t::save(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            rocket::log("failed to open " + path, "command_stream_t", "save", "error");
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(this->data.data()), static_cast<std::streamsize>(this->data.size()));
+        return file.good();
+    }
+
+    bool command_stream_t::load(const std::string &path, command_stream_t &out) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            rocket::log("failed to open " + path, "command_stream_t", "load", "error");
+            return false;
+        }
+        out.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        reader_t r = { out.data.data(), out.data.size() };
+        if (r.get<uint32_t>() != stream_magic) {
+            rocket::log(path + " is not a command stream", "command_stream_t", "load", "error");
+            out.data.clear();
+            return false;
+        }
+        return true;
+    }
+
+    struct recording_renderer_2d_impl_t {
+        recording_options_t options;
+        std::vector<uint8_t> stream;
+        /// @brief Stream size at the last end_frame
+        size_t complete_size = 0;
+        uint32_t frames = 0;
+        int frame_limit = -1;
+        bool armed = false;
+        bool recording = false;
+
+        /// @brief Kept alive so a freed address is never handed out twice
+        std::unordered_map<texture_t *, std::pair<uint32_t, std::shared_ptr<texture_t>>> textures;
+        std::unordered_map<font_t *, std::pair<uint32_t, std::shared_ptr<font_t>>> fonts;
+        std::unordered_map<render_cache_t *, uint32_t> caches;
+        uint32_t next_cache_id = 0;
+
+        void reset() {
+            stream.clear();
+            put(stream, stream_magic);
+            put(stream, stream_version);
+            complete_size = stream.size();
+            frames = 0;
+            textures.clear();
+            fonts.clear();
+        }
+
+        uint32_t texture_handle(const std::shared_ptr<texture_t> &texture) {
+            auto it = textures.find(texture.get());
+            if (it != textures.end()) {
+                return it->second.first;
+            }
+            const uint32_t handle = static_cast<uint32_t>(textures.size());
+            textures.emplace(texture.get(), std::make_pair(handle, texture));
+
+            put_op(stream, op_t::define_texture);
+            put(stream, handle);
+            put(stream, texture->id);
+            put(stream, texture->size);
+            put(stream, static_cast<int32_t>(texture->channels));
+            if (options.embed_assets) {
+                put_bytes(stream, texture->data.data(), texture->data.size());
+            } else {
+                put_bytes(stream, nullptr, 0);
+            }
+            return handle;
+        }
+
+        uint32_t font_handle(const std::shared_ptr<font_t> &font) {
+            auto it = fonts.find(font.get());
+            if (it != fonts.end()) {
+                return it->second.first;
+            }
+            const uint32_t handle = static_cast<uint32_t>(fonts.size());
+            fonts.emplace(font.get(), std::make_pair(handle, font));
+
+            // The default fonts ship with the runtime, only custom ones are embedded
+            font_kind_t kind = font_kind_t::custom;
+            if (font->id == static_cast<assetid_t>(-1)) {
+                kind = font->default_monospace ? font_kind_t::builtin_monospace : font_kind_t::builtin;
+            }
+            put_op(stream, op_t::define_font);
+            put(stream, handle);
+            put(stream, static_cast<uint8_t>(kind));
+            put(stream, font->id);
+            put(stream, font->size);
+            if (kind == font_kind_t::custom && options.embed_assets) {
+                put_bytes(stream, font->ttf_data.data(), font->ttf_data.size());
+            } else {
+                put_bytes(stream, nullptr, 0);
+            }
+            return handle;
+        }
+
+        uint32_t cache_id(render_cache_t *c) {
+            auto it = caches.find(c);
+            return it == caches.end() ? UINT32_MAX : it->second;
+        }
+    };
+
+    recording_renderer_2d::recording_renderer_2d(renderer_2d_i *inner, recording_options_t options) {
+        r_assert(inner != nullptr);
+        this->inner = inner;
+        this->window = inner->get_window_backend();
+        this->flags = inner->get_renderer_flags_state();
+        this->cam = inner->get_camera();
+        this->rec_impl = new recording_renderer_2d_impl_t;
+        this->rec_impl->options = options;
+    }
+
+    recording_renderer_2d::~recording_renderer_2d() {
+        delete this->rec_impl;
+        this->rec_impl = nullptr;
+    }
+
+    void recording_renderer_2d::start_recording(int frames) {
+        this->rec_impl->reset();
+        this->rec_impl->frame_limit = frames;
+        this->rec_impl->armed = true;
+        this->rec_impl->recording = false;
+    }
+
+    bool recording_renderer_2d::is_recording() const {
+        return this->rec_impl->armed || this->rec_impl->recording;
+    }
+
+    uint32_t recording_renderer_2d::get_recorded_frames() const {
+        return this->rec_impl->frames;
+    }
+
+    command_stream_t recording_renderer_2d::stop_recording() {
+        auto *ri = this->rec_impl;
+        ri->armed = false;
+        ri->recording = false;
+        command_stream_t out;
+        if (ri->stream.empty()) {
+            return out;
+        }
+        ri->stream.resize(ri->complete_size);
+        out.data = std::move(ri->stream);
+        ri->stream.clear();
+        ri->textures.clear();
+        ri->fonts.clear();
+        return out;
+    }
+
+    renderer_2d_i::gfx_chk_result recording_renderer_2d::check_graphics_settings(rocket::vec2f_t, rocket::vec2f_t) {
+        // The inner renderer culls
+        return gfx_chk_result::drawable;
+    }
+
+    api_object_t recording_renderer_2d::upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) {
+        return this->inner->upload_font_texture_to_gpu(size, bitmap);
+    }
+
+    void recording_renderer_2d::clean_gpu_resource(api_object_t object) {
+        this->inner->clean_gpu_resource(object);
+    }
+
+    bool recording_renderer_2d::has_frame_began() {
+        return this->inner->has_frame_began();
+    }
+
+    void recording_renderer_2d::begin_frame() {
+        auto *ri = this->rec_impl;
+        this->inner->begin_frame();
+        if (ri->armed) {
+            ri->armed = false;
+            ri->recording = true;
+            put_op(ri->stream, op_t::begin_frame);
+            // Caches were drawn before anything was recorded, draw them again
+            for (auto &[cache, id] : ri->caches) {
+                this->inner->invalidate_render_cache(cache);
+            }
+            return;
+        }
+        if (ri->recording) {
+            put_op(ri->stream, op_t::begin_frame);
+        }
+    }
+
+    void recording_renderer_2d::end_frame() {
+        // Recorded as the plain draws they become
+        this->flush_command_buckets();
+        auto *ri = this->rec_impl;
+        if (ri->recording) {
+            put_op(ri->stream, op_t::end_frame);
+            ri->complete_size = ri->stream.size();
+            ri->frames++;
+            if (ri->frame_limit >= 0 && ri->frames >= static_cast<uint32_t>(ri->frame_limit)) {
+                ri->recording = false;
+            }
+        }
+        this->inner->end_frame();
+    }
+
+    bool recording_renderer_2d::has_frame_ended() {
+        return this->inner->has_frame_ended();
+    }
+
+    void recording_renderer_2d::show_splash() {
+        this->inner->show_splash();
+    }
+
+    void recording_renderer_2d::begin_render_mode(render_mode_t mode) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::render_mode_begin);
+            put(this->rec_impl->stream, static_cast<uint8_t>(mode));
+        }
+        // Culling through the wrapper reads its own camera state
+        if (mode == render_mode_t::camera) {
+            this->begin_camera_mode();
+        }
+        this->inner->begin_render_mode(mode);
+    }
+
+    void recording_renderer_2d::end_render_mode(render_mode_t mode) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::render_mode_end);
+            put(this->rec_impl->stream, static_cast<uint8_t>(mode));
+        }
+        if (mode == render_mode_t::camera) {
+            this->end_camera_mode();
+        }
+        this->inner->end_render_mode(mode);
+    }
+
+    std::vector<rgba_color> recording_renderer_2d::get_framebuffer() {
+        return this->inner->get_framebuffer();
+    }
+
+    void recording_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::push_framebuffer);
+            put_bytes(this->rec_impl->stream, framebuffer.data(), framebuffer.size() * sizeof(rgba_color));
+        }
+        this->inner->push_framebuffer(framebuffer);
+    }
+
+    void recording_renderer_2d::push_canvas() {
+        framebuffer_canvas_t &src = this->canvas;
+        framebuffer_canvas_t &dst = this->inner->get_canvas();
+        const vec2i_t size = src.get_size();
+        const bool same_size = size.x == dst.get_size().x && size.y == dst.get_size().y;
+
+        std::vector<uint8_t> payload;
+        for (const canvas_rect_t &rect : src.get_dirty_rects()) {
+            if (same_size) {
+                for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                    std::memcpy(&dst.at(rect.x, y), &src.at(rect.x, y), static_cast<size_t>(rect.w) * sizeof(rgba_color));
+                }
+                dst.mark_dirty(rect);
+            }
+            if (this->rec_impl->recording) {
+                put(payload, rect);
+                for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                    const uint8_t *row = reinterpret_cast<const uint8_t *>(&src.at(rect.x, y));
+                    payload.insert(payload.end(), row, row + static_cast<size_t>(rect.w) * sizeof(rgba_color));
+                }
+            }
+        }
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::push_canvas);
+            put(this->rec_impl->stream, size);
+            put(this->rec_impl->stream, static_cast<int32_t>(src.get_dirty_rects().size()));
+            put_bytes(this->rec_impl->stream, payload.data(), payload.size());
+        }
+        src.clear_dirty();
+        this->inner->push_canvas();
+    }
+
+    void recording_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+        this->inner->request_framebuffer_readback(region);
+    }
+
+    bool recording_renderer_2d::poll_framebuffer_readback(framebuffer_readback_t &out) {
+        return this->inner->poll_framebuffer_readback(out);
+    }
+
+    vec2f_t recording_renderer_2d::get_viewport_size() {
+        return this->inner->get_viewport_size();
+    }
+
+    void recording_renderer_2d::begin_scissor_mode(rocket::fbounding_box rect) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::scissor_begin);
+            put(this->rec_impl->stream, rect);
+        }
+        this->inner->begin_scissor_mode(rect);
+    }
+
+    void recording_renderer_2d::begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) {
+        this->begin_scissor_mode({ pos, size });
+    }
+
+    void recording_renderer_2d::begin_scissor_mode(float x, float y, float sx, float sy) {
+        this->begin_scissor_mode({ { x, y }, { sx, sy } });
+    }
+
+    void recording_renderer_2d::end_scissor_mode() {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::scissor_end);
+        }
+        this->inner->end_scissor_mode();
+    }
+
+    void recording_renderer_2d::clear(rocket::rgba_color color) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::clear);
+            put(this->rec_impl->stream, color);
+        }
+        this->inner->clear(color);
+    }
+
+    void recording_renderer_2d::draw_shader(const shader_i &shader) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::shader);
+        }
+        this->inner->draw_shader(shader);
+    }
+
+    void recording_renderer_2d::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        if (this->rec_impl->recording) {
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::rectangle);
+            put(s, rect);
+            put(s, color);
+            put(s, rotation);
+            put(s, roundedness);
+            put(s, static_cast<uint8_t>(lines));
+        }
+        this->inner->draw_rectangle(rect, color, rotation, roundedness, lines);
+    }
+
+    void recording_renderer_2d::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        this->draw_rectangle({ pos, size }, color, rotation, roundedness, lines);
+    }
+
+    void recording_renderer_2d::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        if (this->rec_impl->recording) {
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::circle);
+            put(s, pos);
+            put(s, radius);
+            put(s, color);
+            put(s, static_cast<int32_t>(thickness));
+        }
+        this->inner->draw_circle(pos, radius, color, thickness);
+    }
+
+    void recording_renderer_2d::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int sides, float rotation) {
+        if (this->rec_impl->recording) {
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::polygon);
+            put(s, pos);
+            put(s, radius);
+            put(s, color);
+            put(s, static_cast<int32_t>(sides));
+            put(s, rotation);
+        }
+        this->inner->draw_polygon(pos, radius, color, sides, rotation);
+    }
+
+    void recording_renderer_2d::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        if (this->rec_impl->recording && texture != nullptr) {
+            const uint32_t handle = this->rec_impl->texture_handle(texture);
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::texture);
+            put(s, handle);
+            put(s, rect);
+            put(s, rotation);
+            put(s, roundedness);
+        }
+        this->inner->draw_texture(texture, rect, rotation, roundedness);
+    }
+
+    void recording_renderer_2d::draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation, float roundedness) {
+        if (this->rec_impl->recording && texture != nullptr) {
+            const uint32_t handle = this->rec_impl->texture_handle(texture);
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::atlas_texture);
+            put(s, handle);
+            put(s, rect);
+            put(s, texture_position_in_atlas);
+            put(s, texture_size_in_atlas);
+            put(s, rotation);
+            put(s, roundedness);
+        }
+        this->inner->draw_atlas_texture(texture, rect, texture_position_in_atlas, texture_size_in_atlas, rotation, roundedness);
+    }
+
+    void recording_renderer_2d::make_ready_texture(std::shared_ptr<rocket::texture_t> texture) {
+        if (this->rec_impl->recording && texture != nullptr) {
+            const uint32_t handle = this->rec_impl->texture_handle(texture);
+            put_op(this->rec_impl->stream, op_t::make_ready_texture);
+            put(this->rec_impl->stream, handle);
+        }
+        this->inner->make_ready_texture(texture);
+    }
+
+    void recording_renderer_2d::draw_text(const rocket::text_t &text, vec2f_t position) {
+        if (this->rec_impl->recording && text.font != nullptr) {
+            const uint32_t handle = this->rec_impl->font_handle(text.font);
+            auto &s = this->rec_impl->stream;
+            put_op(s, op_t::text);
+            put(s, handle);
+            put(s, text.size);
+            put(s, text.color);
+            put(s, position);
+            put_bytes(s, text.text.data(), text.text.size());
+        }
+        this->inner->draw_text(text, position);
+    }
+
+    void recording_renderer_2d::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::pixel);
+            put(this->rec_impl->stream, pos);
+            put(this->rec_impl->stream, color);
+        }
+        this->inner->draw_pixel(pos, color);
+    }
+
+    void recording_renderer_2d::draw_fps(vec2f_t pos) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::fps);
+            put(this->rec_impl->stream, pos);
+        }
+        this->inner->draw_fps(pos);
+    }
+
+    void recording_renderer_2d::begin_gpu_region(const char *name) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::gpu_region_begin);
+            put_bytes(this->rec_impl->stream, name, std::strlen(name));
+        }
+        this->inner->begin_gpu_region(name);
+    }
+
+    void recording_renderer_2d::end_gpu_region() {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::gpu_region_end);
+        }
+        this->inner->end_gpu_region();
+    }
+
+    void recording_renderer_2d::set_wireframe(bool wireframe) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::wireframe);
+            put(this->rec_impl->stream, static_cast<uint8_t>(wireframe));
+        }
+        this->inner->set_wireframe(wireframe);
+    }
+
+    void recording_renderer_2d::set_vsync(bool vsync) {
+        this->inner->set_vsync(vsync);
+    }
+
+    void recording_renderer_2d::set_fps(int fps) {
+        this->inner->set_fps(fps);
+    }
+
+    void recording_renderer_2d::set_graphics_settings(graphics_settings_t graphics) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::graphics_settings);
+            put(this->rec_impl->stream, graphics);
+        }
+        this->inner->set_graphics_settings(graphics);
+    }
+
+    void recording_renderer_2d::set_viewport_size(vec2f_t size) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::viewport_size);
+            put(this->rec_impl->stream, size);
+        }
+        this->inner->set_viewport_size(size);
+    }
+
+    void recording_renderer_2d::set_viewport_offset(vec2f_t zero_pos) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::viewport_offset);
+            put(this->rec_impl->stream, zero_pos);
+        }
+        this->inner->set_viewport_offset(zero_pos);
+    }
+
+    void recording_renderer_2d::set_camera(camera_2d *cam) {
+        this->cam = cam;
+        this->inner->set_camera(cam);
+    }
+
+    void recording_renderer_2d::close() {
+        this->inner->close();
+    }
+
+    bool recording_renderer_2d::get_wireframe() { return this->inner->get_wireframe(); }
+    bool recording_renderer_2d::get_vsync() { return this->inner->get_vsync(); }
+    int recording_renderer_2d::get_fps() { return this->inner->get_fps(); }
+    double recording_renderer_2d::get_delta_time() { return this->inner->get_delta_time(); }
+    uint64_t recording_renderer_2d::get_framecount() { return this->inner->get_framecount(); }
+    int recording_renderer_2d::get_drawcalls() { return this->inner->get_drawcalls(); }
+    rgl::draw_metrics_t recording_renderer_2d::get_draw_metrics() { return this->inner->get_draw_metrics(); }
+    const graphics_settings_t &recording_renderer_2d::get_graphics_settings() { return this->inner->get_graphics_settings(); }
+    api_object_t recording_renderer_2d::get_framebuffer_texture() { return this->inner->get_framebuffer_texture(); }
+    camera_2d *recording_renderer_2d::get_camera() { return this->inner->get_camera(); }
+    glm::mat4 recording_renderer_2d::get_camera_matrix() { return this->inner->get_camera_matrix(); }
+    float recording_renderer_2d::get_current_fps() { return this->inner->get_current_fps(); }
+
+    render_cache_t *recording_renderer_2d::create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size) {
+        // The id is needed before the inner renderer hands out the cache,
+        // it may draw it right away
+        const uint32_t id = this->rec_impl->next_cache_id++;
+        render_cache_t *cache = this->inner->create_render_cache([this, id, size, draw_cb](renderer_2d_i *) {
+            auto *ri = this->rec_impl;
+            if (ri->recording) {
+                put_op(ri->stream, op_t::cache_contents_begin);
+                put(ri->stream, id);
+                put(ri->stream, size);
+            }
+            draw_cb(this);
+            if (ri->recording) {
+                put_op(ri->stream, op_t::cache_contents_end);
+                put(ri->stream, id);
+            }
+        }, size);
+        if (cache != nullptr) {
+            this->rec_impl->caches[cache] = id;
+        }
+        return cache;
+    }
+
+    void recording_renderer_2d::invalidate_render_cache(render_cache_t *c) {
+        // Redrawing goes through the callback, which records the new contents
+        this->inner->invalidate_render_cache(c);
+    }
+
+    void recording_renderer_2d::update_render_cache(render_cache_t *c) {
+        this->inner->update_render_cache(c);
+    }
+
+    void recording_renderer_2d::begin_render_cache(render_cache_t *c) {
+        // A pending redraw has to land in the stream before this
+        this->inner->update_render_cache(c);
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::cache_begin);
+            put(this->rec_impl->stream, this->rec_impl->cache_id(c));
+        }
+        this->inner->begin_render_cache(c);
+    }
+
+    void recording_renderer_2d::end_render_cache(render_cache_t *c) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::cache_end);
+            put(this->rec_impl->stream, this->rec_impl->cache_id(c));
+        }
+        this->inner->end_render_cache(c);
+    }
+
+    void recording_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        this->inner->update_render_cache(c);
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::cache_draw);
+            put(this->rec_impl->stream, this->rec_impl->cache_id(c));
+            put(this->rec_impl->stream, fbounding_box{ pos, sz });
+        }
+        this->inner->draw_render_cache(c, pos, sz);
+    }
+
+    void recording_renderer_2d::draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) {
+        this->draw_render_cache(c, bbox.pos, bbox.size);
+    }
+
+    void recording_renderer_2d::destroy_render_cache(render_cache_t *&c) {
+        if (this->rec_impl->recording) {
+            put_op(this->rec_impl->stream, op_t::cache_destroy);
+            put(this->rec_impl->stream, this->rec_impl->cache_id(c));
+        }
+        this->rec_impl->caches.erase(c);
+        this->inner->destroy_render_cache(c);
+    }
+
+    struct command_replayer_impl_t {
+        std::vector<uint8_t> data;
+        replay_options_t options;
+        bool valid = false;
+
+        /// @brief [begin, end) of each frame, calls before a frame belong to it
+        std::vector<std::pair<size_t, size_t>> frames;
+        /// @brief Offset of a cache_contents_begin to the offset after its cache_contents_end
+        std::unordered_map<size_t, size_t> contents_end;
+
+        std::unordered_map<uint32_t, std::shared_ptr<texture_t>> textures;
+
+        struct font_entry_t {
+            font_kind_t kind = font_kind_t::builtin;
+            assetid_t asset = 0;
+            float size = 0.f;
+            const uint8_t *ttf = nullptr;
+            size_t ttf_size = 0;
+            std::shared_ptr<font_t> font = nullptr;
+            bool resolved = false;
+        };
+        std::unordered_map<uint32_t, font_entry_t> fonts;
+        /// @brief Embedded fonts are loaded through this, made on first use
+        std::unique_ptr<asset_manager_t> assets = nullptr;
+
+        struct cache_entry_t {
+            render_cache_t *cache = nullptr;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+        std::unordered_map<uint32_t, cache_entry_t> caches;
+        renderer_2d_i *target = nullptr;
+
+        replay_stats_t stats;
+
+        std::shared_ptr<font_t> resolve_font(uint32_t handle) {
+            auto it = fonts.find(handle);
+            if (it == fonts.end()) {
+                return nullptr;
+            }
+            font_entry_t &f = it->second;
+            if (f.resolved) {
+                return f.font;
+            }
+            f.resolved = true;
+            const int size = static_cast<int>(f.size);
+            if (f.kind == font_kind_t::builtin_monospace) {
+                f.font = font_t::font_default_monospace(size);
+            } else if (f.kind == font_kind_t::custom && options.font_resolver) {
+                f.font = options.font_resolver(f.asset, f.size);
+            }
+            if (f.font == nullptr && f.kind == font_kind_t::custom && f.ttf_size > 0) {
+                if (assets == nullptr) {
+                    assets = std::make_unique<asset_manager_t>();
+                }
+                const assetid_t id = assets->load_font(size, std::vector<uint8_t>(f.ttf, f.ttf + f.ttf_size));
+                f.font = assets->get_font(id);
+            }
+            if (f.font == nullptr) {
+                if (f.kind == font_kind_t::custom) {
+                    rocket::log("font " + std::to_string(f.asset) + " is missing, using the default font", "command_replayer_t", "resolve_font", "warn");
+                }
+                f.font = font_t::font_default(size);
+            }
+            return f.font;
+        }
+
+        render_cache_t *find_cache(uint32_t id) {
+            auto it = caches.find(id);
+            return it == caches.end() ? nullptr : it->second.cache;
+        }
+
+        void play(renderer_2d_i *ren, size_t begin, size_t end) {
+            reader_t r = { data.data(), end, begin };
+            command_t c;
+            while (!r.done()) {
+                const size_t at = r.pos;
+                if (!read_command(r, c)) {
+                    break;
+                }
+                bool issued = true;
+                switch (c.op) {
+                    case op_t::begin_frame:
+                        ren->begin_frame();
+                        break;
+                    case op_t::end_frame:
+                        ren->end_frame();
+                        stats.frames++;
+                        break;
+                    case op_t::clear:
+                        ren->clear(c.color);
+                        break;
+                    case op_t::scissor_begin:
+                        ren->begin_scissor_mode(c.box);
+                        break;
+                    case op_t::scissor_end:
+                        ren->end_scissor_mode();
+                        break;
+                    case op_t::render_mode_begin:
+                        ren->begin_render_mode(static_cast<render_mode_t>(c.flag));
+                        break;
+                    case op_t::render_mode_end:
+                        ren->end_render_mode(static_cast<render_mode_t>(c.flag));
+                        break;
+                    case op_t::rectangle:
+                        ren->draw_rectangle(c.box, c.color, c.rotation, c.roundedness, c.flag != 0);
+                        break;
+                    case op_t::circle:
+                        ren->draw_circle(c.pos, c.radius, c.color, c.count);
+                        break;
+                    case op_t::polygon:
+                        ren->draw_polygon(c.pos, c.radius, c.color, c.count, c.rotation);
+                        break;
+                    case op_t::texture:
+                    case op_t::atlas_texture:
+                    case op_t::make_ready_texture: {
+                        auto it = textures.find(c.handle);
+                        if (it == textures.end() || it->second == nullptr) {
+                            issued = false;
+                            stats.skipped++;
+                        } else if (c.op == op_t::texture) {
+                            ren->draw_texture(it->second, c.box, c.rotation, c.roundedness);
+                        } else if (c.op == op_t::atlas_texture) {
+                            ren->draw_atlas_texture(it->second, c.box, c.pos, c.size, c.rotation, c.roundedness);
+                        } else {
+                            ren->make_ready_texture(it->second);
+                        }
+                        break;
+                    }
+                    case op_t::text: {
+                        text_t text(
+                            std::string(reinterpret_cast<const char *>(c.bytes), c.byte_count),
+                            c.radius,
+                            c.text_color,
+                            resolve_font(c.handle)
+                        );
+                        ren->draw_text(text, c.pos);
+                        break;
+                    }
+                    case op_t::pixel:
+                        ren->draw_pixel(c.pos, c.color);
+                        break;
+                    case op_t::fps:
+                        ren->draw_fps(c.pos);
+                        break;
+                    case op_t::gpu_region_begin:
+                        ren->begin_gpu_region(intern_region_name({ reinterpret_cast<const char *>(c.bytes), c.byte_count }));
+                        break;
+                    case op_t::gpu_region_end:
+                        ren->end_gpu_region();
+                        break;
+                    case op_t::wireframe:
+                        ren->set_wireframe(c.flag != 0);
+                        break;
+                    case op_t::viewport_size:
+                        ren->set_viewport_size(c.pos);
+                        break;
+                    case op_t::viewport_offset:
+                        ren->set_viewport_offset(c.pos);
+                        break;
+                    case op_t::graphics_settings:
+                        ren->set_graphics_settings(c.settings);
+                        break;
+                    case op_t::push_framebuffer: {
+                        std::vector<rgba_color> pixels(c.byte_count / sizeof(rgba_color));
+                        std::memcpy(pixels.data(), c.bytes, pixels.size() * sizeof(rgba_color));
+                        ren->push_framebuffer(pixels);
+                        break;
+                    }
+                    case op_t::push_canvas:
+                        push_canvas(ren, c);
+                        break;
+                    case op_t::shader:
+                    case op_t::define_texture:
+                    case op_t::define_font:
+                        // Shaders can't be captured, assets were read up front
+                        issued = false;
+                        if (c.op == op_t::shader) {
+                            stats.skipped++;
+                        }
+                        break;
+                    case op_t::cache_contents_begin:
+                        issued = false;
+                        r.pos = cache_contents(ren, c.handle, c.asset_size, at, r.pos);
+                        break;
+                    case op_t::cache_contents_end:
+                        issued = false;
+                        break;
+                    case op_t::cache_begin:
+                    case op_t::cache_end:
+                    case op_t::cache_draw:
+                    case op_t::cache_destroy: {
+                        render_cache_t *cache = find_cache(c.handle);
+                        if (cache == nullptr) {
+                            issued = false;
+                            stats.skipped++;
+                        } else if (c.op == op_t::cache_begin) {
+                            ren->begin_render_cache(cache);
+                        } else if (c.op == op_t::cache_end) {
+                            ren->end_render_cache(cache);
+                        } else if (c.op == op_t::cache_draw) {
+                            ren->draw_render_cache(cache, c.box);
+                        } else {
+                            ren->destroy_render_cache(cache);
+                            caches.erase(c.handle);
+                        }
+                        break;
+                    }
+                }
+                if (issued) {
+                    stats.commands++;
+                }
+            }
+        }
+
+        /// @brief (Re)draw a cache from the recorded contents, returns where playback continues
+        size_t cache_contents(renderer_2d_i *ren, uint32_t id, vec2i_t size, size_t at, size_t contents_begin) {
+            auto end_it = contents_end.find(at);
+            if (end_it == contents_end.end()) {
+                return data.size();
+            }
+            cache_entry_t &entry = caches[id];
+            entry.begin = contents_begin;
+            entry.end = end_it->second;
+            if (entry.cache == nullptr) {
+                entry.cache = ren->create_render_cache([this, id](renderer_2d_i *cache_ren) {
+                    auto it = caches.find(id);
+                    if (it != caches.end()) {
+                        play(cache_ren, it->second.begin, it->second.end);
+                    }
+                }, size);
+            } else {
+                ren->invalidate_render_cache(entry.cache);
+            }
+            return end_it->second;
+        }
+
+        void push_canvas(renderer_2d_i *ren, const command_t &c) {
+            framebuffer_canvas_t &canvas = ren->get_canvas();
+            const bool same_size = canvas.get_size().x == c.asset_size.x && canvas.get_size().y == c.asset_size.y;
+            reader_t r = { c.bytes, c.byte_count };
+            for (int32_t i = 0; i < c.count && same_size; ++i) {
+                const canvas_rect_t rect = r.get<canvas_rect_t>();
+                const size_t row_bytes = static_cast<size_t>(std::max(rect.w, 0)) * sizeof(rgba_color);
+                if (!r.ok || rect.x < 0 || rect.y < 0 || rect.x + rect.w > c.asset_size.x || rect.y + rect.h > c.asset_size.y
+                    || r.size - r.pos < row_bytes * static_cast<size_t>(std::max(rect.h, 0))) {
+                    break;
+                }
+                for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                    std::memcpy(&canvas.at(rect.x, y), r.data + r.pos, row_bytes);
+                    r.pos += row_bytes;
+                }
+                canvas.mark_dirty(rect);
+            }
+            ren->push_canvas();
+        }
+
+        void release() {
+            if (target != nullptr) {
+                for (auto &[id, entry] : caches) {
+                    if (entry.cache != nullptr) {
+                        target->destroy_render_cache(entry.cache);
+                    }
+                }
+            }
+            caches.clear();
+            target = nullptr;
+        }
+
+        void bind(renderer_2d_i *ren) {
+            if (target != ren) {
+                release();
+                target = ren;
+            }
+        }
+    };
+
+    command_replayer_t::command_replayer_t(const command_stream_t &stream, replay_options_t options) {
+        this->impl = new command_replayer_impl_t;
+        auto *ci = this->impl;
+        ci->data = stream.data;
+        ci->options = std::move(options);
+
+        reader_t r = { ci->data.data(), ci->data.size() };
+        if (r.get<uint32_t>() != stream_magic) {
+            rocket::log("not a command stream", "command_replayer_t", "command_replayer_t", "error");
+            return;
+        }
+        const uint32_t version = r.get<uint32_t>();
+        if (version != stream_version) {
+            rocket::log("unsupported command stream version " + std::to_string(version), "command_replayer_t", "command_replayer_t", "error");
+            return;
+        }
+
+        // Index frames and cache contents, decode textures
+        size_t frame_begin = r.pos;
+        std::vector<size_t> open_contents;
+        command_t c;
+        while (!r.done()) {
+            const size_t at = r.pos;
+            if (!read_command(r, c)) {
+                break;
+            }
+            switch (c.op) {
+                case op_t::end_frame:
+                    ci->frames.push_back({ frame_begin, r.pos });
+                    frame_begin = r.pos;
+                    break;
+                case op_t::cache_contents_begin:
+                    open_contents.push_back(at);
+                    break;
+                case op_t::cache_contents_end:
+                    if (!open_contents.empty()) {
+                        ci->contents_end[open_contents.back()] = r.pos;
+                        open_contents.pop_back();
+                    }
+                    break;
+                case op_t::define_texture: {
+                    std::shared_ptr<texture_t> texture = nullptr;
+                    const size_t expected = static_cast<size_t>(std::max(c.asset_size.x, 0)) * std::max(c.asset_size.y, 0) * std::max(c.channels, 0);
+                    if (c.byte_count > 0 && c.byte_count == expected) {
+                        texture = std::make_shared<texture_t>();
+                        texture->id = c.asset;
+                        texture->size = c.asset_size;
+                        texture->channels = c.channels;
+                        texture->data.assign(c.bytes, c.bytes + c.byte_count);
+                    } else if (ci->options.texture_resolver) {
+                        texture = ci->options.texture_resolver(c.asset);
+                    }
+                    if (texture == nullptr) {
+                        rocket::log("texture " + std::to_string(c.asset) + " is missing, its draws are skipped", "command_replayer_t", "command_replayer_t", "warn");
+                    }
+                    ci->textures[c.handle] = texture;
+                    break;
+                }
+                case op_t::define_font: {
+                    command_replayer_impl_t::font_entry_t font;
+                    font.kind = static_cast<font_kind_t>(c.flag);
+                    font.asset = c.asset;
+                    font.size = c.radius;
+                    font.ttf = c.bytes;
+                    font.ttf_size = c.byte_count;
+                    ci->fonts[c.handle] = font;
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        if (!r.ok) {
+            rocket::log("command stream is truncated, replaying the complete frames", "command_replayer_t", "command_replayer_t", "warn");
+        }
+        ci->valid = true;
+    }
+
+    command_replayer_t::~command_replayer_t() {
+        this->release();
+        delete this->impl;
+        this->impl = nullptr;
+    }
+
+    bool command_replayer_t::is_valid() const {
+        return this->impl->valid;
+    }
+
+    size_t command_replayer_t::get_frame_count() const {
+        return this->impl->frames.size();
+    }
+
+    bool command_replayer_t::replay_frame(renderer_2d_i *ren, size_t frame) {
+        ROCKET_PROFILE_SCOPE("command_replayer_t::replay_frame");
+        if (ren == nullptr || frame >= this->impl->frames.size()) {
+            return false;
+        }
+        this->impl->bind(ren);
+        const auto [begin, end] = this->impl->frames[frame];
+        this->impl->play(ren, begin, end);
+        return true;
+    }
+
+    replay_stats_t command_replayer_t::replay(renderer_2d_i *ren, int loops) {
+        const replay_stats_t before = this->impl->stats;
+        for (int loop = 0; loop < loops; ++loop) {
+            for (size_t i = 0; i < this->impl->frames.size(); ++i) {
+                this->replay_frame(ren, i);
+            }
+        }
+        const replay_stats_t &after = this->impl->stats;
+        return {
+            .frames = after.frames - before.frames,
+            .commands = after.commands - before.commands,
+            .skipped = after.skipped - before.skipped
+        };
+    }
+
+    const replay_stats_t &command_replayer_t::get_stats() const {
+        return this->impl->stats;
+    }
+
+    void command_replayer_t::release() {
+        if (this->impl != nullptr) {
+            this->impl->release();
+        }
+    }
+}
@@ -0,0 +1,863 @@
+#include "rocket/render_thread.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/runtime.hpp"
+#include "rocket/threads.hpp"
+#include "rocket/window.hpp"
+#include "intl_macros.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace rocket::globals {
+    extern std::thread::id g_main_thread_id;
+    extern std::atomic<std::thread::id> g_graphics_thread_id;
+}
+
+namespace rocket {
+    namespace {
+        enum class op_t : uint8_t {
+            begin_frame,
+            clear,
+            scissor_begin,
+            scissor_end,
+            render_mode_begin,
+            render_mode_end,
+            rectangle,
+            circle,
+            polygon,
+            texture,
+            atlas_texture,
+            text,
+            pixel,
+            fps,
+            gpu_region_begin,
+            gpu_region_end,
+            cache_begin,
+            cache_end,
+            cache_draw,
+            /// Anything rare goes through command_list_t::calls
+            call,
+        };
+
+        /// @brief One recorded call, each op reads the fields it needs
+        struct command_t {
+            op_t op = op_t::call;
+            uint8_t flag = 0;
+            int32_t ival = 0;
+            uint32_t ref = 0;
+            float f0 = 0.f;
+            float f1 = 0.f;
+            fbounding_box rect = {};
+            rgba_color color = {};
+            vec2f_t a = {};
+            vec2f_t b = {};
+            const void *ptr = nullptr;
+        };
+
+        /// @brief Calls of (part of) a frame, reused once rendered
+        struct command_list_t {
+            std::vector<command_t> commands;
+            std::vector<std::shared_ptr<texture_t>> textures;
+            std::vector<text_t> texts;
+            std::vector<std::function<void(renderer_2d_i *)>> calls;
+            bool ends_frame = false;
+
+            bool empty() const { return commands.empty(); }
+
+            void reset() {
+                // Keeps the capacity, steady frames record without allocating
+                commands.clear();
+                textures.clear();
+                texts.clear();
+                calls.clear();
+                ends_frame = false;
+            }
+        };
+
+        void replay(const command_list_t &list, renderer_2d_i *r) {
+            for (const command_t &c : list.commands) {
+                switch (c.op) {
+                    case op_t::begin_frame:
+                        r->begin_frame();
+                        break;
+                    case op_t::clear:
+                        r->clear(c.color);
+                        break;
+                    case op_t::scissor_begin:
+                        r->begin_scissor_mode(c.rect);
+                        break;
+                    case op_t::scissor_end:
+                        r->end_scissor_mode();
+                        break;
+                    case op_t::render_mode_begin:
+                        r->begin_render_mode(static_cast<render_mode_t>(c.ival));
+                        break;
+                    case op_t::render_mode_end:
+                        r->end_render_mode(static_cast<render_mode_t>(c.ival));
+                        break;
+                    case op_t::rectangle:
+                        r->draw_rectangle(c.rect, c.color, c.f0, c.f1, c.flag != 0);
+                        break;
+                    case op_t::circle:
+                        r->draw_circle(c.a, c.f0, c.color, c.ival);
+                        break;
+                    case op_t::polygon:
+                        r->draw_polygon(c.a, c.f0, c.color, c.ival, c.f1);
+                        break;
+                    case op_t::texture:
+                        r->draw_texture(list.textures[c.ref], c.rect, c.f0, c.f1);
+                        break;
+                    case op_t::atlas_texture:
+                        r->draw_atlas_texture(list.textures[c.ref], c.rect, c.a, c.b, c.f0, c.f1);
+                        break;
+                    case op_t::text:
+                        r->draw_text(list.texts[c.ref], c.a);
+                        break;
+                    case op_t::pixel:
+                        r->draw_pixel(c.a, c.color);
+                        break;
+                    case op_t::fps:
+                        r->draw_fps(c.a);
+                        break;
+                    case op_t::gpu_region_begin:
+                        r->begin_gpu_region(static_cast<const char *>(c.ptr));
+                        break;
+                    case op_t::gpu_region_end:
+                        r->end_gpu_region();
+                        break;
+                    case op_t::cache_begin:
+                        r->begin_render_cache(static_cast<render_cache_t *>(const_cast<void *>(c.ptr)));
+                        break;
+                    case op_t::cache_end:
+                        r->end_render_cache(static_cast<render_cache_t *>(const_cast<void *>(c.ptr)));
+                        break;
+                    case op_t::cache_draw:
+                        r->draw_render_cache(static_cast<render_cache_t *>(const_cast<void *>(c.ptr)), c.a, c.b);
+                        break;
+                    case op_t::call:
+                        list.calls[c.ref](r);
+                        break;
+                }
+            }
+        }
+
+        /// @brief Inner renderer state as of the last rendered frame
+        struct frame_snapshot_t {
+            vec2f_t viewport = {};
+            double delta_time = 0.0;
+            uint64_t framecount = 0;
+            int drawcalls = 0;
+            float current_fps = 0.f;
+            rgl::draw_metrics_t metrics = {};
+            glm::mat4 camera_matrix = glm::mat4(1.f);
+        };
+    }
+
+    struct threaded_renderer_2d_impl_t {
+        struct job_t {
+            std::unique_ptr<command_list_t> list;
+            std::function<void()> fn;
+        };
+
+        threaded_renderer_options_t options;
+        std::thread thread;
+        /// Read from any thread, see clean_gpu_resource
+        std::atomic<std::thread::id> render_thread_id;
+        std::atomic_bool running = false;
+
+        /// Only touched by the recording thread
+        std::unique_ptr<command_list_t> current;
+
+        std::mutex mutex;
+        /// Wakes the render thread
+        std::condition_variable work_cv;
+        /// Wakes anyone waiting on the render thread
+        std::condition_variable done_cv;
+        std::deque<job_t> jobs;
+        std::vector<std::unique_ptr<command_list_t>> free_lists;
+        uint64_t frames_submitted = 0;
+        uint64_t frames_completed = 0;
+        bool busy = false;
+        bool stopping = false;
+        frame_snapshot_t snapshot;
+        std::deque<framebuffer_readback_t> readbacks;
+
+        bool was_global = false;
+
+        bool on_render_thread() const {
+            return this->running && std::this_thread::get_id() == this->render_thread_id.load();
+        }
+
+        void post(std::function<void()> fn) {
+            {
+                std::lock_guard<std::mutex> _(this->mutex);
+                this->jobs.push_back({ nullptr, std::move(fn) });
+            }
+            this->work_cv.notify_one();
+        }
+
+        command_t &push(op_t op) {
+            command_t &c = this->current->commands.emplace_back();
+            c.op = op;
+            return c;
+        }
+
+        void push_call(std::function<void(renderer_2d_i *)> fn) {
+            command_t &c = this->push(op_t::call);
+            c.ref = static_cast<uint32_t>(this->current->calls.size());
+            this->current->calls.push_back(std::move(fn));
+        }
+
+        uint32_t push_texture(std::shared_ptr<texture_t> texture) {
+            this->current->textures.push_back(std::move(texture));
+            return static_cast<uint32_t>(this->current->textures.size() - 1);
+        }
+    };
+
+    threaded_renderer_2d::threaded_renderer_2d(renderer_2d_i *inner, threaded_renderer_options_t options) {
+        r_assert(inner != nullptr);
+        this->inner = inner;
+        this->window = inner->get_window_backend();
+        this->flags = inner->get_renderer_flags_state();
+        this->fps = inner->get_fps();
+        this->vsync = inner->get_vsync();
+        this->wireframe = inner->get_wireframe();
+        this->graphics_settings = inner->get_graphics_settings();
+        this->cam = inner->get_camera();
+        this->override_viewport_size = inner->get_override_viewport_size_state();
+        this->override_viewport_offset = inner->get_override_viewport_offset_state();
+
+        auto *ti = new threaded_renderer_2d_impl_t;
+        this->thr_impl = ti;
+        ti->options = options;
+        if (options.latency < 1 || options.latency > 2) {
+            rocket::log("latency must be 1 or 2 frames, clamping", "threaded_renderer_2d", "constructor", "warn");
+            ti->options.latency = std::clamp(options.latency, 1, 2);
+        }
+        ti->current = std::make_unique<command_list_t>();
+        ti->snapshot.viewport = inner->get_viewport_size();
+        ti->snapshot.framecount = inner->get_framecount();
+        ti->snapshot.camera_matrix = inner->get_camera_matrix();
+
+        // Fonts upload through the global renderer, that has to be the one
+        // that knows which thread owns the context
+        if (util::get_global_renderer_2d() == inner) {
+            util::set_global_renderer_2d(this);
+            ti->was_global = true;
+        }
+
+        if (this->window != nullptr) {
+            this->window->make_context_current(false);
+        }
+        ti->running = true;
+        ti->thread = std::thread(&threaded_renderer_2d::render_thread_main, this);
+    }
+
+    threaded_renderer_2d::~threaded_renderer_2d() {
+        this->stop();
+        delete this->thr_impl;
+        this->thr_impl = nullptr;
+    }
+
+    void threaded_renderer_2d::render_thread_main(threaded_renderer_2d *self) {
+        auto *ti = self->thr_impl;
+        rocket::thread_t::set_thread_name("rge_render");
+        // Set here, the thread may already be recording before std::thread returns
+        ti->render_thread_id = std::this_thread::get_id();
+        if (self->window != nullptr) {
+            self->window->make_context_current(true);
+        }
+        globals::g_graphics_thread_id = std::this_thread::get_id();
+
+        while (true) {
+            threaded_renderer_2d_impl_t::job_t job;
+            {
+                std::unique_lock<std::mutex> lock(ti->mutex);
+                ti->work_cv.wait(lock, [ti]() { return !ti->jobs.empty() || ti->stopping; });
+                if (ti->jobs.empty()) {
+                    break;
+                }
+                job = std::move(ti->jobs.front());
+                ti->jobs.pop_front();
+                ti->busy = true;
+            }
+
+            if (job.fn) {
+                job.fn();
+            }
+
+            bool frame_done = false;
+            frame_snapshot_t snapshot;
+            std::vector<framebuffer_readback_t> readbacks;
+            if (job.list) {
+                ROCKET_PROFILE_SCOPE("threaded_renderer_2d::replay");
+                replay(*job.list, self->inner);
+                if (job.list->ends_frame) {
+                    snapshot.drawcalls = self->inner->get_drawcalls();
+                    self->inner->end_frame();
+                    snapshot.viewport = self->inner->get_viewport_size();
+                    snapshot.delta_time = self->inner->get_delta_time();
+                    snapshot.framecount = self->inner->get_framecount();
+                    snapshot.current_fps = self->inner->get_current_fps();
+                    snapshot.metrics = self->inner->get_draw_metrics();
+                    snapshot.camera_matrix = self->inner->get_camera_matrix();
+                    framebuffer_readback_t readback;
+                    while (self->inner->poll_framebuffer_readback(readback)) {
+                        readbacks.push_back(std::move(readback));
+                    }
+                    frame_done = true;
+                }
+                job.list->reset();
+            }
+
+            {
+                std::lock_guard<std::mutex> _(ti->mutex);
+                if (job.list) {
+                    ti->free_lists.push_back(std::move(job.list));
+                }
+                if (frame_done) {
+                    ti->snapshot = snapshot;
+                    for (auto &readback : readbacks) {
+                        ti->readbacks.push_back(std::move(readback));
+                    }
+                    ti->frames_completed++;
+                }
+                ti->busy = false;
+            }
+            ti->done_cv.notify_all();
+        }
+
+        globals::g_graphics_thread_id = globals::g_main_thread_id;
+        if (self->window != nullptr) {
+            self->window->make_context_current(false);
+        }
+    }
+
+    void threaded_renderer_2d::submit(bool ends_frame) {
+        auto *ti = this->thr_impl;
+        ti->current->ends_frame = ends_frame;
+        if (!ti->running) {
+            // Closed, whatever is left runs here
+            replay(*ti->current, this->inner);
+            if (ends_frame) {
+                this->inner->end_frame();
+            }
+            ti->current->reset();
+            return;
+        }
+
+        std::unique_ptr<command_list_t> next;
+        {
+            std::lock_guard<std::mutex> _(ti->mutex);
+            ti->jobs.push_back({ std::move(ti->current), nullptr });
+            if (ends_frame) {
+                ti->frames_submitted++;
+            }
+            if (!ti->free_lists.empty()) {
+                next = std::move(ti->free_lists.back());
+                ti->free_lists.pop_back();
+            }
+        }
+        ti->work_cv.notify_one();
+        ti->current = next ? std::move(next) : std::make_unique<command_list_t>();
+    }
+
+    void threaded_renderer_2d::run_sync(std::function<void()> fn) {
+        auto *ti = this->thr_impl;
+        if (!ti->running || ti->on_render_thread()) {
+            fn();
+            return;
+        }
+        // Everything recorded before has to land first
+        if (!ti->current->empty()) {
+            this->submit(false);
+        }
+        std::promise<void> done;
+        std::future<void> finished = done.get_future();
+        ti->post([&fn, &done]() {
+            fn();
+            done.set_value();
+        });
+        finished.wait();
+    }
+
+    void threaded_renderer_2d::stop() {
+        auto *ti = this->thr_impl;
+        if (ti == nullptr || !ti->running) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> _(ti->mutex);
+            ti->stopping = true;
+        }
+        ti->work_cv.notify_one();
+        ti->thread.join();
+        ti->running = false;
+
+        if (this->window != nullptr) {
+            this->window->make_context_current(true);
+        }
+        if (ti->was_global && util::get_global_renderer_2d() == this) {
+            util::set_global_renderer_2d(this->inner);
+        }
+    }
+
+    int threaded_renderer_2d::get_frames_in_flight() const {
+        auto *ti = this->thr_impl;
+        std::lock_guard<std::mutex> _(ti->mutex);
+        return static_cast<int>(ti->frames_submitted - ti->frames_completed);
+    }
+
+    void threaded_renderer_2d::wait_idle() {
+        auto *ti = this->thr_impl;
+        if (!ti->running || ti->on_render_thread()) {
+            return;
+        }
+        if (!ti->current->empty()) {
+            this->submit(false);
+        }
+        std::unique_lock<std::mutex> lock(ti->mutex);
+        ti->done_cv.wait(lock, [ti]() { return ti->jobs.empty() && !ti->busy; });
+    }
+
+    renderer_2d_i::gfx_chk_result threaded_renderer_2d::check_graphics_settings(rocket::vec2f_t, rocket::vec2f_t) {
+        // The inner renderer culls
+        return gfx_chk_result::drawable;
+    }
+
+    api_object_t threaded_renderer_2d::upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) {
+        api_object_t handle = 0;
+        this->run_sync([&]() {
+            handle = this->inner->upload_font_texture_to_gpu(size, bitmap);
+        });
+        return handle;
+    }
+
+    void threaded_renderer_2d::clean_gpu_resource(api_object_t object) {
+        auto *ti = this->thr_impl;
+        if (!ti->running || ti->on_render_thread()) {
+            this->inner->clean_gpu_resource(object);
+            return;
+        }
+        // Can come from any thread, nothing to wait for
+        ti->post([this, object]() {
+            this->inner->clean_gpu_resource(object);
+        });
+    }
+
+    bool threaded_renderer_2d::has_frame_began() {
+        return this->frame_started;
+    }
+
+    bool threaded_renderer_2d::has_frame_ended() {
+        return !this->frame_started;
+    }
+
+    void threaded_renderer_2d::begin_frame() {
+        this->frame_started = true;
+        this->thr_impl->push(op_t::begin_frame);
+    }
+
+    void threaded_renderer_2d::end_frame() {
+        ROCKET_PROFILE_SCOPE("threaded_renderer_2d::end_frame");
+        if (!this->frame_started) {
+            return;
+        }
+        this->flush_command_buckets();
+        this->frame_started = false;
+        this->submit(true);
+
+        auto *ti = this->thr_impl;
+        if (!ti->running) {
+            return;
+        }
+        const uint64_t latency = static_cast<uint64_t>(ti->options.latency);
+        std::unique_lock<std::mutex> lock(ti->mutex);
+        ti->done_cv.wait(lock, [ti, latency]() { return ti->frames_submitted - ti->frames_completed <= latency; });
+    }
+
+    void threaded_renderer_2d::show_splash() {
+        auto *ti = this->thr_impl;
+        if (!ti->running) {
+            this->inner->show_splash();
+            return;
+        }
+        // The splash polls the window, which only works on this thread
+        this->wait_idle();
+        this->run_sync([this]() {
+            globals::g_graphics_thread_id = globals::g_main_thread_id;
+            if (this->window != nullptr) {
+                this->window->make_context_current(false);
+            }
+        });
+        // Calls made by the splash (font uploads) run right here meanwhile
+        ti->running = false;
+        if (this->window != nullptr) {
+            this->window->make_context_current(true);
+        }
+        globals::g_graphics_thread_id = std::this_thread::get_id();
+        this->inner->show_splash();
+        if (this->window != nullptr) {
+            this->window->make_context_current(false);
+        }
+        ti->running = true;
+        this->run_sync([this]() {
+            if (this->window != nullptr) {
+                this->window->make_context_current(true);
+            }
+            globals::g_graphics_thread_id = std::this_thread::get_id();
+        });
+        this->splash_shown = true;
+    }
+
+    void threaded_renderer_2d::begin_render_mode(render_mode_t mode) {
+        // Culling runs on this thread against the wrapper's own camera state
+        if (mode == render_mode_t::camera) {
+            this->begin_camera_mode();
+        }
+        this->thr_impl->push(op_t::render_mode_begin).ival = static_cast<int32_t>(mode);
+    }
+
+    void threaded_renderer_2d::end_render_mode(render_mode_t mode) {
+        if (mode == render_mode_t::camera) {
+            this->end_camera_mode();
+        }
+        this->thr_impl->push(op_t::render_mode_end).ival = static_cast<int32_t>(mode);
+    }
+
+    std::vector<rgba_color> threaded_renderer_2d::get_framebuffer() {
+        std::vector<rgba_color> pixels;
+        this->run_sync([&]() {
+            pixels = this->inner->get_framebuffer();
+        });
+        return pixels;
+    }
+
+    void threaded_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
+        this->thr_impl->push_call([framebuffer](renderer_2d_i *r) {
+            r->push_framebuffer(framebuffer);
+        });
+    }
+
+    void threaded_renderer_2d::push_canvas() {
+        framebuffer_canvas_t &src = this->canvas;
+        const vec2i_t size = src.get_size();
+        std::vector<canvas_rect_t> rects = src.get_dirty_rects();
+        std::vector<rgba_color> pixels;
+        for (const canvas_rect_t &rect : rects) {
+            for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                const rgba_color *row = &src.at(rect.x, y);
+                pixels.insert(pixels.end(), row, row + rect.w);
+            }
+        }
+        src.clear_dirty();
+
+        this->thr_impl->push_call([size, rects = std::move(rects), pixels = std::move(pixels)](renderer_2d_i *r) {
+            framebuffer_canvas_t &dst = r->get_canvas();
+            if (size.x == dst.get_size().x && size.y == dst.get_size().y) {
+                const rgba_color *next = pixels.data();
+                for (const canvas_rect_t &rect : rects) {
+                    for (int y = rect.y; y < rect.y + rect.h; ++y) {
+                        std::memcpy(&dst.at(rect.x, y), next, static_cast<size_t>(rect.w) * sizeof(rgba_color));
+                        next += rect.w;
+                    }
+                    dst.mark_dirty(rect);
+                }
+            }
+            r->push_canvas();
+        });
+    }
+
+    void threaded_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+        this->thr_impl->push_call([region](renderer_2d_i *r) {
+            r->request_framebuffer_readback(region);
+        });
+    }
+
+    bool threaded_renderer_2d::poll_framebuffer_readback(framebuffer_readback_t &out) {
+        auto *ti = this->thr_impl;
+        std::lock_guard<std::mutex> _(ti->mutex);
+        if (ti->readbacks.empty()) {
+            return false;
+        }
+        out = std::move(ti->readbacks.front());
+        ti->readbacks.pop_front();
+        return true;
+    }
+
+    vec2f_t threaded_renderer_2d::get_viewport_size() {
+        if (this->override_viewport_size != vec2f_t{ -1.f, -1.f }) {
+            return this->override_viewport_size;
+        }
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.viewport;
+    }
+
+    void threaded_renderer_2d::begin_scissor_mode(rocket::fbounding_box rect) {
+        this->thr_impl->push(op_t::scissor_begin).rect = rect;
+    }
+
+    void threaded_renderer_2d::begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) {
+        this->begin_scissor_mode({ pos, size });
+    }
+
+    void threaded_renderer_2d::begin_scissor_mode(float x, float y, float sx, float sy) {
+        this->begin_scissor_mode({ { x, y }, { sx, sy } });
+    }
+
+    void threaded_renderer_2d::end_scissor_mode() {
+        this->thr_impl->push(op_t::scissor_end);
+    }
+
+    void threaded_renderer_2d::clear(rocket::rgba_color color) {
+        this->thr_impl->push(op_t::clear).color = color;
+    }
+
+    void threaded_renderer_2d::draw_shader(const shader_i &shader) {
+        this->thr_impl->push_call([s = &shader](renderer_2d_i *r) {
+            r->draw_shader(*s);
+        });
+    }
+
+    void threaded_renderer_2d::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        command_t &c = this->thr_impl->push(op_t::rectangle);
+        c.rect = rect;
+        c.color = color;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+        c.flag = lines;
+    }
+
+    void threaded_renderer_2d::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        this->draw_rectangle({ pos, size }, color, rotation, roundedness, lines);
+    }
+
+    void threaded_renderer_2d::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        command_t &c = this->thr_impl->push(op_t::circle);
+        c.a = pos;
+        c.f0 = radius;
+        c.color = color;
+        c.ival = thickness;
+    }
+
+    void threaded_renderer_2d::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int sides, float rotation) {
+        command_t &c = this->thr_impl->push(op_t::polygon);
+        c.a = pos;
+        c.f0 = radius;
+        c.color = color;
+        c.ival = sides;
+        c.f1 = rotation;
+    }
+
+    void threaded_renderer_2d::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        auto *ti = this->thr_impl;
+        const uint32_t ref = ti->push_texture(std::move(texture));
+        command_t &c = ti->push(op_t::texture);
+        c.ref = ref;
+        c.rect = rect;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+    }
+
+    void threaded_renderer_2d::draw_atlas_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, rocket::vec2f_t texture_position_in_atlas, rocket::vec2f_t texture_size_in_atlas, float rotation, float roundedness) {
+        auto *ti = this->thr_impl;
+        const uint32_t ref = ti->push_texture(std::move(texture));
+        command_t &c = ti->push(op_t::atlas_texture);
+        c.ref = ref;
+        c.rect = rect;
+        c.a = texture_position_in_atlas;
+        c.b = texture_size_in_atlas;
+        c.f0 = rotation;
+        c.f1 = roundedness;
+    }
+
+    void threaded_renderer_2d::make_ready_texture(std::shared_ptr<rocket::texture_t> texture) {
+        this->thr_impl->push_call([texture = std::move(texture)](renderer_2d_i *r) {
+            r->make_ready_texture(texture);
+        });
+    }
+
+    void threaded_renderer_2d::draw_text(const rocket::text_t &text, vec2f_t position) {
+        auto *ti = this->thr_impl;
+        ti->current->texts.push_back(text);
+        command_t &c = ti->push(op_t::text);
+        c.ref = static_cast<uint32_t>(ti->current->texts.size() - 1);
+        c.a = position;
+    }
+
+    void threaded_renderer_2d::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        command_t &c = this->thr_impl->push(op_t::pixel);
+        c.a = pos;
+        c.color = color;
+    }
+
+    void threaded_renderer_2d::draw_fps(vec2f_t pos) {
+        this->thr_impl->push(op_t::fps).a = pos;
+    }
+
+    void threaded_renderer_2d::begin_gpu_region(const char *name) {
+        // Names outlive the renderer, the pointer is enough
+        this->thr_impl->push(op_t::gpu_region_begin).ptr = name;
+    }
+
+    void threaded_renderer_2d::end_gpu_region() {
+        this->thr_impl->push(op_t::gpu_region_end);
+    }
+
+    void threaded_renderer_2d::set_wireframe(bool wireframe) {
+        this->wireframe = wireframe;
+        this->thr_impl->push_call([wireframe](renderer_2d_i *r) {
+            r->set_wireframe(wireframe);
+        });
+    }
+
+    void threaded_renderer_2d::set_vsync(bool vsync) {
+        this->vsync = vsync;
+        this->thr_impl->push_call([vsync](renderer_2d_i *r) {
+            r->set_vsync(vsync);
+        });
+    }
+
+    void threaded_renderer_2d::set_fps(int fps) {
+        this->fps = fps;
+        this->thr_impl->push_call([fps](renderer_2d_i *r) {
+            r->set_fps(fps);
+        });
+    }
+
+    void threaded_renderer_2d::set_graphics_settings(graphics_settings_t graphics) {
+        this->graphics_settings = graphics;
+        this->thr_impl->push_call([graphics](renderer_2d_i *r) {
+            r->set_graphics_settings(graphics);
+        });
+    }
+
+    void threaded_renderer_2d::set_viewport_size(vec2f_t size) {
+        this->override_viewport_size = size;
+        this->thr_impl->push_call([size](renderer_2d_i *r) {
+            r->set_viewport_size(size);
+        });
+    }
+
+    void threaded_renderer_2d::set_viewport_offset(vec2f_t zero_pos) {
+        this->override_viewport_offset = zero_pos;
+        this->thr_impl->push_call([zero_pos](renderer_2d_i *r) {
+            r->set_viewport_offset(zero_pos);
+        });
+    }
+
+    void threaded_renderer_2d::set_camera(camera_2d *cam) {
+        this->cam = cam;
+        this->thr_impl->push_call([cam](renderer_2d_i *r) {
+            r->set_camera(cam);
+        });
+    }
+
+    void threaded_renderer_2d::close() {
+        this->run_sync([this]() {
+            this->inner->close();
+        });
+        this->stop();
+        // Closed renderers drop out of the global slot, same as the inner one would
+        if (this->thr_impl->was_global && util::get_global_renderer_2d() == this->inner) {
+            util::set_global_renderer_2d(nullptr);
+        }
+    }
+
+    bool threaded_renderer_2d::get_wireframe() { return this->wireframe; }
+    bool threaded_renderer_2d::get_vsync() { return this->vsync; }
+    int threaded_renderer_2d::get_fps() { return this->fps; }
+    const graphics_settings_t &threaded_renderer_2d::get_graphics_settings() { return this->graphics_settings; }
+    camera_2d *threaded_renderer_2d::get_camera() { return this->cam; }
+
+    double threaded_renderer_2d::get_delta_time() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.delta_time;
+    }
+
+    uint64_t threaded_renderer_2d::get_framecount() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.framecount;
+    }
+
+    int threaded_renderer_2d::get_drawcalls() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.drawcalls;
+    }
+
+    rgl::draw_metrics_t threaded_renderer_2d::get_draw_metrics() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.metrics;
+    }
+
+    glm::mat4 threaded_renderer_2d::get_camera_matrix() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.camera_matrix;
+    }
+
+    float threaded_renderer_2d::get_current_fps() {
+        std::lock_guard<std::mutex> _(this->thr_impl->mutex);
+        return this->thr_impl->snapshot.current_fps;
+    }
+
+    api_object_t threaded_renderer_2d::get_framebuffer_texture() {
+        api_object_t texture = 0;
+        this->run_sync([&]() {
+            texture = this->inner->get_framebuffer_texture();
+        });
+        return texture;
+    }
+
+    render_cache_t *threaded_renderer_2d::create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size) {
+        render_cache_t *cache = nullptr;
+        this->run_sync([&]() {
+            cache = this->inner->create_render_cache(draw_cb, size);
+        });
+        return cache;
+    }
+
+    void threaded_renderer_2d::invalidate_render_cache(render_cache_t *c) {
+        this->thr_impl->push_call([c](renderer_2d_i *r) {
+            r->invalidate_render_cache(c);
+        });
+    }
+
+    void threaded_renderer_2d::update_render_cache(render_cache_t *c) {
+        this->thr_impl->push_call([c](renderer_2d_i *r) {
+            r->update_render_cache(c);
+        });
+    }
+
+    void threaded_renderer_2d::begin_render_cache(render_cache_t *c) {
+        this->thr_impl->push(op_t::cache_begin).ptr = c;
+    }
+
+    void threaded_renderer_2d::end_render_cache(render_cache_t *c) {
+        this->thr_impl->push(op_t::cache_end).ptr = c;
+    }
+
+    void threaded_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        command_t &cmd = this->thr_impl->push(op_t::cache_draw);
+        cmd.ptr = c;
+        cmd.a = pos;
+        cmd.b = sz;
+    }
+
+    void threaded_renderer_2d::draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) {
+        this->draw_render_cache(c, bbox.pos, bbox.size);
+    }
+
+    void threaded_renderer_2d::destroy_render_cache(render_cache_t *&c) {
+        this->thr_impl->push_call([target = c](renderer_2d_i *r) mutable {
+            r->destroy_render_cache(target);
+        });
+        c = nullptr;
+    }
+}
@@ -3,6 +3,8 @@
 #include <rocket/renderer_helpers.hpp>
 #include <util.hpp>
 #include <stack>
+#include <algorithm>
+#include <cmath>
 
 #define MAJOR(x) ((x) / 10)
 #define MINOR(x) ((x) % 10)
@@ -22,6 +24,8 @@ namespace rocket {
                     return std::make_unique<opengl_renderer_2d>(window, fps, flags);
                 case rocket::renderer_backend_t::vulkan:
                     return std::make_unique<vulkan_renderer_2d>(window, fps, flags);
+                case rocket::renderer_backend_t::software:
+                    return std::make_unique<software_renderer_2d>(window, fps, flags);
                 case rocket::renderer_backend_t::null:
                     return std::make_unique<null_renderer_2d>();
                 default: return std::make_unique<null_renderer_2d>();
@@ -41,6 +45,7 @@ namespace rocket {
                     return test_gl(win);
                 case rocket::renderer_backend_t::vulkan:
                     return test_vk(win);
+                case rocket::renderer_backend_t::software:
                 case rocket::renderer_backend_t::null:
                     return VERSION(1, 0);
                 default: return 0;
@@ -63,11 +68,22 @@ namespace rocket {
             //
             // Order of picking:
             // ---
+            // Software
             // Vulkan
             // OpenGL
             // <Requested>
             // <CLI Override>
             // ---
+            if (
+                choice & renderer_choice::software
+                && std::find(
+                    cli_args.blacklisted_apis.begin(), 
+                    cli_args.blacklisted_apis.end(), 
+                    renderer_backend_t::software
+                ) == cli_args.blacklisted_apis.end()
+            ) {
+                stk.push(renderer_backend_t::software);
+            }
             if (
                 caps.max_vk_version != 0 
                 && choice & renderer_choice::vulkan
@@ -122,4 +138,95 @@ namespace rocket {
             window, fps, flags
         );
     }
+
+    static bool rects_touch(const canvas_rect_t &a, const canvas_rect_t &b) {
+        return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+    }
+
+    static canvas_rect_t rect_union(const canvas_rect_t &a, const canvas_rect_t &b) {
+        int x0 = std::min(a.x, b.x);
+        int y0 = std::min(a.y, b.y);
+        int x1 = std::max(a.x + a.w, b.x + b.w);
+        int y1 = std::max(a.y + a.h, b.y + b.h);
+        return { x0, y0, x1 - x0, y1 - y0 };
+    }
+
+    void framebuffer_canvas_t::mark_dirty(canvas_rect_t rect) {
+        int x0 = std::clamp(rect.x, 0, size.x);
+        int y0 = std::clamp(rect.y, 0, size.y);
+        int x1 = std::clamp(rect.x + rect.w, 0, size.x);
+        int y1 = std::clamp(rect.y + rect.h, 0, size.y);
+        if (x1 <= x0 || y1 <= y0) {
+            return;
+        }
+        rect = { x0, y0, x1 - x0, y1 - y0 };
+
+        // Merge with everything it touches so the list stays non-overlapping
+        for (size_t i = 0; i < dirty.size();) {
+            if (rects_touch(dirty[i], rect)) {
+                rect = rect_union(dirty[i], rect);
+                dirty[i] = dirty.back();
+                dirty.pop_back();
+                i = 0;
+            } else {
+                i++;
+            }
+        }
+        dirty.push_back(rect);
+
+        if (dirty.size() > max_dirty_rects) {
+            canvas_rect_t bounds = dirty.front();
+            for (auto &r : dirty) {
+                bounds = rect_union(bounds, r);
+            }
+            dirty.assign(1, bounds);
+        }
+    }
+
+    void framebuffer_canvas_t::mark_dirty(rocket::fbounding_box rect) {
+        int x0 = static_cast<int>(std::floor(rect.pos.x));
+        int y0 = static_cast<int>(std::floor(rect.pos.y));
+        int x1 = static_cast<int>(std::ceil(rect.pos.x + rect.size.x));
+        int y1 = static_cast<int>(std::ceil(rect.pos.y + rect.size.y));
+        mark_dirty(canvas_rect_t { x0, y0, x1 - x0, y1 - y0 });
+    }
+
+    void framebuffer_canvas_t::mark_all_dirty() {
+        dirty.clear();
+        if (size.x > 0 && size.y > 0) {
+            dirty.push_back({ 0, 0, size.x, size.y });
+        }
+    }
+
+    void framebuffer_canvas_t::fill(rgba_color color) {
+        std::fill(pixels.begin(), pixels.end(), color);
+        mark_all_dirty();
+    }
+
+    void framebuffer_canvas_t::resize(rocket::vec2i_t new_size) {
+        new_size = { std::max(new_size.x, 0), std::max(new_size.y, 0) };
+        if (new_size.x == size.x && new_size.y == size.y) {
+            return;
+        }
+
+        std::vector<rgba_color> resized(static_cast<size_t>(new_size.x) * new_size.y, rgba_color::blank());
+        const int copy_w = std::min(size.x, new_size.x);
+        const int copy_h = std::min(size.y, new_size.y);
+        for (int row = 0; row < copy_h; ++row) {
+            std::copy_n(
+                pixels.begin() + static_cast<size_t>(row) * size.x, copy_w,
+                resized.begin() + static_cast<size_t>(row) * new_size.x
+            );
+        }
+
+        pixels = std::move(resized);
+        size = new_size;
+        mark_all_dirty();
+    }
+
+    framebuffer_canvas_t &renderer_2d_i::get_canvas() {
+        vec2f_t viewport = this->get_viewport_size();
+        this->canvas.resize({ static_cast<int>(viewport.x), static_cast<int>(viewport.y) });
+        return this->canvas;
+    }
 }
@@ -37,12 +37,14 @@ namespace rocket {
     void null_renderer_2d::begin_render_mode(render_mode_t mode) {
     }
 
-    render_cache_t* null_renderer_2d::create_render_cache(std::function<void(renderer_2d_i*)> cb) {
+    render_cache_t* null_renderer_2d::create_render_cache(std::function<void(renderer_2d_i*)> cb, rocket::vec2i_t size) {
         return nullptr;
     }
 
     void null_renderer_2d::invalidate_render_cache(render_cache_t *c) {}
 
+    void null_renderer_2d::update_render_cache(render_cache_t *c) {}
+
     void null_renderer_2d::begin_render_cache(render_cache_t *c) {}
 
     void null_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
@@ -108,6 +110,12 @@ namespace rocket {
     void null_renderer_2d::draw_fps(vec2f_t pos) {
     }
 
+    void null_renderer_2d::begin_gpu_region(const char *name) {
+    }
+
+    void null_renderer_2d::end_gpu_region() {
+    }
+
     std::vector<rgba_color> null_renderer_2d::get_framebuffer() {
         return {};
     }
@@ -115,6 +123,17 @@ namespace rocket {
     void null_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
     }
 
+    void null_renderer_2d::push_canvas() {
+        this->canvas.clear_dirty();
+    }
+
+    void null_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+    }
+
+    bool null_renderer_2d::poll_framebuffer_readback(framebuffer_readback_t &out) {
+        return false;
+    }
+
     vec2f_t null_renderer_2d::get_viewport_size() {
         return {};
     }
@@ -131,9 +150,13 @@ namespace rocket {
     }
 
     void null_renderer_2d::end_frame() {
+        this->flush_command_buckets();
     }
 
     double null_renderer_2d::get_delta_time() {
+        if (double fixed = util::input_replay_delta_time(); fixed > 0.0) {
+            return fixed;
+        }
         return delta_time;
     }
 
@@ -11,14 +11,18 @@
 #include "rocket/asset.hpp"
 #include "rocket/io.hpp"
 #include "rocket/plugin/plugin.hpp"
+#include "rocket/profiler.hpp"
 #include "rocket/runtime.hpp"
 #include "rocket/types.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <iostream>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 #include "rgl.hpp"
@@ -151,6 +155,14 @@ namespace rocket {
         this->flags = flags;
         glViewport(0, 0, window->size.x, window->size.y);
 
+        if (flags.async_shader_compile) {
+            rgl::compile_all_default_shaders_async();
+        }
+
+        if (cli_args.gpu_timing) {
+            rgl::set_gpu_timing(true);
+        }
+
         ::rocket::ovr_clistate = util::get_clistate();
 
         if (flags.show_splash && (!this->splash_shown)) {
@@ -158,6 +170,14 @@ namespace rocket {
         }
     }
     
+    bool opengl_renderer_2d::shader_ready(shader_id_t id) {
+        if (!this->impl->render_cache_use_stack.empty()) {
+            rocket::gl_get_shader(id);
+            return true;
+        }
+        return rocket::gl_try_get_shader(id) != rGL_SHADER_INVALID;
+    }
+
     opengl_renderer_2d::gfx_chk_result opengl_renderer_2d::check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) {
         if (!this->frame_started) return gfx_chk_result::not_drawable;
         if (this->graphics_settings.viewport_culling) {
@@ -165,7 +185,7 @@ namespace rocket {
                 return gfx_chk_result::drawable;
 
             rocket::fbounding_box obj = {pos, sz};
-            rocket::fbounding_box vp = {{0,0}, this->get_viewport_size()};
+            rocket::fbounding_box vp = this->get_culling_bounds();
 
             if (!obj.intersects(vp))
                 return gfx_chk_result::not_drawable;
@@ -187,6 +207,7 @@ namespace rocket {
 #else
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, sz.x, sz.y, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.data());
 #endif
+        rgl::add_frame_metrics_data_uploads(1);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -201,6 +222,10 @@ namespace rocket {
             if (k == obj) {
                 if (v.type == gl_object_type_t::texture) {
                     glDeleteTextures(1, &std::get<_GLuint>(v.value));
+                } else if (v.type == gl_object_type_t::vertex_buffer) {
+                    gl_vertex_buffer_t &vb = std::get<gl_vertex_buffer_t>(v.value);
+                    glDeleteBuffers(1, &vb.vbo);
+                    glDeleteVertexArrays(1, &vb.vao);
                 }
                 bk_impl->objects.erase(obj);
                 break;
@@ -210,6 +235,7 @@ namespace rocket {
 
 
     void opengl_renderer_2d::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_circle");
         rocket::vec2f_t center_pos = {
             .x = pos.x - radius,
             .y = pos.y - radius
@@ -220,15 +246,16 @@ namespace rocket {
         }
 
         if (thickness > 0) {
+            if (!this->shader_ready(shader_id_t::circle_lines)) {
+                rgl::add_frame_metrics_data_skipped_drawcalls(1);
+                return;
+            }
             rgl::shader_program_t pg = rocket::gl_get_shader(shader_id_t::circle_lines);
-            rocket::vec2f_t viewport_size = rgl::get_viewport_size();
-            glm::mat4 projection = glm::ortho(0.f, viewport_size.x, viewport_size.y, 0.f, -1.f, 1.f);
 
             float cx = center_pos.x + radius * 2 * 0.5f;
             float cy = center_pos.y + radius * 2 * 0.5f;
 
-            glm::mat4 transform = projection
-                * glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
                 * glm::rotate(glm::mat4(1.0f), glm::radians(0.f), glm::vec3(0.0f, 0.0f, 1.0f))
                 * glm::translate(glm::mat4(1.0f), glm::vec3(-radius * 2 * 0.5f, -radius * 2 * 0.5f, 0.0f))
                 * glm::scale(glm::mat4(1.0f), glm::vec3(radius * 2, radius * 2, 1.0f));
@@ -251,6 +278,7 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int segments, float rotation) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_polygon");
         rocket::vec2f_t center_pos = {
             .x = pos.x - radius,
             .y = pos.y - radius
@@ -259,14 +287,10 @@ namespace rocket {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
-
-        rocket::vec2f_t viewport = rgl::get_viewport_size();
-        auto to_ndc = [&](float x, float y) {
-            return rocket::vec2f_t{
-                (x / viewport.x) * 2.0f - 1.0f,            // X: same
-                1.0f - (y / viewport.y) * 2.0f             // Y: flip
-            };
-        };
+        if (!this->shader_ready(shader_id_t::polygon)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
 
         std::pair<rgl::vao_t, rgl::vbo_t> vo = {0, 0};
         int vertex_count = 0;
@@ -275,10 +299,9 @@ namespace rocket {
             std::vector<float> verts;
             verts.reserve((segments + 2) * 2);
 
-            // center
-            auto center = to_ndc(pos.x, pos.y);
-            verts.push_back(center.x);
-            verts.push_back(center.y);
+            // center, in pixels, rocket_camera projects
+            verts.push_back(pos.x);
+            verts.push_back(pos.y);
 
             for (int i = 0; i <= segments; i++) {
                 float angle = ((float)i / (float)segments) * 2.0f * M_PI;
@@ -286,9 +309,8 @@ namespace rocket {
 
                 float px = pos.x + cosf(angle) * radius;
                 float py = pos.y + sinf(angle) * radius;
-                auto ndc = to_ndc(px, py);
-                verts.push_back(ndc.x);
-                verts.push_back(ndc.y);
+                verts.push_back(px);
+                verts.push_back(py);
             }
 
             vertex_count = (int)(verts.size() / 2);
@@ -312,6 +334,7 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_pixel");
         if (this->check_graphics_settings(pos, {1,1}) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -320,6 +343,7 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_rectangle");
         if (this->check_graphics_settings(pos, size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -329,10 +353,128 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::begin_frame() {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::begin_frame");
         this->frame_started = true;
         frame_start_time = clock::now();
         delta_time = std::chrono::duration<double>(frame_start_time - last_time).count();
         last_time = frame_start_time;
+        rgl::gpu_timer_begin_frame(this->frame_counter);
+        rgl::poll_default_shaders();
+        this->begin_scene_target();
+    }
+
+    void opengl_renderer_2d::begin_scene_target() {
+        auto *bk = this->bk_impl;
+        const dynamic_resolution_t &dr = this->graphics_settings.dynamic_resolution;
+        if (!dr.enabled) {
+            if (bk->scene_fbo != rGL_FBO_INVALID) {
+                rgl::delete_fbo(bk->scene_fbo);
+                bk->scene_fbo = rGL_FBO_INVALID;
+                bk->scene_fbo_size = { 0, 0 };
+                bk->resolution.reset();
+            }
+            return;
+        }
+        // Drawing into a user framebuffer, leave it alone
+        if (rgl::get_active_fbo() != rGL_FBO_INVALID) {
+            return;
+        }
+
+        const float scale = std::clamp(bk->resolution.get_scale(), std::min(dr.min_scale, dr.max_scale), dr.max_scale);
+        if (scale >= 1.f) {
+            return;
+        }
+        const rocket::vec2f_t viewport = rgl::get_viewport_size();
+        const rocket::vec2i_t size = {
+            std::max(1, static_cast<int>(std::lround(viewport.x * scale))),
+            std::max(1, static_cast<int>(std::lround(viewport.y * scale))),
+        };
+        if (size != bk->scene_fbo_size) {
+            if (bk->scene_fbo != rGL_FBO_INVALID) {
+                rgl::delete_fbo(bk->scene_fbo);
+            }
+            bk->scene_fbo = rgl::create_fbo(size);
+            bk->scene_fbo_size = size;
+            glBindTexture(GL_TEXTURE_2D, bk->scene_fbo.color_tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        glGetIntegerv(GL_VIEWPORT, bk->scene_gl_viewport);
+        rgl::use_fbo(bk->scene_fbo);
+        // The projection stays at the viewport size, only the pixels shrink
+        glViewport(0, 0, size.x, size.y);
+        bk->scene_active = true;
+    }
+
+    void opengl_renderer_2d::resolve_scene_target() {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::resolve_scene_target");
+        auto *bk = this->bk_impl;
+        if (!bk->scene_active) {
+            return;
+        }
+        bk->scene_active = false;
+        rgl::reset_to_default_fbo();
+        glViewport(bk->scene_gl_viewport[0], bk->scene_gl_viewport[1], bk->scene_gl_viewport[2], bk->scene_gl_viewport[3]);
+
+        if (bk->upscale_vao == 0) {
+            // Triangle strip: position, uv
+            const float quad[] = {
+                -1.f, -1.f, 0.f, 0.f,
+                 1.f, -1.f, 1.f, 0.f,
+                -1.f,  1.f, 0.f, 1.f,
+                 1.f,  1.f, 1.f, 1.f,
+            };
+            glGenVertexArrays(1, &bk->upscale_vao);
+            glGenBuffers(1, &bk->upscale_vbo);
+            glBindVertexArray(bk->upscale_vao);
+            glBindBuffer(GL_ARRAY_BUFFER, bk->upscale_vbo);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), reinterpret_cast<void *>(0));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), reinterpret_cast<void *>(2 * sizeof(float)));
+        }
+
+        const dynamic_resolution_t &dr = this->graphics_settings.dynamic_resolution;
+        rgl::shader_program_t pg = dr.filter == upscale_filter_t::fxaa
+            ? rgl::get_fxaa_simplified_shader()
+            : rocket::gl_get_shader(shader_id_t::upscale);
+        glUseProgram(pg);
+
+        rgl::texture_unit_handle_t unit;
+        rgl::alloc_texture_unit(unit);
+        glActiveTexture(unit.unit);
+        glBindTexture(GL_TEXTURE_2D, bk->scene_fbo.color_tex);
+        glUniform1i(glGetUniformLocation(pg, "uScene"), unit.unit - GL_TEXTURE0);
+        glUniform2f(glGetUniformLocation(pg, "uResolution"), bk->scene_fbo_size.x, bk->scene_fbo_size.y);
+        if (dr.filter != upscale_filter_t::fxaa) {
+            glUniform1f(glGetUniformLocation(pg, "uSharpness"), dr.filter == upscale_filter_t::sharpen ? dr.sharpness : 0.f);
+        }
+
+        // Replaces the window contents, nothing to blend with
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+        glDisable(GL_BLEND);
+        glDisable(GL_SCISSOR_TEST);
+        rgl::gpu_timer_begin_region("upscale");
+        glBindVertexArray(bk->upscale_vao);
+        rgl::gl_draw_arrays(GL_TRIANGLE_STRIP, 0, 4);
+        rgl::gpu_timer_end_region();
+        if (blend) {
+            glEnable(GL_BLEND);
+        }
+        if (scissor) {
+            glEnable(GL_SCISSOR_TEST);
+        }
+        rgl::free_texture_unit(unit);
+    }
+
+    float opengl_renderer_2d::get_render_scale() {
+        if (this->bk_impl->scene_fbo == rGL_FBO_INVALID || !this->graphics_settings.dynamic_resolution.enabled) {
+            return 1.f;
+        }
+        return std::min(this->bk_impl->resolution.get_scale(), 1.f);
     }
 
     void opengl_renderer_2d::show_splash() {
@@ -394,102 +536,262 @@ namespace rocket {
     rocket::rgba_color this_frame_clear_color = rgba_color::blank();
 
     void opengl_renderer_2d::begin_render_mode(render_mode_t mode) {
-        // if (mode == render_mode_t::camera && this->cam != nullptr) {
-        //     vec2f_t viewport = get_viewport_size();
-        //
-        //     glm::mat4 projection = glm::ortho(0.0f, viewport.x, viewport.y, 0.0f, -1.0f, 1.0f);
-        //
-        //     glm::mat4 view = glm::mat4(1.0f);
-        //     view = glm::translate(view, glm::vec3(-cam->offset.x, -cam->offset.y, 0.0f));
-        //     view = glm::rotate(view, glm::radians(-cam->rotation), glm::vec3(0,0,1));
-        //     view = glm::scale(view, glm::vec3(cam->zoom, cam->zoom, 1.0f));
-        //
-        //     this->impl->camera_transform = projection * view;
-        // }
+        if (mode == render_mode_t::ui) {
+            this->resolve_scene_target();
+        }
+        if (mode == render_mode_t::camera) {
+            this->begin_camera_mode();
+            if (this->camera_active) {
+                this->impl->camera_transform = this->camera_xf.get_matrix();
+                rgl::set_view_matrix(this->impl->camera_transform);
+            }
+        }
 
         active_render_modes.push_back(mode);
     }
 
-    render_cache_t* opengl_renderer_2d::create_render_cache(std::function<void(renderer_2d_i*)> cb) {
+    render_cache_t* opengl_renderer_2d::create_render_cache(std::function<void(renderer_2d_i*)> cb, rocket::vec2i_t size) {
         std::unique_ptr<render_cache_t> c = std::make_unique<render_cache_t>();
-        rgl::fbo_t fbo = rgl::create_fbo();
-        api_object_t hdl = ++this->impl->current_object_handle;
-        gl_object_t obj = this->bk_impl->objects[hdl];
-        obj.value = fbo;
-        obj.type = gl_object_type_t::fbo;
-        c->fbo = hdl;
         c->draw = cb;
+        c->size = size;
+
+        if (!c->follows_viewport() && size.x <= gl_cache_atlas_max_cache && size.y <= gl_cache_atlas_max_cache) {
+            // 1px of padding so linear filtering does not bleed in neighbours
+            const rocket::vec2i_t padded = { std::max(size.x, 1) + 2, std::max(size.y, 1) + 2 };
+            auto &pages = this->bk_impl->cache_atlas_pages;
+            std::optional<rocket::vec2i_t> at;
+            size_t page = 0;
+            for (; page < pages.size(); ++page) {
+                if (pages[page] != nullptr && (at = pages[page]->packer.allocate(padded))) {
+                    break;
+                }
+            }
+            if (!at) {
+                page = 0;
+                while (page < pages.size() && pages[page] != nullptr) {
+                    page++;
+                }
+                if (page == pages.size()) {
+                    pages.emplace_back();
+                }
+                pages[page] = std::make_unique<gl_cache_atlas_page_t>();
+
+                rgl::fbo_t fbo = rgl::create_fbo({ gl_cache_atlas_size, gl_cache_atlas_size });
+                rgl::fbo_t active = rgl::get_active_fbo();
+                rgl::use_fbo(fbo);
+                glClearColor(0, 0, 0, 0);
+                glClear(GL_COLOR_BUFFER_BIT);
+                if (active != rGL_FBO_INVALID) {
+                    rgl::use_fbo(active);
+                } else {
+                    rgl::reset_to_default_fbo();
+                }
 
-        this->bk_impl->objects[hdl] = obj;
-
-        begin_render_cache(c.get());
-        auto off = this->override_viewport_offset;
-        auto sz = this->override_viewport_size;
-        if (this->override_viewport_offset == rocket::vec2f_t(-1, -1)) {
-            off = {0,0};
-        }
-        if (this->override_viewport_size == rocket::vec2f_t(-1, -1)) {
-            sz = rgl::get_viewport_size();
+                api_object_t hdl = ++this->impl->current_object_handle;
+                this->bk_impl->objects[hdl] = { .type = gl_object_type_t::fbo, .value = fbo };
+                pages[page]->fbo = hdl;
+                at = pages[page]->packer.allocate(padded);
+            }
+            pages[page]->caches++;
+            c->fbo = pages[page]->fbo;
+            c->atlas_page = static_cast<int>(page);
+            c->region = { { at->x + 1.f, at->y + 1.f }, { static_cast<float>(std::max(size.x, 1)), static_cast<float>(std::max(size.y, 1)) } };
+        } else {
+            const rocket::vec2f_t viewport = rgl::get_viewport_size();
+            const rocket::vec2i_t storage = c->follows_viewport()
+                ? rocket::vec2i_t { static_cast<int>(viewport.x), static_cast<int>(viewport.y) }
+                : rocket::vec2i_t { std::max(size.x, 1), std::max(size.y, 1) };
+            api_object_t hdl = ++this->impl->current_object_handle;
+            this->bk_impl->objects[hdl] = { .type = gl_object_type_t::fbo, .value = rgl::create_fbo(storage) };
+            c->fbo = hdl;
+            c->region = { { 0.f, 0.f }, { static_cast<float>(storage.x), static_cast<float>(storage.y) } };
         }
-        glViewport(off.x, off.y, sz.x, sz.y);
-        glClearColor(0,0,0,0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        cb(this);
-        end_render_cache(c.get());
 
+        this->redraw_render_cache(c.get());
         this->impl->render_caches.emplace_back(std::move(c));
 
         return this->impl->render_caches.back().get();
     }
 
-    void opengl_renderer_2d::invalidate_render_cache(render_cache_t *c) {
-        if (c->fbo == ROCKETGE__InvalidNumber)
-            return;
-        rgl::delete_fbo(std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value));
-        rgl::fbo_t fbo = rgl::create_fbo();
-        api_object_t hdl = ++this->impl->current_object_handle;
-        gl_object_t obj = this->bk_impl->objects[hdl];
-        obj.value = fbo;
-        obj.type = gl_object_type_t::fbo;
-        c->fbo = hdl;
-        this->bk_impl->objects[hdl] = obj;
+    void opengl_renderer_2d::redraw_render_cache(render_cache_t *c) {
+        if (c->atlas_page < 0 && c->follows_viewport()) {
+            const rocket::vec2f_t viewport = rgl::get_viewport_size();
+            if (c->region.size != viewport) {
+                // Drawn for an older viewport
+                rgl::delete_fbo(std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value));
+                this->bk_impl->objects[c->fbo].value = rgl::create_fbo();
+                c->region = { { 0.f, 0.f }, viewport };
+            }
+        }
+        c->dirty = false;
+
+        // Contents are in cache space, whatever mode the caller is in
         bool _frame_started = this->frame_started;
+        bool _camera_active = this->camera_active;
+        const glm::mat4 view = rgl::get_view_matrix();
         this->frame_started = true;
+        this->camera_active = false;
+        rgl::set_view_matrix(glm::mat4(1.0f));
+
         begin_render_cache(c);
-        glClearColor(0,0,0,0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        rgl::gpu_timer_begin_region(rgl::gpu_region_render_cache);
+        // The scissor stays on the cache's region for the whole redraw
+        glClearColor(0, 0, 0, 0);
+        glClear(c->atlas_page >= 0 ? GL_COLOR_BUFFER_BIT : GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         c->draw(this);
+        rgl::gpu_timer_end_region();
         end_render_cache(c);
+
+        rgl::set_view_matrix(view);
+        this->camera_active = _camera_active;
         this->frame_started = _frame_started;
     }
 
-    void opengl_renderer_2d::begin_render_cache(render_cache_t *c) {
+    void opengl_renderer_2d::invalidate_render_cache(render_cache_t *c) {
         if (c->fbo == ROCKETGE__InvalidNumber)
             return;
+        c->dirty = true;
+    }
+
+    void opengl_renderer_2d::update_render_cache(render_cache_t *c) {
+        if (c->fbo == ROCKETGE__InvalidNumber || !c->dirty)
+            return;
+        this->redraw_render_cache(c);
+    }
+
+    void opengl_renderer_2d::bind_render_cache_target(render_cache_t *c) {
         rgl::use_fbo(std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value));
+        // Projection over the cache size, placed on its region of the texture.
+        // The screen's GL viewport may be the scaled scene's, never reuse it
+        rgl::update_viewport(c->region.size);
+        glViewport(c->region.pos.x, c->region.pos.y, c->region.size.x, c->region.size.y);
+        this->render_cache_extent = c->follows_viewport() ? rocket::vec2f_t { -1, -1 } : c->region.size;
+        this->apply_scissor();
+    }
+
+    void opengl_renderer_2d::apply_scissor() {
+        auto *bk = this->bk_impl;
+        const std::optional<rocket::fbounding_box> &rect = bk->scissor_rect;
+        if (!this->impl->render_cache_use_stack.empty()) {
+            // Atlas pages hold other caches too, nothing may leave this one's region
+            const rocket::fbounding_box &region = this->impl->render_cache_use_stack.top()->region;
+            float x0 = region.pos.x;
+            float y0 = region.pos.y;
+            float x1 = region.pos.x + region.size.x;
+            float y1 = region.pos.y + region.size.y;
+            if (rect) {
+                // Cache space is y-down from the top of the region
+                x0 = std::max(x0, region.pos.x + rect->pos.x);
+                x1 = std::min(x1, region.pos.x + rect->pos.x + rect->size.x);
+                y0 = std::max(y0, region.pos.y + region.size.y - rect->pos.y - rect->size.y);
+                y1 = std::min(y1, region.pos.y + region.size.y - rect->pos.y);
+            }
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x0, y0, std::max(x1 - x0, 0.f), std::max(y1 - y0, 0.f));
+            return;
+        }
+
+        if (!rect) {
+            glDisable(GL_SCISSOR_TEST);
+            return;
+        }
+        glEnable(GL_SCISSOR_TEST);
+
+        if (bk->scene_active) {
+            // Scissor boxes are in target pixels, the scene has fewer
+            const rocket::vec2f_t viewport = rgl::get_viewport_size();
+            const float sx = bk->scene_fbo_size.x / viewport.x;
+            const float sy = bk->scene_fbo_size.y / viewport.y;
+            glScissor(
+                rect->pos.x * sx,
+                (viewport.y - rect->pos.y - rect->size.y) * sy,
+                rect->size.x * sx,
+                rect->size.y * sy
+            );
+            return;
+        }
+
+        glScissor(
+            rect->pos.x,
+            window->get_size().y - rect->pos.y - rect->size.y,
+            rect->size.x,
+            rect->size.y
+        );
+    }
+
+    void opengl_renderer_2d::begin_render_cache(render_cache_t *c) {
+        if (c->fbo == ROCKETGE__InvalidNumber)
+            return;
+        this->update_render_cache(c);
+        if (this->impl->render_cache_use_stack.empty()) {
+            this->bk_impl->screen_fbo = rgl::get_active_fbo();
+            glGetIntegerv(GL_VIEWPORT, this->bk_impl->screen_gl_viewport);
+            this->bk_impl->screen_viewport_size = rgl::get_viewport_size();
+        }
+        // The caller's scissor is in its own target's space, not the cache's
+        this->bk_impl->saved_scissor_rects.push_back(this->bk_impl->scissor_rect);
+        this->bk_impl->scissor_rect.reset();
         this->impl->render_cache_use_stack.push(c);
+        this->bind_render_cache_target(c);
     }
 
     void opengl_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_render_cache");
         if (this->check_graphics_settings(pos, sz) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
         r_assert(c != nullptr);
+        if (!this->shader_ready(c->follows_viewport() ? shader_id_t::textured_rectangle : shader_id_t::atlas_textured_rectangle)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+        this->update_render_cache(c);
         r_assert(rgl::get_active_fbo() != std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value));
 
-        rgl::shader_program_t pg = rgl::get_paramaterized_textured_quad(pos, sz, 0, 0);
+        if (c->follows_viewport()) {
+            rgl::shader_program_t pg = rgl::get_paramaterized_textured_quad(pos, sz, 0, 0);
+            rgl::texture_unit_handle_t unit;
+            rgl::alloc_texture_unit(unit);
+            glActiveTexture(unit.unit);
+            glBindTexture(GL_TEXTURE_2D, std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value).color_tex);
+            glUniform1i(glGetUniformLocation(pg, "u_texture"), unit.unit - GL_TEXTURE0);
+            glUniform1f(glGetUniformLocation(pg, "u_flip_y"), 1.f);
+            rgl::draw_shader(pg, rgl::shader_use_t::textured_rect);
+            rgl::free_texture_unit(unit);
+            return;
+        }
+
+        rgl::shader_program_t pg = rocket::gl_get_shader(shader_id_t::atlas_textured_rectangle);
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, pos.y, 0.0f))
+            * glm::scale(glm::mat4(1.0f), glm::vec3(sz.x, sz.y, 1.0f));
+
+        glUseProgram(pg);
+        glUniformMatrix4fv(glGetUniformLocation(pg, "u_transform"), 1, GL_FALSE, glm::value_ptr(transform));
+        glUniform2f(glGetUniformLocation(pg, "u_size"), sz.x, sz.y);
+        glUniform1f(glGetUniformLocation(pg, "u_radius"), 0.f);
+
         rgl::texture_unit_handle_t unit;
         rgl::alloc_texture_unit(unit);
         glActiveTexture(unit.unit);
         glBindTexture(GL_TEXTURE_2D, std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value).color_tex);
         glUniform1i(glGetUniformLocation(pg, "u_texture"), unit.unit - GL_TEXTURE0);
-        glUniform1f(glGetUniformLocation(pg, "u_flip_y"), 1.f);
-        rgl::draw_shader(pg, rgl::shader_use_t::textured_rect);
+
+        // FBO rows go bottom-up, sample the region upside down
+        const rocket::vec2f_t texture_size = c->atlas_page >= 0
+            ? rocket::vec2f_t { 1.f * gl_cache_atlas_size, 1.f * gl_cache_atlas_size }
+            : c->region.size;
+        glUniform2f(glGetUniformLocation(pg, "u_texPos"), c->region.pos.x / texture_size.x, (c->region.pos.y + c->region.size.y) / texture_size.y);
+        glUniform2f(glGetUniformLocation(pg, "u_texSize"), c->region.size.x / texture_size.x, -c->region.size.y / texture_size.y);
+
+        static const auto vos = rgl::cache_compile_vo("atlas_texture");
+        if (!vos.first || !vos.second) std::terminate();
+        rgl::draw_shader(pg, vos.first, vos.second);
         rgl::free_texture_unit(unit);
     }
     
     void opengl_renderer_2d::draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_render_cache");
         this->draw_render_cache(c, bbox.pos, bbox.size);
     }
 
@@ -499,35 +801,68 @@ namespace rocket {
         r_assert(this->impl->render_cache_use_stack.top() == c);
 
         this->impl->render_cache_use_stack.pop();
+        this->bk_impl->scissor_rect = this->bk_impl->saved_scissor_rects.back();
+        this->bk_impl->saved_scissor_rects.pop_back();
 
         if (this->impl->render_cache_use_stack.empty()) {
-            rgl::reset_to_default_fbo();
+            if (this->bk_impl->screen_fbo != rGL_FBO_INVALID) {
+                rgl::use_fbo(this->bk_impl->screen_fbo);
+            } else {
+                rgl::reset_to_default_fbo();
+            }
+            rgl::update_viewport(this->bk_impl->screen_viewport_size);
+            const int *vp = this->bk_impl->screen_gl_viewport;
+            glViewport(vp[0], vp[1], vp[2], vp[3]);
+            this->render_cache_extent = { -1, -1 };
+            this->apply_scissor();
         } else {
-            rgl::use_fbo(std::get<rgl::fbo_t>(this->bk_impl->objects[this->impl->render_cache_use_stack.top()->fbo].value));
+            this->bind_render_cache_target(this->impl->render_cache_use_stack.top());
         }
     }
 
     void opengl_renderer_2d::destroy_render_cache(render_cache_t *&c) {
         r_assert(c != nullptr);
         for (auto it = this->impl->render_caches.begin(); it != this->impl->render_caches.end(); ++it) {
-            if (it->get() == c) {
-                this->impl->render_caches.erase(it);
-                if (rgl::get_active_fbo() != std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value)) {
+            if (it->get() != c) {
+                continue;
+            }
+            rgl::fbo_t fbo = std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value);
+            bool release = true;
+            if (c->atlas_page >= 0) {
+                auto &page = this->bk_impl->cache_atlas_pages[c->atlas_page];
+                page->packer.free(
+                    { static_cast<int>(c->region.pos.x) - 1, static_cast<int>(c->region.pos.y) - 1 },
+                    { static_cast<int>(c->region.size.x) + 2, static_cast<int>(c->region.size.y) + 2 }
+                );
+                release = --page->caches == 0;
+                if (release) {
+                    page = nullptr;
+                }
+            }
+            if (release) {
+                if (rgl::get_active_fbo() == fbo) {
                     rgl::reset_to_default_fbo();
                 }
-                rgl::delete_fbo(std::get<rgl::fbo_t>(this->bk_impl->objects[c->fbo].value));
-                c = nullptr;
-                break;
+                rgl::delete_fbo(fbo);
+                this->bk_impl->objects.erase(c->fbo);
             }
+            this->impl->render_caches.erase(it);
+            c = nullptr;
+            break;
         }
     }
 
     void opengl_renderer_2d::clear(rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::clear");
         this_frame_clear_color = color;
 
         vec4f_t clr = color.normalize();
         glClearColor(clr.x, clr.y, clr.z, clr.w);
 
+        if (!this->impl->render_cache_use_stack.empty()) {
+            // Clipped to the cache's region, atlas pages are shared
+            this->apply_scissor();
+        }
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // you probably want plugins to start rendering AFTER clearing
@@ -578,6 +913,7 @@ namespace rocket {
                          texture->channels == 4 ? GL_RGBA : GL_RGB,
                          GL_UNSIGNED_BYTE, texture->data.data());
 #endif
+            rgl::add_frame_metrics_data_uploads(1);
 
             if (std::find(this->active_render_modes.begin(), this->active_render_modes.end(), render_mode_t::texture_filter_none) != this->active_render_modes.end()) {
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -590,12 +926,17 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_texture");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
 
         r_assert(texture != nullptr);
+        if (!this->shader_ready(shader_id_t::textured_rectangle)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
 
         rgl::shader_program_t pg = rgl::get_paramaterized_textured_quad(rect.pos, rect.size, rotation, roundedness);
         rgl::texture_unit_handle_t unit;
@@ -617,25 +958,26 @@ namespace rocket {
         float rotation,
         float roundedness
     ) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_atlas_texture");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
 
         r_assert(atlas != nullptr);
+        if (!this->shader_ready(shader_id_t::atlas_textured_rectangle)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
 
         rgl::shader_program_t pg = rocket::gl_get_shader(shader_id_t::atlas_textured_rectangle);
-        rocket::vec2f_t viewport_size = this->get_viewport_size();
-
-        glm::mat4 projection = glm::ortho(0.f, viewport_size.x, viewport_size.y, 0.f, -1.f, 1.f);
 
         rocket::vec2f_t size = rect.size;
         rocket::vec2f_t pos  = rect.pos;
         float cx = pos.x + size.x * 0.5f;
         float cy = pos.y + size.y * 0.5f;
 
-        glm::mat4 transform = projection
-            * glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(cx, cy, 0.0f))
             * glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f))
             * glm::translate(glm::mat4(1.0f), glm::vec3(-size.x * 0.5f, -size.y * 0.5f, 0.0f))
             * glm::scale(glm::mat4(1.0f), glm::vec3(size.x, size.y, 1.0f));
@@ -666,11 +1008,157 @@ namespace rocket {
         rgl::free_texture_unit(unit);
     }
 
+    void opengl_renderer_2d::draw_tilemap_chunk(tilemap_chunk_t &chunk, const std::shared_ptr<rocket::texture_t> &atlas, rocket::vec2f_t position) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_tilemap_chunk");
+        if (!this->frame_started || chunk.quads.empty()) {
+            return;
+        }
+        if (chunk.gpu_owner != nullptr && chunk.gpu_owner != this) {
+            // Uploaded by another renderer, its buffer is not ours to touch
+            renderer_2d_i::draw_tilemap_chunk(chunk, atlas, position);
+            return;
+        }
+        if (!this->shader_ready(shader_id_t::tilemap)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+
+        if (chunk.gpu_owner == nullptr) {
+            gl_vertex_buffer_t vb;
+            glGenVertexArrays(1, &vb.vao);
+            glGenBuffers(1, &vb.vbo);
+            glBindVertexArray(vb.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vb.vbo);
+            // position
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+            // texcoord
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+            glBindVertexArray(0);
+
+            chunk.gpu = ++this->impl->current_object_handle;
+            chunk.gpu_owner = this;
+            chunk.gpu_revision = 0;
+            this->bk_impl->objects[chunk.gpu] = { gl_object_type_t::vertex_buffer, vb };
+        }
+
+        gl_vertex_buffer_t &vb = std::get<gl_vertex_buffer_t>(this->bk_impl->objects[chunk.gpu].value);
+        if (chunk.gpu_revision != chunk.revision) {
+            // Two triangles per tile in map pixels, the offset goes into u_transform
+            const rocket::vec2f_t atlas_size = { 1.f * atlas->size.x, 1.f * atlas->size.y };
+            std::vector<float> verts;
+            verts.reserve(chunk.quads.size() * 6 * 4);
+            for (const tilemap_quad_t &q : chunk.quads) {
+                const float x0 = q.rect.pos.x;
+                const float y0 = q.rect.pos.y;
+                const float x1 = q.rect.pos.x + q.rect.size.x;
+                const float y1 = q.rect.pos.y + q.rect.size.y;
+                const float s0 = q.atlas_pos.x / atlas_size.x;
+                const float t0 = q.atlas_pos.y / atlas_size.y;
+                const float s1 = (q.atlas_pos.x + chunk.atlas_tile_size.x) / atlas_size.x;
+                const float t1 = (q.atlas_pos.y + chunk.atlas_tile_size.y) / atlas_size.y;
+
+                float vq[] = {
+                    x0, y0, s0, t0,
+                    x0, y1, s0, t1,
+                    x1, y1, s1, t1,
+                    x0, y0, s0, t0,
+                    x1, y1, s1, t1,
+                    x1, y0, s1, t0,
+                };
+                verts.insert(verts.end(), std::begin(vq), std::end(vq));
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, vb.vbo);
+            glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            vb.vertex_count = static_cast<int>(verts.size() / 4);
+            chunk.gpu_revision = chunk.revision;
+            rgl::add_frame_metrics_data_uploads(1);
+        }
+
+        rgl::shader_program_t pg = rocket::gl_get_shader(shader_id_t::tilemap);
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, 0.0f));
+
+        glUseProgram(pg);
+        glUniformMatrix4fv(glGetUniformLocation(pg, "u_transform"), 1, GL_FALSE, glm::value_ptr(transform));
+
+        rgl::texture_unit_handle_t unit;
+        rgl::alloc_texture_unit(unit);
+        glActiveTexture(unit.unit);
+        this->make_ready_texture(atlas);
+        glBindTexture(GL_TEXTURE_2D, std::get<_GLuint>(this->bk_impl->objects[atlas->hdl].value));
+        glUniform1i(glGetUniformLocation(pg, "u_texture"), unit.unit - GL_TEXTURE0);
+
+        glBindVertexArray(vb.vao);
+        rgl::gl_draw_arrays(GL_TRIANGLES, 0, vb.vertex_count);
+        rgl::free_texture_unit(unit);
+    }
+
+    void opengl_renderer_2d::draw_particles(particle_batch_t &batch) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_particles");
+        if (!this->frame_started || batch.instances.empty()) {
+            return;
+        }
+        if (batch.gpu_owner != nullptr && batch.gpu_owner != this) {
+            // Uploaded by another renderer, its buffer is not ours to touch
+            renderer_2d_i::draw_particles(batch);
+            return;
+        }
+        if (!this->shader_ready(shader_id_t::particles)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+
+        if (batch.gpu_owner == nullptr) {
+            gl_vertex_buffer_t vb;
+            glGenVertexArrays(1, &vb.vao);
+            glGenBuffers(1, &vb.vbo);
+            glBindVertexArray(vb.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, vb.vbo);
+            // center + size
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(particle_instance_t), (void*)offsetof(particle_instance_t, x));
+            glVertexAttribDivisor(0, 1);
+            // rgba8
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(particle_instance_t), (void*)offsetof(particle_instance_t, color));
+            glVertexAttribDivisor(1, 1);
+            glBindVertexArray(0);
+
+            batch.gpu = ++this->impl->current_object_handle;
+            batch.gpu_owner = this;
+            batch.gpu_revision = 0;
+            this->bk_impl->objects[batch.gpu] = { gl_object_type_t::vertex_buffer, vb };
+        }
+
+        gl_vertex_buffer_t &vb = std::get<gl_vertex_buffer_t>(this->bk_impl->objects[batch.gpu].value);
+        if (batch.gpu_revision != batch.revision) {
+            // Fresh storage every update so the driver doesn't wait on last frame's draw
+            glBindBuffer(GL_ARRAY_BUFFER, vb.vbo);
+            glBufferData(GL_ARRAY_BUFFER, batch.instances.size() * sizeof(particle_instance_t), batch.instances.data(), GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            vb.vertex_count = static_cast<int>(batch.instances.size());
+            batch.gpu_revision = batch.revision;
+            rgl::add_frame_metrics_data_uploads(1);
+        }
+
+        rgl::shader_program_t pg = rocket::gl_get_shader(shader_id_t::particles);
+        glUseProgram(pg);
+        glBindVertexArray(vb.vao);
+        rgl::gl_draw_arrays_instanced(GL_TRIANGLE_STRIP, 0, 4, vb.vertex_count);
+    }
+
     void opengl_renderer_2d::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_rectangle");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
+        if (!this->shader_ready(shader_id_t::rectangle)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
         rgl::shader_program_t pg = rgl::get_paramaterized_quad(rect.pos, rect.size, color, rotation, roundedness);
         if (lines) {
             rocket::vec2f_t pos = rect.pos;
@@ -692,6 +1180,7 @@ namespace rocket {
     }
    
     void opengl_renderer_2d::draw_text(const rocket::text_t& text_, rocket::vec2f_t position) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_text");
         rocket::text_t &text = const_cast<rocket::text_t&>(text_); // TODO: Make text_t::measure() const;
         if (check_graphics_settings(position, text.measure()) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(text.text.size());
@@ -699,6 +1188,10 @@ namespace rocket {
         }
         static auto cli_args = util::get_clistate();
         if (cli_args.notext) return;
+        if (!this->shader_ready(shader_id_t::text)) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(text.text.size());
+            return;
+        }
 
         static rgl::shader_program_t shader_program = rgl::get_shader(rgl::shader_use_t::text);
         glUseProgram(shader_program);
@@ -712,9 +1205,6 @@ namespace rocket {
             text.color.z / 255.0f);
         glUniform1i(tex_loc, 0);
 
-        float screen_w = (float)window->get_size().x;
-        float screen_h = (float)window->get_size().y;
-
         stbtt_fontinfo info;
         stbtt_InitFont(&info, text.font->ttf_data.data(), 0);
         int ascent;
@@ -734,10 +1224,11 @@ namespace rocket {
             stbtt_GetBakedQuad(text.font->cdata->a, 512, 512, c - 32, &x, &y, &q, 1);
             // TODO: ^^ Optimize this function call
 
-            float x0 = (q.x0 / screen_w) * 2.0f - 1.0f;
-            float y0 = 1.0f - (q.y0 / screen_h) * 2.0f;
-            float x1 = (q.x1 / screen_w) * 2.0f - 1.0f;
-            float y1 = 1.0f - (q.y1 / screen_h) * 2.0f;
+            // Pixels, rocket_camera projects
+            float x0 = q.x0;
+            float y0 = q.y0;
+            float x1 = q.x1;
+            float y1 = q.y1;
 
             float vq[] = {
                 x0, y0, q.s0, q.t0,
@@ -765,6 +1256,7 @@ namespace rocket {
                      verts.size() * sizeof(float),
                      verts.data(),
                      GL_DYNAMIC_DRAW);
+        rgl::add_frame_metrics_data_uploads(1);
 
         rgl::gl_draw_arrays(GL_TRIANGLES, 0, (GLsizei)(verts.size() / 4));
 
@@ -772,6 +1264,7 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::draw_shader(const shader_i &abs_shader) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_shader");
         const opengl_shader_t *shader = dynamic_cast<const opengl_shader_t*>(&abs_shader);
         if (this->check_graphics_settings({-1,-1}, {-1,-1}) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
@@ -868,64 +1361,320 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::set_camera(camera_2d *cam) {
-        rocket::log("cameras are not implemented", "opengl_renderer_2d", "set_camera", "fixme");
         this->cam = cam;
     }
 
     void opengl_renderer_2d::draw_fps(vec2f_t pos) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::draw_fps");
         std::string fps_text = "FPS: " + std::to_string(static_cast<int>(std::round(get_current_fps())));
 
         rocket::text_t fps = rocket::text_t(fps_text, 24, rocket::rgb_color::green());
         this->draw_text(fps, pos);
     }
-}
 
-namespace std {
-    template<>
-    struct hash<std::pair<float, float>> {
-        size_t operator()(const std::pair<float, float> &p) const {
-            return std::hash<float>()(p.first) ^ std::hash<float>()(p.second);
-        }
+    void opengl_renderer_2d::begin_gpu_region(const char *name) {
+        rgl::gpu_timer_begin_region(name);
+    }
+
+    void opengl_renderer_2d::end_gpu_region() {
+        rgl::gpu_timer_end_region();
+    }
+
+    /// @brief Region in GL window coordinates (bottom-left origin)
+    struct gl_read_rect_t {
+        int x = 0, y = 0, w = 0, h = 0;
     };
-}
 
-namespace rocket {
+    /// @brief Clamp a viewport region (top-left origin) to the viewport and convert it for glReadPixels
+    static bool resolve_read_region(rocket::fbounding_box region, framebuffer_readback_t &info, gl_read_rect_t &rect) {
+        GLint vp[4] = { 0, 0, 0, 0 };
+        glGetIntegerv(GL_VIEWPORT, vp);
+
+        int x = static_cast<int>(region.pos.x);
+        int y = static_cast<int>(region.pos.y);
+        int w = region.size.x < 0 ? vp[2] - x : static_cast<int>(region.size.x);
+        int h = region.size.y < 0 ? vp[3] - y : static_cast<int>(region.size.y);
+
+        x = std::clamp(x, 0, static_cast<int>(vp[2]));
+        y = std::clamp(y, 0, static_cast<int>(vp[3]));
+        w = std::clamp(w, 0, static_cast<int>(vp[2]) - x);
+        h = std::clamp(h, 0, static_cast<int>(vp[3]) - y);
+        if (w == 0 || h == 0) {
+            return false;
+        }
+
+        info.offset = { x, y };
+        info.size = { w, h };
+        rect = { vp[0] + x, vp[1] + vp[3] - (y + h), w, h };
+        return true;
+    }
+
+    /// @brief GL rows are bottom to top
+    static void copy_rows_flipped(const uint8_t *src, int w, int h, std::vector<rgba_color> &dst) {
+        dst.resize(static_cast<size_t>(w) * h);
+        const size_t row_bytes = static_cast<size_t>(w) * sizeof(rgba_color);
+        for (int row = 0; row < h; ++row) {
+            std::memcpy(dst.data() + static_cast<size_t>(h - 1 - row) * w, src + row * row_bytes, row_bytes);
+        }
+    }
+
+    static void capture_readback(opengl_renderer_2d_impl_t *bk, rocket::fbounding_box region, uint64_t frame) {
+        gl_readback_slot_t &slot = bk->readback_slots[bk->readback_write];
+        if (slot.fence != nullptr) {
+            rocket::log("readback ring is full, poll_framebuffer_readback more often", "opengl_renderer_2d", "request_framebuffer_readback", "warn");
+            return;
+        }
+
+        gl_read_rect_t rect;
+        if (!resolve_read_region(region, slot.info, rect)) {
+            return;
+        }
+        slot.info.frame = frame;
+
+        size_t bytes = static_cast<size_t>(rect.w) * rect.h * sizeof(rgba_color);
+        if (slot.pbo == 0) {
+            glGenBuffers(1, &slot.pbo);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (slot.capacity < bytes) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+            slot.capacity = bytes;
+        }
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(rect.x, rect.y, rect.w, rect.h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        bk->readback_write = (bk->readback_write + 1) % gl_readback_slots;
+    }
+
+    /// @brief (Re)allocate when the size changed, the old texture is deleted
+    /// @return true if the texture has no contents yet
+    static bool ensure_stream_texture(gl_stream_texture_t &stream, rocket::vec2i_t size) {
+        if (stream.texture != 0 && stream.size.x == size.x && stream.size.y == size.y) {
+            return false;
+        }
+        if (stream.texture != 0) {
+            glDeleteTextures(1, &stream.texture);
+        }
+
+        glGenTextures(1, &stream.texture);
+        glBindTexture(GL_TEXTURE_2D, stream.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        stream.size = size;
+        return true;
+    }
+
+    static void release_stream_texture(gl_stream_texture_t &stream) {
+        if (stream.texture != 0) {
+            glDeleteTextures(1, &stream.texture);
+        }
+        stream = {};
+    }
+
+    static void release_pixel_transfer_resources(opengl_renderer_2d_impl_t *bk) {
+        for (auto &slot : bk->readback_slots) {
+            if (slot.fence != nullptr) {
+                glDeleteSync(static_cast<GLsync>(slot.fence));
+            }
+            if (slot.pbo != 0) {
+                glDeleteBuffers(1, &slot.pbo);
+            }
+            slot = {};
+        }
+        bk->readback_requests.clear();
+
+        if (bk->framebuffer_texture_handle != 0) {
+            bk->objects.erase(bk->framebuffer_texture_handle);
+            bk->framebuffer_texture_handle = 0;
+        }
+        if (bk->framebuffer_texture != 0) {
+            glDeleteTextures(1, &bk->framebuffer_texture);
+            bk->framebuffer_texture = 0;
+            bk->framebuffer_texture_size = { 0, 0 };
+        }
+
+        release_stream_texture(bk->pushed_framebuffer);
+        release_stream_texture(bk->canvas);
+        for (auto &slot : bk->upload_slots) {
+            if (slot.pbo != 0) {
+                glDeleteBuffers(1, &slot.pbo);
+            }
+            slot = {};
+        }
+    }
+
     std::vector<rgba_color> opengl_renderer_2d::get_framebuffer() {
-        static std::unordered_map<std::pair<float, float>, std::vector<rgba_color>> fb_pixels;
-        std::pair<float, float> key = { rgl::get_viewport_size().x, rgl::get_viewport_size().y };
-        auto it = fb_pixels.find(key);
-        if (it != fb_pixels.end()) {
-            return it->second;
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::get_framebuffer");
+        framebuffer_readback_t info;
+        gl_read_rect_t rect;
+        if (!resolve_read_region({ { 0, 0 }, { -1, -1 } }, info, rect)) {
+            return {};
+        }
+
+        // Synchronous path, glReadPixels into client memory waits for the GPU
+        std::vector<uint8_t> raw(static_cast<size_t>(rect.w) * rect.h * sizeof(rgba_color));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(rect.x, rect.y, rect.w, rect.h, GL_RGBA, GL_UNSIGNED_BYTE, raw.data());
+
+        std::vector<rgba_color> pixels;
+        copy_rows_flipped(raw.data(), rect.w, rect.h, pixels);
+        return pixels;
+    }
+
+    void opengl_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+        this->bk_impl->readback_requests.push_back(region);
+    }
+
+    bool opengl_renderer_2d::poll_framebuffer_readback(framebuffer_readback_t &out) {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::poll_framebuffer_readback");
+        gl_readback_slot_t &slot = this->bk_impl->readback_slots[this->bk_impl->readback_read];
+        if (slot.fence == nullptr) {
+            return false;
+        }
+
+        GLenum status = glClientWaitSync(static_cast<GLsync>(slot.fence), 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return false;
+        }
+        glDeleteSync(static_cast<GLsync>(slot.fence));
+        slot.fence = nullptr;
+        this->bk_impl->readback_read = (this->bk_impl->readback_read + 1) % gl_readback_slots;
+
+        size_t bytes = static_cast<size_t>(slot.info.size.x) * slot.info.size.y * sizeof(rgba_color);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+        if (mapped == nullptr) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            rocket::log("failed to map readback buffer", "opengl_renderer_2d", "poll_framebuffer_readback", "error");
+            return false;
         }
 
-        fb_pixels[key] = std::vector<rgba_color>(rgl::get_viewport_size().x * rgl::get_viewport_size().y);
-        return fb_pixels[key];
+        out.frame = slot.info.frame;
+        out.offset = slot.info.offset;
+        out.size = slot.info.size;
+        copy_rows_flipped(static_cast<const uint8_t *>(mapped), slot.info.size.x, slot.info.size.y, out.pixels);
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return true;
+    }
+
+    /// @brief Draw the texture bound to unit over the whole viewport
+    static void draw_stream_texture(const rgl::texture_unit_handle_t &unit) {
+        // Pushed pixels are screen space, also in camera mode
+        const glm::mat4 view = rgl::get_view_matrix();
+        const bool has_view = view != glm::mat4(1.0f);
+        if (has_view) {
+            rgl::set_view_matrix(glm::mat4(1.0f));
+        }
+        rgl::shader_program_t shader = rgl::get_paramaterized_textured_quad({0,0}, rgl::get_viewport_size(), 0.f, 0.f);
+        glUniform1i(glGetUniformLocation(shader, "u_texture"), unit.unit - GL_TEXTURE0);
+        rgl::draw_shader(shader, rgl::shader_use_t::textured_rect);
+        if (has_view) {
+            rgl::set_view_matrix(view);
+        }
     }
 
     void opengl_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
-        static GLuint framebuffer_tx = rGL_TXID_INVALID;
-        if (framebuffer_tx == rGL_TXID_INVALID) {
-            glGenTextures(1, &framebuffer_tx);
-            glBindTexture(GL_TEXTURE_2D, framebuffer_tx);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, rgl::get_viewport_size().x, rgl::get_viewport_size().y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::push_framebuffer");
+        rocket::vec2i_t size = { static_cast<int>(rgl::get_viewport_size().x), static_cast<int>(rgl::get_viewport_size().y) };
+        if (framebuffer.size() != static_cast<size_t>(size.x) * size.y) {
+            rocket::log("framebuffer size does not match the viewport", "opengl_renderer_2d", "push_framebuffer", "error");
+            return;
+        }
+
+        rgl::gpu_timer_begin_region("push_framebuffer");
+        rgl::texture_unit_handle_t unit;
+        rgl::alloc_texture_unit(unit);
+        glActiveTexture(unit.unit);
+        ensure_stream_texture(this->bk_impl->pushed_framebuffer, size);
+        glBindTexture(GL_TEXTURE_2D, this->bk_impl->pushed_framebuffer.texture);
+        // rgba_color is tightly packed RGBA8, upload straight from the caller's memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.data());
+        rgl::add_frame_metrics_data_uploads(1);
+
+        draw_stream_texture(unit);
+        rgl::free_texture_unit(unit);
+        rgl::gpu_timer_end_region();
+    }
+
+    /// @brief Pack the dirty rectangles into the next PBO and copy them into the bound texture
+    static void upload_dirty_rects(opengl_renderer_2d_impl_t *bk, const framebuffer_canvas_t &canvas) {
+        const auto &rects = canvas.get_dirty_rects();
+        size_t bytes = 0;
+        for (auto &rect : rects) {
+            bytes += static_cast<size_t>(rect.w) * rect.h * sizeof(rgba_color);
+        }
+
+        gl_upload_slot_t &slot = bk->upload_slots[bk->upload_write];
+        bk->upload_write = (bk->upload_write + 1) % gl_upload_slots;
+        if (slot.pbo == 0) {
+            glGenBuffers(1, &slot.pbo);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        if (slot.capacity < bytes) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+            slot.capacity = bytes;
+        }
+
+        // Invalidating lets the driver hand out fresh storage if the GPU still reads this slot
+        uint8_t *mapped = static_cast<uint8_t *>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+        ));
+        if (mapped == nullptr) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            rocket::log("failed to map canvas upload buffer", "opengl_renderer_2d", "push_canvas", "error");
+            return;
+        }
+
+        const int stride = canvas.get_size().x;
+        size_t offset = 0;
+        for (auto &rect : rects) {
+            const size_t row_bytes = static_cast<size_t>(rect.w) * sizeof(rgba_color);
+            for (int row = 0; row < rect.h; ++row) {
+                std::memcpy(mapped + offset, canvas.data() + static_cast<size_t>(rect.y + row) * stride + rect.x, row_bytes);
+                offset += row_bytes;
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        offset = 0;
+        for (auto &rect : rects) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.w, rect.h, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(offset));
+            offset += static_cast<size_t>(rect.w) * rect.h * sizeof(rgba_color);
         }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        rgl::add_frame_metrics_data_uploads(static_cast<int>(rects.size()));
+    }
 
-        std::vector<uint8_t> flat(framebuffer.size() * 4);
-        std::memcpy(flat.data(), framebuffer.data(), framebuffer.size() * sizeof(rgba_color));
+    void opengl_renderer_2d::push_canvas() {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::push_canvas");
+        rocket::vec2i_t size = this->canvas.get_size();
+        if (size.x == 0 || size.y == 0) {
+            return;
+        }
 
+        rgl::gpu_timer_begin_region("push_canvas");
         rgl::texture_unit_handle_t unit;
         rgl::alloc_texture_unit(unit);
         glActiveTexture(unit.unit);
-        glBindTexture(GL_TEXTURE_2D, framebuffer_tx);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, rgl::get_viewport_size().x, rgl::get_viewport_size().y, GL_RGBA, GL_UNSIGNED_BYTE, flat.data());
+        if (ensure_stream_texture(this->bk_impl->canvas, size)) {
+            this->canvas.mark_all_dirty();
+        }
+        glBindTexture(GL_TEXTURE_2D, this->bk_impl->canvas.texture);
+        if (this->canvas.is_dirty()) {
+            upload_dirty_rects(this->bk_impl, this->canvas);
+            this->canvas.clear_dirty();
+        }
 
-        static rgl::shader_program_t shader = rgl::get_paramaterized_textured_quad({0,0}, rgl::get_viewport_size(), 0.f, 0.f);
-        glUniform1i(glGetUniformLocation(shader, "u_texture"), unit.unit - GL_TEXTURE0);
-        rgl::draw_shader(shader, rgl::shader_use_t::textured_rect);
+        draw_stream_texture(unit);
         rgl::free_texture_unit(unit);
+        rgl::gpu_timer_end_region();
     }
 
     vec2f_t opengl_renderer_2d::get_viewport_size() {
@@ -965,7 +1714,9 @@ namespace rocket {
 
     void opengl_renderer_2d::end_render_mode(render_mode_t mode) {
         if (mode == render_mode_t::camera) {
+            this->end_camera_mode();
             this->impl->camera_transform = glm::mat4(1.0f);
+            rgl::set_view_matrix(this->impl->camera_transform);
         }
 
         for (auto it = this->active_render_modes.begin(); it != this->active_render_modes.end(); it++) {
@@ -985,13 +1736,33 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::end_frame() {
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::end_frame");
+        this->flush_command_buckets();
+        this->resolve_scene_target();
         if (flags.share_renderer_as_global) {
             __rallframeend();
         }
-        if (util::get_clistate().debugoverlay)
+        // Before the overlay, so it is not captured
+        for (auto &region : this->bk_impl->readback_requests) {
+            capture_readback(this->bk_impl, region, this->frame_counter);
+        }
+        this->bk_impl->readback_requests.clear();
+
+        if (util::get_clistate().debugoverlay) {
+            rgl::gpu_timer_begin_region("debug_overlay");
             util::draw_debug_overlay(this);
+            rgl::gpu_timer_end_region();
+        }
+        rgl::gpu_timer_end_frame();
         this->frame_started = false;
         auto frame_end_time = clock::now();
+        if (const dynamic_resolution_t &dr = this->graphics_settings.dynamic_resolution; dr.enabled) {
+            const float target_fps = dr.target_fps > 0.f ? dr.target_fps : (this->fps == rocket::cst::fps_uncapped ? 60.f : static_cast<float>(this->fps));
+            // Work only, the pacing wait after it is not load
+            const float cpu_time = std::chrono::duration<float>(frame_end_time - frame_start_time).count();
+            const float gpu_time = rgl::get_draw_metrics().gpu_frametime;
+            this->bk_impl->resolution.update(std::max(cpu_time, gpu_time), 1.f / target_fps, dr.min_scale, dr.max_scale);
+        }
         this->window->swap_buffers();
         rgl::frame_metrics_t fmetrics = rgl::get_frame_metrics();
         int drawcalls = fmetrics.drawcalls;
@@ -1005,6 +1776,18 @@ namespace rocket {
 
         rgl::reset_frame_metrics();
 
+        auto push_frame_record = [&]() {
+            rgl::push_frame_record({
+                .frame = this->frame_counter,
+                .cpu_time = std::chrono::duration<float>(frame_end_time - frame_start_time).count(),
+                .wait_time = std::chrono::duration<float>(clock::now() - frame_end_time).count(),
+                .drawcalls = fmetrics.drawcalls,
+                .tricount = fmetrics.tricount,
+                .skipped_drawcalls = fmetrics.skipped_drawcalls,
+                .uploads = fmetrics.uploads,
+            });
+        };
+
         rocket::vec2f_t final_viewport_position = {  0,  0 };
         rocket::vec2f_t final_viewport_size     = { -1, -1 };
 
@@ -1021,8 +1804,11 @@ namespace rocket {
         }
 
         if (last_frame_vp_size != final_viewport_size) {
+            // Sized caches do not depend on the viewport
             for (auto &cache : this->impl->render_caches) {
-                this->invalidate_render_cache(cache.get());
+                if (cache->follows_viewport()) {
+                    this->invalidate_render_cache(cache.get());
+                }
             }
         }
         last_frame_vp_size = final_viewport_size;
@@ -1053,11 +1839,13 @@ namespace rocket {
 
         if (this->fps == rocket::cst::fps_uncapped) {
             delta_time = std::chrono::duration<double>(frame_start_time - last_time).count();
+            push_frame_record();
             return;
         }
 
         if (this->vsync) {
             delta_time = std::chrono::duration<double>(frame_start_time - last_time).count();
+            push_frame_record();
             return; // We're done here
         }
 
@@ -1073,9 +1861,11 @@ namespace rocket {
         double frametime_limit = 1.0 / (fps + 0);
 
         // Perfect Frame Timer
-        util::frame_timer_wait_for(frame_duration, frametime_limit, cli_args.software_frame_timer, this->fps, this->frame_start_time);
+        double pacing_error = util::frame_timer_wait_for(frame_duration, frametime_limit, cli_args.software_frame_timer, this->fps, this->frame_start_time);
+        rgl::update_pacing_metrics_data(static_cast<float>(pacing_error));
 
         rgl::update_draw_metrics_data(frame_duration + std::chrono::duration<double>(clock::now() - frame_end_time).count(), 1 / this->delta_time);
+        push_frame_record();
 
         delta_time = std::chrono::duration<double>(frame_start_time - last_time).count();
     }
@@ -1088,6 +1878,9 @@ namespace rocket {
     };
 
     double opengl_renderer_2d::get_delta_time() {
+        if (double fixed = util::input_replay_delta_time(); fixed > 0.0) {
+            return fixed;
+        }
         return delta_time;
     }
 
@@ -1124,26 +1917,52 @@ namespace rocket {
     }
 
     api_object_t opengl_renderer_2d::get_framebuffer_texture() {
-        rocket::crash("TODO: Implement 'get_framebuffer_texture'");
-        return 0;
-        // rgl::scoped_gl_texture_t t;
-        // glBindTexture(GL_TEXTURE_2D, t.id);
-        //
-        // int w = rgl::get_viewport_size().x;
-        // int h = rgl::get_viewport_size().y;
-        //
-        // glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        //
-        // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        // glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        //
-        // glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, w, h);
-        //
-        // return t; // Implicit move
+        ROCKET_PROFILE_SCOPE("opengl_renderer_2d::get_framebuffer_texture");
+        framebuffer_readback_t info;
+        gl_read_rect_t rect;
+        if (!resolve_read_region({ { 0, 0 }, { -1, -1 } }, info, rect)) {
+            return ROCKETGE__InvalidNumber;
+        }
+
+        auto *bk = this->bk_impl;
+        if (bk->framebuffer_texture_handle != 0 && !bk->objects.contains(bk->framebuffer_texture_handle)) {
+            // Freed through clean_gpu_resource, the texture went with it
+            bk->framebuffer_texture = 0;
+            bk->framebuffer_texture_size = { 0, 0 };
+            bk->framebuffer_texture_handle = 0;
+        }
+
+        rgl::texture_unit_handle_t unit;
+        rgl::alloc_texture_unit(unit);
+        glActiveTexture(unit.unit);
+        if (bk->framebuffer_texture == 0) {
+            glGenTextures(1, &bk->framebuffer_texture);
+            glBindTexture(GL_TEXTURE_2D, bk->framebuffer_texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, bk->framebuffer_texture);
+        }
+
+        // Storage only changes with the viewport, otherwise the copy is GPU-side only
+        if (bk->framebuffer_texture_size != rocket::vec2i_t{ rect.w, rect.h }) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, rect.w, rect.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            bk->framebuffer_texture_size = { rect.w, rect.h };
+        }
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, rect.x, rect.y, rect.w, rect.h);
+        rgl::free_texture_unit(unit);
+
+        // One object, rewritten on every call
+        if (bk->framebuffer_texture_handle == 0) {
+            bk->framebuffer_texture_handle = ++this->impl->current_object_handle;
+            bk->objects[bk->framebuffer_texture_handle] = { .type = gl_object_type_t::texture, .value = bk->framebuffer_texture };
+        }
+        return bk->framebuffer_texture_handle;
     }
 
     camera_2d* opengl_renderer_2d::get_camera() {
-        rocket::log("cameras are not implemented", "opengl_renderer_2d", "get_camera", "fixme");
         return this->cam;
     }
 
@@ -1152,14 +1971,8 @@ namespace rocket {
     };
 
     void opengl_renderer_2d::begin_scissor_mode(rocket::fbounding_box rect) {
-        glEnable(GL_SCISSOR_TEST);
-
-        glScissor(
-            rect.pos.x,
-            window->get_size().y - rect.pos.y - rect.size.y,
-            rect.size.x,
-            rect.size.y
-        );
+        this->bk_impl->scissor_rect = rect;
+        this->apply_scissor();
     }
 
     void opengl_renderer_2d::begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) {
@@ -1171,7 +1984,8 @@ namespace rocket {
     }
 
     void opengl_renderer_2d::end_scissor_mode() {
-        glDisable(GL_SCISSOR_TEST);
+        this->bk_impl->scissor_rect.reset();
+        this->apply_scissor();
     }
 
     void opengl_renderer_2d::close() {
@@ -1191,6 +2005,14 @@ namespace rocket {
             util::set_global_renderer_2d(nullptr);
         }
 
+        release_pixel_transfer_resources(this->bk_impl);
+        if (this->bk_impl->scene_fbo != rGL_FBO_INVALID) {
+            rgl::delete_fbo(this->bk_impl->scene_fbo);
+        }
+        if (this->bk_impl->upscale_vao != 0) {
+            glDeleteVertexArrays(1, &this->bk_impl->upscale_vao);
+            glDeleteBuffers(1, &this->bk_impl->upscale_vbo);
+        }
         rgl::cleanup_all();
         rgl::reset();
         shader_provider_reset();
@@ -0,0 +1,1629 @@
+#include "rocket/macros.hpp"
+#if defined(ROCKETGE__Platform_Android)
+    #include <GLES3/gl32.h>
+#else
+    #include <lib/glad/glad.h>
+#endif
+#include "rocket/renderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ROCKETGE__SW_SSE2
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ROCKETGE__SW_AVX2
+#endif
+
+#include "binary_stuff/splash_screen.h"
+#include "internal_types.hpp"
+#include "intl_macros.hpp"
+#include "lib/stb/stb_image.h"
+#include "lib/stb/stb_truetype.h"
+#include "lib/tweeny/tweeny.h"
+#include "plugin.hpp"
+#include "rgl.hpp"
+#include "rocket/plugin/plugin.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/runtime.hpp"
+#include "rocket/threads.hpp"
+#include "util.hpp"
+#include "worker_pool.hpp"
+
+// Draws are recorded into a command list and rasterized when the frame ends
+// (or when pixels are needed earlier). Every command is binned into the
+// 64x64 tiles it touches, tiles are handed out to the worker threads and each
+// tile runs its commands in submission order, so blending stays correct
+// without any locking on the framebuffer.
+
+namespace {
+    using rocket::rgba_color;
+    using rocket::sw_texture_t;
+
+    constexpr int sw_tile_size = 64;
+    /// @brief Fewer command/tile pairs than this are rasterized on the calling thread
+    constexpr size_t sw_min_parallel_work = 32;
+
+    /// @brief Inside when a * x + b * y + c >= 0
+    struct sw_edge_t {
+        float a = 0.f, b = 0.f, c = 0.f;
+    };
+
+    enum class sw_shape_t : uint8_t {
+        /// @brief Intersection of edges, no edges fills the bounds
+        convex,
+        circle,
+    };
+
+    struct sw_command_t {
+        sw_shape_t shape = sw_shape_t::convex;
+        /// @brief Write the color instead of blending (clear)
+        bool replace = false;
+        /// @brief Fill color, or the tint when textured
+        rgba_color color;
+
+        /// @brief Pixel bounds with the scissor applied, [x0, x1) x [y0, y1)
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        uint32_t first_edge = 0;
+        uint32_t edge_count = 0;
+
+        /// @brief Rounded corners, tested in the shape's own frame
+        float radius = 0.f;
+        rocket::vec2f_t center = { 0.f, 0.f };
+        rocket::vec2f_t half = { 0.f, 0.f };
+        float cs = 1.f, sn = 0.f;
+
+        /// @brief Circle, inner_sq < 0 when solid
+        float outer_sq = 0.f;
+        float inner_sq = -1.f;
+
+        const sw_texture_t *texture = nullptr;
+        bool bilinear = true;
+        /// @brief Texels at a pixel center (x, y): u = u0 + ux * x + uy * y
+        float u0 = 0.f, ux = 0.f, uy = 0.f;
+        float v0 = 0.f, vx = 0.f, vy = 0.f;
+        /// @brief Texel rectangle sampling is clamped to (atlas entry)
+        int tex_x0 = 0, tex_y0 = 0, tex_x1 = 0, tex_y1 = 0;
+    };
+
+    // -- pixel math, identical in every SIMD path so results are pixel-exact --
+
+    [[nodiscard]] inline uint32_t div255(uint32_t x) {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    inline void blend_one(rgba_color &dst, rgba_color src) {
+        const uint32_t a = src.w;
+        const uint32_t ia = 255 - a;
+        dst.x = static_cast<uint8_t>(div255(src.x * a + dst.x * ia));
+        dst.y = static_cast<uint8_t>(div255(src.y * a + dst.y * ia));
+        dst.z = static_cast<uint8_t>(div255(src.z * a + dst.z * ia));
+        dst.w = static_cast<uint8_t>(div255(255 * a + dst.w * ia));
+    }
+
+    static void blend_span_scalar(rgba_color *dst, int count, rgba_color src) {
+        for (int i = 0; i < count; ++i) {
+            blend_one(dst[i], src);
+        }
+    }
+
+#ifdef ROCKETGE__SW_SSE2
+    static void blend_span_sse2(rgba_color *dst, int count, rgba_color src) {
+        const int a = src.w;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i inv = _mm_set1_epi16(static_cast<short>(255 - a));
+        const __m128i src_term = _mm_set_epi16(
+            static_cast<short>(255 * a + 128), static_cast<short>(src.z * a + 128), static_cast<short>(src.y * a + 128), static_cast<short>(src.x * a + 128),
+            static_cast<short>(255 * a + 128), static_cast<short>(src.z * a + 128), static_cast<short>(src.y * a + 128), static_cast<short>(src.x * a + 128)
+        );
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), src_term);
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), src_term);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+        blend_span_scalar(dst + i, count - i, src);
+    }
+#endif
+
+#ifdef ROCKETGE__SW_AVX2
+    __attribute__((target("avx2")))
+    static void blend_span_avx2(rgba_color *dst, int count, rgba_color src) {
+        const int a = src.w;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i inv = _mm256_set1_epi16(static_cast<short>(255 - a));
+        const short sx = static_cast<short>(src.x * a + 128);
+        const short sy = static_cast<short>(src.y * a + 128);
+        const short sz = static_cast<short>(src.z * a + 128);
+        const short sw = static_cast<short>(255 * a + 128);
+        const __m256i src_term = _mm256_set_epi16(sw, sz, sy, sx, sw, sz, sy, sx, sw, sz, sy, sx, sw, sz, sy, sx);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+            // unpack and pack both work per 128-bit lane, so pixel order survives
+            __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv), src_term);
+            __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv), src_term);
+            lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+            hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+        blend_span_scalar(dst + i, count - i, src);
+    }
+#endif
+
+    using blend_span_fn = void (*)(rgba_color *, int, rgba_color);
+
+    [[nodiscard]] static blend_span_fn pick_blend_span() {
+#ifdef ROCKETGE__SW_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            return blend_span_avx2;
+        }
+#endif
+#ifdef ROCKETGE__SW_SSE2
+        return blend_span_sse2;
+#else
+        return blend_span_scalar;
+#endif
+    }
+
+    static const blend_span_fn blend_span_impl = pick_blend_span();
+
+    inline void fill_span(rgba_color *dst, int count, rgba_color color, bool replace) {
+        if (count <= 0) {
+            return;
+        }
+        if (replace || color.w == 255) {
+            std::fill_n(dst, count, color);
+        } else if (color.w != 0) {
+            blend_span_impl(dst, count, color);
+        }
+    }
+
+    [[nodiscard]] inline rgba_color texel(const sw_texture_t &texture, int x, int y) {
+        return texture.pixels[static_cast<size_t>(y) * texture.size.x + x];
+    }
+
+    [[nodiscard]] static rgba_color sample(const sw_command_t &cmd, float u, float v) {
+        const sw_texture_t &texture = *cmd.texture;
+        if (!cmd.bilinear) {
+            const int x = std::clamp(static_cast<int>(std::floor(u)), cmd.tex_x0, cmd.tex_x1);
+            const int y = std::clamp(static_cast<int>(std::floor(v)), cmd.tex_y0, cmd.tex_y1);
+            return texel(texture, x, y);
+        }
+
+        // Texel centers sit at +0.5, weights in 8-bit fixed point
+        const float fu = u - 0.5f;
+        const float fv = v - 0.5f;
+        const float base_u = std::floor(fu);
+        const float base_v = std::floor(fv);
+        const uint32_t wx = static_cast<uint32_t>((fu - base_u) * 256.f);
+        const uint32_t wy = static_cast<uint32_t>((fv - base_v) * 256.f);
+        const int x0 = std::clamp(static_cast<int>(base_u), cmd.tex_x0, cmd.tex_x1);
+        const int y0 = std::clamp(static_cast<int>(base_v), cmd.tex_y0, cmd.tex_y1);
+        const int x1 = std::clamp(static_cast<int>(base_u) + 1, cmd.tex_x0, cmd.tex_x1);
+        const int y1 = std::clamp(static_cast<int>(base_v) + 1, cmd.tex_y0, cmd.tex_y1);
+
+        const rgba_color c00 = texel(texture, x0, y0);
+        const rgba_color c10 = texel(texture, x1, y0);
+        const rgba_color c01 = texel(texture, x0, y1);
+        const rgba_color c11 = texel(texture, x1, y1);
+        const auto lerp2 = [wx, wy](uint8_t a, uint8_t b, uint8_t c, uint8_t d) -> uint8_t {
+            const uint32_t top = a * (256 - wx) + b * wx;
+            const uint32_t bottom = c * (256 - wx) + d * wx;
+            return static_cast<uint8_t>((top * (256 - wy) + bottom * wy + 32768) >> 16);
+        };
+        return {
+            lerp2(c00.x, c10.x, c01.x, c11.x),
+            lerp2(c00.y, c10.y, c01.y, c11.y),
+            lerp2(c00.z, c10.z, c01.z, c11.z),
+            lerp2(c00.w, c10.w, c01.w, c11.w),
+        };
+    }
+
+    [[nodiscard]] inline rgba_color apply_tint(rgba_color c, rgba_color tint) {
+        if (tint.x == 255 && tint.y == 255 && tint.z == 255 && tint.w == 255) {
+            return c;
+        }
+        return {
+            static_cast<uint8_t>(div255(c.x * tint.x)),
+            static_cast<uint8_t>(div255(c.y * tint.y)),
+            static_cast<uint8_t>(div255(c.z * tint.z)),
+            static_cast<uint8_t>(div255(c.w * tint.w)),
+        };
+    }
+
+    [[nodiscard]] static bool rounded_contains(const sw_command_t &cmd, float px, float py) {
+        const float dx = px - cmd.center.x;
+        const float dy = py - cmd.center.y;
+        const float lx = dx * cmd.cs - dy * cmd.sn;
+        const float ly = dx * cmd.sn + dy * cmd.cs;
+        const float qx = std::abs(lx) - (cmd.half.x - cmd.radius);
+        const float qy = std::abs(ly) - (cmd.half.y - cmd.radius);
+        const float ox = std::max(qx, 0.f);
+        const float oy = std::max(qy, 0.f);
+        return (std::min(std::max(qx, qy), 0.f) + std::sqrt(ox * ox + oy * oy)) <= cmd.radius;
+    }
+
+    /// @brief Columns of a convex command covered on row y, clipped to [lo, hi)
+    [[nodiscard]] static bool convex_span(const sw_command_t &cmd, const std::vector<sw_edge_t> &edges, int y, int &lo, int &hi) {
+        const float yc = static_cast<float>(y) + 0.5f;
+        float min_x = static_cast<float>(lo) + 0.5f;
+        float max_x = static_cast<float>(hi) - 0.5f;
+        for (uint32_t i = 0; i < cmd.edge_count; ++i) {
+            const sw_edge_t &edge = edges[cmd.first_edge + i];
+            const float m = edge.b * yc + edge.c;
+            if (edge.a > 1e-6f) {
+                min_x = std::max(min_x, -m / edge.a);
+            } else if (edge.a < -1e-6f) {
+                max_x = std::min(max_x, -m / edge.a);
+            } else if (m < 0.f) {
+                return false;
+            }
+        }
+        lo = std::max(lo, static_cast<int>(std::ceil(min_x - 0.5f)));
+        hi = std::min(hi, static_cast<int>(std::floor(max_x - 0.5f)) + 1);
+        return lo < hi;
+    }
+
+    static void raster_span(const sw_command_t &cmd, sw_texture_t &target, int y, int x0, int x1) {
+        rgba_color *row = target.pixels.data() + static_cast<size_t>(y) * target.size.x;
+        const float yc = static_cast<float>(y) + 0.5f;
+
+        if (cmd.texture == nullptr && cmd.radius <= 0.f) {
+            fill_span(row + x0, x1 - x0, cmd.color, cmd.replace);
+            return;
+        }
+
+        for (int x = x0; x < x1; ++x) {
+            const float xc = static_cast<float>(x) + 0.5f;
+            if (cmd.radius > 0.f && !rounded_contains(cmd, xc, yc)) {
+                continue;
+            }
+
+            rgba_color src = cmd.color;
+            if (cmd.texture != nullptr) {
+                src = apply_tint(sample(cmd, cmd.u0 + cmd.ux * xc + cmd.uy * yc, cmd.v0 + cmd.vx * xc + cmd.vy * yc), cmd.color);
+            }
+            if (cmd.replace || src.w == 255) {
+                row[x] = src;
+            } else if (src.w != 0) {
+                blend_one(row[x], src);
+            }
+        }
+    }
+
+    static void raster_command(const sw_command_t &cmd, const std::vector<sw_edge_t> &edges, sw_texture_t &target, int clip_x0, int clip_y0, int clip_x1, int clip_y1) {
+        const int x0 = std::max(cmd.x0, clip_x0);
+        const int y0 = std::max(cmd.y0, clip_y0);
+        const int x1 = std::min(cmd.x1, clip_x1);
+        const int y1 = std::min(cmd.y1, clip_y1);
+        if (x0 >= x1 || y0 >= y1) {
+            return;
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            if (cmd.shape == sw_shape_t::circle) {
+                const float dy = static_cast<float>(y) + 0.5f - cmd.center.y;
+                const float rest = cmd.outer_sq - dy * dy;
+                if (rest < 0.f) {
+                    continue;
+                }
+                const float s = std::sqrt(rest);
+                const int lo = std::max(x0, static_cast<int>(std::ceil(cmd.center.x - s - 0.5f)));
+                const int hi = std::min(x1, static_cast<int>(std::floor(cmd.center.x + s - 0.5f)) + 1);
+
+                const float inner_rest = cmd.inner_sq - dy * dy;
+                if (inner_rest > 0.f) {
+                    // Ring, the hole is open: |x - cx| < t is left out
+                    const float t = std::sqrt(inner_rest);
+                    const int left_end = std::min(hi, static_cast<int>(std::floor(cmd.center.x - t - 0.5f)) + 1);
+                    const int right_start = std::max(lo, static_cast<int>(std::ceil(cmd.center.x + t - 0.5f)));
+                    if (lo < left_end) raster_span(cmd, target, y, lo, left_end);
+                    if (right_start < hi) raster_span(cmd, target, y, right_start, hi);
+                } else if (lo < hi) {
+                    raster_span(cmd, target, y, lo, hi);
+                }
+                continue;
+            }
+
+            int lo = x0, hi = x1;
+            if (convex_span(cmd, edges, y, lo, hi)) {
+                raster_span(cmd, target, y, lo, hi);
+            }
+        }
+    }
+
+    struct sw_raster_state_t {
+        sw_texture_t framebuffer;
+        /// @brief Where draws currently land, the framebuffer or a render cache
+        sw_texture_t *target = nullptr;
+
+        std::vector<sw_command_t> commands;
+        std::vector<sw_edge_t> edges;
+        std::vector<std::vector<uint32_t>> bins;
+        /// @brief Raster worker threads
+        rocket::worker_pool_t pool{ "rge-sw-raster" };
+
+        std::optional<rocket::fbounding_box> scissor_rect;
+
+        std::vector<rocket::fbounding_box> readback_requests;
+        std::vector<rocket::framebuffer_readback_t> readbacks;
+
+        /// @brief Snapshot handed out by get_framebuffer_texture
+        rocket::api_object_t framebuffer_texture = 0;
+
+        /// @brief Presenting through the window's OpenGL context
+        bool present_gl = false;
+        uint32_t present_texture = 0;
+        rocket::vec2i_t present_size = { 0, 0 };
+
+        bool shader_warning_shown = false;
+    };
+
+    [[nodiscard]] static sw_raster_state_t &sw_state(rocket::software_renderer_2d *renderer) {
+        return *reinterpret_cast<sw_raster_state_t *>(renderer->get_backend_impl()->raster_state);
+    }
+
+    /// @brief Rasterize everything recorded for the current target
+    static void flush(sw_raster_state_t &state) {
+        if (state.commands.empty() || state.target == nullptr) {
+            state.commands.clear();
+            state.edges.clear();
+            return;
+        }
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::flush");
+
+        sw_texture_t &target = *state.target;
+        const int tiles_x = (target.size.x + sw_tile_size - 1) / sw_tile_size;
+        const int tiles_y = (target.size.y + sw_tile_size - 1) / sw_tile_size;
+        const int tile_count = tiles_x * tiles_y;
+        if (static_cast<int>(state.bins.size()) < tile_count) {
+            state.bins.resize(tile_count);
+        }
+        for (int i = 0; i < tile_count; ++i) {
+            state.bins[i].clear();
+        }
+
+        size_t work = 0;
+        for (uint32_t i = 0; i < state.commands.size(); ++i) {
+            const sw_command_t &cmd = state.commands[i];
+            if (cmd.x0 >= cmd.x1 || cmd.y0 >= cmd.y1) {
+                continue;
+            }
+            const int tx0 = cmd.x0 / sw_tile_size;
+            const int ty0 = cmd.y0 / sw_tile_size;
+            const int tx1 = (cmd.x1 - 1) / sw_tile_size;
+            const int ty1 = (cmd.y1 - 1) / sw_tile_size;
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    state.bins[ty * tiles_x + tx].push_back(i);
+                }
+            }
+            work += static_cast<size_t>(tx1 - tx0 + 1) * (ty1 - ty0 + 1);
+        }
+
+        const std::function<void(int)> raster_tile = [&state, &target, tiles_x](int tile) {
+            const int clip_x0 = (tile % tiles_x) * sw_tile_size;
+            const int clip_y0 = (tile / tiles_x) * sw_tile_size;
+            const int clip_x1 = std::min(clip_x0 + sw_tile_size, target.size.x);
+            const int clip_y1 = std::min(clip_y0 + sw_tile_size, target.size.y);
+            for (uint32_t index : state.bins[tile]) {
+                raster_command(state.commands[index], state.edges, target, clip_x0, clip_y0, clip_x1, clip_y1);
+            }
+        };
+
+        if (state.pool.size() == 0 || work < sw_min_parallel_work) {
+            for (int i = 0; i < tile_count; ++i) {
+                raster_tile(i);
+            }
+        } else {
+            state.pool.run(tile_count, raster_tile);
+        }
+
+        state.commands.clear();
+        state.edges.clear();
+    }
+
+    static void resize_target(sw_texture_t &texture, rocket::vec2i_t size, rgba_color fill) {
+        size = { std::max(size.x, 0), std::max(size.y, 0) };
+        texture.size = size;
+        texture.pixels.assign(static_cast<size_t>(size.x) * size.y, fill);
+    }
+
+    /// @brief Clip the bounds to the target and scissor, false if nothing is left
+    [[nodiscard]] static bool clip_bounds(const sw_raster_state_t &state, float min_x, float min_y, float max_x, float max_y, sw_command_t &cmd) {
+        const sw_texture_t &target = *state.target;
+        float x0 = std::max(min_x, 0.f);
+        float y0 = std::max(min_y, 0.f);
+        float x1 = std::min(max_x, static_cast<float>(target.size.x));
+        float y1 = std::min(max_y, static_cast<float>(target.size.y));
+        if (state.scissor_rect.has_value()) {
+            const auto &rect = *state.scissor_rect;
+            x0 = std::max(x0, rect.pos.x);
+            y0 = std::max(y0, rect.pos.y);
+            x1 = std::min(x1, rect.pos.x + rect.size.x);
+            y1 = std::min(y1, rect.pos.y + rect.size.y);
+        }
+        if (x0 >= x1 || y0 >= y1) {
+            return false;
+        }
+        cmd.x0 = static_cast<int>(std::floor(x0));
+        cmd.y0 = static_cast<int>(std::floor(y0));
+        cmd.x1 = static_cast<int>(std::ceil(x1));
+        cmd.y1 = static_cast<int>(std::ceil(y1));
+        return cmd.x0 < cmd.x1 && cmd.y0 < cmd.y1;
+    }
+
+    /// @brief Record a convex polygon, points in either winding
+    [[nodiscard]] static bool push_convex(sw_raster_state_t &state, const rocket::vec2f_t *points, size_t count, sw_command_t &cmd) {
+        float min_x = std::numeric_limits<float>::max();
+        float min_y = std::numeric_limits<float>::max();
+        float max_x = std::numeric_limits<float>::lowest();
+        float max_y = std::numeric_limits<float>::lowest();
+        float area = 0.f;
+        for (size_t i = 0; i < count; ++i) {
+            const rocket::vec2f_t &a = points[i];
+            const rocket::vec2f_t &b = points[(i + 1) % count];
+            min_x = std::min(min_x, a.x);
+            min_y = std::min(min_y, a.y);
+            max_x = std::max(max_x, a.x);
+            max_y = std::max(max_y, a.y);
+            area += a.x * b.y - b.x * a.y;
+        }
+        if (std::abs(area) < std::numeric_limits<float>::epsilon()) {
+            return false;
+        }
+        if (!clip_bounds(state, min_x, min_y, max_x, max_y, cmd)) {
+            return false;
+        }
+
+        const float sign = area > 0.f ? 1.f : -1.f;
+        cmd.shape = sw_shape_t::convex;
+        cmd.first_edge = static_cast<uint32_t>(state.edges.size());
+        cmd.edge_count = static_cast<uint32_t>(count);
+        for (size_t i = 0; i < count; ++i) {
+            const rocket::vec2f_t &a = points[i];
+            const rocket::vec2f_t &b = points[(i + 1) % count];
+            // Inside is to the left of a -> b for a positive (y-down clockwise) area
+            state.edges.push_back({
+                -(b.y - a.y) * sign,
+                (b.x - a.x) * sign,
+                (a.x * (b.y - a.y) - a.y * (b.x - a.x)) * sign
+            });
+        }
+        state.commands.push_back(cmd);
+        return true;
+    }
+
+    /// @brief Corners of a rect rotated (degrees) around its center, also fills the command's local frame
+    static std::array<rocket::vec2f_t, 4> rotated_corners(rocket::fbounding_box rect, float rotation, sw_command_t &cmd) {
+        const float radians = rotation * std::numbers::pi_v<float> / 180.f;
+        const float cs = std::cos(radians);
+        const float sn = std::sin(radians);
+        cmd.center = { rect.pos.x + rect.size.x * 0.5f, rect.pos.y + rect.size.y * 0.5f };
+        cmd.half = { rect.size.x * 0.5f, rect.size.y * 0.5f };
+        // Local frame is the inverse rotation
+        cmd.cs = cs;
+        cmd.sn = -sn;
+
+        std::array<rocket::vec2f_t, 4> corners = {{
+            { -cmd.half.x, -cmd.half.y },
+            {  cmd.half.x, -cmd.half.y },
+            {  cmd.half.x,  cmd.half.y },
+            { -cmd.half.x,  cmd.half.y },
+        }};
+        for (auto &corner : corners) {
+            corner = {
+                corner.x * cs - corner.y * sn + cmd.center.x,
+                corner.x * sn + corner.y * cs + cmd.center.y
+            };
+        }
+        return corners;
+    }
+
+    static void push_rect(sw_raster_state_t &state, rocket::fbounding_box rect, rgba_color color, float rotation, float roundedness) {
+        if (color.w == 0 || rect.size.x <= 0.f || rect.size.y <= 0.f) {
+            return;
+        }
+        sw_command_t cmd;
+        cmd.color = color;
+        cmd.radius = std::min(rect.size.x, rect.size.y) * 0.5f * std::clamp(roundedness, 0.f, 1.f);
+        const auto corners = rotated_corners(rect, rotation, cmd);
+        (void) push_convex(state, corners.data(), corners.size(), cmd);
+    }
+
+    static void push_textured(
+        sw_raster_state_t &state,
+        const sw_texture_t &texture,
+        rocket::fbounding_box rect,
+        rocket::vec2f_t texture_origin,
+        rocket::vec2f_t texture_size,
+        float rotation,
+        float roundedness,
+        rgba_color tint,
+        bool bilinear
+    ) {
+        if (texture.pixels.empty() || rect.size.x <= 0.f || rect.size.y <= 0.f || tint.w == 0) {
+            return;
+        }
+        sw_command_t cmd;
+        cmd.color = tint;
+        cmd.texture = &texture;
+        cmd.bilinear = bilinear;
+        cmd.radius = std::min(rect.size.x, rect.size.y) * 0.5f * std::clamp(roundedness, 0.f, 1.f);
+        const auto corners = rotated_corners(rect, rotation, cmd);
+
+        // Texels are affine in screen space: local = R^-1 (p - center) + half
+        const float scale_u = texture_size.x / rect.size.x;
+        const float scale_v = texture_size.y / rect.size.y;
+        cmd.ux = scale_u * cmd.cs;
+        cmd.uy = -scale_u * cmd.sn;
+        cmd.u0 = texture_origin.x + scale_u * (cmd.half.x - cmd.center.x * cmd.cs + cmd.center.y * cmd.sn);
+        cmd.vx = scale_v * cmd.sn;
+        cmd.vy = scale_v * cmd.cs;
+        cmd.v0 = texture_origin.y + scale_v * (cmd.half.y - cmd.center.x * cmd.sn - cmd.center.y * cmd.cs);
+
+        cmd.tex_x0 = std::clamp(static_cast<int>(std::floor(texture_origin.x)), 0, texture.size.x - 1);
+        cmd.tex_y0 = std::clamp(static_cast<int>(std::floor(texture_origin.y)), 0, texture.size.y - 1);
+        cmd.tex_x1 = std::clamp(static_cast<int>(std::ceil(texture_origin.x + texture_size.x)) - 1, cmd.tex_x0, texture.size.x - 1);
+        cmd.tex_y1 = std::clamp(static_cast<int>(std::ceil(texture_origin.y + texture_size.y)) - 1, cmd.tex_y0, texture.size.y - 1);
+
+        (void) push_convex(state, corners.data(), corners.size(), cmd);
+    }
+
+    static void push_circle(sw_raster_state_t &state, rocket::vec2f_t pos, float radius, rgba_color color, int thickness) {
+        if (color.w == 0 || radius <= 0.f) {
+            return;
+        }
+        sw_command_t cmd;
+        cmd.shape = sw_shape_t::circle;
+        cmd.color = color;
+        cmd.center = pos;
+        cmd.outer_sq = radius * radius;
+        if (thickness > 0) {
+            const float inner = std::max(0.f, radius - static_cast<float>(thickness));
+            cmd.inner_sq = inner * inner;
+        }
+        if (clip_bounds(state, pos.x - radius, pos.y - radius, pos.x + radius, pos.y + radius, cmd)) {
+            state.commands.push_back(cmd);
+        }
+    }
+
+    static void push_clear(sw_raster_state_t &state, rgba_color color) {
+        sw_command_t cmd;
+        cmd.color = color;
+        cmd.replace = true;
+        const sw_texture_t &target = *state.target;
+        if (!clip_bounds(state, 0.f, 0.f, static_cast<float>(target.size.x), static_cast<float>(target.size.y), cmd)) {
+            return;
+        }
+        if (!state.scissor_rect.has_value()) {
+            // Everything recorded so far is overwritten
+            state.commands.clear();
+            state.edges.clear();
+        }
+        state.commands.push_back(cmd);
+    }
+
+    [[nodiscard]] static sw_texture_t to_sw_texture(rocket::vec2i_t size, int channels, const std::vector<uint8_t> &data) {
+        sw_texture_t texture;
+        texture.size = size;
+        const size_t count = static_cast<size_t>(std::max(size.x, 0)) * std::max(size.y, 0);
+        if (channels <= 0 || data.size() < count * channels) {
+            return texture;
+        }
+        texture.pixels.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t *src = data.data() + i * channels;
+            rgba_color &dst = texture.pixels[i];
+            dst.x = src[0];
+            dst.y = channels >= 2 ? src[1] : src[0];
+            dst.z = channels >= 3 ? src[2] : src[0];
+            dst.w = channels >= 4 ? src[3] : 255;
+        }
+        return texture;
+    }
+
+    [[nodiscard]] static bool window_has_gl_context(rocket::window_backend_i *window) {
+        if (window == nullptr || window->get_native_handle() == nullptr) {
+            return false;
+        }
+        return window->get_native_handle()->backend != rocket::window_backend_t::null
+            && window->get_flags().graphics_ctx.backend == rocket::renderer_backend_t::opengl;
+    }
+
+    static void init_gl_present(sw_raster_state_t &state, rocket::window_backend_i *window, const rocket::renderer_flags_t &flags) {
+        if (!window_has_gl_context(window)) {
+            rocket::log("no OpenGL context on the window, frames stay in memory", "software_renderer_2d", "constructor", "info");
+            return;
+        }
+        if (!util::glinitialized()) {
+            util::glinit(true);
+            std::vector<std::string> log_messages = rgl::init_gl(
+                { static_cast<float>(window->get_size().x), static_cast<float>(window->get_size().y) },
+                flags.glfnldr_backend,
+                window
+            );
+            for (auto &l : log_messages) {
+                if (l.starts_with('!'))
+                    rocket::log(l.substr(1), "rgl", "init_gl", "warn");
+                else if (l.starts_with('?'))
+                    rocket::log(l.substr(1), "rgl", "init_gl", "error");
+                else
+                    rocket::log(l, "rgl", "init_gl", "info");
+            }
+        }
+        state.present_gl = true;
+    }
+
+    /// @brief Upload the framebuffer and draw it over the whole window
+    static void present_gl(sw_raster_state_t &state) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::present");
+        const sw_texture_t &fb = state.framebuffer;
+        if (fb.size.x <= 0 || fb.size.y <= 0) {
+            return;
+        }
+
+        const rocket::vec2f_t size = { static_cast<float>(fb.size.x), static_cast<float>(fb.size.y) };
+        rgl::update_viewport(size);
+        glViewport(0, 0, fb.size.x, fb.size.y);
+
+        rgl::texture_unit_handle_t unit;
+        rgl::alloc_texture_unit(unit);
+        glActiveTexture(unit.unit);
+        if (state.present_texture == 0 || state.present_size.x != fb.size.x || state.present_size.y != fb.size.y) {
+            if (state.present_texture != 0) {
+                glDeleteTextures(1, &state.present_texture);
+            }
+            glGenTextures(1, &state.present_texture);
+            glBindTexture(GL_TEXTURE_2D, state.present_texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, fb.size.x, fb.size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            state.present_size = fb.size;
+        }
+        glBindTexture(GL_TEXTURE_2D, state.present_texture);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fb.size.x, fb.size.y, GL_RGBA, GL_UNSIGNED_BYTE, fb.pixels.data());
+
+        glDisable(GL_BLEND);
+        rgl::shader_program_t shader = rgl::get_paramaterized_textured_quad({ 0.f, 0.f }, size, 0.f, 0.f);
+        glUniform1i(glGetUniformLocation(shader, "u_texture"), unit.unit - GL_TEXTURE0);
+        rgl::draw_shader(shader, rgl::shader_use_t::textured_rect);
+        glEnable(GL_BLEND);
+        rgl::free_texture_unit(unit);
+    }
+
+    static void capture_readbacks(sw_raster_state_t &state, uint64_t frame) {
+        const sw_texture_t &fb = state.framebuffer;
+        for (auto &region : state.readback_requests) {
+            const int x = std::clamp(static_cast<int>(region.pos.x), 0, fb.size.x);
+            const int y = std::clamp(static_cast<int>(region.pos.y), 0, fb.size.y);
+            const int w = std::clamp(region.size.x < 0 ? fb.size.x - x : static_cast<int>(region.size.x), 0, fb.size.x - x);
+            const int h = std::clamp(region.size.y < 0 ? fb.size.y - y : static_cast<int>(region.size.y), 0, fb.size.y - y);
+            if (w == 0 || h == 0) {
+                continue;
+            }
+
+            rocket::framebuffer_readback_t readback;
+            readback.frame = frame;
+            readback.offset = { x, y };
+            readback.size = { w, h };
+            readback.pixels.resize(static_cast<size_t>(w) * h);
+            for (int row = 0; row < h; ++row) {
+                std::memcpy(
+                    readback.pixels.data() + static_cast<size_t>(row) * w,
+                    fb.pixels.data() + static_cast<size_t>(y + row) * fb.size.x + x,
+                    static_cast<size_t>(w) * sizeof(rgba_color)
+                );
+            }
+            state.readbacks.push_back(std::move(readback));
+        }
+        state.readback_requests.clear();
+    }
+}
+
+namespace rocket {
+    software_renderer_2d::software_renderer_2d(window_backend_i *window, int fps, renderer_flags_t flags) {
+        r_assert(window != nullptr);
+        r_assert(fps != 0);
+
+        this->impl = new renderer_2d_impl_t;
+        this->impl->obj = this;
+        this->bk_impl = new software_renderer_2d_impl_t;
+        this->bk_impl->raster_state = new sw_raster_state_t;
+        this->window = window;
+        this->fps = fps;
+        this->flags = flags;
+        window->wbi_impl->bound_renderer2d = this;
+
+        const auto cli_args = util::get_clistate();
+        if (cli_args.framerate != -1) {
+            this->fps = cli_args.framerate;
+        }
+        if (this->fps == -1) {
+            this->fps = 2147483647;
+        }
+
+        if (flags.share_renderer_as_global) {
+            util::set_global_renderer_2d(this);
+        }
+
+        this->vsync = window->flags.vsync;
+
+        auto &state = sw_state(this);
+        int threads = flags.software_threads;
+        if (threads <= 0) {
+            threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        // The calling thread rasterizes too
+        state.pool.start(threads - 1);
+        rocket::log("rasterizing on " + std::to_string(threads) + " thread(s)", "software_renderer_2d", "constructor", "info");
+
+        init_gl_present(state, window, flags);
+
+        const vec2f_t viewport = this->get_viewport_size();
+        resize_target(state.framebuffer, { static_cast<int>(viewport.x), static_cast<int>(viewport.y) }, rgba_color::black());
+        state.target = &state.framebuffer;
+
+        if (flags.show_splash && !this->splash_shown) {
+            this->show_splash();
+        }
+    }
+
+    software_renderer_2d::gfx_chk_result software_renderer_2d::check_graphics_settings(rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        if (!this->frame_started) {
+            return gfx_chk_result::not_drawable;
+        }
+        if (!this->graphics_settings.viewport_culling) {
+            return gfx_chk_result::drawable;
+        }
+        if (pos == rocket::vec2f_t { -1.f, -1.f } || sz == rocket::vec2f_t { -1.f, -1.f }) {
+            return gfx_chk_result::drawable;
+        }
+
+        const rocket::fbounding_box object_rect = { pos, sz };
+        return object_rect.intersects(this->get_culling_bounds()) ? gfx_chk_result::drawable : gfx_chk_result::not_drawable;
+    }
+
+    api_object_t software_renderer_2d::upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) {
+        api_object_t handle = ++this->impl->current_object_handle;
+        sw_texture_t texture;
+        texture.size = size;
+        texture.pixels.resize(static_cast<size_t>(size.x) * size.y);
+        for (size_t i = 0; i < texture.pixels.size() && i < bitmap.size(); ++i) {
+            texture.pixels[i] = { 255, 255, 255, bitmap[i] };
+        }
+        this->bk_impl->objects[handle] = std::move(texture);
+        return handle;
+    }
+
+    void software_renderer_2d::clean_gpu_resource(api_object_t object) {
+        auto it = this->bk_impl->objects.find(object);
+        if (it == this->bk_impl->objects.end()) {
+            return;
+        }
+        // Recorded draws may still sample it
+        flush(sw_state(this));
+        this->bk_impl->objects.erase(it);
+    }
+
+    bool software_renderer_2d::has_frame_began() {
+        return this->frame_started;
+    }
+
+    void software_renderer_2d::begin_frame() {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::begin_frame");
+        auto &state = sw_state(this);
+        const vec2f_t viewport = this->get_viewport_size();
+        const vec2i_t size = { static_cast<int>(viewport.x), static_cast<int>(viewport.y) };
+        if (size.x != state.framebuffer.size.x || size.y != state.framebuffer.size.y) {
+            resize_target(state.framebuffer, size, rgba_color::black());
+            // Sized caches do not depend on the viewport
+            for (auto &cache : this->impl->render_caches) {
+                if (cache->follows_viewport()) {
+                    this->invalidate_render_cache(cache.get());
+                }
+            }
+        }
+
+        this->frame_started = true;
+        this->frame_start_time = clock::now();
+        if (this->frame_counter == 0) {
+            this->delta_time = 0.0;
+        } else {
+            this->delta_time = std::chrono::duration<double>(this->frame_start_time - this->last_time).count();
+        }
+        this->last_time = this->frame_start_time;
+    }
+
+    void software_renderer_2d::show_splash() {
+        const auto cli_args = util::get_clistate();
+        if (cli_args.nosplash) {
+            this->splash_shown = true;
+            return;
+        }
+        this->splash_shown = true;
+
+        constexpr float duration = 16384.f;
+        auto tween = tweeny::from(0).to(0).during(duration / 2).via(tweeny::easing::cubicOut);
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        stbi_uc *img_data = stbi_load_from_memory(
+            splash_screen_png,
+            static_cast<int>(splash_screen_png_len),
+            &width,
+            &height,
+            &channels,
+            4
+        );
+        if (img_data == nullptr) {
+            rocket::log("failed to load embedded splash texture", "software_renderer_2d", "show_splash", "error");
+            return;
+        }
+
+        auto texture = std::make_shared<texture_t>();
+        texture->size = { width, height };
+        texture->channels = 4;
+        texture->data.assign(img_data, img_data + (width * height * 4));
+        stbi_image_free(img_data);
+
+        bool final_stage = false;
+        bool splash_finished = false;
+        while (window->is_running() && !splash_finished) {
+            this->begin_frame();
+            this->clear(rgba_color::black());
+            {
+                const float alpha = tween.step(static_cast<float>(this->get_delta_time()));
+                const float center_x = this->get_viewport_size().x / 2.f - window->get_size().y / 2.f;
+                this->draw_texture(texture, { { center_x, 0.f }, { static_cast<float>(window->get_size().y), static_cast<float>(window->get_size().y) } });
+
+                rocket::text_t version_text = { "Version: " ROCKETGE__VERSION, 24, rgb_color::white(), rGE__FONT_DEFAULT_MONOSPACED };
+                this->draw_rectangle({ 0.f, 0.f }, this->get_viewport_size(), { 0, 0, 0, static_cast<uint8_t>(alpha) });
+                this->draw_text(version_text, { 0.f, this->get_viewport_size().y - version_text.measure().y });
+
+                if (tween.progress() >= 1.f) {
+                    if (final_stage) {
+                        splash_finished = true;
+                    }
+                    final_stage = true;
+                    tween = tweeny::from(0).to(255).during(duration).via(tweeny::easing::cubicOut);
+                }
+            }
+            this->end_frame();
+            this->window->poll_events();
+        }
+        this->clean_gpu_resource(texture->hdl);
+        texture->hdl = 0;
+    }
+
+    void software_renderer_2d::begin_render_mode(render_mode_t mode) {
+        if (mode == render_mode_t::camera) {
+            this->begin_camera_mode();
+        }
+        this->active_render_modes.push_back(mode);
+    }
+
+    std::vector<rgba_color> software_renderer_2d::get_framebuffer() {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::get_framebuffer");
+        auto &state = sw_state(this);
+        if (state.target == &state.framebuffer) {
+            flush(state);
+        }
+        return state.framebuffer.pixels;
+    }
+
+    void software_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::push_framebuffer");
+        auto &state = sw_state(this);
+        if (framebuffer.size() != state.framebuffer.pixels.size()) {
+            rocket::log("framebuffer size does not match the viewport", "software_renderer_2d", "push_framebuffer", "error");
+            return;
+        }
+        flush(state);
+        state.framebuffer.pixels = framebuffer;
+        rgl::add_frame_metrics_data_uploads(1);
+    }
+
+    void software_renderer_2d::push_canvas() {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::push_canvas");
+        auto &state = sw_state(this);
+        const vec2i_t size = this->canvas.get_size();
+        if (size.x != state.framebuffer.size.x || size.y != state.framebuffer.size.y) {
+            // Canvas is a viewport behind, get_canvas resizes it
+            return;
+        }
+        flush(state);
+        std::memcpy(state.framebuffer.pixels.data(), this->canvas.data(), state.framebuffer.pixels.size() * sizeof(rgba_color));
+        this->canvas.clear_dirty();
+    }
+
+    void software_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+        sw_state(this).readback_requests.push_back(region);
+    }
+
+    bool software_renderer_2d::poll_framebuffer_readback(framebuffer_readback_t &out) {
+        auto &state = sw_state(this);
+        if (state.readbacks.empty()) {
+            return false;
+        }
+        out = std::move(state.readbacks.front());
+        state.readbacks.erase(state.readbacks.begin());
+        return true;
+    }
+
+    vec2f_t software_renderer_2d::get_viewport_size() {
+        if (this->override_viewport_size != vec2f_t { -1.f, -1.f }) {
+            return this->override_viewport_size;
+        }
+        if (this->window == nullptr) {
+            return { 0.f, 0.f };
+        }
+        return {
+            static_cast<float>(this->window->get_size().x),
+            static_cast<float>(this->window->get_size().y)
+        };
+    }
+
+    void software_renderer_2d::begin_scissor_mode(rocket::fbounding_box rect) {
+        sw_state(this).scissor_rect = rect;
+    }
+
+    void software_renderer_2d::begin_scissor_mode(rocket::vec2f_t pos, rocket::vec2f_t size) {
+        this->begin_scissor_mode({ pos, size });
+    }
+
+    void software_renderer_2d::begin_scissor_mode(float x, float y, float sx, float sy) {
+        this->begin_scissor_mode({ { x, y }, { sx, sy } });
+    }
+
+    void software_renderer_2d::clear(rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::clear");
+        push_clear(sw_state(this), color);
+        if (flags.share_renderer_as_global) {
+            __rallframestart();
+        }
+    }
+
+    void software_renderer_2d::draw_shader(const shader_i &shader) {
+        (void) shader;
+        auto &state = sw_state(this);
+        if (!state.shader_warning_shown) {
+            rocket::log("shaders are not supported by the software renderer, skipping", "software_renderer_2d", "draw_shader", "warn");
+            state.shader_warning_shown = true;
+        }
+        rgl::add_frame_metrics_data_skipped_drawcalls(1);
+    }
+
+    void software_renderer_2d::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_rectangle");
+        if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+
+        if (lines) {
+            constexpr float thickness = 1.f;
+            this->draw_rectangle({ rect.pos, { rect.size.x, thickness } }, color);
+            this->draw_rectangle({ { rect.pos.x, rect.pos.y + rect.size.y - thickness }, { rect.size.x, thickness } }, color);
+            this->draw_rectangle({ rect.pos, { thickness, rect.size.y } }, color);
+            this->draw_rectangle({ { rect.pos.x + rect.size.x - thickness, rect.pos.y }, { thickness, rect.size.y } }, color);
+            return;
+        }
+
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
+        push_rect(sw_state(this), rect, color, rotation, roundedness);
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(2);
+    }
+
+    void software_renderer_2d::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        this->draw_rectangle({ pos, size }, color, rotation, roundedness, lines);
+    }
+
+    void software_renderer_2d::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_circle");
+        if (this->check_graphics_settings({ pos.x - radius, pos.y - radius }, { radius * 2.f, radius * 2.f }) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+
+        if (this->camera_active) {
+            pos = this->camera_xf.apply(pos);
+            radius = this->camera_xf.apply_length(radius);
+            if (thickness > 0) {
+                thickness = std::max(1, static_cast<int>(std::round(this->camera_xf.apply_length(static_cast<float>(thickness)))));
+            }
+        }
+        push_circle(sw_state(this), pos, radius, color, thickness);
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(std::max(2, static_cast<int>(radius)));
+    }
+
+    void software_renderer_2d::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int sides, float rotation) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_polygon");
+        if (this->check_graphics_settings({ pos.x - radius, pos.y - radius }, { radius * 2.f, radius * 2.f }) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+        if (color.w == 0) {
+            return;
+        }
+
+        if (this->camera_active) {
+            pos = this->camera_xf.apply(pos);
+            radius = this->camera_xf.apply_length(radius);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
+
+        // Regular polygons are convex, one command instead of a triangle fan
+        const int segment_count = std::max(3, sides);
+        std::vector<rocket::vec2f_t> points(static_cast<size_t>(segment_count));
+        const float rotation_rad = rotation * std::numbers::pi_v<float> / 180.f;
+        for (int i = 0; i < segment_count; ++i) {
+            const float angle = rotation_rad + (static_cast<float>(i) / segment_count) * 2.f * std::numbers::pi_v<float>;
+            points[i] = { pos.x + std::cos(angle) * radius, pos.y + std::sin(angle) * radius };
+        }
+
+        sw_command_t cmd;
+        cmd.color = color;
+        (void) push_convex(sw_state(this), points.data(), points.size(), cmd);
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(std::max(1, sides - 2));
+    }
+
+    void software_renderer_2d::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_texture");
+        if (texture == nullptr) {
+            return;
+        }
+        this->draw_atlas_texture(
+            texture,
+            rect,
+            { 0.f, 0.f },
+            { static_cast<float>(texture->size.x), static_cast<float>(texture->size.y) },
+            rotation,
+            roundedness
+        );
+    }
+
+    void software_renderer_2d::draw_atlas_texture(
+        std::shared_ptr<rocket::texture_t> texture,
+        rocket::fbounding_box rect,
+        rocket::vec2f_t texture_position_in_atlas,
+        rocket::vec2f_t texture_size_in_atlas,
+        float rotation,
+        float roundedness
+    ) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_atlas_texture");
+        if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+        if (texture == nullptr) {
+            return;
+        }
+
+        this->make_ready_texture(texture);
+        auto it = this->bk_impl->objects.find(texture->hdl);
+        if (it == this->bk_impl->objects.end()) {
+            return;
+        }
+
+        const bool nearest = std::find(this->active_render_modes.begin(), this->active_render_modes.end(), render_mode_t::texture_filter_none) != this->active_render_modes.end();
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
+        push_textured(
+            sw_state(this),
+            it->second,
+            rect,
+            texture_position_in_atlas,
+            texture_size_in_atlas,
+            rotation,
+            roundedness,
+            rgba_color::white(),
+            !nearest
+        );
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(2);
+    }
+
+    void software_renderer_2d::make_ready_texture(std::shared_ptr<rocket::texture_t> texture) {
+        if (texture == nullptr || texture->hdl != 0) {
+            return;
+        }
+
+        api_object_t handle = ++this->impl->current_object_handle;
+        this->bk_impl->objects[handle] = to_sw_texture(texture->size, texture->channels, texture->data);
+        texture->hdl = handle;
+        rgl::add_frame_metrics_data_uploads(1);
+    }
+
+    void software_renderer_2d::draw_text(const rocket::text_t &text_value, vec2f_t position) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_text");
+        rocket::text_t text = text_value;
+        if (check_graphics_settings(position, text.measure()) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(static_cast<int>(text.text.size()));
+            return;
+        }
+        if (util::get_clistate().notext) {
+            return;
+        }
+
+        if (text.font == nullptr) {
+            text.font = font_t::font_default(static_cast<int>(text.size));
+        } else if (text.font.get() == reinterpret_cast<font_t*>(0x01)) {
+            text.font = font_t::font_default_monospace(static_cast<int>(text.size));
+        }
+        if (text.font == nullptr || text.font->hdl == 0) {
+            return;
+        }
+
+        auto font_it = this->bk_impl->objects.find(text.font->hdl);
+        if (font_it == this->bk_impl->objects.end()) {
+            return;
+        }
+
+        auto &state = sw_state(this);
+        const sw_texture_t &font_texture = font_it->second;
+        const rgba_color tint = static_cast<rocket::rgba_color>(text.color);
+        float x = position.x;
+        float y = position.y;
+        for (const char raw_ch : text.text) {
+            const unsigned char ch = static_cast<unsigned char>(raw_ch);
+            if (ch < 32 || ch > 127) {
+                continue;
+            }
+
+            stbtt_aligned_quad quad {};
+            stbtt_GetBakedQuad(text.font->cdata->a, text.font->sttex_size.x, text.font->sttex_size.y, ch - 32, &x, &y, &quad, 1);
+            rocket::fbounding_box glyph = { { quad.x0, quad.y0 }, { quad.x1 - quad.x0, quad.y1 - quad.y0 } };
+            float glyph_rotation = 0.f;
+            if (this->camera_active) {
+                glyph = this->camera_xf.apply(glyph);
+                glyph_rotation = this->camera_xf.apply_rotation(glyph_rotation);
+            }
+            push_textured(
+                state,
+                font_texture,
+                glyph,
+                { quad.s0 * static_cast<float>(font_texture.size.x), quad.t0 * static_cast<float>(font_texture.size.y) },
+                { (quad.s1 - quad.s0) * static_cast<float>(font_texture.size.x), (quad.t1 - quad.t0) * static_cast<float>(font_texture.size.y) },
+                glyph_rotation,
+                0.f,
+                tint,
+                false
+            );
+        }
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(static_cast<int>(text.text.size()) * 2);
+    }
+
+    void software_renderer_2d::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_pixel");
+        if (this->check_graphics_settings(pos, { 1.f, 1.f }) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+        rocket::fbounding_box pixel = { { std::floor(pos.x), std::floor(pos.y) }, { 1.f, 1.f } };
+        float rotation = 0.f;
+        if (this->camera_active) {
+            pixel = this->camera_xf.apply(pixel);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
+        push_rect(sw_state(this), pixel, color, rotation, 0.f);
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(1);
+    }
+
+    void software_renderer_2d::draw_fps(vec2f_t pos) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_fps");
+        const std::string fps_text = "FPS: " + std::to_string(static_cast<int>(std::round(get_current_fps())));
+        rocket::text_t fps = rocket::text_t(fps_text, 24, rocket::rgb_color::green());
+        this->draw_text(fps, pos);
+    }
+
+    void software_renderer_2d::begin_gpu_region(const char *name) {
+        // No GPU, use ROCKET_PROFILE_SCOPE for CPU time
+        (void) name;
+    }
+
+    void software_renderer_2d::end_gpu_region() {
+    }
+
+    void software_renderer_2d::set_wireframe(bool enabled) {
+        this->wireframe = enabled;
+    }
+
+    void software_renderer_2d::set_vsync(bool enabled) {
+        this->vsync = enabled;
+        if (this->window != nullptr) {
+            this->window->set_vsync(enabled);
+        }
+    }
+
+    void software_renderer_2d::set_fps(int fps_value) {
+        this->fps = fps_value;
+    }
+
+    void software_renderer_2d::end_scissor_mode() {
+        sw_state(this).scissor_rect.reset();
+    }
+
+    void software_renderer_2d::end_render_mode(render_mode_t mode) {
+        if (mode == render_mode_t::camera) {
+            this->end_camera_mode();
+        }
+        for (auto it = this->active_render_modes.begin(); it != this->active_render_modes.end(); ++it) {
+            if (*it == mode) {
+                this->active_render_modes.erase(it);
+                break;
+            }
+        }
+    }
+
+    void software_renderer_2d::end_frame() {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::end_frame");
+        if (!this->frame_started) {
+            return;
+        }
+        this->flush_command_buckets();
+
+        if (flags.share_renderer_as_global) {
+            __rallframeend();
+        }
+        if (util::get_clistate().debugoverlay) {
+            util::draw_debug_overlay(this);
+        }
+
+        auto &state = sw_state(this);
+        flush(state);
+        capture_readbacks(state, this->frame_counter);
+        if (state.present_gl) {
+            present_gl(state);
+            this->window->swap_buffers();
+        }
+
+        this->frame_started = false;
+        auto frame_end_time = clock::now();
+        this->frame_counter++;
+
+        rgl::frame_metrics_t metrics = rgl::get_frame_metrics();
+        if (metrics.drawcalls > rGL_MAX_RECOMMENDED_DRAWCALLS) {
+            rocket::log("Too many drawcalls! (" + std::to_string(metrics.drawcalls) + ") Frames may suffer", "software_renderer_2d", "end_frame", "warning");
+        }
+        if (metrics.tricount > rGL_MAX_RECOMMENDED_TRICOUNT) {
+            rocket::log("Too many triangles! (" + std::to_string(metrics.tricount) + ") Frames may suffer", "software_renderer_2d", "end_frame", "warning");
+        }
+
+        rgl::reset_frame_metrics();
+
+        if (this->fps != rocket::cst::fps_uncapped && !this->vsync) {
+            const double frame_duration = std::chrono::duration<double>(frame_end_time - frame_start_time).count();
+            if (this->fps == 0) {
+                rocket::log("Target FPS 0 is too low", "software_renderer_2d", "end_frame", "fatal");
+                rocket::exit(1);
+            }
+            const double frametime_limit = 1.0 / this->fps;
+            const double pacing_error = util::frame_timer_wait_for(
+                frame_duration,
+                frametime_limit,
+                util::get_clistate().software_frame_timer,
+                this->fps,
+                this->frame_start_time
+            );
+            rgl::update_pacing_metrics_data(static_cast<float>(pacing_error));
+            const double measured_time = frame_duration + std::chrono::duration<double>(clock::now() - frame_end_time).count();
+            rgl::update_draw_metrics_data(static_cast<float>(measured_time), this->delta_time > 0.0 ? static_cast<float>(1.0 / this->delta_time) : 0.f);
+        } else {
+            const double frame_duration = std::chrono::duration<double>(frame_end_time - frame_start_time).count();
+            rgl::update_draw_metrics_data(static_cast<float>(frame_duration), this->delta_time > 0.0 ? static_cast<float>(1.0 / this->delta_time) : 0.f);
+        }
+
+        rgl::push_frame_record({
+            .frame = this->frame_counter,
+            .cpu_time = std::chrono::duration<float>(frame_end_time - this->frame_start_time).count(),
+            .wait_time = std::chrono::duration<float>(clock::now() - frame_end_time).count(),
+            .drawcalls = metrics.drawcalls,
+            .tricount = metrics.tricount,
+            .skipped_drawcalls = metrics.skipped_drawcalls,
+            .uploads = metrics.uploads,
+        });
+    }
+
+    bool software_renderer_2d::has_frame_ended() {
+        return !this->frame_started;
+    }
+
+    void software_renderer_2d::set_graphics_settings(graphics_settings_t graphics) {
+        this->graphics_settings = graphics;
+    }
+
+    void software_renderer_2d::set_viewport_size(vec2f_t size) {
+        this->override_viewport_size = size;
+    }
+
+    void software_renderer_2d::set_viewport_offset(vec2f_t zero_pos) {
+        this->override_viewport_offset = zero_pos;
+    }
+
+    void software_renderer_2d::set_camera(camera_2d *cam) {
+        this->cam = cam;
+    }
+
+    void software_renderer_2d::close() {
+        if (this->window != nullptr && this->window->wbi_impl != nullptr && this->window->wbi_impl->bound_renderer2d == this) {
+            this->window->wbi_impl->bound_renderer2d = nullptr;
+        }
+
+        if (util::get_global_renderer_2d() == this) {
+            util::set_global_renderer_2d(nullptr);
+        }
+
+        if (this->bk_impl != nullptr) {
+            auto *state = reinterpret_cast<sw_raster_state_t *>(this->bk_impl->raster_state);
+            if (state != nullptr) {
+                state->pool.stop();
+                if (state->present_texture != 0) {
+                    glDeleteTextures(1, &state->present_texture);
+                }
+                delete state;
+            }
+            this->bk_impl->raster_state = nullptr;
+            delete this->bk_impl;
+            this->bk_impl = nullptr;
+        }
+
+        if (this->impl != nullptr) {
+            delete this->impl;
+            this->impl = nullptr;
+        }
+
+        this->window = nullptr;
+    }
+
+    bool software_renderer_2d::get_wireframe() {
+        return this->wireframe;
+    }
+
+    bool software_renderer_2d::get_vsync() {
+        return this->vsync;
+    }
+
+    int software_renderer_2d::get_fps() {
+        return this->fps;
+    }
+
+    double software_renderer_2d::get_delta_time() {
+        if (double fixed = util::input_replay_delta_time(); fixed > 0.0) {
+            return fixed;
+        }
+        return this->delta_time;
+    }
+
+    uint64_t software_renderer_2d::get_framecount() {
+        return this->frame_counter;
+    }
+
+    int software_renderer_2d::get_drawcalls() {
+        return rgl::get_frame_metrics().drawcalls;
+    }
+
+    rgl::draw_metrics_t software_renderer_2d::get_draw_metrics() {
+        return rgl::get_draw_metrics();
+    }
+
+    const graphics_settings_t &software_renderer_2d::get_graphics_settings() {
+        return this->graphics_settings;
+    }
+
+    api_object_t software_renderer_2d::get_framebuffer_texture() {
+        auto &state = sw_state(this);
+        if (state.target == &state.framebuffer) {
+            flush(state);
+        }
+
+        // One snapshot object, rewritten on every call
+        if (state.framebuffer_texture == 0) {
+            state.framebuffer_texture = ++this->impl->current_object_handle;
+        }
+        this->bk_impl->objects[state.framebuffer_texture] = state.framebuffer;
+        return state.framebuffer_texture;
+    }
+
+    camera_2d *software_renderer_2d::get_camera() {
+        return this->cam;
+    }
+
+    glm::mat4 software_renderer_2d::get_camera_matrix() {
+        if (!this->camera_active) {
+            return glm::mat4(1.0f);
+        }
+        return this->camera_xf.get_matrix();
+    }
+
+    float software_renderer_2d::get_current_fps() {
+        return rgl::get_draw_metrics().avg_fps;
+    }
+
+    render_cache_t *software_renderer_2d::create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size) {
+        std::unique_ptr<render_cache_t> c = std::make_unique<render_cache_t>();
+        api_object_t handle = ++this->impl->current_object_handle;
+        c->fbo = handle;
+        c->draw = draw_cb;
+        c->size = size;
+        this->bk_impl->objects.try_emplace(handle);
+        c->dirty = true;
+        this->redraw_render_cache(c.get());
+
+        this->impl->render_caches.emplace_back(std::move(c));
+        return this->impl->render_caches.back().get();
+    }
+
+    void software_renderer_2d::redraw_render_cache(render_cache_t *c) {
+        auto it = this->bk_impl->objects.find(c->fbo);
+        if (it == this->bk_impl->objects.end()) {
+            return;
+        }
+        vec2i_t size = { std::max(c->size.x, 1), std::max(c->size.y, 1) };
+        if (c->follows_viewport()) {
+            const vec2f_t viewport = this->get_viewport_size();
+            size = { static_cast<int>(viewport.x), static_cast<int>(viewport.y) };
+        }
+        if (size.x != it->second.size.x || size.y != it->second.size.y) {
+            // Draws recorded against the old size may sample it
+            flush(sw_state(this));
+            resize_target(it->second, size, rgba_color::blank());
+        }
+        c->region = { { 0.f, 0.f }, { static_cast<float>(size.x), static_cast<float>(size.y) } };
+        c->dirty = false;
+
+        // Contents are in cache space, whatever mode the caller is in
+        bool _frame_started = this->frame_started;
+        bool _camera_active = this->camera_active;
+        this->frame_started = true;
+        this->camera_active = false;
+        this->begin_render_cache(c);
+        push_clear(sw_state(this), rgba_color::blank());
+        c->draw(this);
+        this->end_render_cache(c);
+        this->camera_active = _camera_active;
+        this->frame_started = _frame_started;
+    }
+
+    void software_renderer_2d::invalidate_render_cache(render_cache_t *c) {
+        if (c == nullptr || c->fbo == ROCKETGE__InvalidNumber) {
+            return;
+        }
+        c->dirty = true;
+    }
+
+    void software_renderer_2d::update_render_cache(render_cache_t *c) {
+        if (c == nullptr || c->fbo == ROCKETGE__InvalidNumber || !c->dirty) {
+            return;
+        }
+        this->redraw_render_cache(c);
+    }
+
+    void software_renderer_2d::begin_render_cache(render_cache_t *c) {
+        if (c == nullptr || c->fbo == ROCKETGE__InvalidNumber) {
+            return;
+        }
+        this->update_render_cache(c);
+        auto it = this->bk_impl->objects.find(c->fbo);
+        if (it == this->bk_impl->objects.end()) {
+            return;
+        }
+        auto &state = sw_state(this);
+        flush(state);
+        this->impl->render_cache_use_stack.push(c);
+        state.target = &it->second;
+        this->render_cache_extent = c->follows_viewport() ? vec2f_t { -1, -1 } : c->region.size;
+    }
+
+    void software_renderer_2d::end_render_cache(render_cache_t *c) {
+        r_assert(c != nullptr);
+        r_assert(!this->impl->render_cache_use_stack.empty());
+        r_assert(this->impl->render_cache_use_stack.top() == c);
+
+        auto &state = sw_state(this);
+        flush(state);
+        this->impl->render_cache_use_stack.pop();
+        if (this->impl->render_cache_use_stack.empty()) {
+            state.target = &state.framebuffer;
+            this->render_cache_extent = { -1, -1 };
+        } else {
+            render_cache_t *top = this->impl->render_cache_use_stack.top();
+            state.target = &this->bk_impl->objects[top->fbo];
+            this->render_cache_extent = top->follows_viewport() ? vec2f_t { -1, -1 } : top->region.size;
+        }
+    }
+
+    void software_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        ROCKET_PROFILE_SCOPE("software_renderer_2d::draw_render_cache");
+        if (this->check_graphics_settings(pos, sz) == gfx_chk_result::not_drawable) {
+            rgl::add_frame_metrics_data_skipped_drawcalls(1);
+            return;
+        }
+        r_assert(c != nullptr);
+        this->update_render_cache(c);
+        auto it = this->bk_impl->objects.find(c->fbo);
+        if (it == this->bk_impl->objects.end()) {
+            return;
+        }
+        auto &state = sw_state(this);
+        r_assert(state.target != &it->second);
+
+        const sw_texture_t &cache = it->second;
+        rocket::fbounding_box rect = { pos, sz };
+        float rotation = 0.f;
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
+        push_textured(
+            state,
+            cache,
+            rect,
+            { 0.f, 0.f },
+            { static_cast<float>(cache.size.x), static_cast<float>(cache.size.y) },
+            rotation,
+            0.f,
+            rgba_color::white(),
+            true
+        );
+        rgl::add_frame_metrics_data_drawcalls(1);
+        rgl::add_frame_metrics_data_tricount(2);
+    }
+
+    void software_renderer_2d::draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) {
+        this->draw_render_cache(c, bbox.pos, bbox.size);
+    }
+
+    void software_renderer_2d::destroy_render_cache(render_cache_t *&c) {
+        r_assert(c != nullptr);
+        for (auto it = this->impl->render_caches.begin(); it != this->impl->render_caches.end(); ++it) {
+            if (it->get() == c) {
+                this->clean_gpu_resource(c->fbo);
+                this->impl->render_caches.erase(it);
+                c = nullptr;
+                break;
+            }
+        }
+    }
+
+    software_renderer_2d::~software_renderer_2d() {
+        this->close();
+    }
+}
@@ -40,6 +40,7 @@
 #include "plugin.hpp"
 #include "rocket/macros.hpp"
 #include "rocket/plugin/plugin.hpp"
+#include "rocket/profiler.hpp"
 #include "rocket/runtime.hpp"
 #include "shader_provider.hpp"
 #include "util.hpp"
@@ -122,6 +123,8 @@ namespace {
         rge_vk_pipeline_t overlay_pipeline;
 
         std::vector<rocket::rgba_color> framebuffer;
+        /// @brief Finished readbacks, oldest first
+        std::vector<rocket::framebuffer_readback_t> readbacks;
         std::vector<rocket::api_object_t> queued_shaders;
 
         bool swapchain_needs_rebuild = false;
@@ -1499,6 +1502,7 @@ void main() {
         );
 
         transition_overlay_image(state, command_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        rgl::add_frame_metrics_data_uploads(1);
     }
 
     static void bind_default_viewport_and_scissor(const rge_vk_native_state_t &state, VkCommandBuffer command_buffer) {
@@ -2104,8 +2108,7 @@ namespace rocket {
         }
 
         const rocket::fbounding_box object_rect = { pos, sz };
-        const rocket::fbounding_box viewport_rect = { { 0.f, 0.f }, this->get_viewport_size() };
-        return object_rect.intersects(viewport_rect) ? gfx_chk_result::drawable : gfx_chk_result::not_drawable;
+        return object_rect.intersects(this->get_culling_bounds()) ? gfx_chk_result::drawable : gfx_chk_result::not_drawable;
     }
 
     api_object_t vulkan_renderer_2d::upload_font_texture_to_gpu(rocket::vec2i_t size, const std::vector<uint8_t> &bitmap) {
@@ -2141,6 +2144,7 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::begin_frame() {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::begin_frame");
         recreate_swapchain_if_needed(this);
         recreate_overlay_if_needed(this);
         ensure_framebuffer_storage(this);
@@ -2218,15 +2222,61 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::begin_render_mode(render_mode_t mode) {
+        if (mode == render_mode_t::camera) {
+            this->begin_camera_mode();
+        }
         this->active_render_modes.push_back(mode);
     }
 
     std::vector<rgba_color> vulkan_renderer_2d::get_framebuffer() {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::get_framebuffer");
         ensure_framebuffer_storage(this);
         return vk_state(this).framebuffer;
     }
 
+    void vulkan_renderer_2d::request_framebuffer_readback(rocket::fbounding_box region) {
+        // The framebuffer is already CPU-side, copy it right away
+        ensure_framebuffer_storage(this);
+        auto &state = vk_state(this);
+        const VkExtent2D extent = to_vk_extent(resolved_viewport_size(this));
+        const int width = static_cast<int>(extent.width);
+        const int height = static_cast<int>(extent.height);
+
+        int x = std::clamp(static_cast<int>(region.pos.x), 0, width);
+        int y = std::clamp(static_cast<int>(region.pos.y), 0, height);
+        int w = std::clamp(region.size.x < 0 ? width - x : static_cast<int>(region.size.x), 0, width - x);
+        int h = std::clamp(region.size.y < 0 ? height - y : static_cast<int>(region.size.y), 0, height - y);
+        if (w == 0 || h == 0) {
+            return;
+        }
+
+        rocket::framebuffer_readback_t readback;
+        readback.frame = this->frame_counter;
+        readback.offset = { x, y };
+        readback.size = { w, h };
+        readback.pixels.resize(static_cast<std::size_t>(w) * h);
+        for (int row = 0; row < h; ++row) {
+            std::memcpy(
+                readback.pixels.data() + static_cast<std::size_t>(row) * w,
+                state.framebuffer.data() + static_cast<std::size_t>(y + row) * width + x,
+                static_cast<std::size_t>(w) * sizeof(rgba_color)
+            );
+        }
+        state.readbacks.push_back(std::move(readback));
+    }
+
+    bool vulkan_renderer_2d::poll_framebuffer_readback(rocket::framebuffer_readback_t &out) {
+        auto &state = vk_state(this);
+        if (state.readbacks.empty()) {
+            return false;
+        }
+        out = std::move(state.readbacks.front());
+        state.readbacks.erase(state.readbacks.begin());
+        return true;
+    }
+
     void vulkan_renderer_2d::push_framebuffer(const std::vector<rgba_color> &framebuffer) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::push_framebuffer");
         ensure_framebuffer_storage(this);
         auto &dst = vk_state(this).framebuffer;
         if (framebuffer.size() == dst.size()) {
@@ -2234,6 +2284,22 @@ namespace rocket {
         }
     }
 
+    void vulkan_renderer_2d::push_canvas() {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::push_canvas");
+        ensure_framebuffer_storage(this);
+        auto &dst = vk_state(this).framebuffer;
+        const rocket::vec2i_t size = this->canvas.get_size();
+        if (dst.size() != static_cast<std::size_t>(size.x) * size.y) {
+            // Canvas is a viewport behind, get_canvas resizes it
+            return;
+        }
+
+        // The framebuffer is redrawn every frame, so the whole canvas is copied,
+        // there is no texture upload to save
+        std::memcpy(dst.data(), this->canvas.data(), dst.size() * sizeof(rgba_color));
+        this->canvas.clear_dirty();
+    }
+
     vec2f_t vulkan_renderer_2d::get_viewport_size() {
         return resolved_viewport_size(this);
     }
@@ -2251,6 +2317,7 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::clear(rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::clear");
         ensure_framebuffer_storage(this);
         std::fill(vk_state(this).framebuffer.begin(), vk_state(this).framebuffer.end(), color);
         if (flags.share_renderer_as_global) {
@@ -2259,6 +2326,7 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_shader(const shader_i &shader) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_shader");
         if (this->check_graphics_settings({ -1.f, -1.f }, { -1.f, -1.f }) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -2276,6 +2344,7 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_rectangle(rocket::fbounding_box rect, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_rectangle");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -2290,16 +2359,22 @@ namespace rocket {
             return;
         }
 
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
         raster_rectangle(this, rect, color, rotation, roundedness);
         rgl::add_frame_metrics_data_drawcalls(1);
         rgl::add_frame_metrics_data_tricount(2);
     }
 
     void vulkan_renderer_2d::draw_rectangle(rocket::vec2f_t pos, rocket::vec2f_t size, rocket::rgba_color color, float rotation, float roundedness, bool lines) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_rectangle");
         this->draw_rectangle({ pos, size }, color, rotation, roundedness, lines);
     }
 
     void vulkan_renderer_2d::draw_circle(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int thickness) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_circle");
         const rocket::vec2f_t center_pos = {
             pos.x - radius,
             pos.y - radius
@@ -2309,12 +2384,20 @@ namespace rocket {
             return;
         }
 
+        if (this->camera_active) {
+            pos = this->camera_xf.apply(pos);
+            radius = this->camera_xf.apply_length(radius);
+            if (thickness > 0) {
+                thickness = std::max(1, static_cast<int>(std::round(this->camera_xf.apply_length(static_cast<float>(thickness)))));
+            }
+        }
         raster_circle(this, pos, radius, color, thickness);
         rgl::add_frame_metrics_data_drawcalls(1);
         rgl::add_frame_metrics_data_tricount(std::max(2, static_cast<int>(radius)));
     }
 
     void vulkan_renderer_2d::draw_polygon(rocket::vec2f_t pos, float radius, rocket::rgba_color color, int sides, float rotation) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_polygon");
         const rocket::vec2f_t center_pos = {
             pos.x - radius,
             pos.y - radius
@@ -2324,12 +2407,18 @@ namespace rocket {
             return;
         }
 
+        if (this->camera_active) {
+            pos = this->camera_xf.apply(pos);
+            radius = this->camera_xf.apply_length(radius);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
         raster_polygon(this, pos, radius, color, sides, rotation);
         rgl::add_frame_metrics_data_drawcalls(1);
         rgl::add_frame_metrics_data_tricount(std::max(1, sides - 2));
     }
 
     void vulkan_renderer_2d::draw_texture(std::shared_ptr<rocket::texture_t> texture, rocket::fbounding_box rect, float rotation, float roundedness) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_texture");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -2344,6 +2433,10 @@ namespace rocket {
             return;
         }
         const auto &vk_texture = std::get<vk_texture_t>(object_it->second.value);
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
         raster_textured_quad(
             this,
             vk_texture,
@@ -2365,6 +2458,7 @@ namespace rocket {
         float rotation,
         float roundedness
     ) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_atlas_texture");
         if (this->check_graphics_settings(rect.pos, rect.size) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
@@ -2379,6 +2473,10 @@ namespace rocket {
             return;
         }
         const auto &vk_texture = std::get<vk_texture_t>(object_it->second.value);
+        if (this->camera_active) {
+            rect = this->camera_xf.apply(rect);
+            rotation = this->camera_xf.apply_rotation(rotation);
+        }
         raster_textured_quad(
             this,
             vk_texture,
@@ -2413,6 +2511,7 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_text(const rocket::text_t &text_value, vec2f_t position) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_text");
         rocket::text_t text = text_value;
         if (check_graphics_settings(position, text.measure()) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(static_cast<int>(text.text.size()));
@@ -2447,10 +2546,15 @@ namespace rocket {
 
             stbtt_aligned_quad quad {};
             stbtt_GetBakedQuad(text.font->cdata->a, text.font->sttex_size.x, text.font->sttex_size.y, ch - 32, &x, &y, &quad, 1);
-            const rocket::fbounding_box rect = {
+            rocket::fbounding_box rect = {
                 { quad.x0, quad.y0 },
                 { quad.x1 - quad.x0, quad.y1 - quad.y0 }
             };
+            float rotation = 0.f;
+            if (this->camera_active) {
+                rect = this->camera_xf.apply(rect);
+                rotation = this->camera_xf.apply_rotation(rotation);
+            }
 
             raster_textured_quad(
                 this,
@@ -2464,7 +2568,7 @@ namespace rocket {
                     (quad.s1 - quad.s0) * static_cast<float>(font_texture.size.x),
                     (quad.t1 - quad.t0) * static_cast<float>(font_texture.size.y)
                 },
-                0.f,
+                rotation,
                 0.f,
                 static_cast<rocket::rgba_color>(text.color)
             );
@@ -2474,10 +2578,18 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_pixel(rocket::vec2f_t pos, rocket::rgba_color color) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_pixel");
         if (this->check_graphics_settings(pos, { 1.f, 1.f }) == gfx_chk_result::not_drawable) {
             rgl::add_frame_metrics_data_skipped_drawcalls(1);
             return;
         }
+        if (this->camera_active) {
+            // A zoomed pixel covers more than one
+            raster_rectangle(this, this->camera_xf.apply(rocket::fbounding_box { pos, { 1.f, 1.f } }), color, this->camera_xf.apply_rotation(0.f), 0.f);
+            rgl::add_frame_metrics_data_drawcalls(1);
+            rgl::add_frame_metrics_data_tricount(2);
+            return;
+        }
         ensure_framebuffer_storage(this);
         auto &state = vk_state(this);
         const int width = static_cast<int>(to_vk_extent(this->get_viewport_size()).width);
@@ -2488,11 +2600,19 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_fps(vec2f_t pos) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_fps");
         const std::string fps_text = "FPS: " + std::to_string(static_cast<int>(std::round(get_current_fps())));
         rocket::text_t fps = rocket::text_t(fps_text, 24, rocket::rgb_color::green());
         this->draw_text(fps, pos);
     }
 
+    void vulkan_renderer_2d::begin_gpu_region(const char *name) {
+        // No timestamp queries on this backend yet
+    }
+
+    void vulkan_renderer_2d::end_gpu_region() {
+    }
+
     void vulkan_renderer_2d::set_wireframe(bool enabled) {
         this->wireframe = enabled;
     }
@@ -2511,6 +2631,9 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::end_render_mode(render_mode_t mode) {
+        if (mode == render_mode_t::camera) {
+            this->end_camera_mode();
+        }
         for (auto it = this->active_render_modes.begin(); it != this->active_render_modes.end(); ++it) {
             if (*it == mode) {
                 this->active_render_modes.erase(it);
@@ -2520,9 +2643,11 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::end_frame() {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::end_frame");
         if (!this->frame_started) {
             return;
         }
+        this->flush_command_buckets();
 
         if (flags.share_renderer_as_global) {
             __rallframeend();
@@ -2616,19 +2741,30 @@ namespace rocket {
                 rocket::exit(1);
             }
             const double frametime_limit = 1.0 / this->fps;
-            util::frame_timer_wait_for(
+            const double pacing_error = util::frame_timer_wait_for(
                 frame_duration,
                 frametime_limit,
                 util::get_clistate().software_frame_timer,
                 this->fps,
                 this->frame_start_time
             );
+            rgl::update_pacing_metrics_data(static_cast<float>(pacing_error));
             const double measured_time = frame_duration + std::chrono::duration<double>(clock::now() - frame_end_time).count();
             rgl::update_draw_metrics_data(static_cast<float>(measured_time), this->delta_time > 0.0 ? static_cast<float>(1.0 / this->delta_time) : 0.f);
         } else {
             const double frame_duration = std::chrono::duration<double>(frame_end_time - frame_start_time).count();
             rgl::update_draw_metrics_data(static_cast<float>(frame_duration), this->delta_time > 0.0 ? static_cast<float>(1.0 / this->delta_time) : 0.f);
         }
+
+        rgl::push_frame_record({
+            .frame = this->frame_counter,
+            .cpu_time = std::chrono::duration<float>(frame_end_time - this->frame_start_time).count(),
+            .wait_time = std::chrono::duration<float>(clock::now() - frame_end_time).count(),
+            .drawcalls = metrics.drawcalls,
+            .tricount = metrics.tricount,
+            .skipped_drawcalls = metrics.skipped_drawcalls,
+            .uploads = metrics.uploads,
+        });
     }
 
     bool vulkan_renderer_2d::has_frame_ended() {
@@ -2651,7 +2787,6 @@ namespace rocket {
 
     void vulkan_renderer_2d::set_camera(camera_2d *cam) {
         this->cam = cam;
-        rocket::log("cameras are not implemented", "vulkan_renderer_2d", "set_camera", "fixme");
     }
 
     void vulkan_renderer_2d::close() {
@@ -2694,6 +2829,9 @@ namespace rocket {
     }
 
     double vulkan_renderer_2d::get_delta_time() {
+        if (double fixed = util::input_replay_delta_time(); fixed > 0.0) {
+            return fixed;
+        }
         return this->delta_time;
     }
 
@@ -2741,15 +2879,19 @@ namespace rocket {
     }
 
     glm::mat4 vulkan_renderer_2d::get_camera_matrix() {
-        return {};
+        if (!this->camera_active) {
+            return glm::mat4(1.0f);
+        }
+        return this->camera_xf.get_matrix();
     }
 
     float vulkan_renderer_2d::get_current_fps() {
         return rgl::get_draw_metrics().avg_fps;
     }
 
-    render_cache_t *vulkan_renderer_2d::create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb) {
+    render_cache_t *vulkan_renderer_2d::create_render_cache(std::function<void(renderer_2d_i *ren)> draw_cb, rocket::vec2i_t size) {
         (void) draw_cb;
+        (void) size;
         return nullptr;
     }
 
@@ -2757,6 +2899,10 @@ namespace rocket {
         (void) c;
     }
 
+    void vulkan_renderer_2d::update_render_cache(render_cache_t *c) {
+        (void) c;
+    }
+
     void vulkan_renderer_2d::begin_render_cache(render_cache_t *c) {
         (void) c;
     }
@@ -2766,12 +2912,14 @@ namespace rocket {
     }
 
     void vulkan_renderer_2d::draw_render_cache(render_cache_t *c, rocket::vec2f_t pos, rocket::vec2f_t sz) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_render_cache");
         (void) c;
         (void) pos;
         (void) sz;
     }
 
     void vulkan_renderer_2d::draw_render_cache(render_cache_t *c, rocket::fbounding_box bbox) {
+        ROCKET_PROFILE_SCOPE("vulkan_renderer_2d::draw_render_cache");
         (void) c;
         (void) bbox;
     }
@@ -0,0 +1,144 @@
+#include "rocket/tilemap.hpp"
+#include "rocket/profiler.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/runtime.hpp"
+#include <algorithm>
+#include <string>
+
+namespace rocket {
+    tilemap_t::tilemap_t(std::shared_ptr<texture_t> atlas, vec2i_t tile_size, vec2i_t map_size, int chunk_tiles) {
+        this->atlas = atlas;
+        this->tile_size = { std::max(tile_size.x, 1), std::max(tile_size.y, 1) };
+        this->map_size = { std::max(map_size.x, 0), std::max(map_size.y, 0) };
+        this->chunk_tiles = std::max(chunk_tiles, 1);
+        this->chunk_grid = {
+            (this->map_size.x + this->chunk_tiles - 1) / this->chunk_tiles,
+            (this->map_size.y + this->chunk_tiles - 1) / this->chunk_tiles,
+        };
+        this->atlas_columns = atlas != nullptr ? std::max(atlas->size.x / this->tile_size.x, 1) : 1;
+
+        this->tiles.assign(static_cast<size_t>(this->map_size.x) * this->map_size.y, tile_none);
+        this->chunks.resize(static_cast<size_t>(this->chunk_grid.x) * this->chunk_grid.y);
+        this->dirty.assign(this->chunks.size(), true);
+
+        const vec2f_t chunk_px = {
+            static_cast<float>(this->chunk_tiles * this->tile_size.x),
+            static_cast<float>(this->chunk_tiles * this->tile_size.y),
+        };
+        for (int cy = 0; cy < this->chunk_grid.y; ++cy) {
+            for (int cx = 0; cx < this->chunk_grid.x; ++cx) {
+                tilemap_chunk_t &chunk = this->chunks[static_cast<size_t>(cy) * this->chunk_grid.x + cx];
+                // Edge chunks only cover what is left of the map
+                const int w = std::min(this->chunk_tiles, this->map_size.x - cx * this->chunk_tiles);
+                const int h = std::min(this->chunk_tiles, this->map_size.y - cy * this->chunk_tiles);
+                chunk.bounds = {
+                    { cx * chunk_px.x, cy * chunk_px.y },
+                    { static_cast<float>(w * this->tile_size.x), static_cast<float>(h * this->tile_size.y) },
+                };
+                chunk.atlas_tile_size = { static_cast<float>(this->tile_size.x), static_cast<float>(this->tile_size.y) };
+            }
+        }
+        this->rebuild_chunk_bounds({ 0, 0 });
+    }
+
+    tilemap_t::~tilemap_t() {
+        for (tilemap_chunk_t &chunk : this->chunks) {
+            if (chunk.gpu_owner != nullptr) {
+                chunk.gpu_owner->clean_gpu_resource(chunk.gpu);
+            }
+        }
+    }
+
+    void tilemap_t::set_tile(vec2i_t cell, tile_id_t tile) {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= this->map_size.x || cell.y >= this->map_size.y) {
+            rocket::log("cell " + std::to_string(cell.x) + ", " + std::to_string(cell.y) + " is outside the map", "tilemap_t", "set_tile", "error");
+            return;
+        }
+        tile_id_t &slot = this->tiles[static_cast<size_t>(cell.y) * this->map_size.x + cell.x];
+        if (slot == tile) {
+            return;
+        }
+        slot = tile;
+        this->dirty[static_cast<size_t>(cell.y / this->chunk_tiles) * this->chunk_grid.x + cell.x / this->chunk_tiles] = true;
+    }
+
+    tile_id_t tilemap_t::get_tile(vec2i_t cell) const {
+        if (cell.x < 0 || cell.y < 0 || cell.x >= this->map_size.x || cell.y >= this->map_size.y) {
+            return tile_none;
+        }
+        return this->tiles[static_cast<size_t>(cell.y) * this->map_size.x + cell.x];
+    }
+
+    void tilemap_t::fill(tile_id_t tile) {
+        std::fill(this->tiles.begin(), this->tiles.end(), tile);
+        this->dirty.assign(this->chunks.size(), true);
+    }
+
+    void tilemap_t::rebuild_chunk(size_t index) {
+        tilemap_chunk_t &chunk = this->chunks[index];
+        const int cx = static_cast<int>(index % this->chunk_grid.x);
+        const int cy = static_cast<int>(index / this->chunk_grid.x);
+        const int x0 = cx * this->chunk_tiles;
+        const int y0 = cy * this->chunk_tiles;
+        const int x1 = std::min(x0 + this->chunk_tiles, this->map_size.x);
+        const int y1 = std::min(y0 + this->chunk_tiles, this->map_size.y);
+
+        chunk.quads.clear();
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                const tile_id_t tile = this->tiles[static_cast<size_t>(y) * this->map_size.x + x];
+                if (tile < 0) {
+                    continue;
+                }
+                chunk.quads.push_back({
+                    {
+                        { static_cast<float>(x * this->tile_size.x), static_cast<float>(y * this->tile_size.y) },
+                        chunk.atlas_tile_size,
+                    },
+                    {
+                        static_cast<float>((tile % this->atlas_columns) * this->tile_size.x),
+                        static_cast<float>((tile / this->atlas_columns) * this->tile_size.y),
+                    },
+                });
+            }
+        }
+        chunk.revision++;
+        this->dirty[index] = false;
+    }
+
+    void tilemap_t::rebuild_chunk_bounds(vec2f_t position) {
+        this->chunk_bounds.clear();
+        this->chunk_bounds.reserve(this->chunks.size());
+        for (const tilemap_chunk_t &chunk : this->chunks) {
+            this->chunk_bounds.push({ { chunk.bounds.pos.x + position.x, chunk.bounds.pos.y + position.y }, chunk.bounds.size });
+        }
+        this->chunk_bounds_position = position;
+    }
+
+    void tilemap_t::draw(renderer_2d_i *ren, vec2f_t position) {
+        ROCKET_PROFILE_SCOPE("tilemap_t::draw");
+        if (this->atlas == nullptr) {
+            return;
+        }
+        if (!(position == this->chunk_bounds_position)) {
+            this->rebuild_chunk_bounds(position);
+        }
+
+        ren->cull_visible(this->chunk_bounds, this->visible);
+        for (uint32_t index : this->visible) {
+            if (this->dirty[index]) {
+                this->rebuild_chunk(index);
+            }
+            tilemap_chunk_t &chunk = this->chunks[index];
+            if (!chunk.quads.empty()) {
+                ren->draw_tilemap_chunk(chunk, this->atlas, position);
+            }
+        }
+    }
+
+    void renderer_2d_i::draw_tilemap_chunk(tilemap_chunk_t &chunk, const std::shared_ptr<texture_t> &atlas, vec2f_t position) {
+        for (const tilemap_quad_t &quad : chunk.quads) {
+            this->draw_atlas_texture(atlas, { { quad.rect.pos.x + position.x, quad.rect.pos.y + position.y }, quad.rect.size }, quad.atlas_pos, chunk.atlas_tile_size);
+        }
+    }
+}
@@ -7,12 +7,14 @@
     #include <lib/glad/glad.h>
 #endif
 #include <rocket/threads.hpp>
+#include <rocket/profiler.hpp>
 #ifdef ROCKETGE__Platform_Windows
 #define GL_STATIC_DRAW 0x88E4
 #endif
 #include "binary_stuff/default_fonts.h"
 #include "rocket/audio.hpp"
 #include "rocket/asset.hpp"
+#include "audio.hpp"
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -81,113 +83,54 @@ namespace rocket {
     }
     
     void audio_t::play(float vol, bool loop, std::function<void()> on_finish) {
-        if (this->playing) {
+        if (this->playing->load(std::memory_order_acquire)) {
             rocket::log("audio is already playing", "audio_t", "play", "error");
             return;
         }
 
-        // Delete previous source if still exists
-        if (source != 0) {
-            alDeleteSources(1, &source);
-            source = 0;
-        }
-
-        alGenSources(1, &source);
-
-        // Remove percentage
-        vol = vol / 100.f;
-        alSourcei(source, AL_BUFFER, buffer);
-        alSourcef(source, AL_GAIN, vol);
-
-        alSourcei(source, AL_LOOPING, AL_FALSE);
-        if (loop) {
-            alSourcei(source, AL_LOOPING, AL_TRUE);
-        }
+        // The source is reused between plays
+        if (source == 0) {
+            alGenSources(1, &source);
 
-        alSourcePlay(source);
-
-        ALenum error = alGetError();
-        if (error != AL_NO_ERROR) {
-            rocket::log("failed to play audio: " + std::to_string(error), "openal", "alGetError", "error");
-            return;
-        }
-
-        this->playing = true;
-
-        if (on_finish == nullptr) {
-            return;
+            ALenum error = alGetError();
+            if (error != AL_NO_ERROR) {
+                rocket::log("failed to play audio: " + std::to_string(error), "openal", "alGetError", "error");
+                source = 0;
+                return;
+            }
         }
 
-        ALint state;
-        do {
-            alGetSourcei(source, AL_SOURCE_STATE, &state);
-            std::this_thread::sleep_for(16ms);
-        } while (state != AL_PLAYING);
-
-        unsigned int src_cpy = this->source;
+        this->playing->store(true, std::memory_order_release);
 
-        finish_thread = std::thread([on_finish, loop, src_cpy]() {
-            ALint state;
-            do {
-                alGetSourcei(src_cpy, AL_SOURCE_STATE, &state);
-                std::this_thread::sleep_for(16ms);
-            } while (state == AL_PLAYING);
-
-            if (!loop) {
-                // [TODO] Somehow make this->playing false
-                on_finish();
-            }
-        });
-
-        finish_thread.detach();
+        audio::service::command_t cmd;
+        cmd.type = audio::service::command_type_t::play;
+        cmd.source = source;
+        cmd.buffer = buffer;
+        cmd.loop = loop;
+        // Remove percentage
+        cmd.gain = vol / 100.f;
+        cmd.on_release = [playing = this->playing]() {
+            playing->store(false, std::memory_order_release);
+        };
+        cmd.on_finish = std::move(on_finish);
+        audio::service::submit(std::move(cmd));
     }
 
     void audio_t::seek(std::chrono::milliseconds time) {
-        if (!this->buffer) return;
-
-        // Stop current playback if needed
-        if (this->source) {
-            alSourceStop(this->source);
-        }
-
-        // Re-decode using stb_vorbis
-        stb_vorbis* vorbis = stb_vorbis_open_filename(this->path.c_str(), nullptr, nullptr);
-        if (!vorbis) {
-            rocket::log("seek failed: could not reopen audio", "stb_vorbis", "open_filename", "error");
-            return;
-        }
-
-        stb_vorbis_info info = stb_vorbis_get_info(vorbis);
-        int channels = info.channels;
-        int sample_rate = info.sample_rate;
-
-        // Calculate sample index to seek to
-        int sample_index = static_cast<int>((time.count() / 1000.0) * sample_rate);
-
-        // Seek
-        stb_vorbis_seek(vorbis, sample_index);
-
-        // Read remaining samples
-        int max_samples = stb_vorbis_stream_length_in_samples(vorbis) - sample_index;
-        short* samples = new short[max_samples * channels];
-        int actual_samples = stb_vorbis_get_samples_short_interleaved(vorbis, channels, samples, max_samples * channels);
-        stb_vorbis_close(vorbis);
-
-        // Rebuffer data
-        ALenum format = (channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
-        alBufferData(buffer, format, samples, actual_samples * sizeof(short) * channels, sample_rate);
-        delete[] samples;
+        if (!this->buffer || !this->source) return;
 
-        // Play again from new position
-        alSourcei(this->source, AL_BUFFER, buffer);
-        alSourcePlay(this->source);
+        audio::service::command_t cmd;
+        cmd.type = audio::service::command_type_t::seek;
+        cmd.source = this->source;
+        cmd.offset_seconds = static_cast<float>(time.count()) / 1000.f;
+        audio::service::submit(std::move(cmd));
     }
 
     std::chrono::milliseconds audio_t::get_time() {
-        if (!this->playing) return 0ms;
-        ALint position;
-        alGetSourcei(this->source, AL_SEC_OFFSET, &position);
-        return std::chrono::milliseconds(static_cast<int>(position) * 1000);
+        if (!this->playing->load(std::memory_order_acquire)) return 0ms;
+        ALfloat position = 0.f;
+        alGetSourcef(this->source, AL_SEC_OFFSET, &position);
+        return std::chrono::milliseconds(static_cast<int64_t>(position * 1000.f));
     }
     
     audio_t::~audio_t() {
@@ -217,6 +160,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_texture(std::string path, texture_color_format_t format) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_texture");
         assetid_t id = current_id++;
         std::shared_ptr<texture_t> texture = std::make_shared<texture_t>();
         texture->id = id;
@@ -242,6 +186,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_texture(std::vector<uint8_t> data, texture_color_format_t format) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_texture");
         assetid_t id = current_id++;
         std::shared_ptr<texture_t> texture = std::make_shared<texture_t>();
         texture->id = id;
@@ -302,6 +247,7 @@ namespace rocket {
     }
 
     void destroy_audio_ctx(void) {
+        audio::service::stop();
         ALCcontext *ctx = alcGetCurrentContext();
         ALCdevice *dvc = alcGetContextsDevice(ctx);
         alcMakeContextCurrent(nullptr);
@@ -310,6 +256,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_sound(std::string path) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_sound");
         assetid_t id = current_id++;
         std::shared_ptr<audio::sound_t> sound = std::make_shared<audio::sound_t>();
         sound->id = id;
@@ -347,6 +294,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_sound(std::vector<uint8_t> mem) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_sound");
         assetid_t id = current_id++;
         std::shared_ptr<audio::sound_t> sound = std::make_shared<audio::sound_t>();
         sound->id = id;
@@ -378,6 +326,7 @@ namespace rocket {
     }
     
     assetid_t asset_manager_t::load_audio(std::string path) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_audio");
         assetid_t id = current_id++;
         std::shared_ptr<audio_t> audio = std::make_shared<audio_t>();
         audio->id = id;
@@ -435,6 +384,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_audio(std::vector<uint8_t> mem) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_audio");
         init_audio_ctx();
 
         assetid_t id = current_id++;
@@ -563,6 +513,7 @@ namespace rocket {
             std::shared_ptr<font_t> font = std::make_shared<font_t>();
             font->ttf_data = std::vector<uint8_t>(rocket_binary::FontDefault_Monospace_ttf, rocket_binary::FontDefault_Monospace_ttf + rocket_binary::FontDefault_Monospace_ttf_len);
             font->id = -1;
+            font->default_monospace = true;
             font->size = fsize;
             std::vector<unsigned char> bitmap(font->sttex_size.x * font->sttex_size.y);
             stbtt_BakeFontBitmap(rocket_binary::FontDefault_Monospace_ttf, 0, fsize, bitmap.data(), font->sttex_size.x, font->sttex_size.y, 32, 96, font->cdata->a);
@@ -591,6 +542,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_font(int fsize, std::vector<uint8_t> mem) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_font");
         std::shared_ptr<font_t> font = std::make_shared<font_t>();
         font->id = current_id++;
         std::vector<unsigned char> bitmap(font->sttex_size.x * font->sttex_size.y);
@@ -623,6 +575,7 @@ namespace rocket {
     }
 
     assetid_t asset_manager_t::load_font(int fsize, std::string path) {
+        ROCKET_PROFILE_SCOPE("asset_manager_t::load_font");
         std::shared_ptr<font_t> font = std::make_shared<font_t>();
         font->id = current_id++;
         FILE* f = fopen(path.c_str(), "rb");
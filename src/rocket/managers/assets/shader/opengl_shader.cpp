@@ -49,14 +49,8 @@ namespace rocket {
         return true;
     }
 
-    void opengl_shader_t::shader_init() {
-        this->glshaderv = glCreateShader(GL_VERTEX_SHADER);
-        this->glshaderf = glCreateShader(GL_FRAGMENT_SHADER);
-
-        const char* vsrc = vcode.c_str();
-        const char* fsrc = fcode.c_str();
-
-        const char *default_vcode = R"(
+    // Stands in for a shader that failed to compile
+    static const char *default_vcode = R"(
 #version 300 es
 precision highp float;
 
@@ -67,8 +61,8 @@ void main() {
     fragPos = aPos;
     gl_Position = vec4(aPos, 0.0, 1.0);
 }
-            )";
-        const char *default_fcode = R"(
+    )";
+    static const char *default_fcode = R"(
 #version 300 es
 precision highp float;
 
@@ -78,45 +72,47 @@ out vec4 FragColor;
 void main() {
     FragColor = vec4(0.);
 }
-            )";
-
-        while (glGetError() != GL_NO_ERROR) {}
-        glShaderSource(glshaderv, 1, &vsrc, nullptr);
-        glCompileShader(glshaderv);
-        if (!check_shader_compile(glshaderv, "Vertex")) {
-            rocket::log("Cannot continue with failed compilation", "opengl_shader_t", "constructor", "error");
-            this->glprogram = rgl::nocache_compile_shader(default_vcode, default_fcode);
-            return;
-        }
-        gl_check_errors(1);
+    )";
 
-        glShaderSource(glshaderf, 1, &fsrc, nullptr);
-        glCompileShader(glshaderf);
-        if (!check_shader_compile(glshaderf, "Fragment")) {
-            rocket::log("Cannot continue with failed compilation", "opengl_shader_t", "constructor", "error");
-            this->glprogram = rgl::nocache_compile_shader(default_vcode, default_fcode);
-            return;
+    void opengl_shader_t::shader_init() {
+        this->shader_submit();
+        if (!this->deferred) {
+            this->shader_finish(true);
         }
-        gl_check_errors(2);
-
-        glprogram = glCreateProgram();
-        glAttachShader(glprogram, glshaderv);
-        gl_check_errors(3);
-
-        glAttachShader(glprogram, glshaderf);
-        gl_check_errors(4);
+    }
 
-        glLinkProgram(glprogram);
-        if (!check_program_link(glprogram)) {
-            rocket::log("Cannot continue with failed linking", "opengl_shader_t", "constructor", "error");
-            return;
+    void opengl_shader_t::shader_submit() {
+        // Linked programs are cached on disk, only a miss compiles
+        this->cache_key = rgl::program_cache_key(this->vcode, this->fcode, this->rlsl_version, rgl::program_cache_driver());
+        this->glprogram = rgl::program_cache_load(this->cache_key);
+        if (this->glprogram == 0) {
+            this->glshaderv = glCreateShader(GL_VERTEX_SHADER);
+            this->glshaderf = glCreateShader(GL_FRAGMENT_SHADER);
+
+            const char* vsrc = vcode.c_str();
+            const char* fsrc = fcode.c_str();
+
+            // No status queries until shader_finish, any query waits for the driver
+            while (glGetError() != GL_NO_ERROR) {}
+            glShaderSource(glshaderv, 1, &vsrc, nullptr);
+            glCompileShader(glshaderv);
+            gl_check_errors(1);
+
+            glShaderSource(glshaderf, 1, &fsrc, nullptr);
+            glCompileShader(glshaderf);
+            gl_check_errors(2);
+
+            glprogram = glCreateProgram();
+            glAttachShader(glprogram, glshaderv);
+            gl_check_errors(3);
+
+            glAttachShader(glprogram, glshaderf);
+            gl_check_errors(4);
+
+            rgl::program_cache_prepare(glprogram);
+            glLinkProgram(glprogram);
+            this->pending = true;
         }
-        gl_check_errors(5);
-
-        glDeleteShader(glshaderv);
-        gl_check_errors(6);
-        glDeleteShader(glshaderf);
-        gl_check_errors(7);
 
         std::array<float, 12> vertices = {
             -1.0f, -1.0f,   // bottom left
@@ -152,6 +148,38 @@ void main() {
         gl_check_errors(16);
     }
 
+    bool opengl_shader_t::shader_finish(bool wait) {
+        if (!this->pending) {
+            return true;
+        }
+        if (!wait && !rgl::is_program_ready(this->glprogram)) {
+            return false;
+        }
+        this->pending = false;
+
+        if (!check_shader_compile(glshaderv, "Vertex") || !check_shader_compile(glshaderf, "Fragment")) {
+            rocket::log("Cannot continue with failed compilation", "opengl_shader_t", "shader_finish", "error");
+            glDeleteProgram(glprogram);
+            glDeleteShader(glshaderv);
+            glDeleteShader(glshaderf);
+            this->glprogram = rgl::nocache_compile_shader(default_vcode, default_fcode);
+            return true;
+        }
+
+        if (!check_program_link(glprogram)) {
+            rocket::log("Cannot continue with failed linking", "opengl_shader_t", "shader_finish", "error");
+        } else {
+            gl_check_errors(5);
+            rgl::program_cache_store(this->cache_key, glprogram);
+        }
+
+        glDeleteShader(glshaderv);
+        gl_check_errors(6);
+        glDeleteShader(glshaderf);
+        gl_check_errors(7);
+        return true;
+    }
+
     opengl_shader_t::opengl_shader_t(shader_type type, std::string vcode, std::string fcode, std::string name) {
         this->type = type;
         this->vcode = vcode;
@@ -196,8 +224,12 @@ void main() {
 
     opengl_shader_t::opengl_shader_t() {}
 
-    opengl_shader_t::opengl_shader_t(shader_type type, const std::string &rlsl) {
+    opengl_shader_t::opengl_shader_t(shader_type type, const std::string &rlsl)
+        : opengl_shader_t(type, rlsl, false) {}
+
+    opengl_shader_t::opengl_shader_t(shader_type type, const std::string &rlsl, bool deferred) {
         this->type = type;
+        this->deferred = deferred;
 
         static auto split = [](std::string str, char delim) -> std::vector<std::string> {
             std::stringstream ss(str);
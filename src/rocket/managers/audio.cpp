@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -5,7 +7,6 @@
 #include <audio.hpp>
 #include <rocket/memory.hpp>
 #include <rocket/threads.hpp>
-#include <thread>
 #include <AL/al.h>
 #include <AL/alc.h>
 #include "intl_macros.hpp"
@@ -49,8 +50,8 @@ namespace rocket::audio {
 
     source_t* fetch_source(std::array<rocket::audio::source_t, 32> &sources) {
         for (auto &source : sources) {
-            if (!source.in_use) {
-                source.in_use = true;
+            bool expected = false;
+            if (source.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
                 return &source;
             }
         }
@@ -95,7 +96,21 @@ namespace rocket::audio {
         }
     }
 
+    sound_engine_t::sound_engine_t(software_mixer_t *mixer) {
+        r_assert(mixer != nullptr);
+        this->mixer = mixer;
+        this->ctx = nullptr;
+        this->last_mix = std::chrono::steady_clock::now();
+        rocket::log("Sound engine created with software mixer at " + std::to_string(mixer->get_config().sample_rate) + "Hz",
+                "sound_engine_t", "constructor", "info");
+    }
+
     void sound_engine_t::set_device(device_t *device) {
+        if (this->mixer != nullptr) {
+            rocket::log("cannot set a device on a software mixer engine", "sound_engine_t", "set_device", "error");
+            return;
+        }
+        service::stop();
         alcMakeContextCurrent(nullptr);
         alcDestroyContext(this->ctx);
 
@@ -114,35 +129,425 @@ namespace rocket::audio {
         alListenerfv(AL_ORIENTATION, orientation);
     }
 
-    void sound_engine_t::play(sound_t &sound, bool loop, sound_finish_callback_t cb, float vol) {
-        source_t *source = fetch_source(this->sources);
-        if (source == nullptr) return;
+    /// @brief Frees the source and fires the callback, unless the source changed owner meanwhile
+    static std::function<void()> make_release(source_t *source, uint32_t generation, sound_finish_callback_t cb) {
+        return [source, generation, cb = std::move(cb)]() {
+            uint32_t expected = generation;
+            if (!source->generation.compare_exchange_strong(expected, generation + 1, std::memory_order_acq_rel)) {
+                return; // stolen or virtualized
+            }
+            source->in_use.store(false, std::memory_order_release);
+            service::dispatch(cb);
+        };
+    }
+
+    static float distance(const vec3f_t &a, const vec3f_t &b) {
+        vec3f_t d = a - b;
+        return std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+
+    unsigned int sound_engine_t::upload(sound_t &sound) {
+        if (sound.handle != 0 && sound.owner == this) {
+            return sound.handle;
+        }
 
         ALuint format = sound.buffer.format == format_t::mono16 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
 
-        ALuint buffer;
+        alGetError();
+        ALuint buffer = 0;
         alGenBuffers(1, &buffer);
         alBufferData(buffer, format, sound.buffer.samples.data(),
                  sound.buffer.samples.size() * sizeof(int16_t), sound.buffer.sample_rate);
-        alSourcei(source->source, AL_BUFFER, buffer);
-        alSourcei(source->source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
-        alSourcef(source->source, AL_GAIN, (vol / 100.f));
-        alSourcePlay(source->source);
-
-        std::thread t = std::thread([source, buffer, cb]() {
-            ALint state;
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                alGetSourcei(source->source, AL_SOURCE_STATE, &state);
-            } while (state == AL_PLAYING);
-
-            rocket::thread_t::schedule([buffer, source, cb]() {
-                alDeleteBuffers(1, &buffer); // cleanup
-                source->in_use = false;
-                if (cb) cb();
-            });
+
+        ALenum error = alGetError();
+        if (error != AL_NO_ERROR) {
+            rocket::log("failed to upload sound: " + std::to_string(error), "sound_engine_t", "upload", "error");
+            alDeleteBuffers(1, &buffer);
+            return 0;
+        }
+
+        sound.handle = buffer;
+        sound.owner = this;
+        uploaded_buffers.push_back(buffer);
+        return buffer;
+    }
+
+    void sound_engine_t::release(sound_t &sound) {
+        if (sound.handle == 0) {
+            return;
+        }
+
+        if (this->mixer != nullptr) {
+            mixer->release(sound.handle);
+            sound.handle = 0;
+            return;
+        }
+
+        for (size_t i = 0; i < voices.size();) {
+            if (voices[i].sound != &sound) {
+                ++i;
+                continue;
+            }
+
+            if (voices[i].source != nullptr) {
+                // Its release fires the callback and frees the source
+                service::command_t cmd;
+                cmd.type = service::command_type_t::stop;
+                cmd.source = voices[i].source->source;
+                service::submit(std::move(cmd));
+            } else {
+                service::dispatch(std::move(voices[i].cb));
+            }
+            voices[i] = std::move(voices.back());
+            voices.pop_back();
+        }
+
+        std::erase(uploaded_buffers, sound.handle);
+        // Queued behind the stops, the audio thread still owns the sources
+        service::command_t cmd;
+        cmd.type = service::command_type_t::delete_buffer;
+        cmd.buffer = sound.handle;
+        service::submit(std::move(cmd));
+        sound.handle = 0;
+    }
+
+    bool sound_engine_t::is_alive(const voice_t &voice) const {
+        if (voice.source != nullptr) {
+            return voice.source->generation.load(std::memory_order_acquire) == voice.generation;
+        }
+        if (voice.loop) {
+            return true;
+        }
+
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - voice.started;
+        return elapsed.count() < voice.duration;
+    }
+
+    float sound_engine_t::loudness(const voice_t &voice) const {
+        if (!voice.spatial) {
+            return voice.gain;
+        }
+        // AL_INVERSE_DISTANCE_CLAMPED with reference distance and rolloff of 1
+        float d = std::max(distance(voice.position, listener.position), 1.f);
+        return voice.gain / d;
+    }
+
+    bool sound_engine_t::attach(voice_t &voice, source_t *source) {
+        voice.source = source;
+        voice.generation = source->generation.load(std::memory_order_acquire);
+
+        service::command_t cmd;
+        cmd.type = service::command_type_t::play;
+        cmd.source = source->source;
+        cmd.buffer = voice.buffer;
+        cmd.loop = voice.loop;
+        cmd.gain = voice.gain;
+        cmd.spatial = voice.spatial;
+        cmd.position = voice.position;
+
+        // Promoted voices resume where they would have been
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - voice.started;
+        if (elapsed.count() > 0.01f && voice.duration > 0.f) {
+            cmd.offset_seconds = voice.loop ? std::fmod(elapsed.count(), voice.duration) : elapsed.count();
+        }
+
+        cmd.on_release = make_release(source, voice.generation, voice.cb);
+        service::submit(std::move(cmd));
+        return true;
+    }
+
+    void sound_engine_t::virtualize(voice_t &voice) {
+        source_t *source = voice.source;
+        if (source == nullptr) {
+            return;
+        }
+
+        uint32_t expected = voice.generation;
+        if (!source->generation.compare_exchange_strong(expected, expected + 1, std::memory_order_acq_rel)) {
+            // Finished on the audio thread meanwhile, is_alive() reports it dead
+            return;
+        }
+
+        service::command_t cmd;
+        cmd.type = service::command_type_t::stop;
+        cmd.source = source->source;
+        service::submit(std::move(cmd));
+
+        source->in_use.store(false, std::memory_order_release);
+        voice.source = nullptr;
+    }
+
+    /// @brief Picks a voice to take a source from, or nullptr
+    static voice_t *pick_victim(std::vector<voice_t> &voices, steal_policy_t policy, uint8_t priority, float loudness, bool allow_equal,
+            const std::function<bool(const voice_t&)> &alive, const std::function<float(const voice_t&)> &loudness_of) {
+        if (policy == steal_policy_t::none) {
+            return nullptr;
+        }
+
+        voice_t *victim = nullptr;
+        float victim_loudness = 0.f;
+        for (auto &voice : voices) {
+            if (voice.source == nullptr || !alive(voice)) continue;
+            if (voice.priority > priority) continue;
+
+            float l = loudness_of(voice);
+            if (voice.priority == priority) {
+                if (!allow_equal) continue;
+                if (policy == steal_policy_t::quietest && l >= loudness) continue;
+            }
+
+            bool better = victim == nullptr || voice.priority < victim->priority;
+            if (victim != nullptr && voice.priority == victim->priority) {
+                better = policy == steal_policy_t::quietest
+                    ? l < victim_loudness
+                    : voice.started < victim->started;
+            }
+
+            if (better) {
+                victim = &voice;
+                victim_loudness = l;
+            }
+        }
+
+        return victim;
+    }
+
+    void sound_engine_t::play_voice(voice_t voice) {
+        // Callers that never call update_voices() must not grow the list forever
+        reap_voices();
+
+        auto alive = [this](const voice_t &v) { return this->is_alive(v); };
+        auto loudness_of = [this](const voice_t &v) { return this->loudness(v); };
+
+        if (voice.sound->max_instances != 0) {
+            size_t instances = 0;
+            voice_t *oldest = nullptr;
+            for (auto &v : voices) {
+                if (v.sound != voice.sound || !is_alive(v)) continue;
+                instances++;
+                if (oldest == nullptr || v.started < oldest->started) {
+                    oldest = &v;
+                }
+            }
+
+            if (instances >= voice.sound->max_instances && oldest != nullptr) {
+                if (oldest->source != nullptr) {
+                    // Its release fires the callback and frees the source
+                    service::command_t cmd;
+                    cmd.type = service::command_type_t::stop;
+                    cmd.source = oldest->source->source;
+                    service::submit(std::move(cmd));
+                } else {
+                    service::dispatch(oldest->cb);
+                }
+                *oldest = std::move(voices.back());
+                voices.pop_back();
+            }
+        }
+
+        bool audible = !voice.spatial || distance(voice.position, listener.position) <= voice_config.virtualize_distance;
+        if (audible) {
+            source_t *source = fetch_source(this->sources);
+            if (source == nullptr) {
+                voice_t *victim = pick_victim(voices, voice_config.steal_policy, voice.priority, loudness(voice), true, alive, loudness_of);
+                if (victim != nullptr) {
+                    virtualize(*victim);
+                    source = fetch_source(this->sources);
+                }
+            }
+
+            if (source != nullptr) {
+                attach(voice, source);
+                voices.push_back(std::move(voice));
+                return;
+            }
+        }
+
+        size_t virtual_voices = 0;
+        voice_t *lowest = nullptr;
+        for (auto &v : voices) {
+            if (v.source != nullptr) continue;
+            virtual_voices++;
+            if (lowest == nullptr || v.priority < lowest->priority) {
+                lowest = &v;
+            }
+        }
+
+        if (virtual_voices >= voice_config.max_virtual_voices) {
+            if (lowest == nullptr || lowest->priority >= voice.priority) {
+                rocket::log("voice limit reached, dropping sound", "sound_engine_t", "play_voice", "trace");
+                service::dispatch(voice.cb);
+                return;
+            }
+            service::dispatch(lowest->cb);
+            *lowest = std::move(voices.back());
+            voices.pop_back();
+        }
+
+        voices.push_back(std::move(voice));
+    }
+
+    /// @brief Equal-ish panning by listener-relative x, attenuated like OpenAL
+    static void mixer_spatialize(const vec3f_t &position, const listener_t &listener, float range, float &gain, float &pan) {
+        float d = distance(position, listener.position);
+        if (d > range) {
+            gain = 0.f; // virtual, keeps time for free
+            return;
+        }
+        gain /= std::max(d, 1.f);
+        pan = range > 0.f ? std::clamp((position.x - listener.position.x) / range, -1.f, 1.f) : 0.f;
+    }
+
+    void sound_engine_t::play(sound_t &sound, bool loop, sound_finish_callback_t cb, float vol) {
+        if (this->mixer != nullptr) {
+            if (sound.handle == 0 || sound.owner != this) {
+                sound.handle = mixer->upload(sound.buffer);
+                sound.owner = this;
+            }
+            if (sound.handle == 0) return;
+            mixer->play(sound.handle, vol / 100.f, 0.f, loop, std::move(cb));
+            return;
+        }
+
+        voice_t voice;
+        voice.sound = &sound;
+        voice.buffer = upload(sound);
+        if (voice.buffer == 0) return;
+
+        int channels = sound.buffer.format == format_t::mono16 ? 1 : 2;
+        voice.priority = sound.priority;
+        voice.gain = vol / 100.f;
+        voice.loop = loop;
+        voice.started = std::chrono::steady_clock::now();
+        voice.duration = sound.buffer.sample_rate > 0
+            ? static_cast<float>(sound.buffer.samples.size() / channels) / static_cast<float>(sound.buffer.sample_rate)
+            : 0.f;
+        voice.cb = std::move(cb);
+
+        play_voice(std::move(voice));
+    }
+
+    void sound_engine_t::play_at(sound_t &sound, vec3f_t position, bool loop, sound_finish_callback_t cb, float vol) {
+        if (this->mixer != nullptr) {
+            if (sound.handle == 0 || sound.owner != this) {
+                sound.handle = mixer->upload(sound.buffer);
+                sound.owner = this;
+            }
+            if (sound.handle == 0) return;
+            float gain = vol / 100.f;
+            float pan = 0.f;
+            mixer_spatialize(position, listener, voice_config.virtualize_distance, gain, pan);
+            mixer->play(sound.handle, gain, pan, loop, std::move(cb));
+            return;
+        }
+
+        voice_t voice;
+        voice.sound = &sound;
+        voice.buffer = upload(sound);
+        if (voice.buffer == 0) return;
+
+        int channels = sound.buffer.format == format_t::mono16 ? 1 : 2;
+        voice.priority = sound.priority;
+        voice.gain = vol / 100.f;
+        voice.loop = loop;
+        voice.spatial = true;
+        voice.position = position;
+        voice.started = std::chrono::steady_clock::now();
+        voice.duration = sound.buffer.sample_rate > 0
+            ? static_cast<float>(sound.buffer.samples.size() / channels) / static_cast<float>(sound.buffer.sample_rate)
+            : 0.f;
+        voice.cb = std::move(cb);
+
+        play_voice(std::move(voice));
+    }
+
+    void sound_engine_t::reap_voices() {
+        for (size_t i = 0; i < voices.size();) {
+            if (is_alive(voices[i])) {
+                ++i;
+                continue;
+            }
+
+            // Real voices already fired their callback from the audio thread
+            if (voices[i].source == nullptr) {
+                service::dispatch(std::move(voices[i].cb));
+            }
+            voices[i] = std::move(voices.back());
+            voices.pop_back();
+        }
+    }
+
+    void sound_engine_t::update_voices() {
+        if (this->mixer != nullptr) {
+            auto now = std::chrono::steady_clock::now();
+            mixer->process_for(now - last_mix);
+            last_mix = now;
+            return;
+        }
+
+        reap_voices();
+
+        std::vector<voice_t*> waiting;
+        waiting.reserve(voices.size());
+        for (auto &voice : voices) {
+            bool audible = !voice.spatial || distance(voice.position, listener.position) <= voice_config.virtualize_distance;
+            if (voice.source != nullptr && !audible) {
+                virtualize(voice);
+            } else if (voice.source == nullptr && audible) {
+                waiting.push_back(&voice);
+            }
+        }
+
+        std::sort(waiting.begin(), waiting.end(), [this](const voice_t *a, const voice_t *b) {
+            if (a->priority != b->priority) return a->priority > b->priority;
+            return loudness(*a) > loudness(*b);
         });
-        t.detach();
+
+        auto alive = [this](const voice_t &v) { return this->is_alive(v); };
+        auto loudness_of = [this](const voice_t &v) { return this->loudness(v); };
+        for (voice_t *voice : waiting) {
+            source_t *source = fetch_source(this->sources);
+            if (source == nullptr) {
+                // Only strictly lower priorities, equal ones would ping-pong every frame
+                voice_t *victim = pick_victim(voices, voice_config.steal_policy, voice->priority, loudness(*voice), false, alive, loudness_of);
+                if (victim == nullptr) break;
+                virtualize(*victim);
+                source = fetch_source(this->sources);
+                if (source == nullptr) break;
+            }
+            attach(*voice, source);
+        }
+    }
+
+    size_t sound_engine_t::get_active_voice_count() const {
+        if (this->mixer != nullptr) {
+            return mixer->get_voice_count();
+        }
+
+        size_t count = 0;
+        for (const auto &voice : voices) {
+            if (voice.source != nullptr && is_alive(voice)) count++;
+        }
+        return count;
+    }
+
+    size_t sound_engine_t::get_virtual_voice_count() const {
+        size_t count = 0;
+        for (const auto &voice : voices) {
+            if (voice.source == nullptr && is_alive(voice)) count++;
+        }
+        return count;
+    }
+
+    void sound_engine_t::set_voice_config(voice_config_t config) {
+        this->voice_config = config;
+    }
+
+    void sound_engine_t::set_listener(const listener_t &listener) {
+        this->listener = listener;
+        if (this->mixer == nullptr) {
+            this->listener.apply();
+        }
     }
 
     void sound_t::set_unloaded() {
@@ -151,6 +556,12 @@ namespace rocket::audio {
 
     void sound_t::reload() {
         this->loaded = true;
+        // Samples may have changed, upload again on next play
+        if (this->owner != nullptr) {
+            this->owner->release(*this);
+        }
+        this->handle = 0;
+        this->owner = nullptr;
     }
 
     // void streaming_sound_t::next_frame() {
@@ -272,6 +683,11 @@ namespace rocket::audio {
     }
 
     void sound_engine_t::play(std::shared_ptr<streaming_sound_t> sound, bool loop, sound_finish_callback_t cb) {
+        if (this->mixer != nullptr) {
+            rocket::log("streaming sounds are not supported by the software mixer", "sound_engine_t", "play", "fixme");
+            return;
+        }
+
         sound->loop = loop;
         sound->cb = cb;
 
@@ -326,28 +742,14 @@ namespace rocket::audio {
 
             alBufferData(sound->buffers[0], format, sound->current_buffer_to_play.samples.data(),
                      sound->current_buffer_to_play.samples.size() * sizeof(int16_t), sound->current_buffer_to_play.sample_rate);
-            alSourcei(source->source, AL_BUFFER, sound->buffers[0]);
-            alSourcei(source->source, AL_LOOPING, AL_FALSE);
-            alSourcePlay(source->source);
-
-            if (cb == nullptr) {
-                source->in_use = false;
-                return;
-            }
-            
-            std::thread t = std::thread([source, buffer, cb]() {
-                ALint state;
-                alGetSourcei(source->source, AL_SOURCE_STATE, &state);
-                while (state == AL_PLAYING) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                    alGetSourcei(source->source, AL_SOURCE_STATE, &state);
-                }
 
-                source->in_use = false;
-                cb();
-            });
-
-            t.detach();
+            service::command_t cmd;
+            cmd.type = service::command_type_t::play;
+            cmd.source = source->source;
+            cmd.buffer = sound->buffers[0];
+            cmd.loop = false;
+            cmd.on_release = make_release(source, source->generation.load(std::memory_order_acquire), cb);
+            service::submit(std::move(cmd));
         }
     }
 
@@ -428,7 +830,19 @@ namespace rocket::audio {
     bool sound_engine_no_destruction_cleanup_once = false;
 
     sound_engine_t::~sound_engine_t() {
+        if (this->mixer != nullptr) {
+            return;
+        }
+
         if (!sound_engine_no_destruction_cleanup_once) {
+            // The service thread issues AL calls, it must be gone before the context is
+            service::stop();
+            if (!uploaded_buffers.empty()) {
+                for (auto &source : this->sources) {
+                    alSourcei(source.source, AL_BUFFER, 0);
+                }
+                alDeleteBuffers(static_cast<ALsizei>(uploaded_buffers.size()), uploaded_buffers.data());
+            }
             alcMakeContextCurrent(nullptr);
 
             alcCloseDevice(this->device->handle);
@@ -0,0 +1,489 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include <audio.hpp>
+#include <rocket/audio.hpp>
+#include <rocket/macros.hpp>
+#include <rocket/runtime.hpp>
+
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+#include <emmintrin.h>
+#elif defined(ROCKETGE__Architecture_arm64)
+#include <arm_neon.h>
+#endif
+
+namespace rocket::audio {
+    /// @brief 32.32 fixed point, keeps playback positions bit-exact across platforms
+    constexpr uint64_t fixed_one = 1ull << 32;
+    constexpr float fixed_to_float = 1.f / static_cast<float>(fixed_one);
+    constexpr float s16_to_float = 1.f / 32768.f;
+
+    struct pcm_t {
+        std::variant<std::vector<int16_t>, std::vector<float>> samples;
+        int channels = 1;
+        int sample_rate = 0;
+        size_t frames = 0;
+    };
+
+    struct mixer_voice_t {
+        software_mixer_t::voice_handle_t handle = 0;
+        software_mixer_t::pcm_handle_t pcm = 0;
+        uint64_t position = 0;
+        uint64_t step = fixed_one;
+        float gain = 1.f;
+        float pan = 0.f;
+        bool loop = false;
+        bool finished = false;
+        sound_finish_callback_t cb;
+    };
+
+    struct software_mixer_impl_t {
+        mixer_config_t config;
+        std::vector<pcm_t> pcm;
+        std::vector<mixer_voice_t> voices;
+        software_mixer_t::voice_handle_t next_voice = 1;
+
+        /// @brief One voice, resampled to stereo
+        std::vector<float> scratch;
+        /// @brief Accumulated output of all voices
+        std::vector<float> mix;
+
+        std::ofstream wav;
+        std::vector<int16_t> wav_block;
+        uint64_t wav_data_bytes = 0;
+
+        uint64_t frames_processed = 0;
+        std::chrono::nanoseconds carry = std::chrono::nanoseconds(0);
+    };
+
+    /// @brief dst[l, r] += src[l, r] * [gl, gr]
+    static void simd_mix_stereo(float *dst, const float *src, size_t frames, float gl, float gr) {
+        size_t i = 0;
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+        __m128 g = _mm_setr_ps(gl, gr, gl, gr);
+        for (; i + 2 <= frames; i += 2) {
+            __m128 s = _mm_loadu_ps(src + i * 2);
+            __m128 d = _mm_loadu_ps(dst + i * 2);
+            _mm_storeu_ps(dst + i * 2, _mm_add_ps(d, _mm_mul_ps(s, g)));
+        }
+#elif defined(ROCKETGE__Architecture_arm64)
+        float gv[4] = { gl, gr, gl, gr };
+        float32x4_t g = vld1q_f32(gv);
+        for (; i + 2 <= frames; i += 2) {
+            float32x4_t s = vld1q_f32(src + i * 2);
+            float32x4_t d = vld1q_f32(dst + i * 2);
+            vst1q_f32(dst + i * 2, vmlaq_f32(d, s, g));
+        }
+#endif
+        for (; i < frames; ++i) {
+            dst[i * 2 + 0] += src[i * 2 + 0] * gl;
+            dst[i * 2 + 1] += src[i * 2 + 1] * gr;
+        }
+    }
+
+    static void simd_s16_to_f32(float *dst, const int16_t *src, size_t count) {
+        size_t i = 0;
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+        __m128 scale = _mm_set1_ps(s16_to_float);
+        for (; i + 8 <= count; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            // Sign extend by placing each int16 in the high half, then shifting down
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#elif defined(ROCKETGE__Architecture_arm64)
+        float32x4_t scale = vdupq_n_f32(s16_to_float);
+        for (; i + 8 <= count; i += 8) {
+            int16x8_t v = vld1q_s16(src + i);
+            vst1q_f32(dst + i + 0, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+            vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] = static_cast<float>(src[i]) * s16_to_float;
+        }
+    }
+
+    static void simd_clamp(float *buf, size_t count) {
+        size_t i = 0;
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+        __m128 lo = _mm_set1_ps(-1.f);
+        __m128 hi = _mm_set1_ps(1.f);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(buf + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(buf + i), lo), hi));
+        }
+#elif defined(ROCKETGE__Architecture_arm64)
+        float32x4_t lo = vdupq_n_f32(-1.f);
+        float32x4_t hi = vdupq_n_f32(1.f);
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(buf + i, vminq_f32(vmaxq_f32(vld1q_f32(buf + i), lo), hi));
+        }
+#endif
+        for (; i < count; ++i) {
+            buf[i] = std::min(std::max(buf[i], -1.f), 1.f);
+        }
+    }
+
+    /// @note Input must already be clamped
+    static void simd_f32_to_s16(int16_t *dst, const float *src, size_t count) {
+        size_t i = 0;
+#if defined(ROCKETGE__Architecture_x64) || defined(ROCKETGE__Architecture_x86)
+        __m128 scale = _mm_set1_ps(32767.f);
+        for (; i + 8 <= count; i += 8) {
+            __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 0), scale));
+            __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+        }
+#elif defined(ROCKETGE__Architecture_arm64)
+        float32x4_t scale = vdupq_n_f32(32767.f);
+        for (; i + 8 <= count; i += 8) {
+            int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i + 0), scale));
+            int32x4_t b = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i + 4), scale));
+            vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+        }
+#endif
+        for (; i < count; ++i) {
+            dst[i] = static_cast<int16_t>(std::lrintf(src[i] * 32767.f));
+        }
+    }
+
+    static inline float load_sample(const std::vector<int16_t> &data, size_t index) {
+        return static_cast<float>(data[index]) * s16_to_float;
+    }
+
+    static inline float load_sample(const std::vector<float> &data, size_t index) {
+        return data[index];
+    }
+
+    static inline float cubic(float p0, float p1, float p2, float p3, float t) {
+        // Catmull-Rom
+        float a = -0.5f * p0 + 1.5f * p1 - 1.5f * p2 + 0.5f * p3;
+        float b = p0 - 2.5f * p1 + 2.f * p2 - 0.5f * p3;
+        float c = -0.5f * p0 + 0.5f * p2;
+        return ((a * t + b) * t + c) * t + p1;
+    }
+
+    /// @brief Resample one voice into out (stereo), returns frames written before the voice ended
+    template<typename T>
+    static size_t render_voice(const std::vector<T> &data, const pcm_t &pcm, mixer_voice_t &voice, resampler_t resampler, float *out, size_t frames) {
+        const size_t channels = static_cast<size_t>(pcm.channels);
+        const uint64_t end = static_cast<uint64_t>(pcm.frames) << 32;
+
+        // Frame index with wrap (loop) or silence (past the end)
+        auto frame_at = [&](int64_t index, size_t channel) -> float {
+            if (index < 0) {
+                if (!voice.loop) return 0.f;
+                index += static_cast<int64_t>(pcm.frames);
+            }
+            size_t i = static_cast<size_t>(index);
+            if (i >= pcm.frames) {
+                if (!voice.loop) return 0.f;
+                i %= pcm.frames;
+            }
+            return load_sample(data, i * channels + channel);
+        };
+
+        size_t written = 0;
+
+        // Fast path: same rate, integer position, int16 stereo data
+        if constexpr (std::is_same_v<T, int16_t>) {
+            if (voice.step == fixed_one && (voice.position & (fixed_one - 1)) == 0 && channels == 2) {
+                while (written < frames) {
+                    size_t index = static_cast<size_t>(voice.position >> 32);
+                    size_t run = std::min(frames - written, pcm.frames - index);
+                    simd_s16_to_f32(out + written * 2, data.data() + index * 2, run * 2);
+                    written += run;
+                    voice.position += static_cast<uint64_t>(run) << 32;
+                    if (voice.position >= end) {
+                        if (!voice.loop) break;
+                        voice.position -= end;
+                    }
+                }
+                return written;
+            }
+        }
+
+        for (; written < frames; ++written) {
+            if (voice.position >= end) {
+                if (!voice.loop) break;
+                voice.position %= end;
+            }
+
+            int64_t index = static_cast<int64_t>(voice.position >> 32);
+            float t = static_cast<float>(voice.position & (fixed_one - 1)) * fixed_to_float;
+
+            float l = 0.f;
+            float r = 0.f;
+            for (size_t ch = 0; ch < std::min<size_t>(channels, 2); ++ch) {
+                float v;
+                if (resampler == resampler_t::cubic) {
+                    v = cubic(frame_at(index - 1, ch), frame_at(index, ch), frame_at(index + 1, ch), frame_at(index + 2, ch), t);
+                } else {
+                    float a = frame_at(index, ch);
+                    v = a + (frame_at(index + 1, ch) - a) * t;
+                }
+                (ch == 0 ? l : r) = v;
+            }
+            if (channels == 1) {
+                r = l;
+            }
+
+            out[written * 2 + 0] = l;
+            out[written * 2 + 1] = r;
+            voice.position += voice.step;
+        }
+
+        return written;
+    }
+
+    static void wav_write_header(std::ofstream &file, int sample_rate, uint32_t data_bytes) {
+        auto u32 = [&file](uint32_t v) { file.write(reinterpret_cast<const char*>(&v), 4); };
+        auto u16 = [&file](uint16_t v) { file.write(reinterpret_cast<const char*>(&v), 2); };
+
+        const uint16_t channels = 2;
+        const uint16_t bits = 16;
+
+        file.write("RIFF", 4);
+        u32(36 + data_bytes);
+        file.write("WAVE", 4);
+        file.write("fmt ", 4);
+        u32(16);
+        u16(1); // PCM
+        u16(channels);
+        u32(static_cast<uint32_t>(sample_rate));
+        u32(static_cast<uint32_t>(sample_rate) * channels * bits / 8);
+        u16(channels * bits / 8);
+        u16(bits);
+        file.write("data", 4);
+        u32(data_bytes);
+    }
+
+    software_mixer_t::software_mixer_t(mixer_config_t config) {
+        this->impl = new software_mixer_impl_t;
+        if (config.block_frames == 0) {
+            rocket::log("block_frames must be > 0, using 256", "software_mixer_t", "constructor", "warning");
+            config.block_frames = 256;
+        }
+        if (config.sample_rate <= 0) {
+            rocket::log("sample_rate must be > 0, using 48000", "software_mixer_t", "constructor", "warning");
+            config.sample_rate = 48000;
+        }
+        impl->config = config;
+        impl->scratch.resize(config.block_frames * 2);
+        impl->mix.resize(config.block_frames * 2);
+        impl->pcm.reserve(64);
+        impl->voices.reserve(256);
+
+        if (config.sink == sink_type_t::wav) {
+            impl->wav.open(config.wav_path, std::ios::binary | std::ios::trunc);
+            if (!impl->wav.is_open()) {
+                rocket::log("failed to open wav sink: " + config.wav_path, "software_mixer_t", "constructor", "error");
+            } else {
+                wav_write_header(impl->wav, config.sample_rate, 0);
+                impl->wav_block.resize(config.block_frames * 2);
+            }
+        }
+    }
+
+    software_mixer_t::pcm_handle_t software_mixer_t::upload(const buffer_t &buffer) {
+        int channels = buffer.format == format_t::mono16 ? 1 : 2;
+        if (buffer.sample_rate <= 0 || buffer.samples.size() < static_cast<size_t>(channels)) {
+            rocket::log("invalid buffer", "software_mixer_t", "upload", "error");
+            return 0;
+        }
+
+        pcm_t pcm;
+        pcm.channels = channels;
+        pcm.sample_rate = buffer.sample_rate;
+        pcm.frames = buffer.samples.size() / channels;
+        pcm.samples = buffer.samples;
+        impl->pcm.push_back(std::move(pcm));
+        return static_cast<pcm_handle_t>(impl->pcm.size());
+    }
+
+    software_mixer_t::pcm_handle_t software_mixer_t::upload(const float *samples, size_t frame_count, int channels, int sample_rate) {
+        if (samples == nullptr || frame_count == 0 || channels < 1 || channels > 2 || sample_rate <= 0) {
+            rocket::log("invalid samples", "software_mixer_t", "upload", "error");
+            return 0;
+        }
+
+        pcm_t pcm;
+        pcm.channels = channels;
+        pcm.sample_rate = sample_rate;
+        pcm.frames = frame_count;
+        pcm.samples = std::vector<float>(samples, samples + frame_count * channels);
+        impl->pcm.push_back(std::move(pcm));
+        return static_cast<pcm_handle_t>(impl->pcm.size());
+    }
+
+    void software_mixer_t::release(pcm_handle_t pcm) {
+        if (pcm == 0 || pcm > impl->pcm.size()) {
+            return;
+        }
+
+        for (auto &voice : impl->voices) {
+            if (voice.pcm == pcm) voice.finished = true;
+        }
+        impl->pcm[pcm - 1] = {};
+    }
+
+    software_mixer_t::voice_handle_t software_mixer_t::play(pcm_handle_t pcm, float gain, float pan, bool loop, sound_finish_callback_t cb) {
+        if (pcm == 0 || pcm > impl->pcm.size() || impl->pcm[pcm - 1].frames == 0) {
+            rocket::log("invalid pcm handle", "software_mixer_t", "play", "error");
+            return 0;
+        }
+
+        const pcm_t &data = impl->pcm[pcm - 1];
+
+        mixer_voice_t voice;
+        voice.handle = impl->next_voice++;
+        voice.pcm = pcm;
+        voice.step = (static_cast<uint64_t>(data.sample_rate) << 32) / static_cast<uint64_t>(impl->config.sample_rate);
+        voice.gain = gain;
+        voice.pan = std::clamp(pan, -1.f, 1.f);
+        voice.loop = loop;
+        voice.cb = std::move(cb);
+        impl->voices.push_back(std::move(voice));
+
+        return impl->voices.back().handle;
+    }
+
+    static mixer_voice_t *find_voice(software_mixer_impl_t *impl, software_mixer_t::voice_handle_t handle) {
+        for (auto &voice : impl->voices) {
+            if (voice.handle == handle) return &voice;
+        }
+        return nullptr;
+    }
+
+    void software_mixer_t::stop(voice_handle_t handle) {
+        mixer_voice_t *voice = find_voice(impl, handle);
+        if (voice != nullptr) voice->finished = true;
+    }
+
+    void software_mixer_t::set_gain(voice_handle_t handle, float gain) {
+        mixer_voice_t *voice = find_voice(impl, handle);
+        if (voice != nullptr) voice->gain = gain;
+    }
+
+    void software_mixer_t::set_pan(voice_handle_t handle, float pan) {
+        mixer_voice_t *voice = find_voice(impl, handle);
+        if (voice != nullptr) voice->pan = std::clamp(pan, -1.f, 1.f);
+    }
+
+    bool software_mixer_t::is_playing(voice_handle_t handle) const {
+        mixer_voice_t *voice = find_voice(impl, handle);
+        return voice != nullptr && !voice->finished;
+    }
+
+    size_t software_mixer_t::get_voice_count() const {
+        return impl->voices.size();
+    }
+
+    void software_mixer_t::process(size_t block_count) {
+        const size_t block = impl->config.block_frames;
+        float *mix = impl->mix.data();
+        float *scratch = impl->scratch.data();
+
+        for (size_t b = 0; b < block_count; ++b) {
+            std::fill(impl->mix.begin(), impl->mix.end(), 0.f);
+
+            for (auto &voice : impl->voices) {
+                if (voice.finished) continue;
+
+                const pcm_t &pcm = impl->pcm[voice.pcm - 1];
+
+                // Silent voices only advance, they still finish on time
+                if (voice.gain == 0.f) {
+                    voice.position += voice.step * block;
+                    uint64_t end = static_cast<uint64_t>(pcm.frames) << 32;
+                    if (voice.position >= end) {
+                        if (voice.loop) voice.position %= end;
+                        else voice.finished = true;
+                    }
+                    continue;
+                }
+
+                size_t written = std::visit([&](const auto &data) {
+                    return render_voice(data, pcm, voice, impl->config.resampler, scratch, block);
+                }, pcm.samples);
+
+                float gl = voice.gain * std::min(1.f, 1.f - voice.pan);
+                float gr = voice.gain * std::min(1.f, 1.f + voice.pan);
+                simd_mix_stereo(mix, scratch, written, gl, gr);
+
+                if (written < block) {
+                    voice.finished = true;
+                }
+            }
+
+            simd_clamp(mix, block * 2);
+
+            switch (impl->config.sink) {
+                case sink_type_t::wav: {
+                    if (!impl->wav.is_open()) break;
+                    simd_f32_to_s16(impl->wav_block.data(), mix, block * 2);
+                    impl->wav.write(reinterpret_cast<const char*>(impl->wav_block.data()), block * 2 * sizeof(int16_t));
+                    impl->wav_data_bytes += block * 2 * sizeof(int16_t);
+                    break;
+                }
+                case sink_type_t::callback: {
+                    if (impl->config.callback) impl->config.callback(mix, block);
+                    break;
+                }
+                case sink_type_t::null: {
+                    break;
+                }
+            }
+
+            impl->frames_processed += block;
+
+            for (size_t i = 0; i < impl->voices.size();) {
+                if (!impl->voices[i].finished) {
+                    ++i;
+                    continue;
+                }
+
+                service::dispatch(std::move(impl->voices[i].cb));
+                impl->voices[i] = std::move(impl->voices.back());
+                impl->voices.pop_back();
+            }
+        }
+    }
+
+    void software_mixer_t::process_for(std::chrono::nanoseconds elapsed) {
+        impl->carry += elapsed;
+        std::chrono::nanoseconds block_time(static_cast<int64_t>(impl->config.block_frames) * 1'000'000'000 / impl->config.sample_rate);
+        if (block_time.count() <= 0) return;
+
+        size_t blocks = static_cast<size_t>(impl->carry / block_time);
+        impl->carry -= block_time * static_cast<int64_t>(blocks);
+        process(blocks);
+    }
+
+    uint64_t software_mixer_t::get_frames_processed() const {
+        return impl->frames_processed;
+    }
+
+    const mixer_config_t &software_mixer_t::get_config() const {
+        return impl->config;
+    }
+
+    software_mixer_t::~software_mixer_t() {
+        if (impl->wav.is_open()) {
+            impl->wav.seekp(0);
+            wav_write_header(impl->wav, impl->config.sample_rate, static_cast<uint32_t>(impl->wav_data_bytes));
+            impl->wav.close();
+        }
+
+        delete impl;
+        impl = nullptr;
+    }
+}
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <audio.hpp>
+#include <data_structures.hpp>
+#include <rocket/audio.hpp>
+#include <rocket/runtime.hpp>
+#include <rocket/threads.hpp>
+
+namespace rocket::audio::service {
+    constexpr size_t command_queue_size = 256;
+
+    struct watch_t {
+        unsigned int source = 0;
+        std::function<void()> on_release;
+        sound_finish_callback_t on_finish;
+    };
+
+    struct service_state_t {
+        mpsc_ring_t<command_t, command_queue_size> commands;
+
+        std::thread thread;
+        std::atomic_bool running = false;
+        std::mutex lifecycle_mutex;
+
+        /// @brief Only used to sleep between polls, never held by producers
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+
+        std::atomic<int64_t> poll_interval_ms = 10;
+        std::atomic<callback_thread_t> callback_thread = callback_thread_t::main;
+
+        ~service_state_t() {
+            running.store(false, std::memory_order_release);
+            wake.notify_one();
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    };
+
+    static service_state_t &get_state() {
+        static service_state_t state;
+        return state;
+    }
+
+    void dispatch(sound_finish_callback_t cb) {
+        if (!cb) {
+            return;
+        }
+
+        if (get_state().callback_thread.load(std::memory_order_relaxed) == callback_thread_t::audio) {
+            cb();
+        } else {
+            rocket::thread_t::schedule(std::move(cb));
+        }
+    }
+
+    static void dispatch_finish(watch_t &watch) {
+        if (watch.on_release) {
+            watch.on_release();
+        }
+
+        dispatch(std::move(watch.on_finish));
+    }
+
+    static void execute(command_t &cmd, std::vector<watch_t> &watches) {
+        switch (cmd.type) {
+            case command_type_t::play: {
+                // The source was handed to a new voice before the old one was polled
+                for (size_t i = 0; i < watches.size(); ++i) {
+                    if (watches[i].source != cmd.source) continue;
+                    if (watches[i].on_release) watches[i].on_release();
+                    watches[i] = std::move(watches.back());
+                    watches.pop_back();
+                    break;
+                }
+
+                // Clear errors left behind by polls of deleted sources
+                alGetError();
+                alSourceStop(cmd.source);
+                if (cmd.buffer != 0) {
+                    alSourcei(cmd.source, AL_BUFFER, cmd.buffer);
+                }
+                alSourcei(cmd.source, AL_LOOPING, cmd.loop ? AL_TRUE : AL_FALSE);
+                alSourcef(cmd.source, AL_GAIN, cmd.gain);
+                alSourcei(cmd.source, AL_SOURCE_RELATIVE, cmd.spatial ? AL_FALSE : AL_TRUE);
+                alSource3f(cmd.source, AL_POSITION, cmd.position.x, cmd.position.y, cmd.position.z);
+                if (cmd.offset_seconds > 0.f) {
+                    alSourcef(cmd.source, AL_SEC_OFFSET, cmd.offset_seconds);
+                }
+                alSourcePlay(cmd.source);
+
+                ALenum error = alGetError();
+                if (error != AL_NO_ERROR) {
+                    rocket::log("failed to play source: " + std::to_string(error), "audio::service", "execute", "error");
+                    if (cmd.on_release) cmd.on_release();
+                    return;
+                }
+
+                watches.push_back({ cmd.source, std::move(cmd.on_release), std::move(cmd.on_finish) });
+                break;
+            }
+            case command_type_t::stop: {
+                alSourceStop(cmd.source);
+                break;
+            }
+            case command_type_t::seek: {
+                alSourcef(cmd.source, AL_SEC_OFFSET, cmd.offset_seconds);
+
+                ALint state = AL_STOPPED;
+                alGetSourcei(cmd.source, AL_SOURCE_STATE, &state);
+                if (state != AL_PLAYING) {
+                    alSourcePlay(cmd.source);
+                }
+                break;
+            }
+            case command_type_t::delete_buffer: {
+                // Stops queued before this already ran, sources may still hold the buffer
+                for (auto &watch : watches) {
+                    ALint bound = 0;
+                    alGetSourcei(watch.source, AL_BUFFER, &bound);
+                    if (static_cast<unsigned int>(bound) != cmd.buffer) continue;
+                    alSourceStop(watch.source);
+                    alSourcei(watch.source, AL_BUFFER, 0);
+                }
+
+                alGetError();
+                alDeleteBuffers(1, &cmd.buffer);
+                ALenum error = alGetError();
+                if (error != AL_NO_ERROR) {
+                    rocket::log("failed to delete buffer: " + std::to_string(error), "audio::service", "execute", "error");
+                }
+                break;
+            }
+            case command_type_t::none: {
+                break;
+            }
+        }
+    }
+
+    static void poll(std::vector<watch_t> &watches) {
+        for (size_t i = 0; i < watches.size();) {
+            // Deleted sources report AL_INVALID_NAME and keep this value, so they finish too
+            ALint state = AL_STOPPED;
+            alGetSourcei(watches[i].source, AL_SOURCE_STATE, &state);
+            if (state == AL_PLAYING || state == AL_PAUSED) {
+                ++i;
+                continue;
+            }
+
+            watch_t finished = std::move(watches[i]);
+            watches[i] = std::move(watches.back());
+            watches.pop_back();
+
+            // Idle sources must not pin buffers, play binds one again
+            alSourcei(finished.source, AL_BUFFER, 0);
+
+            dispatch_finish(finished);
+        }
+    }
+
+    static void service_main() {
+        rocket::thread_t::set_thread_name("rge-audio");
+        service_state_t &state = get_state();
+
+        std::vector<watch_t> watches;
+        watches.reserve(64);
+
+        while (state.running.load(std::memory_order_acquire)) {
+            while (auto cmd = state.commands.try_pop()) {
+                execute(*cmd, watches);
+            }
+
+            poll(watches);
+
+            std::chrono::milliseconds interval(state.poll_interval_ms.load(std::memory_order_relaxed));
+            std::unique_lock<std::mutex> lock(state.wake_mutex);
+            state.wake.wait_for(lock, interval, [&state]() {
+                return !state.running.load(std::memory_order_acquire) || state.commands.size_approx() != 0;
+            });
+        }
+
+        // Never executed, but their resources still have to be released
+        while (auto cmd = state.commands.try_pop()) {
+            if (cmd->on_release) cmd->on_release();
+        }
+        for (auto &watch : watches) {
+            if (watch.on_release) watch.on_release();
+        }
+    }
+
+    void submit(command_t cmd) {
+        service_state_t &state = get_state();
+        if (!state.running.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(state.lifecycle_mutex);
+            if (!state.running.load(std::memory_order_relaxed)) {
+                state.running.store(true, std::memory_order_release);
+                state.thread = std::thread(service_main);
+            }
+        }
+
+        while (!state.commands.try_push(cmd)) {
+            // Queue is full, the service thread drains it on wake
+            state.wake.notify_one();
+            std::this_thread::yield();
+        }
+        state.wake.notify_one();
+    }
+
+    void stop() {
+        service_state_t &state = get_state();
+        std::lock_guard<std::mutex> lock(state.lifecycle_mutex);
+        if (!state.running.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        state.running.store(false, std::memory_order_release);
+        state.wake.notify_one();
+        if (state.thread.joinable()) {
+            state.thread.join();
+        }
+    }
+}
+
+namespace rocket::audio {
+    void set_service_config(service_config_t config) {
+        service::service_state_t &state = service::get_state();
+        state.poll_interval_ms.store(std::max<int64_t>(1, config.poll_interval.count()), std::memory_order_relaxed);
+        state.callback_thread.store(config.callback_thread, std::memory_order_relaxed);
+        state.wake.notify_one();
+    }
+
+    service_config_t get_service_config() {
+        service::service_state_t &state = service::get_state();
+        return {
+            .poll_interval = std::chrono::milliseconds(state.poll_interval_ms.load(std::memory_order_relaxed)),
+            .callback_thread = state.callback_thread.load(std::memory_order_relaxed),
+        };
+    }
+}
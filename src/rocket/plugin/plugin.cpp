@@ -1,6 +1,7 @@
 #include "rocket/plugin/plugin.hpp"
 #include "rocket/macros.hpp"
 #include "rocket/plugin/api/api.hpp"
+#include "rocket/profiler.hpp"
 #include "rocket/runtime.hpp"
 #include <cstdint>
 #include <fstream>
@@ -103,6 +104,7 @@ namespace rocket {
             }
 
             if (plugin->cap->needs_frame_events) {
+                ROCKET_PROFILE_SCOPE("plugin::on_framestart");
                 on_framestart();
             }
         }
@@ -118,6 +120,7 @@ namespace rocket {
             }
 
             if (plugin->cap->needs_frame_events) {
+                ROCKET_PROFILE_SCOPE("plugin::on_frameend");
                 on_frameend();
             }
         }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <data_structures.hpp>
 #include <rocket/runtime.hpp>
@@ -81,4 +82,81 @@ namespace rocket {
     }
 
     compressed_data_t::~compressed_data_t() = default;
+
+    std::optional<vec2i_t> shelf_packer_t::allocate(vec2i_t rect) {
+        if (rect.x <= 0 || rect.y <= 0 || rect.x > this->size.x || rect.y > this->size.y) {
+            return std::nullopt;
+        }
+        const int height = (rect.y + 7) & ~7;
+        // Tightest fitting shelf with a free span wide enough
+        shelf_t *best = nullptr;
+        size_t best_span = 0;
+        for (shelf_t &shelf : this->shelves) {
+            if (shelf.height < rect.y || (shelf.height > height && shelf.height * 2 > rect.y * 3)) {
+                continue;
+            }
+            if (best != nullptr && shelf.height >= best->height) {
+                continue;
+            }
+            for (size_t i = 0; i < shelf.free.size(); ++i) {
+                if (shelf.free[i].second >= rect.x) {
+                    best = &shelf;
+                    best_span = i;
+                    break;
+                }
+            }
+        }
+
+        if (best == nullptr) {
+            if (this->top + rect.y > this->size.y) {
+                return std::nullopt;
+            }
+            shelf_t shelf;
+            shelf.y = this->top;
+            shelf.height = std::min(height, this->size.y - this->top);
+            shelf.free.push_back({ 0, this->size.x });
+            this->top += shelf.height;
+            this->shelves.push_back(std::move(shelf));
+            best = &this->shelves.back();
+            best_span = 0;
+        }
+
+        auto &span = best->free[best_span];
+        const vec2i_t pos = { span.first, best->y };
+        span.first += rect.x;
+        span.second -= rect.x;
+        if (span.second == 0) {
+            best->free.erase(best->free.begin() + static_cast<std::ptrdiff_t>(best_span));
+        }
+        best->used++;
+        return pos;
+    }
+
+    void shelf_packer_t::free(vec2i_t pos, vec2i_t rect) {
+        for (size_t s = 0; s < this->shelves.size(); ++s) {
+            shelf_t &shelf = this->shelves[s];
+            if (shelf.y != pos.y) {
+                continue;
+            }
+            auto it = std::lower_bound(shelf.free.begin(), shelf.free.end(), std::make_pair(pos.x, 0));
+            it = shelf.free.insert(it, { pos.x, rect.x });
+            // Merge with the neighbours
+            if (it + 1 != shelf.free.end() && it->first + it->second == (it + 1)->first) {
+                it->second += (it + 1)->second;
+                shelf.free.erase(it + 1);
+            }
+            if (it != shelf.free.begin() && (it - 1)->first + (it - 1)->second == it->first) {
+                (it - 1)->second += it->second;
+                shelf.free.erase(it);
+            }
+            shelf.used--;
+
+            // Empty shelves at the bottom go back to the page
+            while (!this->shelves.empty() && this->shelves.back().used == 0) {
+                this->top = this->shelves.back().y;
+                this->shelves.pop_back();
+            }
+            return;
+        }
+    }
 }
@@ -0,0 +1,347 @@
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <rocket/io.hpp>
+#include <rocket/runtime.hpp>
+#include "util.hpp"
+
+// File layout (native endianness, not meant to move between machines):
+//   header: "RGIR" u32 version
+//   frame:  u64 publish_ns, u32 event_count, events...
+//   event:  u8 kind (variant index), u64 timestamp_ns, payload
+// Every frame is written, even empty ones, so frame indices line up on replay
+
+namespace rocket::io {
+    constexpr char recording_magic[4] = { 'R', 'G', 'I', 'R' };
+    constexpr uint32_t recording_version = 1;
+    constexpr double default_replay_delta_time = 1.0 / 60.0;
+
+    struct recorded_frame_t {
+        uint64_t publish_ns = 0;
+        std::vector<input_event_t> events;
+    };
+
+    struct recorder_t {
+        std::ofstream file;
+        std::vector<uint8_t> buffer;
+    };
+
+    struct replayer_t {
+        bool active = false;
+        bool exit_when_done = false;
+        std::vector<recorded_frame_t> frames;
+        size_t next_frame = 0;
+        double delta_time = default_replay_delta_time;
+
+        std::bitset<static_cast<size_t>(keyboard_key::last_key) + 1> keys;
+        std::bitset<static_cast<size_t>(mouse_button::last) + 1> buttons;
+        /// @brief Last recorded scancode of every key, dispatched with its state
+        std::array<int32_t, static_cast<size_t>(keyboard_key::last_key) + 1> scancodes = {};
+        rocket::vec2d_t mouse_pos = { 0, 0 };
+        /// @brief Position of the last dispatched mouse move
+        rocket::vec2d_t dispatched_mouse_pos = { 0, 0 };
+    };
+
+    static recorder_t recorder;
+    static replayer_t replayer;
+
+    template<typename T>
+    static void put(std::vector<uint8_t> &out, const T &value) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    static bool get(std::ifstream &in, T &value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+
+    static uint8_t pack_state(keystate_t state) {
+        return static_cast<uint8_t>(state.current) | static_cast<uint8_t>(state.previous) << 1;
+    }
+
+    static keystate_t unpack_state(uint8_t bits) {
+        return { (bits & 1) != 0, (bits & 2) != 0 };
+    }
+
+    /// @brief Keys and buttons the replayer can track, anything else is from a corrupt file
+    static bool replayable(const input_event_t &event) {
+        if (auto *e = std::get_if<key_event_t>(&event.data)) {
+            const int key = static_cast<int>(e->key);
+            return key >= 0 && key <= static_cast<int>(keyboard_key::last_key);
+        }
+        if (auto *e = std::get_if<mouse_event_t>(&event.data)) {
+            const int button = static_cast<int>(e->button);
+            return button >= 0 && button <= static_cast<int>(mouse_button::last);
+        }
+        return true;
+    }
+
+    static void serialize(std::vector<uint8_t> &out, const input_event_t &event) {
+        put<uint8_t>(out, static_cast<uint8_t>(event.data.index()));
+        put<uint64_t>(out, event.timestamp_ns);
+
+        if (auto *e = std::get_if<key_event_t>(&event.data)) {
+            put<int32_t>(out, static_cast<int32_t>(e->key));
+            put<uint8_t>(out, pack_state(e->state));
+            put<int32_t>(out, e->scancode);
+        } else if (auto *e = std::get_if<mouse_event_t>(&event.data)) {
+            put<uint8_t>(out, static_cast<uint8_t>(e->button));
+            put<uint8_t>(out, pack_state(e->state));
+            put(out, e->position.x);
+            put(out, e->position.y);
+        } else if (auto *e = std::get_if<mouse_move_event_t>(&event.data)) {
+            put(out, e->old_pos.x);
+            put(out, e->old_pos.y);
+            put(out, e->pos.x);
+            put(out, e->pos.y);
+        } else if (auto *e = std::get_if<scroll_offset_event_t>(&event.data)) {
+            put(out, e->offset.x);
+            put(out, e->offset.y);
+        } else if (auto *e = std::get_if<gamepad_event_t>(&event.data)) {
+            put<uint8_t>(out, e->gamepad);
+            put<uint8_t>(out, static_cast<uint8_t>(e->index));
+            put<uint8_t>(out, e->axis ? 1 : 0);
+            put<float>(out, e->value);
+        }
+    }
+
+    static bool deserialize(std::ifstream &in, input_event_t &event) {
+        uint8_t kind = 0;
+        if (!get(in, kind) || !get(in, event.timestamp_ns)) {
+            return false;
+        }
+
+        switch (kind) {
+            case 0: {
+                int32_t key = 0, scancode = 0;
+                uint8_t state = 0;
+                if (!get(in, key) || !get(in, state) || !get(in, scancode)) return false;
+                event.data = key_event_t { static_cast<keyboard_key>(key), unpack_state(state), scancode };
+                return true;
+            }
+            case 1: {
+                uint8_t button = 0, state = 0;
+                rocket::vec2d_t pos;
+                if (!get(in, button) || !get(in, state) || !get(in, pos.x) || !get(in, pos.y)) return false;
+                event.data = mouse_event_t { static_cast<mouse_button>(button), unpack_state(state), pos };
+                return true;
+            }
+            case 2: {
+                mouse_move_event_t e;
+                if (!get(in, e.old_pos.x) || !get(in, e.old_pos.y) || !get(in, e.pos.x) || !get(in, e.pos.y)) return false;
+                event.data = e;
+                return true;
+            }
+            case 3: {
+                scroll_offset_event_t e;
+                if (!get(in, e.offset.x) || !get(in, e.offset.y)) return false;
+                event.data = e;
+                return true;
+            }
+            case 4: {
+                uint8_t gamepad = 0, index = 0, axis = 0;
+                float value = 0.f;
+                if (!get(in, gamepad) || !get(in, index) || !get(in, axis) || !get(in, value)) return false;
+                event.data = gamepad_event_t { gamepad, index, axis != 0, value };
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+
+    bool start_recording(const std::string &path) {
+        stop_recording();
+
+        recorder.file.open(path, std::ios::binary | std::ios::trunc);
+        if (!recorder.file) {
+            rocket::log("failed to open input recording: " + path, "rocket::io", "start_recording", "error");
+            return false;
+        }
+
+        recorder.file.write(recording_magic, sizeof(recording_magic));
+        recorder.file.write(reinterpret_cast<const char *>(&recording_version), sizeof(recording_version));
+        rocket::log("recording input to " + path, "rocket::io", "start_recording", "info");
+        return true;
+    }
+
+    void stop_recording() {
+        if (recorder.file.is_open()) {
+            recorder.file.close();
+        }
+    }
+
+    bool start_replay(const std::string &path, bool exit_when_done) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            rocket::log("failed to open input recording: " + path, "rocket::io", "start_replay", "error");
+            return false;
+        }
+
+        char magic[sizeof(recording_magic)] = {};
+        uint32_t version = 0;
+        in.read(magic, sizeof(magic));
+        if (!in || std::memcmp(magic, recording_magic, sizeof(magic)) != 0 || !get(in, version) || version != recording_version) {
+            rocket::log("not an input recording or unsupported version: " + path, "rocket::io", "start_replay", "error");
+            return false;
+        }
+
+        std::vector<recorded_frame_t> frames;
+        recorded_frame_t frame;
+        uint32_t count = 0;
+        size_t rejected = 0;
+        while (get(in, frame.publish_ns) && get(in, count)) {
+            frame.events.resize(count);
+            bool complete = true;
+            for (auto &event : frame.events) {
+                if (!deserialize(in, event)) {
+                    complete = false;
+                    break;
+                }
+            }
+            // Fully read, so the stream stays in step when one is dropped
+            rejected += std::erase_if(frame.events, [](const input_event_t &event) { return !replayable(event); });
+            if (!complete) {
+                // Process died mid-write while recording, keep the complete frames
+                rocket::log("truncated input recording, replaying " + std::to_string(frames.size()) + " frames", "rocket::io", "start_replay", "warn");
+                break;
+            }
+            frames.push_back(std::move(frame));
+            frame = {};
+        }
+        if (rejected > 0) {
+            rocket::log("dropped " + std::to_string(rejected) + " events with an unknown key or button", "rocket::io", "start_replay", "warn");
+        }
+
+        replayer = {};
+        replayer.frames = std::move(frames);
+        replayer.exit_when_done = exit_when_done;
+        if (replayer.frames.size() >= 2) {
+            uint64_t span = replayer.frames.back().publish_ns - replayer.frames.front().publish_ns;
+            replayer.delta_time = static_cast<double>(span) / 1e9 / static_cast<double>(replayer.frames.size() - 1);
+        }
+        replayer.active = true;
+
+        rocket::log("replaying " + std::to_string(replayer.frames.size()) + " frames from " + path + " at a fixed delta time of " + std::to_string(replayer.delta_time) + "s", "rocket::io", "start_replay", "info");
+        return true;
+    }
+
+    bool is_replaying() {
+        return replayer.active;
+    }
+}
+
+namespace util {
+    void input_record_frame(std::span<const rocket::io::input_event_t> frame) {
+        auto &recorder = rocket::io::recorder;
+        if (!recorder.file.is_open()) {
+            return;
+        }
+
+        recorder.buffer.clear();
+        uint32_t count = 0;
+        for (auto &event : frame) {
+            if (!event.simulated) count++;
+        }
+
+        rocket::io::put<uint64_t>(recorder.buffer, rocket::io::event_clock_ns());
+        rocket::io::put<uint32_t>(recorder.buffer, count);
+        for (auto &event : frame) {
+            if (event.simulated) continue;
+            rocket::io::serialize(recorder.buffer, event);
+        }
+
+        // Flushed every frame, rocket::exit does not unwind
+        recorder.file.write(reinterpret_cast<const char *>(recorder.buffer.data()), static_cast<std::streamsize>(recorder.buffer.size()));
+        recorder.file.flush();
+    }
+
+    bool input_replay_frame(std::vector<rocket::io::input_event_t> &frame) {
+        auto &replayer = rocket::io::replayer;
+        if (!replayer.active) {
+            return false;
+        }
+
+        std::erase_if(frame, [](const rocket::io::input_event_t &event) { return !event.simulated; });
+
+        if (replayer.next_frame >= replayer.frames.size()) {
+            replayer.active = false;
+            rocket::log("input replay finished", "rocket::io", "replay", "info");
+            if (replayer.exit_when_done) {
+                rocket::exit(0);
+            }
+            return false;
+        }
+
+        const auto keys_before = replayer.keys;
+        const auto buttons_before = replayer.buttons;
+        // Events were range checked by start_replay
+        for (auto &event : replayer.frames[replayer.next_frame++].events) {
+            if (auto *e = std::get_if<rocket::io::key_event_t>(&event.data)) {
+                replayer.keys[static_cast<size_t>(e->key)] = e->state.down();
+                replayer.scancodes[static_cast<size_t>(e->key)] = e->scancode;
+            } else if (auto *e = std::get_if<rocket::io::mouse_event_t>(&event.data)) {
+                replayer.buttons[static_cast<size_t>(e->button)] = e->state.down();
+            } else if (auto *e = std::get_if<rocket::io::mouse_move_event_t>(&event.data)) {
+                replayer.mouse_pos = e->pos;
+            } else if (auto *e = std::get_if<rocket::io::scroll_offset_event_t>(&event.data)) {
+                // Dispatched from the callback when live too
+                dispatch_event(*e);
+            }
+            frame.push_back(event);
+        }
+
+        // Same listener calls as a live poll_events, every key and button each frame
+        using rocket::io::keyboard_key;
+        using rocket::io::mouse_button;
+        for (int i = static_cast<int>(keyboard_key::first_key); i <= static_cast<int>(keyboard_key::last_key); ++i) {
+            dispatch_event(rocket::io::key_event_t {
+                static_cast<keyboard_key>(i),
+                { replayer.keys[i], keys_before[i] },
+                replayer.scancodes[i],
+            });
+        }
+        for (int i = static_cast<int>(mouse_button::first); i <= static_cast<int>(mouse_button::last); ++i) {
+            dispatch_event(rocket::io::mouse_event_t {
+                static_cast<mouse_button>(i),
+                { replayer.buttons[i], buttons_before[i] },
+                replayer.mouse_pos,
+            });
+        }
+        if (replayer.mouse_pos.x != replayer.dispatched_mouse_pos.x || replayer.mouse_pos.y != replayer.dispatched_mouse_pos.y) {
+            rocket::io::mouse_move_event_t event;
+            event.pos = replayer.mouse_pos;
+            event.old_pos = replayer.dispatched_mouse_pos;
+            dispatch_event(event);
+            replayer.dispatched_mouse_pos = replayer.mouse_pos;
+        }
+        return true;
+    }
+
+    bool input_replay_active() {
+        return rocket::io::replayer.active;
+    }
+
+    double input_replay_delta_time() {
+        return rocket::io::replayer.active ? rocket::io::replayer.delta_time : 0.0;
+    }
+
+    bool input_replay_key_down(rocket::io::keyboard_key key) {
+        size_t i = static_cast<size_t>(key);
+        return i < rocket::io::replayer.keys.size() && rocket::io::replayer.keys[i];
+    }
+
+    bool input_replay_mouse_down(rocket::io::mouse_button button) {
+        size_t i = static_cast<size_t>(button);
+        return i < rocket::io::replayer.buttons.size() && rocket::io::replayer.buttons[i];
+    }
+
+    rocket::vec2d_t input_replay_mouse_pos() {
+        return rocket::io::replayer.mouse_pos;
+    }
+}
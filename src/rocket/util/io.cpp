@@ -7,13 +7,20 @@
 #include <SDL2/SDL_haptic.h>
 #include <SDL2/SDL_joystick.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <internal_types.hpp>
 #include <iostream>
+#include <rocket/threads.hpp>
 #include <rocket/window.hpp>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <SDL2/SDL.h>
 #include <intl_macros.hpp>
@@ -104,20 +111,33 @@ namespace rocket::io {
     keystate_t keystate_t::make_released() { return {false, true}; }
     keystate_t keystate_t::make_down() { return {true, true}; }
 
-    void add_listener(std::function<void(key_event_t)> listener) {
-        ::util::key_listeners().push_back(listener);
+    listener_id_t add_listener(std::function<void(key_event_t)> listener) {
+        return ::util::add_listener(std::move(listener));
     }
 
-    void add_listener(std::function<void(mouse_event_t)> listener) {
-        ::util::mouse_listeners().push_back(listener);
+    listener_id_t add_listener(std::function<void(mouse_event_t)> listener) {
+        return ::util::add_listener(std::move(listener));
     }
 
-    void add_listener(std::function<void(mouse_move_event_t)> listener) {
-        ::util::mouse_move_listeners().push_back(listener);
+    listener_id_t add_listener(std::function<void(mouse_move_event_t)> listener) {
+        return ::util::add_listener(std::move(listener));
     }
 
-    void add_listener(std::function<void(scroll_offset_event_t)> listener) {
-        ::util::scroll_offset_listeners().push_back(listener);
+    listener_id_t add_listener(std::function<void(scroll_offset_event_t)> listener) {
+        return ::util::add_listener(std::move(listener));
+    }
+
+    bool remove_listener(listener_id_t id) {
+        return ::util::remove_listener(id);
+    }
+
+    std::span<const input_event_t> get_frame_events() {
+        return ::util::get_input_frame();
+    }
+
+    uint64_t event_clock_ns() {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
     }
 
     void simulate(keyboard_key key, keystate_t state) {
@@ -127,6 +147,7 @@ namespace rocket::io {
         event.key = key;
         event.state = state;
         ::util::dispatch_event(event, true);
+        ::util::record_input_event(event, true);
 #else
         (void)key; (void)state;
 #endif
@@ -138,6 +159,7 @@ namespace rocket::io {
         event.state = state;
         event.position = position;
         ::util::dispatch_event(event, true);
+        ::util::record_input_event(event, true);
     }
 
     void simulate(rocket::vec2d_t position, rocket::vec2d_t old_position) {
@@ -148,6 +170,7 @@ namespace rocket::io {
         event.old_pos = old_position;
         event.pos = position;
         ::util::dispatch_event(event, true);
+        ::util::record_input_event(event, true);
     }
 
     rocket::fbounding_box mouse_bbox() {
@@ -257,7 +280,7 @@ namespace rocket::io {
         rocket::vec2d_t pos = ::util::mouse_pos();
         pos.x = std::max(0.0, pos.x);
         pos.y = std::max(0.0, pos.y);
-        auto mmevs = ::util::get_simulated_mmevents();
+        const auto &mmevs = ::util::get_simulated_mmevents();
         if (!mmevs.empty()) return mmevs.back().pos;
         return pos;
 #endif
@@ -459,3 +482,138 @@ namespace rocket::gpad {
 #endif
     }
 }
+
+namespace rocket::io {
+    struct gamepad_thread_state_t {
+        std::thread thread;
+        std::atomic_bool running = false;
+        std::atomic<int> rate_hz = 1000;
+
+        ~gamepad_thread_state_t() {
+            running.store(false, std::memory_order_release);
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    };
+
+    static gamepad_thread_state_t gamepad_thread;
+
+    /// @brief Axis changes smaller than this are not recorded
+    constexpr float gamepad_axis_epsilon = 1.f / 256.f;
+
+#ifdef ROCKETGE__Platform_Desktop
+    // SDL button order, mapped to gpad::button_t (GLFW order)
+    static constexpr gpad::button_t sdl_button_map[SDL_CONTROLLER_BUTTON_DPAD_RIGHT + 1] = {
+        gpad::button_t::a, gpad::button_t::b, gpad::button_t::x, gpad::button_t::y,
+        gpad::button_t::back, gpad::button_t::guide, gpad::button_t::start,
+        gpad::button_t::left_stick, gpad::button_t::right_stick,
+        gpad::button_t::left_bumper, gpad::button_t::right_bumper,
+        gpad::button_t::dpad_up, gpad::button_t::dpad_down, gpad::button_t::dpad_left, gpad::button_t::dpad_right,
+    };
+
+    struct polled_gamepad_t {
+        SDL_GameController *controller = nullptr;
+        std::array<bool, std::size(sdl_button_map)> buttons = {};
+        std::array<float, SDL_CONTROLLER_AXIS_MAX> axes = {};
+    };
+
+    static void gamepad_thread_main() {
+        rocket::thread_t::set_thread_name("rge-gamepad");
+
+        // GLFW joystick functions are main thread only, SDL is used from this thread alone
+        SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
+        if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) != 0) {
+            rocket::log(std::string("failed to init SDL game controllers: ") + SDL_GetError(), "rocket::io", "gamepad_thread", "error");
+            gamepad_thread.running.store(false, std::memory_order_release);
+            return;
+        }
+
+        std::vector<polled_gamepad_t> pads;
+        int joystick_count = -1;
+        auto next = std::chrono::steady_clock::now();
+
+        while (gamepad_thread.running.load(std::memory_order_acquire)) {
+            SDL_GameControllerUpdate();
+
+            if (int n = SDL_NumJoysticks(); n != joystick_count) {
+                for (auto &pad : pads) {
+                    SDL_GameControllerClose(pad.controller);
+                }
+                pads.clear();
+                for (int i = 0; i < n; ++i) {
+                    if (!SDL_IsGameController(i)) continue;
+                    if (SDL_GameController *gc = SDL_GameControllerOpen(i)) {
+                        pads.push_back({ .controller = gc });
+                    }
+                }
+                joystick_count = n;
+            }
+
+            uint64_t now = event_clock_ns();
+            for (size_t p = 0; p < pads.size(); ++p) {
+                polled_gamepad_t &pad = pads[p];
+
+                for (size_t b = 0; b < pad.buttons.size(); ++b) {
+                    bool down = SDL_GameControllerGetButton(pad.controller, static_cast<SDL_GameControllerButton>(b)) != 0;
+                    if (down == pad.buttons[b]) continue;
+                    pad.buttons[b] = down;
+
+                    gamepad_event_t event = { static_cast<uint8_t>(p), static_cast<int>(sdl_button_map[b]), false, down ? 1.f : 0.f };
+                    ::util::record_input_event_async(event, now);
+                }
+
+                for (size_t a = 0; a < pad.axes.size(); ++a) {
+                    float v = std::clamp(SDL_GameControllerGetAxis(pad.controller, static_cast<SDL_GameControllerAxis>(a)) / 32767.f, -1.f, 1.f);
+                    // SDL triggers are 0 to 1, GLFW reports them as -1 to 1
+                    if (a >= SDL_CONTROLLER_AXIS_TRIGGERLEFT) {
+                        v = v * 2.f - 1.f;
+                    }
+                    if (std::abs(v - pad.axes[a]) < gamepad_axis_epsilon) continue;
+                    pad.axes[a] = v;
+
+                    // axis_t follows the SDL axis order
+                    gamepad_event_t event = { static_cast<uint8_t>(p), static_cast<int>(a), true, v };
+                    ::util::record_input_event_async(event, now);
+                }
+            }
+
+            next += std::chrono::nanoseconds(1'000'000'000 / std::max(1, gamepad_thread.rate_hz.load(std::memory_order_relaxed)));
+            auto current = std::chrono::steady_clock::now();
+            if (next < current) {
+                // Fell behind, do not try to catch up with a burst of polls
+                next = current;
+            }
+            std::this_thread::sleep_until(next);
+        }
+
+        for (auto &pad : pads) {
+            SDL_GameControllerClose(pad.controller);
+        }
+        SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+    }
+#endif
+
+    void start_gamepad_thread(int rate_hz) {
+#ifdef ROCKETGE__Platform_Desktop
+        gamepad_thread.rate_hz.store(rate_hz, std::memory_order_relaxed);
+        if (gamepad_thread.running.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        if (gamepad_thread.thread.joinable()) {
+            gamepad_thread.thread.join();
+        }
+        gamepad_thread.thread = std::thread(gamepad_thread_main);
+#else
+        (void)rate_hz;
+        rocket::log("gamepad thread is not supported on this platform", "rocket::io", "start_gamepad_thread", "warn");
+#endif
+    }
+
+    void stop_gamepad_thread() {
+        gamepad_thread.running.store(false, std::memory_order_release);
+        if (gamepad_thread.thread.joinable()) {
+            gamepad_thread.thread.join();
+        }
+    }
+}
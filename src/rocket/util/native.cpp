@@ -1,8 +1,11 @@
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <exception>
+#include <thread>
+#include <time.h>
 #include "rocket/macros.hpp"
 #include "rocket/runtime.hpp"
 
@@ -106,6 +109,17 @@ namespace unix_backend {
     void get_thread_name(char *buf, size_t sz) {
         pthread_getname_np(pthread_self(), buf, sz);
     }
+
+#if defined(ROCKETGE__Platform_Linux) || defined(ROCKETGE__Platform_Android)
+    void sleep_until(std::chrono::steady_clock::time_point deadline) {
+        // steady_clock is CLOCK_MONOTONIC here
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+    }
+#endif
 }
 #endif
 
@@ -289,6 +303,14 @@ namespace rnative {
 #endif
     }
 
+    void sleep_until(std::chrono::steady_clock::time_point deadline) {
+#if defined(ROCKETGE__Platform_Linux) || defined(ROCKETGE__Platform_Android)
+        unix_backend::sleep_until(deadline);
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+
 #ifdef ROCKETGE__Platform_Desktop
     proc_address_t load_proc_address(const char *name) {
 #ifdef ROCKETGE__Platform_Linux
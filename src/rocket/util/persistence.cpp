@@ -78,12 +78,23 @@ namespace rocket::storage {
         throw std::runtime_error("Unsupported JSON type for variant");
     }
 
+    std::filesystem::path get_storage_path() {
+        if (data_path.empty()) {
+            return get_data_storage_path() / "RocketGE";
+        }
+        return data_path;
+    }
+
     void init(std::string name) {
+        init(name, get_data_storage_path());
+    }
+
+    void init(std::string name, const std::filesystem::path &directory) {
         if (name.empty()) {
             rocket::log("Name may not be empty", "rocket::storage", "init", "error");
             return;
         }
-        data_path = get_data_storage_path() / ("RocketGE_" + name);
+        data_path = directory / ("RocketGE_" + name);
         vars_path = data_path / "rocket-runtime-persistent-storage.dat";
         if (!std::filesystem::exists(data_path)) {
             std::filesystem::create_directories(data_path);
@@ -0,0 +1,264 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <rocket/profiler.hpp>
+#include <rocket/runtime.hpp>
+#include "native.hpp"
+
+// Every thread owns one buffer and is its only writer, so recording a zone is a
+// store plus a release increment. Buffers are registered once per thread and
+// never freed, the zones of finished threads still end up in the trace.
+// Chunks are allocated by the owning thread as the capture grows.
+
+namespace rocket::profiler {
+    struct zone_t {
+        const char *name;
+        uint64_t start_ns;
+        uint64_t end_ns;
+    };
+
+    constexpr size_t zones_per_chunk = 16384;
+    constexpr size_t max_chunks = 64;
+
+    struct thread_buffer_t {
+        uint32_t tid = 0;
+        std::string thread_name;
+
+        /// @brief Capture this buffer was last written in, stale buffers are reset by their owner
+        std::atomic<uint64_t> generation = 0;
+        std::atomic<size_t> count = 0;
+        std::atomic<size_t> dropped = 0;
+        std::array<std::atomic<zone_t *>, max_chunks> chunks = {};
+
+        ~thread_buffer_t() {
+            for (auto &chunk : chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct profiler_state_t {
+        std::atomic_bool capturing = false;
+        std::atomic<uint64_t> generation = 0;
+        uint64_t capture_start_ns = 0;
+
+        std::mutex buffers_mutex;
+        std::vector<std::unique_ptr<thread_buffer_t>> buffers;
+
+        std::string exit_trace_path;
+        std::atomic_bool exit_trace_written = false;
+
+        ~profiler_state_t() {
+            write_exit_trace();
+        }
+
+        void write_exit_trace();
+    };
+
+    static profiler_state_t &get_state() {
+        static profiler_state_t state;
+        return state;
+    }
+
+    static thread_buffer_t *register_thread() {
+        auto buffer = std::make_unique<thread_buffer_t>();
+
+        char name[32] = {};
+        rnative::get_thread_name(name, sizeof(name));
+        buffer->thread_name = name;
+
+        profiler_state_t &state = get_state();
+        std::lock_guard<std::mutex> lock(state.buffers_mutex);
+        buffer->tid = static_cast<uint32_t>(state.buffers.size() + 1);
+        if (buffer->thread_name.empty()) {
+            buffer->thread_name = "thread " + std::to_string(buffer->tid);
+        }
+        state.buffers.push_back(std::move(buffer));
+        return state.buffers.back().get();
+    }
+
+    static thread_buffer_t &get_thread_buffer() {
+        thread_local thread_buffer_t *buffer = register_thread();
+        return *buffer;
+    }
+
+    uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count());
+    }
+
+    void record_zone(const char *name, uint64_t start_ns, uint64_t end_ns) {
+        profiler_state_t &state = get_state();
+        if (!state.capturing.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        thread_buffer_t &buffer = get_thread_buffer();
+        uint64_t generation = state.generation.load(std::memory_order_acquire);
+        if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            buffer.generation.store(generation, std::memory_order_release);
+        }
+
+        size_t index = buffer.count.load(std::memory_order_relaxed);
+        size_t chunk_index = index / zones_per_chunk;
+        if (chunk_index >= max_chunks) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        zone_t *chunk = buffer.chunks[chunk_index].load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new zone_t[zones_per_chunk];
+            buffer.chunks[chunk_index].store(chunk, std::memory_order_release);
+        }
+
+        chunk[index % zones_per_chunk] = { name, start_ns, end_ns };
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    void start_capture() {
+        profiler_state_t &state = get_state();
+        state.capture_start_ns = now_ns();
+        state.generation.fetch_add(1, std::memory_order_acq_rel);
+        state.capturing.store(true, std::memory_order_release);
+    }
+
+    void stop_capture() {
+        get_state().capturing.store(false, std::memory_order_release);
+    }
+
+    bool is_capturing() {
+        return get_state().capturing.load(std::memory_order_relaxed);
+    }
+
+    static void write_json_string(std::string &out, const char *str) {
+        out += '"';
+        for (const char *c = str; *c != '\0'; ++c) {
+            switch (*c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default: {
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        char esc[8];
+                        std::snprintf(esc, sizeof(esc), "\\u%04x", *c);
+                        out += esc;
+                    } else {
+                        out += *c;
+                    }
+                    break;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    static void write_microseconds(std::string &out, uint64_t ns) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%llu.%03llu",
+            static_cast<unsigned long long>(ns / 1000),
+            static_cast<unsigned long long>(ns % 1000));
+        out += buf;
+    }
+
+    static bool write_trace(profiler_state_t &state, const std::string &path) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            rocket::log("failed to open profiler trace: " + path, "rocket::profiler", "write_chrome_trace", "error");
+            return false;
+        }
+
+        uint64_t generation = state.generation.load(std::memory_order_acquire);
+        uint64_t origin = state.capture_start_ns;
+
+        std::string out;
+        out.reserve(1 << 20);
+        out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        size_t zones = 0, dropped = 0;
+
+        std::lock_guard<std::mutex> lock(state.buffers_mutex);
+        for (auto &buffer : state.buffers) {
+            if (buffer->generation.load(std::memory_order_acquire) != generation) {
+                continue;
+            }
+
+            if (!first) out += ',';
+            first = false;
+            out += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(buffer->tid) + ",\"args\":{\"name\":";
+            write_json_string(out, buffer->thread_name.c_str());
+            out += "}}";
+
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < count; ++i) {
+                const zone_t &zone = buffer->chunks[i / zones_per_chunk].load(std::memory_order_acquire)[i % zones_per_chunk];
+                if (zone.start_ns < origin) {
+                    continue;
+                }
+
+                out += ",\n{\"name\":";
+                write_json_string(out, zone.name);
+                out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(buffer->tid) + ",\"ts\":";
+                write_microseconds(out, zone.start_ns - origin);
+                out += ",\"dur\":";
+                write_microseconds(out, zone.end_ns - zone.start_ns);
+                out += '}';
+                zones++;
+            }
+
+            if (out.size() > (1 << 20)) {
+                file.write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+        }
+        out += "\n]}\n";
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        file.flush();
+
+        if (dropped != 0) {
+            rocket::log("profiler buffers were full, dropped " + std::to_string(dropped) + " zones", "rocket::profiler", "write_chrome_trace", "warn");
+        }
+        rocket::log("wrote " + std::to_string(zones) + " zones to " + path, "rocket::profiler", "write_chrome_trace", "info");
+        return static_cast<bool>(file);
+    }
+
+    bool write_chrome_trace(const std::string &path) {
+        return write_trace(get_state(), path);
+    }
+
+    void profiler_state_t::write_exit_trace() {
+        if (exit_trace_path.empty() || exit_trace_written.exchange(true)) {
+            return;
+        }
+        capturing.store(false, std::memory_order_release);
+        write_trace(*this, exit_trace_path);
+    }
+
+    void capture_until_exit(const std::string &path) {
+        if (!enabled()) {
+            rocket::log("built without ROCKETGE__PROFILER, the trace only contains zones from code built with it", "rocket::profiler", "capture_until_exit", "warn");
+        }
+
+        profiler_state_t &state = get_state();
+        state.exit_trace_path = path;
+        state.exit_trace_written.store(false);
+        start_capture();
+    }
+}
+
+namespace util {
+    void profiler_flush_at_exit() {
+        rocket::profiler::get_state().write_exit_trace();
+    }
+}
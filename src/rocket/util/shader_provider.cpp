@@ -1,6 +1,7 @@
 #include <rocket/runtime.hpp>
 #include <rocket/shader.hpp>
 #include <shader_provider.hpp>
+#include <atomic>
 #include <unordered_map>
 #include <resources/autogen_shader_includes.h>
 #include "rocket/macros.hpp"
@@ -16,6 +17,7 @@
 namespace rocket::globals {
     extern std::thread::id g_main_thread_id;
     extern bool g_main_thread_id_set;
+    extern std::atomic<std::thread::id> g_graphics_thread_id;
 }
 
 namespace rocket {
@@ -25,30 +27,61 @@ namespace rocket {
 #define CONCAT_IMPL(x, y) x##y
 #define CONCAT(x, y) CONCAT_IMPL(x, y)
 
-    rgl::shader_program_t gl_get_shader(shader_id_t shid) {
-        r_debug_if (rocket::globals::g_main_thread_id_set)
-            r_assert(globals::g_main_thread_id == std::this_thread::get_id() && "rocket::get_shader called on worker thread");
-        if (gl_shader_map.find(shid) != gl_shader_map.end())
-            return gl_shader_map[shid].glprogram;
+    /// @brief Entries of gl_shader_map that were submitted but not finished
+    static size_t gl_pending_shaders = 0;
 
+    static const char *gl_shader_source(shader_id_t shid) {
 #define SHADER_DISPATCH_ENTRY(name)                                      \
         if (shid == shader_id_t::name) {                                 \
-            gl_shader_map[shid] = opengl_shader_t(          \
-                shader_type::vert_frag,                                  \
-                std::string(rocket_resource::CONCAT(shader_, CONCAT(name, _rlsl))));  \
-            return gl_shader_map[shid].glprogram;                           \
+            return rocket_resource::CONCAT(shader_, CONCAT(name, _rlsl)); \
         }
 #include <resources/autogen_shader_dispatch.h>
 #undef SHADER_DISPATCH_ENTRY
 
         rocket::log("invalid shader_id given", "rocket", "get_shader", "fatal");
         rocket::exit(1);
-        return rGL_SHADER_INVALID;
+        return nullptr;
+    }
+
+    bool gl_finish_shader(opengl_shader_t &shader, bool wait) {
+        if (!shader.pending) {
+            return true;
+        }
+        if (!shader.shader_finish(wait)) {
+            return false;
+        }
+        gl_pending_shaders--;
+        rgl::bind_camera_block(shader.glprogram);
+        return true;
+    }
+
+    rgl::shader_program_t gl_get_shader(shader_id_t shid) {
+        r_debug_if (rocket::globals::g_main_thread_id_set)
+            r_assert(globals::g_graphics_thread_id.load() == std::this_thread::get_id() && "rocket::get_shader called on worker thread");
+        auto it = gl_shader_map.find(shid);
+        if (it != gl_shader_map.end()) {
+            // Submitted ahead, only this one is waited for
+            gl_finish_shader(it->second, true);
+            return it->second.glprogram;
+        }
+
+        opengl_shader_t &shader = gl_shader_map[shid] = opengl_shader_t(shader_type::vert_frag, std::string(gl_shader_source(shid)));
+        rgl::bind_camera_block(shader.glprogram);
+        return shader.glprogram;
+    }
+
+    rgl::shader_program_t gl_try_get_shader(shader_id_t shid) {
+        auto it = gl_shader_map.find(shid);
+        if (it == gl_shader_map.end()) {
+            // Never submitted, compiled on first use as before
+            return gl_get_shader(shid);
+        }
+        return gl_finish_shader(it->second, false) ? it->second.glprogram : rGL_SHADER_INVALID;
     }
 
     vk_shader_t vk_get_shader(shader_id_t shid) {
         r_debug_if (rocket::globals::g_main_thread_id_set)
-            r_assert(globals::g_main_thread_id == std::this_thread::get_id() && "rocket::get_shader called on worker thread");
+            r_assert(globals::g_graphics_thread_id.load() == std::this_thread::get_id() && "rocket::get_shader called on worker thread");
         if (vk_shader_map.find(shid) != vk_shader_map.end()) {
             auto *ren = util::get_global_renderer_2d();
             auto *vk_ren = dynamic_cast<vulkan_renderer_2d*>(ren);
@@ -86,6 +119,32 @@ namespace rocket {
         }
     }
 
+    void shader_provider_submit_all_gl() {
+        using namespace rocket_resource;
+        for (shader_id_t id : {SHADER_ID_LIST}) {
+            if (gl_shader_map.contains(id)) {
+                continue;
+            }
+            opengl_shader_t &shader = gl_shader_map[id] = opengl_shader_t(shader_type::vert_frag, std::string(gl_shader_source(id)), true);
+            if (shader.pending) {
+                gl_pending_shaders++;
+            } else {
+                // Came from the program cache
+                rgl::bind_camera_block(shader.glprogram);
+            }
+        }
+    }
+
+    bool shader_provider_poll_gl() {
+        if (gl_pending_shaders == 0) {
+            return true;
+        }
+        for (auto &[id, shader] : gl_shader_map) {
+            gl_finish_shader(shader, false);
+        }
+        return gl_pending_shaders == 0;
+    }
+
     void shader_provider_compile_all_vk() {
         using namespace rocket_resource;
         for (shader_id_t id : {SHADER_ID_LIST}) {
@@ -95,6 +154,7 @@ namespace rocket {
 
     void shader_provider_reset() {
         gl_shader_map.clear();
+        gl_pending_shaders = 0;
         vk_shader_map.clear();
     }
 }
@@ -1,6 +1,7 @@
 #ifdef ROCKETGE__Platform_Desktop
 #include <GLFW/glfw3.h>
 #endif
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <mutex>
@@ -14,6 +15,7 @@
 #include <rocket/threads.hpp>
 #include "intl_macros.hpp"
 #include "internal_types.hpp"
+#include "worker_pool.hpp"
 
 namespace rocket {
     r_static void thread_t::schedule(std::function<void()> fn) {
@@ -64,4 +66,14 @@ namespace rocket {
         ss << std::this_thread::get_id();
         return std::stoull(ss.str());
     }
+
+    worker_pool_t &get_job_pool() {
+        // Never destroyed, workers may already be gone when statics unwind at exit
+        static worker_pool_t *pool = [] {
+            auto *p = new worker_pool_t("rge-jobs");
+            p->start(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1);
+            return p;
+        }();
+        return *pool;
+    }
 }
@@ -7,12 +7,17 @@
 #endif
 
 #include "util.hpp"
+#include "data_structures.hpp"
 #include "rocket/io.hpp"
+#include "rocket/profiler.hpp"
 #include "rocket/runtime.hpp"
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <glm/trigonometric.hpp>
 #include <internal_types.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <rocket/renderer_helpers.hpp>
 #include <sstream>
@@ -29,10 +34,79 @@ static rocket::log_callback_t log_cb;
 
 static std::vector<std::function<void()>> on_close_listeners = {};
 
-static std::vector<std::function<void(rocket::io::key_event_t)>> _key_listeners = {};
-static std::vector<std::function<void(rocket::io::mouse_event_t)>> _mouse_listeners = {};
-static std::vector<std::function<void(rocket::io::mouse_move_event_t)>> _mouse_move_listeners = {};
-static std::vector<std::function<void(rocket::io::scroll_offset_event_t)>> _scroll_offset_listeners = {};
+/// @brief Flat listener table, removal is deferred while dispatching
+template<typename E>
+struct listener_table_t {
+    struct entry_t {
+        rocket::io::listener_id_t id = 0;
+        std::function<void(E)> fn;
+    };
+
+    std::vector<entry_t> entries;
+    /// @brief Added while dispatching, merged once the outermost dispatch returns
+    std::vector<entry_t> pending;
+    int depth = 0;
+    bool dirty = false;
+
+    void add(rocket::io::listener_id_t id, std::function<void(E)> fn) {
+        if (depth > 0) {
+            pending.push_back({ id, std::move(fn) });
+        } else {
+            entries.push_back({ id, std::move(fn) });
+        }
+    }
+
+    bool remove(rocket::io::listener_id_t id) {
+        for (auto *list : { &entries, &pending }) {
+            for (auto &e : *list) {
+                if (e.id != id || e.fn == nullptr) continue;
+                e.fn = nullptr;
+                dirty = true;
+                if (depth == 0) compact();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void dispatch(const E &event) {
+        depth++;
+        for (auto &e : entries) {
+            if (e.fn == nullptr) continue;
+            e.fn(event);
+        }
+        depth--;
+
+        if (depth == 0 && (dirty || !pending.empty())) {
+            compact();
+        }
+    }
+
+    void compact() {
+        std::erase_if(entries, [](const entry_t &e) { return e.fn == nullptr; });
+        for (auto &e : pending) {
+            if (e.fn == nullptr) continue;
+            entries.push_back(std::move(e));
+        }
+        pending.clear();
+        dirty = false;
+    }
+};
+
+static listener_table_t<rocket::io::key_event_t> _key_listeners;
+static listener_table_t<rocket::io::mouse_event_t> _mouse_listeners;
+static listener_table_t<rocket::io::mouse_move_event_t> _mouse_move_listeners;
+static listener_table_t<rocket::io::scroll_offset_event_t> _scroll_offset_listeners;
+static rocket::io::listener_id_t next_listener_id = 1;
+
+constexpr size_t async_input_queue_size = 1024;
+
+/// @brief Two frames of input, one being filled and one published
+static std::array<std::vector<rocket::io::input_event_t>, 2> input_frames;
+static size_t input_frame_published = 0;
+static uint64_t input_sequence = 0;
+/// @brief Events from other threads (gamepad polling)
+static rocket::mpsc_ring_t<rocket::io::input_event_t, async_input_queue_size> async_input_events;
 
 static std::unordered_map<rocket::io::keyboard_key, rocket::io::keystate_t> kstates;
 static std::unordered_map<rocket::io::mouse_button, rocket::io::keystate_t> mstates;
@@ -156,20 +230,71 @@ namespace util {
         return { color.x / 255.0f, color.y / 255.0f, color.z / 255.0f };
     }
 
-    std::vector<std::function<void(rocket::io::key_event_t)>> &key_listeners() {
-        return _key_listeners;
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::key_event_t)> fn) {
+        _key_listeners.add(next_listener_id, std::move(fn));
+        return next_listener_id++;
+    }
+
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_event_t)> fn) {
+        _mouse_listeners.add(next_listener_id, std::move(fn));
+        return next_listener_id++;
+    }
+
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::mouse_move_event_t)> fn) {
+        _mouse_move_listeners.add(next_listener_id, std::move(fn));
+        return next_listener_id++;
+    }
+
+    rocket::io::listener_id_t add_listener(std::function<void(rocket::io::scroll_offset_event_t)> fn) {
+        _scroll_offset_listeners.add(next_listener_id, std::move(fn));
+        return next_listener_id++;
+    }
+
+    bool remove_listener(rocket::io::listener_id_t id) {
+        return _key_listeners.remove(id)
+            || _mouse_listeners.remove(id)
+            || _mouse_move_listeners.remove(id)
+            || _scroll_offset_listeners.remove(id);
     }
 
-    std::vector<std::function<void(rocket::io::mouse_event_t)>> &mouse_listeners() {
-        return _mouse_listeners;
+    void record_input_event(rocket::io::input_event_t::data_t data, bool simulated) {
+        auto &frame = input_frames[input_frame_published ^ 1];
+        frame.push_back({ rocket::io::event_clock_ns(), 0, std::move(data), simulated });
     }
 
-    std::vector<std::function<void(rocket::io::mouse_move_event_t)>> &mouse_move_listeners() {
-        return _mouse_move_listeners;
+    void record_input_event_async(rocket::io::input_event_t::data_t data, uint64_t timestamp_ns) {
+        if (!async_input_events.try_push({ timestamp_ns, 0, std::move(data) })) {
+            rocket::log("async input queue full, event dropped", "util", "record_input_event_async", "warn");
+        }
+    }
+
+    void publish_input_frame() {
+        auto &frame = input_frames[input_frame_published ^ 1];
+
+        bool merged = false;
+        while (auto event = async_input_events.try_pop()) {
+            frame.push_back(std::move(*event));
+            merged = true;
+        }
+        merged |= input_replay_frame(frame);
+        // Main thread events are already in order, only the merged ones can be out of place
+        if (merged) {
+            std::stable_sort(frame.begin(), frame.end(), [](const rocket::io::input_event_t &a, const rocket::io::input_event_t &b) {
+                return a.timestamp_ns < b.timestamp_ns;
+            });
+        }
+        for (auto &event : frame) {
+            event.sequence = input_sequence++;
+        }
+
+        input_frame_published ^= 1;
+        input_frames[input_frame_published ^ 1].clear();
+
+        input_record_frame(input_frames[input_frame_published]);
     }
 
-    std::vector<std::function<void(rocket::io::scroll_offset_event_t)>> &scroll_offset_listeners() {
-        return _scroll_offset_listeners;
+    std::span<const rocket::io::input_event_t> get_input_frame() {
+        return input_frames[input_frame_published];
     }
 
     bool key_down(rocket::io::keyboard_key key) {
@@ -197,6 +322,9 @@ namespace util {
     }
 
     rocket::vec2<double> mouse_pos() {
+        if (input_replay_active()) {
+            return input_replay_mouse_pos();
+        }
 #ifndef ROCKETGE__Platform_Android
         double x, y;
         if (glfwGetCurrentContext() == nullptr) {
@@ -210,9 +338,7 @@ namespace util {
     }
 
     void dispatch_event(rocket::io::key_event_t event, bool addsm) {
-        for (auto l : _key_listeners) {
-            l(event);
-        }
+        _key_listeners.dispatch(event);
 
 
         if (addsm) {
@@ -221,18 +347,14 @@ namespace util {
     }
 
     void dispatch_event(rocket::io::mouse_event_t event, bool addsm) {
-        for (auto l : _mouse_listeners) {
-            l(event);
-        }
+        _mouse_listeners.dispatch(event);
         if (addsm) {
             simulated_mevents.push_back(event);
         }
     }
 
     void dispatch_event(rocket::io::mouse_move_event_t event, bool addsm) {
-        for (auto l : _mouse_move_listeners) {
-            l(event);
-        }
+        _mouse_move_listeners.dispatch(event);
 
         if (addsm) {
             simulated_mmevents.push_back(event);
@@ -240,28 +362,26 @@ namespace util {
     }
 
     void dispatch_event(rocket::io::scroll_offset_event_t event, bool addsm) {
-        for (auto l : _scroll_offset_listeners) {
-            l(event);
-        }
+        _scroll_offset_listeners.dispatch(event);
 
         if (addsm) {
             simulated_sevents.push_back(event);
         }
     }
 
-    std::vector<rocket::io::key_event_t> get_simulated_kevents() {
+    const std::vector<rocket::io::key_event_t> &get_simulated_kevents() {
         return simulated_kevents;
     }
 
-    std::vector<rocket::io::mouse_event_t> get_simulated_mevents() {
+    const std::vector<rocket::io::mouse_event_t> &get_simulated_mevents() {
         return simulated_mevents;
     }
 
-    std::vector<rocket::io::mouse_move_event_t> get_simulated_mmevents() {
+    const std::vector<rocket::io::mouse_move_event_t> &get_simulated_mmevents() {
         return simulated_mmevents;
     }
 
-    std::vector<rocket::io::scroll_offset_event_t> get_simulated_sevents() {
+    const std::vector<rocket::io::scroll_offset_event_t> &get_simulated_sevents() {
         return simulated_sevents;
     }
 
@@ -284,6 +404,21 @@ namespace util {
     }
 
     void io_update_end_frame() {
+        // Published first, a replay drives the key states below
+        publish_input_frame();
+
+        if (input_replay_active()) {
+            for (auto &k : kstates) {
+                k.second.previous = k.second.current;
+                k.second.current = input_replay_key_down(k.first);
+            }
+            for (auto &m : mstates) {
+                m.second.previous = m.second.current;
+                m.second.current = input_replay_mouse_down(m.first);
+            }
+            goto cleanup;
+        }
+
 #ifndef ROCKETGE__Platform_Android
         if (glfwGetCurrentContext() == nullptr) goto cleanup;
         for (auto &k : kstates) {
@@ -480,6 +615,8 @@ cleanup:
             return rocket::renderer_backend_t::opengl;
         } else if (rocket::instance_of<rocket::vulkan_renderer_2d>(ren)) {
             return rocket::renderer_backend_t::vulkan;
+        } else if (rocket::instance_of<rocket::software_renderer_2d>(ren)) {
+            return rocket::renderer_backend_t::software;
         } else if (rocket::instance_of<rocket::null_renderer_2d>(ren)) {
             return rocket::renderer_backend_t::null;
         } else {
@@ -487,14 +624,76 @@ cleanup:
         }
     }
 
-    void frame_timer_wait_for(
+    struct frame_pacer_t {
+        std::chrono::steady_clock::time_point deadline = {};
+        double period = 0;
+
+        /// @brief Wake-up latency of the OS sleep, mean and mean deviation
+        double latency_avg = 0.0005;
+        double latency_dev = 0.00025;
+    };
+
+    static frame_pacer_t pacer;
+
+#if defined(ROCKETGE__Platform_Windows)
+    constexpr double pacer_max_spin_window = 0.004;
+#else
+    constexpr double pacer_max_spin_window = 0.002;
+#endif
+    constexpr double pacer_min_spin_window = 0.00005;
+
+    /// @brief Sleep to an absolute deadline, only spinning through the learned wake-up latency
+    static double frame_pacer_wait(double frametime_limit, std::chrono::time_point<std::chrono::steady_clock> frame_start_time) {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(frametime_limit));
+
+        if (pacer.period != frametime_limit || pacer.deadline == clock::time_point{}) {
+            pacer.period = frametime_limit;
+            pacer.deadline = frame_start_time;
+        }
+        // Deadlines advance by a fixed period, frame start jitter does not accumulate
+        pacer.deadline += period;
+
+        auto now = clock::now();
+        if (pacer.deadline <= now) {
+            double late = std::chrono::duration<double>(now - pacer.deadline).count();
+            // Missed, resync instead of rushing the next frames to catch up
+            pacer.deadline = now;
+            return late;
+        }
+
+        double spin_window = std::clamp(pacer.latency_avg + 4 * pacer.latency_dev, pacer_min_spin_window, pacer_max_spin_window);
+        auto wake = pacer.deadline - std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(spin_window));
+        if (wake > now) {
+            rnative::sleep_until(wake);
+
+            double latency = std::chrono::duration<double>(clock::now() - wake).count();
+            double error = latency - pacer.latency_avg;
+            pacer.latency_avg += 0.125 * error;
+            pacer.latency_dev += 0.25 * (std::abs(error) - pacer.latency_dev);
+        }
+
+        while (clock::now() < pacer.deadline) {
+            rnative::intrin_cpu_minfreq();
+        }
+
+        return std::chrono::duration<double>(clock::now() - pacer.deadline).count();
+    }
+
+    double frame_timer_wait_for(
         double frame_duration, 
         double frametime_limit, 
         bool software_frame_timer, 
         int target_fps, 
         std::chrono::time_point<std::chrono::steady_clock> frame_start_time
     ) {
-        if (frame_duration < frametime_limit && true /* << Continue with Frametimer */) {
+        ROCKET_PROFILE_SCOPE("frame_timer_wait");
+        static const bool legacy_frame_timer = get_clistate().legacy_frame_timer;
+
+        double pacing_error = 0;
+        if (!software_frame_timer && !legacy_frame_timer) {
+            pacing_error = frame_pacer_wait(frametime_limit, frame_start_time);
+        } else if (frame_duration < frametime_limit && true /* << Continue with Frametimer */) {
             // Dynamically wait on Unix vs Win32
             // (Scheduler Differences)
             // Do not modify, took a very long time to tune it
@@ -526,6 +725,9 @@ cleanup:
             while (std::chrono::duration<double>(std::chrono::steady_clock::now() - frame_start_time).count() < frametime_limit) {
                 rnative::intrin_cpu_minfreq();
             }
+            pacing_error = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame_start_time).count() - frametime_limit;
+        } else {
+            pacing_error = frame_duration - frametime_limit;
         }
         
         if (target_fps < 2147483647) {
@@ -542,6 +744,8 @@ cleanup:
                 rocket::log("Frame took too long! (" + double_to_str(frame_duration * 1000., 2) + "ms)", "util", "frame_timer", "debug");
             }
         }
+
+        return pacing_error;
     }
 }
 
@@ -566,8 +770,13 @@ namespace rocket {
         };
         static std::shared_ptr<rocket::font_t> font = rGE__FONT_DEFAULT_MONOSPACED;
         rgl::frame_metrics_t fmetrics = rgl::get_frame_metrics();
-        rocket::text_t fps_avg_text = { "FPS: " + std::to_string(ren->get_current_fps()), text_size, rgb_color::white(), font };
-        rocket::text_t frametime_text = { "FrameTime: " + double_to_str(ren->get_draw_metrics().avg_frametime * 1000) + "ms", text_size, rgb_color::white(), font };
+        rgl::frame_stats_t fstats = rgl::get_frame_stats(240);
+        rocket::text_t fps_avg_text = { "FPS: " + std::to_string(ren->get_current_fps()) + " (1% low: " + std::to_string(static_cast<int>(fstats.low_1_percent_fps)) + ", " + std::to_string(fstats.hitches) + " hitches)", text_size, rgb_color::white(), font };
+        rgl::draw_metrics_t dmetrics = ren->get_draw_metrics();
+        rocket::text_t frametime_text = { "FrameTime: " + double_to_str(dmetrics.avg_frametime * 1000) + "ms (jitter " + double_to_str(dmetrics.avg_pacing_error * 1000, 3) + "ms)", text_size, rgb_color::white(), font };
+        if (rgl::is_gpu_timing_enabled()) {
+            frametime_text.text += " GPU: " + double_to_str(dmetrics.avg_gpu_frametime * 1000, 3) + "ms";
+        }
         rocket::text_t deltatime_text = { "DeltaTime: " + std::to_string(ren->get_delta_time()), text_size, rgb_color::white(), font };
         rocket::text_t drawcalls_text = { "Drawcalls: " + std::to_string(fmetrics.drawcalls) + " (" + std::to_string(fmetrics.skipped_drawcalls) + " skipped)", text_size, rgb_color::white(), font };
 
@@ -582,6 +791,9 @@ namespace rocket {
         }
 
         renderer_backend_t backend = __r2d_get_window(ren)->get_flags().graphics_ctx.backend;
+        if (util::get_renderer_backend(ren) == renderer_backend_t::software) {
+            backend = renderer_backend_t::software;
+        }
         std::string fbo_active = "N/A";
         if (backend == renderer_backend_t::opengl) {
             fbo_active = rgl::is_active_any_fbo() ? "Yes" : "No";
@@ -687,6 +899,8 @@ namespace rocket {
                 + gl_version;
         } else if (backend == renderer_backend_t::vulkan) {
             api_str = "Vulkan " "6.7"; // TODO: Implement Vk version checking
+        } else if (backend == renderer_backend_t::software) {
+            api_str = "Software 1";
         } else if (backend == renderer_backend_t::null) {
             api_str = "Null 1";
         } else {
@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <rocket/audio.hpp>
+#include <rocket/runtime.hpp>
+#include <string>
+#include <vector>
+
+static rocket::audio::buffer_t make_sine(int sample_rate, float freq, float seconds) {
+    rocket::audio::buffer_t buffer;
+    buffer.format = rocket::audio::format_t::mono16;
+    buffer.sample_rate = sample_rate;
+    int frames = static_cast<int>(sample_rate * seconds);
+    buffer.samples.reserve(frames);
+    for (int i = 0; i < frames; ++i) {
+        buffer.samples.push_back(static_cast<int16_t>(16000.f * std::sin(2.f * 3.14159265f * freq * i / sample_rate)));
+    }
+    return buffer;
+}
+
+static std::vector<float> render(rocket::audio::resampler_t resampler, const rocket::audio::buffer_t &buffer, bool &finished) {
+    std::vector<float> out;
+    rocket::audio::mixer_config_t config;
+    config.resampler = resampler;
+    config.sink = rocket::audio::sink_type_t::callback;
+    config.callback = [&out](const float *frames, size_t count) {
+        out.insert(out.end(), frames, frames + count * 2);
+    };
+
+    rocket::audio::software_mixer_t mixer(config);
+    auto pcm = mixer.upload(buffer);
+    mixer.play(pcm, 1.f, 0.f, false, [&finished]() { finished = true; });
+    mixer.process(200);
+    return out;
+}
+
+int main(int argc, char **argv) {
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    // No main loop here, run callbacks where the mixer finishes voices
+    rocket::audio::set_service_config({ .callback_thread = rocket::audio::callback_thread_t::audio });
+
+    // 44.1kHz source into the 48kHz mixer, has to resample
+    auto sine = make_sine(44100, 440.f, 0.5f);
+
+    int failures = 0;
+    for (auto resampler : { rocket::audio::resampler_t::linear, rocket::audio::resampler_t::cubic }) {
+        bool finished_a = false, finished_b = false;
+        auto a = render(resampler, sine, finished_a);
+        auto b = render(resampler, sine, finished_b);
+
+        if (a != b) {
+            std::cerr << "mixer output is not deterministic\n";
+            failures++;
+        }
+        if (!finished_a || !finished_b) {
+            std::cerr << "finish callback did not fire\n";
+            failures++;
+        }
+        for (size_t i = 0; i + 1 < a.size(); i += 2) {
+            if (a[i] != a[i + 1]) {
+                std::cerr << "centered mono voice is not balanced at frame " << i / 2 << '\n';
+                failures++;
+                break;
+            }
+        }
+    }
+
+    // Throughput: how many voices one core mixes in real time
+    {
+        rocket::audio::software_mixer_t mixer;
+        auto pcm = mixer.upload(sine);
+        const int voices = 256;
+        for (int i = 0; i < voices; ++i) {
+            mixer.play(pcm, 0.01f, (i % 3) - 1.f, true);
+        }
+
+        const size_t blocks = 1000;
+        auto start = std::chrono::steady_clock::now();
+        mixer.process(blocks);
+        std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+
+        double audio_seconds = static_cast<double>(mixer.get_frames_processed()) / mixer.get_config().sample_rate;
+        double realtime_voices = voices * audio_seconds / took.count();
+        if (!test_mode) {
+            std::cout << "mixed " << voices << " voices, " << audio_seconds << "s of audio in " << took.count()
+                << "s (~" << static_cast<int>(realtime_voices) << " voices per core)\n";
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include "rocket/camera.hpp"
+#include "rocket/culling.hpp"
+#include "rocket/headless.hpp"
+#include "rocket/render_thread.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <rocket/runtime.hpp>
+
+static bool all_black(const std::vector<rocket::rgba_color> &pixels) {
+    for (auto &p : pixels) {
+        if (p.x != 0 || p.y != 0 || p.z != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool near(rocket::vec2f_t a, rocket::vec2f_t b) {
+    return std::fabs(a.x - b.x) < 1e-3f && std::fabs(a.y - b.y) < 1e-3f;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    const rocket::vec2f_t viewport = { 240, 160 };
+    int failures = 0;
+
+    rocket::headless_renderer_t headless({ 240, 160 });
+    rocket::renderer_2d_i &r = *headless.get_renderer();
+
+    {
+        // world_to_screen and screen_to_world undo each other
+        rocket::camera_2d cam;
+        cam.position = { 37, -12 };
+        cam.zoom = 1.5f;
+        cam.rotation = 30.f;
+        for (rocket::vec2f_t p : { rocket::vec2f_t{ 0, 0 }, rocket::vec2f_t{ 120, 80 }, rocket::vec2f_t{ -55, 310 } }) {
+            if (!near(cam.world_to_screen(cam.screen_to_world(p, viewport), viewport), p)) {
+                std::cerr << "screen_to_world is not the inverse of world_to_screen\n";
+                failures++;
+            }
+        }
+        if (!near(cam.world_to_screen(cam.position, viewport), { viewport.x / 2, viewport.y / 2 })) {
+            std::cerr << "camera position is not at the viewport center\n";
+            failures++;
+        }
+    }
+
+    rocket::camera_2d cam;
+    cam.position = { 100, 60 };
+    cam.zoom = 2.f;
+    r.set_camera(&cam);
+
+    // Zoom 2 around (100, 60): world (90, 50) lands on screen (100, 60)
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    r.draw_rectangle({ { 100, 60 }, { 20, 20 } }, { 255, 0, 0, 255 });
+    r.draw_circle({ 140, 80 }, 12, { 0, 255, 0, 255 });
+    r.end_frame();
+    std::vector<rocket::rgba_color> expected = r.get_framebuffer();
+
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    r.begin_render_mode(rocket::render_mode_t::camera);
+    r.draw_rectangle({ { 90, 50 }, { 10, 10 } }, { 255, 0, 0, 255 });
+    r.draw_circle({ 110, 60 }, 6, { 0, 255, 0, 255 });
+    r.end_render_mode(rocket::render_mode_t::camera);
+    r.end_frame();
+    if (!rocket::compare_images(expected, r.get_framebuffer(), headless.get_size()).identical()) {
+        std::cerr << "camera draw differs from the transformed screen draw\n";
+        failures++;
+    }
+
+    // Outside camera mode draws stay in screen space
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    r.draw_rectangle({ { 50, 30 }, { 10, 10 } }, { 255, 0, 0, 255 });
+    r.end_frame();
+    std::vector<rocket::rgba_color> screen_space = r.get_framebuffer();
+    if (screen_space[35 * 240 + 55].x != 255) {
+        std::cerr << "screen space draw was moved by the camera\n";
+        failures++;
+    }
+
+    // Culling uses the camera's world bounds, not the screen
+    cam.position = { 1000, 1000 };
+    cam.zoom = 1.f;
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    r.begin_render_mode(rocket::render_mode_t::camera);
+    r.draw_rectangle({ { 10, 10 }, { 20, 20 } }, { 255, 0, 0, 255 });
+    r.end_render_mode(rocket::render_mode_t::camera);
+    r.end_frame();
+    if (!all_black(r.get_framebuffer())) {
+        std::cerr << "draw outside the camera was not culled\n";
+        failures++;
+    }
+
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    r.begin_render_mode(rocket::render_mode_t::camera);
+    r.draw_rectangle({ { 990, 990 }, { 20, 20 } }, { 255, 0, 0, 255 });
+    r.end_render_mode(rocket::render_mode_t::camera);
+    r.end_frame();
+    if (r.get_framebuffer()[80 * 240 + 120].x != 255) {
+        std::cerr << "draw inside the camera was culled\n";
+        failures++;
+    }
+
+    {
+        // Wrappers cull on the caller's thread, they need the camera state too
+        rocket::threaded_renderer_2d threaded(headless.get_renderer());
+        rocket::cull_soa_t bounds;
+        bounds.push({ { 10, 10 }, { 20, 20 } });
+        bounds.push({ { 990, 990 }, { 20, 20 } });
+        std::vector<uint32_t> visible;
+        threaded.begin_frame();
+        threaded.begin_render_mode(rocket::render_mode_t::camera);
+        threaded.cull_visible(bounds, visible);
+        threaded.end_render_mode(rocket::render_mode_t::camera);
+        threaded.end_frame();
+        if (visible.size() != 1 || visible[0] != 1) {
+            std::cerr << "threaded renderer culled against the viewport in camera mode\n";
+            failures++;
+        }
+    }
+
+    r.set_camera(nullptr);
+    r.close();
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
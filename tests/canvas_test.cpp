@@ -0,0 +1,130 @@
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+static bool same(rocket::rgba_color a, rocket::rgba_color b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static size_t dirty_area(const rocket::framebuffer_canvas_t &canvas) {
+    size_t area = 0;
+    for (auto &rect : canvas.get_dirty_rects()) {
+        area += static_cast<size_t>(rect.w) * rect.h;
+    }
+    return area;
+}
+
+static int test_dirty_tracking() {
+    int failures = 0;
+    rocket::framebuffer_canvas_t canvas;
+    canvas.resize({ 100, 100 });
+    if (canvas.get_dirty_rects().size() != 1 || dirty_area(canvas) != 100 * 100) {
+        std::cerr << "resize does not dirty the whole canvas\n";
+        failures++;
+    }
+
+    canvas.clear_dirty();
+    canvas.mark_dirty(rocket::canvas_rect_t { 10, 10, 5, 5 });
+    canvas.mark_dirty(rocket::canvas_rect_t { 50, 50, 5, 5 });
+    if (canvas.get_dirty_rects().size() != 2 || dirty_area(canvas) != 50) {
+        std::cerr << "separate regions were merged\n";
+        failures++;
+    }
+
+    // Overlaps the first one, both become their bounds
+    canvas.mark_dirty(rocket::canvas_rect_t { 12, 12, 5, 5 });
+    if (canvas.get_dirty_rects().size() != 2 || dirty_area(canvas) != 49 + 25) {
+        std::cerr << "overlapping regions were not merged\n";
+        failures++;
+    }
+
+    canvas.clear_dirty();
+    canvas.mark_dirty(rocket::canvas_rect_t { 90, 90, 50, 50 });
+    canvas.mark_dirty(rocket::canvas_rect_t { -10, -10, 5, 5 });
+    if (canvas.get_dirty_rects().size() != 1 || dirty_area(canvas) != 100) {
+        std::cerr << "regions are not clamped to the canvas\n";
+        failures++;
+    }
+
+    canvas.clear_dirty();
+    for (size_t i = 0; i <= rocket::framebuffer_canvas_t::max_dirty_rects; ++i) {
+        canvas.mark_dirty(rocket::canvas_rect_t { static_cast<int>(i) * 5, static_cast<int>(i) * 5, 1, 1 });
+    }
+    if (canvas.get_dirty_rects().size() != 1) {
+        std::cerr << "too many regions did not collapse\n";
+        failures++;
+    }
+
+    canvas.at(3, 4) = rocket::rgba_color::blue();
+    canvas.resize({ 50, 60 });
+    if (!same(canvas.at(3, 4), rocket::rgba_color::blue()) || dirty_area(canvas) != 50 * 60) {
+        std::cerr << "resize lost pixels or did not dirty the canvas\n";
+        failures++;
+    }
+    return failures;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    int failures = test_dirty_tracking();
+
+    rocket::window_t window = { {640, 360}, "RocketGE - Canvas Test" };
+    rocket::renderer_2d r(&window, 60, {
+        .show_splash = !test_mode
+    });
+
+    for (int frame = 0; frame < 3 && window.is_running(); ++frame) {
+        r.begin_frame();
+        r.clear(rocket::rgba_color::white());
+
+        rocket::framebuffer_canvas_t &canvas = r.get_canvas();
+        rocket::vec2f_t vp = r.get_viewport_size();
+        if (canvas.get_size().x != static_cast<int>(vp.x) || canvas.get_size().y != static_cast<int>(vp.y)) {
+            std::cerr << "canvas does not match the viewport\n";
+            failures++;
+            break;
+        }
+
+        if (frame == 0) {
+            canvas.fill(rocket::rgba_color::red());
+        } else if (frame == 1) {
+            // Only this region changes, the rest must stay from frame 0
+            for (int y = 20; y < 30; ++y) {
+                for (int x = 40; x < 60; ++x) {
+                    canvas.at(x, y) = rocket::rgba_color::blue();
+                }
+            }
+            canvas.mark_dirty(rocket::canvas_rect_t { 40, 20, 20, 10 });
+        }
+        r.push_canvas();
+
+        if (canvas.is_dirty()) {
+            std::cerr << "push_canvas did not consume the dirty regions\n";
+            failures++;
+        }
+
+        if (frame >= 1) {
+            std::vector<rocket::rgba_color> pixels = r.get_framebuffer();
+            const int width = canvas.get_size().x;
+            if (!same(pixels[25 * width + 50], rocket::rgba_color::blue()) || !same(pixels[5 * width + 5], rocket::rgba_color::red())) {
+                std::cerr << "canvas was not drawn (frame " << frame << ")\n";
+                failures++;
+            }
+        }
+
+        r.end_frame();
+        window.poll_events();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,175 @@
+#include "rocket/command_bucket.hpp"
+#include "rocket/headless.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <rocket/runtime.hpp>
+
+struct test_draw_t {
+    uint64_t key;
+    rocket::fbounding_box rect;
+    rocket::rgba_color color;
+};
+
+// Deterministic per-thread draws, layers and depths overlap across threads.
+// Within a layer a bucket's draws follow the buckets submitted before it
+static std::vector<test_draw_t> make_draws(uint32_t seed, int count) {
+    std::vector<test_draw_t> draws;
+    uint32_t state = seed * 2654435761u + 1;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    for (int i = 0; i < count; ++i) {
+        const uint8_t layer = static_cast<uint8_t>(next() % 4);
+        const uint32_t depth = next() % 70000;
+        draws.push_back({
+            rocket::sort_key_t::make(rocket::sort_key_t::pass_screen, layer, seed, 0, 0, depth),
+            { { static_cast<float>(next() % 200), static_cast<float>(next() % 120) }, { 24, 24 } },
+            { static_cast<uint8_t>(next()), static_cast<uint8_t>(next()), static_cast<uint8_t>(next()), 255 },
+        });
+    }
+    return draws;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    constexpr int thread_count = 4;
+    constexpr int draws_per_thread = 600;
+    int failures = 0;
+
+    rocket::headless_renderer_t headless({ 240, 160 });
+    rocket::renderer_2d_i &r = *headless.get_renderer();
+
+    std::vector<std::vector<test_draw_t>> draws;
+    for (int t = 0; t < thread_count; ++t) {
+        draws.push_back(make_draws(static_cast<uint32_t>(t), draws_per_thread));
+    }
+
+    // Reference: everything in submission order, stable sorted by key
+    std::vector<test_draw_t> sorted;
+    for (auto &d : draws) {
+        sorted.insert(sorted.end(), d.begin(), d.end());
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const test_draw_t &a, const test_draw_t &b) { return a.key < b.key; });
+
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    for (auto &d : sorted) {
+        r.draw_rectangle(d.rect, d.color);
+    }
+    r.end_frame();
+    std::vector<rocket::rgba_color> expected = r.get_framebuffer();
+
+    // Same draws recorded on worker threads
+    for (int frame = 0; frame < 2; ++frame) {
+        std::vector<rocket::command_bucket_t> buckets(thread_count);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < thread_count; ++t) {
+            workers.emplace_back([&buckets, &draws, t]() {
+                for (auto &d : draws[t]) {
+                    buckets[t].set_layer(rocket::sort_key_t::get_layer(d.key));
+                    buckets[t].set_depth(rocket::sort_key_t::get_depth(d.key));
+                    buckets[t].draw_rectangle(d.rect, d.color);
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        for (auto &b : buckets) {
+            r.submit_bucket(b);
+            if (!b.empty()) {
+                std::cerr << "bucket was not emptied by submit\n";
+                failures++;
+            }
+        }
+        r.end_frame();
+        if (!rocket::compare_images(expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << "sorted bucket frame " << frame << " differs\n";
+            failures++;
+        }
+    }
+
+    {
+        // Overlapping draws with different shaders keep their recording order in a layer,
+        // a render cache is filled before the screen samples it
+        rocket::render_cache_t *cache = r.create_render_cache([](rocket::renderer_2d_i *ren) {
+            ren->clear({ 0, 0, 0, 0 });
+        });
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.draw_circle({ 40, 40 }, 25, { 0, 0, 255, 255 });
+        r.draw_rectangle({ { 10, 10 }, { 60, 60 } }, { 255, 0, 0, 255 });
+        r.draw_circle({ 150, 120 }, 10, { 0, 255, 0, 255 });
+        r.begin_render_cache(cache);
+        r.draw_rectangle({ { 0, 0 }, { 20, 20 } }, { 255, 0, 255, 255 });
+        r.end_render_cache(cache);
+        r.draw_render_cache(cache, { { 100, 10 }, r.get_viewport_size() });
+        r.end_frame();
+        std::vector<rocket::rgba_color> mixed_expected = r.get_framebuffer();
+        r.invalidate_render_cache(cache);
+
+        rocket::command_bucket_t bucket;
+        bucket.draw_circle({ 40, 40 }, 25, { 0, 0, 255, 255 });
+        bucket.draw_rectangle({ { 10, 10 }, { 60, 60 } }, { 255, 0, 0, 255 });
+        bucket.draw_circle({ 150, 120 }, 10, { 0, 255, 0, 255 });
+        bucket.draw_render_cache(cache, { { 100, 10 }, r.get_viewport_size() });
+        bucket.set_target(cache);
+        bucket.draw_rectangle({ { 0, 0 }, { 20, 20 } }, { 255, 0, 255, 255 });
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.submit_bucket(bucket);
+        r.end_frame();
+        if (!rocket::compare_images(mixed_expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << "mixed bucket frame differs\n";
+            failures++;
+        }
+        r.destroy_render_cache(cache);
+    }
+
+    {
+        // Runs of one bucket never interleave with the runs of another
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.draw_rectangle({ { 20, 20 }, { 60, 60 } }, { 255, 0, 0, 255 });
+        r.draw_circle({ 50, 50 }, 25, { 0, 0, 255, 255 });
+        r.draw_rectangle({ { 40, 40 }, { 60, 60 } }, { 0, 255, 0, 255 });
+        r.draw_circle({ 90, 90 }, 20, { 255, 255, 0, 255 });
+        r.end_frame();
+        std::vector<rocket::rgba_color> overlap_expected = r.get_framebuffer();
+
+        rocket::command_bucket_t first;
+        first.draw_rectangle({ { 20, 20 }, { 60, 60 } }, { 255, 0, 0, 255 });
+        first.draw_circle({ 50, 50 }, 25, { 0, 0, 255, 255 });
+        rocket::command_bucket_t second;
+        second.draw_rectangle({ { 40, 40 }, { 60, 60 } }, { 0, 255, 0, 255 });
+        second.draw_circle({ 90, 90 }, 20, { 255, 255, 0, 255 });
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.submit_bucket(first);
+        r.submit_bucket(second);
+        r.end_frame();
+        if (!rocket::compare_images(overlap_expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << "overlapping buckets interleaved their runs\n";
+            failures++;
+        }
+    }
+
+    r.close();
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,170 @@
+#include "rocket/command_bucket.hpp"
+#include "rocket/culling.hpp"
+#include "rocket/headless.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <cmath>
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+// Scalar reference, rotated rects are tested by the square around their circle
+static std::vector<uint32_t> reference_cull(const rocket::cull_soa_t &bounds, rocket::fbounding_box view) {
+    std::vector<uint32_t> visible;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        rocket::fbounding_box rect = { { bounds.x[i], bounds.y[i] }, { bounds.w[i], bounds.h[i] } };
+        if (!bounds.rotation.empty() && bounds.rotation[i] != 0.f) {
+            const float half = 0.5f * std::sqrt(rect.size.x * rect.size.x + rect.size.y * rect.size.y);
+            const float cx = rect.pos.x + rect.size.x * 0.5f;
+            const float cy = rect.pos.y + rect.size.y * 0.5f;
+            rect = { { cx - half, cy - half }, { half + half, half + half } };
+        }
+        if (rect.intersects(view)) {
+            visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return visible;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+    int failures = 0;
+
+    {
+        // Odd count so every SIMD width ends in the scalar tail
+        const rocket::fbounding_box view = { { 0, 0 }, { 1280, 720 } };
+        rocket::cull_soa_t bounds;
+        uint32_t state = 12345;
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        };
+        for (int i = 0; i < 100003; ++i) {
+            const rocket::fbounding_box rect = {
+                { static_cast<float>(next() % 4000) - 1500.f, static_cast<float>(next() % 3000) - 1100.f },
+                { static_cast<float>(next() % 200), static_cast<float>(next() % 200) }
+            };
+            bounds.push(rect, i % 5 == 0 ? static_cast<float>(next() % 360) : 0.f);
+        }
+        // Edges touching the view are outside, like fbounding_box::intersects
+        bounds.push({ { -50, 10 }, { 50, 10 } });
+        bounds.push({ { 1280, 10 }, { 50, 10 } });
+        bounds.push({ { 10, -10 }, { 10, 10.5f } });
+
+        std::vector<uint32_t> visible;
+        rocket::cull_rects(bounds, view, visible);
+        if (visible != reference_cull(bounds, view)) {
+            std::cerr << "bulk cull differs from the scalar reference\n";
+            failures++;
+        }
+
+        rocket::cull_soa_t unrotated;
+        unrotated.push({ { 10, 10 }, { 5, 5 } });
+        unrotated.push({ { 2000, 10 }, { 5, 5 } });
+        if (!unrotated.rotation.empty()) {
+            std::cerr << "rotation array filled without rotated rects\n";
+            failures++;
+        }
+        rocket::cull_rects(unrotated, view, visible);
+        if (visible != std::vector<uint32_t>{ 0 }) {
+            std::cerr << "unrotated cull kept the wrong rects\n";
+            failures++;
+        }
+    }
+
+    {
+        // Every path the CPU has against the reference and the scalar path,
+        // counts around each SIMD width hit every tail length
+        const rocket::fbounding_box view = { { -20, -10 }, { 300, 200 } };
+        const rocket::cull_path_t paths[] = { rocket::cull_path_t::sse2, rocket::cull_path_t::avx2, rocket::cull_path_t::neon };
+        uint32_t state = 777;
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        };
+        for (size_t count = 0; count <= 67; ++count) {
+            rocket::cull_soa_t bounds;
+            for (size_t i = 0; i < count; ++i) {
+                const rocket::fbounding_box rect = {
+                    { static_cast<float>(next() % 600) - 200.f, static_cast<float>(next() % 400) - 150.f },
+                    { static_cast<float>(next() % 80), static_cast<float>(next() % 80) }
+                };
+                bounds.push(rect, i % 3 == 0 ? static_cast<float>(next() % 360) : 0.f);
+            }
+
+            std::vector<uint32_t> scalar;
+            rocket::set_cull_path(rocket::cull_path_t::scalar);
+            rocket::cull_rects(bounds, view, scalar);
+            if (scalar != reference_cull(bounds, view)) {
+                std::cerr << "scalar cull differs from the reference for " << count << " rects\n";
+                failures++;
+            }
+            for (rocket::cull_path_t path : paths) {
+                if (!rocket::set_cull_path(path)) {
+                    continue;
+                }
+                std::vector<uint32_t> visible;
+                rocket::cull_rects(bounds, view, visible);
+                if (visible != scalar) {
+                    std::cerr << "cull path " << static_cast<int>(path) << " differs from scalar for " << count << " rects\n";
+                    failures++;
+                }
+            }
+        }
+        rocket::set_cull_path(rocket::cull_path_t::automatic);
+    }
+
+    {
+        // Command buckets cull in bulk before sorting, the frame must not change
+        rocket::headless_renderer_t headless({ 160, 120 });
+        rocket::renderer_2d_i &r = *headless.get_renderer();
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.draw_rectangle({ { 10, 10 }, { 30, 30 } }, { 255, 0, 0, 255 });
+        r.draw_rectangle({ { 150, 50 }, { 40, 40 } }, { 0, 255, 0, 255 }, 45.f);
+        r.draw_circle({ 80, 118 }, 10, { 0, 0, 255, 255 });
+        r.end_frame();
+        std::vector<rocket::rgba_color> expected = r.get_framebuffer();
+
+        rocket::command_bucket_t bucket;
+        for (int i = 0; i < 64; ++i) {
+            bucket.draw_rectangle({ { -500.f - i * 10.f, 10 }, { 30, 30 } }, { 255, 255, 255, 255 });
+            bucket.draw_circle({ 80, 400.f + i }, 10, { 255, 255, 255, 255 });
+        }
+        bucket.draw_rectangle({ { 10, 10 }, { 30, 30 } }, { 255, 0, 0, 255 });
+        bucket.draw_rectangle({ { 150, 50 }, { 40, 40 } }, { 0, 255, 0, 255 }, 45.f);
+        bucket.draw_circle({ 80, 118 }, 10, { 0, 0, 255, 255 });
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        r.submit_bucket(bucket);
+        r.end_frame();
+        if (!rocket::compare_images(expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << "culled bucket frame differs\n";
+            failures++;
+        }
+
+        rocket::graphics_settings_t settings = r.get_graphics_settings();
+        settings.viewport_culling = false;
+        r.set_graphics_settings(settings);
+        rocket::cull_soa_t offscreen;
+        offscreen.push({ { -100, -100 }, { 10, 10 } });
+        std::vector<uint32_t> visible;
+        r.begin_frame();
+        r.cull_visible(offscreen, visible);
+        r.end_frame();
+        if (visible.size() != 1) {
+            std::cerr << "cull_visible culled with viewport culling off\n";
+            failures++;
+        }
+
+        r.close();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
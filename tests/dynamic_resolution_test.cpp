@@ -0,0 +1,92 @@
+#include "rocket/dynamic_resolution.hpp"
+#include <deque>
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+    int failures = 0;
+    const float budget = 1.f / 60.f;
+
+    {
+        // Fill-bound scene at 30 fps native, GPU times arrive 3 frames late
+        rocket::dynamic_resolution_controller_t controller;
+        std::deque<float> in_flight;
+        float heavy = 0.f;
+        float light = 0.f;
+        for (int frame = 0; frame < 1000; ++frame) {
+            const float per_pixel = frame < 400 ? 0.030f : 0.008f;
+            const float scale = controller.get_scale();
+            in_flight.push_back(0.002f + per_pixel * scale * scale);
+            float gpu_time = 0.f;
+            if (in_flight.size() > 3) {
+                gpu_time = in_flight.front();
+                in_flight.pop_front();
+            }
+            controller.update(gpu_time, budget, 0.5f, 1.f);
+            if (frame == 399) {
+                heavy = controller.get_scale();
+            }
+            if (frame == 999) {
+                light = controller.get_scale();
+            }
+        }
+        const float heavy_time = 0.002f + 0.030f * heavy * heavy;
+        if (heavy >= 1.f || heavy_time > budget) {
+            std::cerr << "scale " << heavy << " does not hold 60 fps\n";
+            failures++;
+        }
+        if (heavy < 0.55f) {
+            std::cerr << "scale " << heavy << " dropped further than needed\n";
+            failures++;
+        }
+        if (light != 1.f) {
+            std::cerr << "scale " << light << " did not recover once the load went away\n";
+            failures++;
+        }
+    }
+
+    {
+        // Never leaves the configured range, however slow the frames
+        rocket::dynamic_resolution_controller_t controller;
+        for (int frame = 0; frame < 200; ++frame) {
+            controller.update(1.f, budget, 0.6f, 0.9f);
+        }
+        if (controller.get_scale() != 0.6f) {
+            std::cerr << "expected the minimum scale, got " << controller.get_scale() << "\n";
+            failures++;
+        }
+        for (int frame = 0; frame < 2000; ++frame) {
+            controller.update(0.001f, budget, 0.6f, 0.9f);
+        }
+        if (controller.get_scale() > 0.9f) {
+            std::cerr << "scale went over the maximum: " << controller.get_scale() << "\n";
+            failures++;
+        }
+    }
+
+    {
+        // Steady load just under budget does not oscillate
+        rocket::dynamic_resolution_controller_t controller;
+        int changes = 0;
+        float last = controller.get_scale();
+        for (int frame = 0; frame < 600; ++frame) {
+            controller.update(budget * 0.8f, budget, 0.5f, 1.f);
+            if (controller.get_scale() != last) {
+                changes++;
+                last = controller.get_scale();
+            }
+        }
+        if (changes != 0) {
+            std::cerr << "scale changed " << changes << " times under a steady load\n";
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
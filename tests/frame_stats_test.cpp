@@ -0,0 +1,54 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <rocket/rgl.hpp>
+#include <rocket/runtime.hpp>
+#include <string>
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "rocket_frame_stats_test.csv";
+    if (!rgl::start_frame_export(path.string(), rgl::frame_export_format_t::csv)) {
+        return 1;
+    }
+
+    // 1..100ms with two 250ms hitches
+    rgl::set_frame_history_capacity(128);
+    for (int i = 1; i <= 100; ++i) {
+        rgl::push_frame_record({ .frame = static_cast<uint64_t>(i), .cpu_time = i / 1000.f, .wait_time = 0.f });
+    }
+    rgl::push_frame_record({ .frame = 101, .cpu_time = 0.25f });
+    rgl::push_frame_record({ .frame = 102, .cpu_time = 0.25f });
+    rgl::stop_frame_export();
+
+    int failures = 0;
+    auto expect = [&failures](bool ok, const std::string &what) {
+        if (!ok) {
+            std::cerr << "failed: " << what << '\n';
+            failures++;
+        }
+    };
+
+    rgl::frame_stats_t all = rgl::get_frame_stats();
+    expect(all.frames == 102, "frame count");
+    expect(std::abs(all.frame_time.p50 - 0.051f) < 1e-6f, "p50");
+    expect(std::abs(all.frame_time.max - 0.25f) < 1e-6f, "max");
+    expect(all.hitches == 2, "hitch count");
+    expect(std::abs(all.low_1_percent_fps - 4.f) < 1e-3f, "1% low");
+
+    rgl::frame_stats_t last = rgl::get_frame_stats(2);
+    expect(last.frames == 2 && last.frame_time.p50 == 0.25f, "window");
+
+    std::ifstream in(path);
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);) lines++;
+    expect(lines == 103, "exported rows");
+    in.close();
+    std::filesystem::remove(path);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+static bool same(rocket::rgba_color a, rocket::rgba_color b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static rocket::rgba_color at(const rocket::framebuffer_readback_t &readback, int x, int y) {
+    return readback.pixels[static_cast<size_t>(y) * readback.size.x + x];
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    rocket::window_t window = { {640, 360}, "RocketGE - Framebuffer Readback Test" };
+    rocket::renderer_2d r(&window, 60, {
+        .show_splash = !test_mode
+    });
+
+    const rocket::fbounding_box blue_rect = { { 100, 50 }, { 40, 30 } };
+    int failures = 0;
+
+    rocket::framebuffer_readback_t full, roi;
+    bool got_full = false, got_roi = false;
+    std::vector<rocket::rgba_color> sync;
+    rocket::api_object_t texture_a = 0, texture_b = 0;
+    uint64_t requested_frame = 0;
+
+    for (int frame = 0; frame < 30 && window.is_running() && !(got_full && got_roi); ++frame) {
+        r.begin_frame();
+        r.clear(rocket::rgba_color::red());
+        r.draw_rectangle(blue_rect, rocket::rgba_color::blue());
+
+        if (frame == 0) {
+            requested_frame = r.get_framecount();
+            sync = r.get_framebuffer();
+            texture_a = r.get_framebuffer_texture();
+            texture_b = r.get_framebuffer_texture();
+            r.request_framebuffer_readback();
+            r.request_framebuffer_readback(blue_rect);
+        }
+        r.end_frame();
+        window.poll_events();
+
+        rocket::framebuffer_readback_t readback;
+        while (r.poll_framebuffer_readback(readback)) {
+            if (!got_full) {
+                full = std::move(readback);
+                got_full = true;
+            } else {
+                roi = std::move(readback);
+                got_roi = true;
+            }
+        }
+    }
+
+    if (!got_full || !got_roi) {
+        std::cerr << "readbacks never completed\n";
+        return 1;
+    }
+
+    rocket::vec2f_t vp = r.get_viewport_size();
+    if (full.size.x != static_cast<int>(vp.x) || full.size.y != static_cast<int>(vp.y) || full.frame != requested_frame) {
+        std::cerr << "full readback has the wrong size or frame\n";
+        failures++;
+    } else {
+        if (!same(at(full, 0, 0), rocket::rgba_color::red()) || !same(at(full, 110, 60), rocket::rgba_color::blue())) {
+            std::cerr << "full readback has the wrong pixels (or is upside down)\n";
+            failures++;
+        }
+        if (sync.size() != full.pixels.size() || !same(sync[60 * full.size.x + 110], rocket::rgba_color::blue())) {
+            std::cerr << "synchronous readback does not match\n";
+            failures++;
+        }
+    }
+
+    if (roi.offset.x != 100 || roi.offset.y != 50 || roi.size.x != 40 || roi.size.y != 30) {
+        std::cerr << "region readback has the wrong bounds\n";
+        failures++;
+    } else {
+        for (auto &pixel : roi.pixels) {
+            if (!same(pixel, rocket::rgba_color::blue())) {
+                std::cerr << "region readback contains pixels outside the region\n";
+                failures++;
+                break;
+            }
+        }
+    }
+
+    if (texture_a == 0 || texture_a != texture_b) {
+        std::cerr << "framebuffer texture is not reused\n";
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
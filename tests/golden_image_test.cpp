@@ -0,0 +1,142 @@
+#include "rocket/headless.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <rocket/runtime.hpp>
+
+// Scenes stick to primitives and generated textures, fonts differ between
+// platforms. Run with --update-golden after an intended visual change.
+
+static std::shared_ptr<rocket::texture_t> make_gradient() {
+    // 8x8, quadrants tinted differently so atlas lookups are visible
+    auto texture = std::make_shared<rocket::texture_t>();
+    texture->size = { 8, 8 };
+    texture->channels = 4;
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const uint8_t quadrant = static_cast<uint8_t>((y / 4) * 2 + (x / 4));
+            texture->data.push_back(static_cast<uint8_t>(x * 32));
+            texture->data.push_back(static_cast<uint8_t>(y * 32));
+            texture->data.push_back(static_cast<uint8_t>(quadrant * 80));
+            texture->data.push_back(static_cast<uint8_t>(quadrant == 3 ? 160 : 255));
+        }
+    }
+    return texture;
+}
+
+static void draw_primitives(rocket::renderer_2d_i *r, uint64_t) {
+    r->clear({ 24, 28, 40, 255 });
+    r->draw_rectangle({ { 20, 20 }, { 120, 80 } }, { 230, 80, 60, 255 });
+    r->draw_rectangle({ { 80, 60 }, { 120, 80 } }, { 60, 140, 230, 140 });
+    r->draw_rectangle({ { 240, 40 }, { 100, 50 } }, { 250, 210, 70, 255 }, 30.f);
+    r->draw_rectangle({ { 380, 30 }, { 120, 90 } }, { 120, 220, 120, 255 }, 0.f, 0.5f);
+    r->draw_rectangle({ { 530, 30 }, { 80, 80 } }, { 255, 255, 255, 255 }, 0.f, 0.f, true);
+    r->draw_circle({ 80, 240 }, 50, { 200, 120, 255, 255 });
+    r->draw_circle({ 220, 240 }, 50, { 255, 255, 255, 200 }, 8);
+    r->draw_polygon({ 360, 240 }, 50, { 255, 150, 40, 255 }, 6, 15.f);
+    r->draw_polygon({ 500, 240 }, 50, { 40, 200, 200, 180 }, 3);
+    for (int i = 0; i < 16; ++i) {
+        r->draw_pixel({ 600.f + static_cast<float>(i), 330.f }, { 255, 255, 255, 255 });
+    }
+}
+
+static void draw_textures(rocket::renderer_2d_i *r, std::shared_ptr<rocket::texture_t> texture) {
+    r->clear({ 40, 40, 40, 255 });
+    r->draw_texture(texture, { { 20, 20 }, { 160, 160 } });
+    r->begin_render_mode(rocket::render_mode_t::texture_filter_none);
+    r->draw_texture(texture, { { 200, 20 }, { 160, 160 } });
+    r->draw_atlas_texture(texture, { { 380, 20 }, { 80, 80 } }, { 4, 0 }, { 4, 4 });
+    r->end_render_mode(rocket::render_mode_t::texture_filter_none);
+    r->draw_atlas_texture(texture, { { 480, 20 }, { 80, 80 } }, { 0, 4 }, { 4, 4 });
+    r->draw_texture(texture, { { 60, 200 }, { 200, 120 } }, 20.f);
+    r->draw_texture(texture, { { 320, 200 }, { 120, 120 } }, 0.f, 0.6f);
+}
+
+static void draw_cache_contents(rocket::renderer_2d_i *r) {
+    r->draw_rectangle({ { 0, 0 }, { 60, 40 } }, { 255, 90, 90, 255 });
+    r->draw_circle({ 60, 40 }, 20, { 90, 255, 90, 200 });
+}
+
+static void draw_render_caches(rocket::renderer_2d_i *r, rocket::render_cache_t *cache) {
+    r->clear({ 10, 10, 30, 255 });
+    const rocket::vec2f_t vp = r->get_viewport_size();
+    r->draw_render_cache(cache, { 20, 20 }, vp);
+    r->draw_render_cache(cache, { 200, 120 }, vp);
+    r->draw_render_cache(cache, { 400, 200 }, { vp.x / 2.f, vp.y / 2.f });
+}
+
+static void draw_animation(rocket::renderer_2d_i *r, uint64_t frame) {
+    r->clear({ 0, 0, 0, 255 });
+    const float t = static_cast<float>(frame);
+    r->draw_rectangle({ { 10.f + t * 12.f, 40.f }, { 60, 60 } }, { 255, 200, 0, 255 }, t * 6.f);
+    r->draw_circle({ 320.f, 180.f + std::sin(t * 0.3f) * 100.f }, 30, { 0, 200, 255, 255 });
+}
+
+static int test_compare_images() {
+    int failures = 0;
+    std::vector<rocket::rgba_color> a(16, { 10, 20, 30, 255 });
+    std::vector<rocket::rgba_color> b = a;
+    rocket::image_diff_t same = rocket::compare_images(a, b, { 4, 4 });
+    if (same.differing_pixels != 0 || same.max_channel_error != 0 || !std::isinf(same.psnr)) {
+        std::cerr << "identical images compare as different\n";
+        failures++;
+    }
+
+    b[5].x = 13;
+    rocket::image_diff_t off = rocket::compare_images(a, b, { 4, 4 });
+    rocket::image_diff_t tolerated = rocket::compare_images(a, b, { 4, 4 }, 3);
+    if (off.differing_pixels != 1 || off.max_channel_error != 3 || tolerated.differing_pixels != 0) {
+        std::cerr << "image difference is measured wrong\n";
+        failures++;
+    }
+
+    if (!rocket::compare_images(a, b, { 4, 3 }).size_mismatch) {
+        std::cerr << "size mismatch went unnoticed\n";
+        failures++;
+    }
+    return failures;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t args) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    int failures = test_compare_images();
+    const std::string golden_dir = args.working_dir + "resources/golden";
+    rocket::headless_renderer_t headless({ 640, 360 });
+    const rocket::vec2i_t size = headless.get_size();
+
+    auto check = [&](const std::string &name, const std::vector<rocket::rgba_color> &pixels) {
+        rocket::image_diff_t diff;
+        if (!rocket::check_golden(golden_dir, name, pixels, size, {}, &diff)) {
+            std::cerr << name << ": " << diff.differing_pixels << " pixels differ, psnr " << diff.psnr << " dB\n";
+            failures++;
+        }
+    };
+
+    std::vector<rocket::rgba_color> primitives = headless.render(1, draw_primitives);
+    check("primitives", primitives);
+    // Same input, same pixels, frame after frame
+    std::vector<rocket::rgba_color> again = headless.render(3, draw_primitives);
+    if (rocket::compare_images(primitives, again, size).differing_pixels != 0) {
+        std::cerr << "rendering is not deterministic\n";
+        failures++;
+    }
+
+    auto texture = make_gradient();
+    check("textures", headless.render(1, [&](rocket::renderer_2d_i *r, uint64_t) { draw_textures(r, texture); }));
+
+    rocket::render_cache_t *cache = headless.get_renderer()->create_render_cache(draw_cache_contents);
+    check("render_cache", headless.render(1, [&](rocket::renderer_2d_i *r, uint64_t) { draw_render_caches(r, cache); }));
+    headless.get_renderer()->destroy_render_cache(cache);
+
+    check("animation", headless.render(30, draw_animation));
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
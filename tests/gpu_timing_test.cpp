@@ -0,0 +1,78 @@
+#include "rocket/renderer.hpp"
+#include "rocket/rgl.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include <cstring>
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    rocket::window_t window = { {1280, 720}, "RocketGE - GPU Timing Test" };
+    rocket::renderer_2d r(&window, 60, {
+        .show_splash = !test_mode
+    });
+
+    if (!rgl::set_gpu_timing(true)) {
+        // No timer queries on this context, nothing to test
+        std::cout << "timer queries unsupported, skipping\n";
+        return 0;
+    }
+
+    const uint64_t frames = test_mode ? 30 : 600;
+    while (window.is_running() && r.get_framecount() < frames) {
+        r.begin_frame();
+        r.clear();
+        {
+            r.begin_gpu_region("rectangles");
+            for (int i = 0; i < 200; ++i) {
+                r.draw_rectangle({ { static_cast<float>(i * 5 % 1200), static_cast<float>(i * 3 % 700) }, { 64, 64 } }, rocket::rgba_color::red());
+            }
+            r.end_gpu_region();
+
+            if (!test_mode) {
+                auto metrics = r.get_draw_metrics();
+                rocket::text_t text = { "GPU: " + std::to_string(metrics.avg_gpu_frametime * 1000) + "ms", 24, rocket::rgb_color::black() };
+                r.draw_text(text, { 10, 10 });
+            }
+        }
+        r.end_frame();
+        window.poll_events();
+    }
+
+    auto metrics = r.get_draw_metrics();
+    int failures = 0;
+    if (metrics.gpu_frame == 0 || metrics.gpu_frame >= r.get_framecount()) {
+        std::cerr << "no frame was read back (gpu_frame " << metrics.gpu_frame << ")\n";
+        failures++;
+    }
+    if (metrics.gpu_frametime <= 0.f) {
+        std::cerr << "gpu frame time is zero\n";
+        failures++;
+    }
+
+    bool found = false;
+    for (auto &region : metrics.get_gpu_regions()) {
+        if (region.name != nullptr && std::strcmp(region.name, "rectangles") == 0) {
+            found = true;
+            if (region.time > metrics.gpu_frametime) {
+                std::cerr << "region is longer than its frame\n";
+                failures++;
+            }
+        }
+    }
+    if (!found) {
+        std::cerr << "named region missing from draw metrics\n";
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,54 @@
+#include "rocket/io.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/runtime.hpp"
+#include "rocket/window.hpp"
+#include <filesystem>
+#include <string>
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+    rocket::init(argc, argv);
+    rocket::window_t window = { {1280, 720}, "RocketGE - Input Replay Test" };
+    rocket::renderer_2d r(&window, 60, {.show_splash = !test_mode});
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "rocket_input_replay_test.rgir";
+    const int frames = test_mode ? 5 : 300;
+
+    // Record a few frames of whatever the user does
+    if (!rocket::io::start_recording(path.string())) {
+        return 1;
+    }
+    for (int i = 0; i < frames && window.is_running(); ++i) {
+        r.begin_frame();
+        r.clear();
+        r.end_frame();
+        window.poll_events();
+    }
+    rocket::io::stop_recording();
+
+    // Play it back, the replay ends after exactly as many frames
+    if (!rocket::io::start_replay(path.string())) {
+        return 1;
+    }
+    int replayed = 0;
+    while (rocket::io::is_replaying() && window.is_running()) {
+        r.begin_frame();
+        r.clear();
+        if (rocket::io::key_down(rocket::io::keyboard_key::space)) {
+            rocket::log("Replayed: [Space]", "main.cpp", "main", "info");
+        }
+        r.end_frame();
+        window.poll_events();
+        replayed++;
+    }
+
+    std::filesystem::remove(path);
+    // The frame that finds the recording exhausted counts too
+    return replayed == frames + 1 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -4,6 +4,7 @@
 #include "rocket/runtime.hpp"
 #include "rocket/types.hpp"
 #include "rocket/window.hpp"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -28,6 +29,12 @@ int rocket_main(int argc, char **argv, rocket_arguments_t) {
         }
     });
 
+    auto temporary = rocket::io::add_listener([](rocket::io::key_event_t) {});
+    if (!rocket::io::remove_listener(temporary) || rocket::io::remove_listener(temporary)) {
+        rocket::log("listener removal failed", "main.cpp", "main", "error");
+        return 1;
+    }
+
     while (window.is_running()) {
         r.begin_frame();
         r.clear();
@@ -64,9 +71,27 @@ int rocket_main(int argc, char **argv, rocket_arguments_t) {
             rocket::log("Key: [D]", "main.cpp", "main", "info");
         }
 
+        if (test_mode) {
+            rocket::io::simulate(rocket::io::keyboard_key::w, rocket::io::keystate_t::make_pressed());
+        }
+
         r.end_frame();
         window.poll_events();
-        if (test_mode) return 0;
+
+        for (auto &event : rocket::io::get_frame_events()) {
+            if (auto *key = std::get_if<rocket::io::key_event_t>(&event.data); key && key->state.pressed()) {
+                rocket::log("Pressed at " + std::to_string(event.timestamp_ns) + "ns", "main.cpp", "main", "info");
+            }
+        }
+
+        if (test_mode) {
+            auto events = rocket::io::get_frame_events();
+            bool found = std::any_of(events.begin(), events.end(), [](const rocket::io::input_event_t &event) {
+                auto *key = std::get_if<rocket::io::key_event_t>(&event.data);
+                return key && key->key == rocket::io::keyboard_key::w;
+            });
+            return found ? 0 : 1;
+        }
     }
     return 0;
 }
@@ -0,0 +1,142 @@
+#include "rocket/headless.hpp"
+#include "rocket/particles.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <cmath>
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 0.05f;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+    int failures = 0;
+
+    {
+        // Spawn rate and burst control
+        rocket::particle_emitter_config_t config;
+        config.rate = 100.f;
+        config.lifetime_min = config.lifetime_max = 10.f;
+        config.max_particles = 1000;
+        rocket::particle_emitter_t emitter(config);
+        for (int i = 0; i < 10; ++i) {
+            emitter.update(0.1f);
+        }
+        if (emitter.get_particle_count() != 100) {
+            std::cerr << "expected 100 particles after 1s at 100/s, got " << emitter.get_particle_count() << "\n";
+            failures++;
+        }
+
+        emitter.set_emitting(false);
+        emitter.burst(5000);
+        emitter.update(0.1f);
+        if (emitter.get_particle_count() != 1000) {
+            std::cerr << "burst was not capped at max_particles, got " << emitter.get_particle_count() << "\n";
+            failures++;
+        }
+
+        emitter.update(10.f);
+        if (emitter.get_particle_count() != 0) {
+            std::cerr << "particles outlived their lifetime, " << emitter.get_particle_count() << " left\n";
+            failures++;
+        }
+    }
+
+    {
+        // Integration and size/color over life, large enough to split across the job pool
+        rocket::particle_emitter_config_t config;
+        config.position = { 100, 50 };
+        config.rate = 0.f;
+        config.max_particles = 100003;
+        config.lifetime_min = config.lifetime_max = 1.f;
+        config.velocity_min = config.velocity_max = { 10, 0 };
+        config.acceleration = { 0, 20 };
+        config.size_start = 10.f;
+        config.size_end = 0.f;
+        config.color_start = { 255, 0, 0, 255 };
+        config.color_end = { 0, 0, 255, 255 };
+        rocket::particle_emitter_t emitter(config);
+        emitter.burst(config.max_particles);
+        emitter.update(0.f);
+        emitter.update(0.5f);
+
+        const rocket::particle_batch_t &batch = emitter.get_batch();
+        if (batch.instances.size() != config.max_particles) {
+            std::cerr << "expected " << config.max_particles << " instances, got " << batch.instances.size() << "\n";
+            failures++;
+        }
+        size_t wrong = 0;
+        for (const rocket::particle_instance_t &p : batch.instances) {
+            // v = (10, 20 * 0.5), x += v * 0.5
+            const uint8_t r = p.color & 0xff;
+            const uint8_t b = (p.color >> 16) & 0xff;
+            if (!near(p.x, 105.f) || !near(p.y, 55.f) || std::fabs(p.size - 5.f) > 0.1f || r < 120 || r > 135 || b < 120 || b > 135) {
+                wrong++;
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << wrong << " particles integrated or eased wrong\n";
+            failures++;
+        }
+        if (!near(batch.bounds.pos.x, 102.5f) || !near(batch.bounds.size.x, 5.f)) {
+            std::cerr << "batch bounds are wrong\n";
+            failures++;
+        }
+    }
+
+    {
+        // The emitter draws the same frame as one rectangle per particle
+        rocket::headless_renderer_t headless({ 160, 120 });
+        rocket::renderer_2d_i &r = *headless.get_renderer();
+
+        rocket::particle_emitter_config_t config;
+        config.position = { 80, 60 };
+        config.spawn_area = { 60, 40 };
+        config.rate = 500.f;
+        config.lifetime_min = 0.5f;
+        config.lifetime_max = 2.f;
+        config.size_start = 6.f;
+        config.size_end = 1.f;
+        config.size_easing = rocket::particle_easing_t::cubic_out;
+        config.color_start = { 255, 200, 0, 255 };
+        config.color_end = { 255, 0, 0, 64 };
+        rocket::particle_emitter_t emitter(config);
+        for (int i = 0; i < 30; ++i) {
+            emitter.update(1.f / 30.f);
+        }
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        for (const rocket::particle_instance_t &p : emitter.get_batch().instances) {
+            const rocket::rgba_color color = {
+                static_cast<uint8_t>(p.color & 0xff),
+                static_cast<uint8_t>((p.color >> 8) & 0xff),
+                static_cast<uint8_t>((p.color >> 16) & 0xff),
+                static_cast<uint8_t>(p.color >> 24),
+            };
+            r.draw_rectangle({ { p.x - p.size * 0.5f, p.y - p.size * 0.5f }, { p.size, p.size } }, color);
+        }
+        r.end_frame();
+        std::vector<rocket::rgba_color> expected = r.get_framebuffer();
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        emitter.draw(&r);
+        r.end_frame();
+        if (!rocket::compare_images(expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << "emitter frame differs from per-particle draws\n";
+            failures++;
+        }
+
+        r.close();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
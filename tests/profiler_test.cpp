@@ -0,0 +1,122 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <rocket/profiler.hpp>
+#include <rocket/runtime.hpp>
+#include <rocket/threads.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static size_t count_occurrences(const std::string &haystack, const std::string &needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+static void worker(int zones) {
+    rocket::thread_t::set_thread_name("rge-prof-test");
+    for (int i = 0; i < zones; ++i) {
+        // Explicit scope_t, the macros compile out without ROCKETGE__PROFILER
+        rocket::profiler::scope_t outer("worker_outer");
+        rocket::profiler::scope_t inner("worker \"inner\"");
+    }
+}
+
+int main(int argc, char **argv) {
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    int failures = 0;
+    std::string path = (std::filesystem::temp_directory_path() / "rge_profiler_test.json").string();
+
+    // Not capturing, nothing is recorded
+    rocket::profiler::record_zone("before_capture", 1, 2);
+
+    const int zones_per_thread = 1000;
+    const int threads = 4;
+    rocket::profiler::start_capture();
+    {
+        rocket::profiler::scope_t main_zone("main_zone");
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) {
+            pool.emplace_back(worker, zones_per_thread);
+        }
+        for (auto &t : pool) {
+            t.join();
+        }
+    }
+    rocket::profiler::stop_capture();
+    rocket::profiler::record_zone("after_capture", rocket::profiler::now_ns(), rocket::profiler::now_ns());
+
+    if (!rocket::profiler::write_chrome_trace(path)) {
+        std::cerr << "failed to write trace\n";
+        return 1;
+    }
+
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string trace = ss.str();
+
+    size_t complete = count_occurrences(trace, "\"ph\":\"X\"");
+    size_t expected = static_cast<size_t>(threads * zones_per_thread * 2 + 1);
+    if (complete != expected) {
+        std::cerr << "expected " << expected << " zones, got " << complete << '\n';
+        failures++;
+    }
+    if (count_occurrences(trace, "\"name\":\"worker \\\"inner\\\"\"") != static_cast<size_t>(threads * zones_per_thread)) {
+        std::cerr << "zone names are not escaped\n";
+        failures++;
+    }
+    if (count_occurrences(trace, "\"ph\":\"M\"") < static_cast<size_t>(threads + 1)) {
+        std::cerr << "missing thread metadata\n";
+        failures++;
+    }
+    if (trace.find("before_capture") != std::string::npos || trace.find("after_capture") != std::string::npos) {
+        std::cerr << "zones recorded outside of the capture\n";
+        failures++;
+    }
+    if (trace.rfind("{\"displayTimeUnit\"", 0) != 0 || trace.find("]}") == std::string::npos) {
+        std::cerr << "trace is not a complete JSON object\n";
+        failures++;
+    }
+
+    // A new capture starts empty
+    rocket::profiler::start_capture();
+    rocket::profiler::record_zone("second_capture", rocket::profiler::now_ns(), rocket::profiler::now_ns());
+    rocket::profiler::stop_capture();
+    rocket::profiler::write_chrome_trace(path);
+    {
+        std::ifstream second(path);
+        std::stringstream ss2;
+        ss2 << second.rdbuf();
+        if (count_occurrences(ss2.str(), "\"ph\":\"X\"") != 1) {
+            std::cerr << "previous capture leaked into the next one\n";
+            failures++;
+        }
+    }
+
+    // Overhead of one zone while capturing
+    if (!test_mode) {
+        const int iterations = 1000000;
+        rocket::profiler::start_capture();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            rocket::profiler::scope_t zone("overhead");
+        }
+        std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+        rocket::profiler::stop_capture();
+        std::cout << "~" << took.count() / iterations << "ns per zone\n";
+    }
+
+    std::filesystem::remove(path);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "rocket/rgl.hpp"
+#include <iostream>
+#include <rgl.hpp>
+#include <rocket/runtime.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Entry layout and validation only, loading into GL needs a real context
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+    int failures = 0;
+
+    const uint64_t driver_a = 0x1111;
+    const uint64_t driver_b = 0x2222;
+    const uint64_t key = rgl::program_cache_key("vs", "fs", "1.0", driver_a);
+
+    if (key != rgl::program_cache_key("vs", "fs", "1.0", driver_a)) {
+        std::cerr << "key is not stable\n";
+        failures++;
+    }
+    // Two GPUs of one machine share the cache directory
+    if (key == rgl::program_cache_key("vs", "fs", "1.0", driver_b)) {
+        std::cerr << "key ignores the driver\n";
+        failures++;
+    }
+    if (key == rgl::program_cache_key("vs", "fs", "1.1", driver_a) || key == rgl::program_cache_key("vsf", "s", "1.0", driver_a)) {
+        std::cerr << "key ignores the source or RLSL version\n";
+        failures++;
+    }
+
+    const std::vector<char> binary = { 'b', 'i', 'n', 'a', 'r', 'y' };
+    std::ostringstream out;
+    if (!rgl::program_cache_write(out, key, driver_a, 0x42, binary)) {
+        std::cerr << "entry was not written\n";
+        failures++;
+    }
+    const std::string entry = out.str();
+
+    auto read = [&](const std::string &data, uint64_t k, uint64_t driver) {
+        std::istringstream in(data);
+        uint32_t format = 0;
+        std::vector<char> loaded;
+        std::string why = rgl::program_cache_read(in, k, driver, format, loaded);
+        if (why.empty() && (format != 0x42 || loaded != binary)) {
+            return std::string("round trip changed the entry");
+        }
+        return why;
+    };
+
+    if (std::string why = read(entry, key, driver_a); !why.empty()) {
+        std::cerr << "valid entry rejected: " << why << "\n";
+        failures++;
+    }
+    if (read(entry, key + 1, driver_a).empty()) {
+        std::cerr << "entry accepted for another key\n";
+        failures++;
+    }
+    if (read(entry, key, driver_b).empty()) {
+        std::cerr << "entry accepted for another driver\n";
+        failures++;
+    }
+
+    std::string corrupt = entry;
+    corrupt[0] ^= 0x5a;
+    if (read(corrupt, key, driver_a).empty()) {
+        std::cerr << "bad magic accepted\n";
+        failures++;
+    }
+    corrupt = entry;
+    corrupt.back() ^= 0x5a;
+    if (read(corrupt, key, driver_a).empty()) {
+        std::cerr << "checksum mismatch accepted\n";
+        failures++;
+    }
+    if (read(entry.substr(0, entry.size() - 2), key, driver_a).empty()) {
+        std::cerr << "truncated entry accepted\n";
+        failures++;
+    }
+    if (read(entry.substr(0, 8), key, driver_a).empty()) {
+        std::cerr << "truncated header accepted\n";
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,153 @@
+#include "rocket/headless.hpp"
+#include "rocket/recording.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <rocket/runtime.hpp>
+
+static std::shared_ptr<rocket::texture_t> make_checker() {
+    // 2x2: red green / blue white
+    auto texture = std::make_shared<rocket::texture_t>();
+    texture->size = { 2, 2 };
+    texture->channels = 4;
+    texture->id = 42;
+    texture->data = {
+        255, 0, 0, 255,     0, 255, 0, 255,
+        0, 0, 255, 255,     255, 255, 255, 255,
+    };
+    return texture;
+}
+
+static void draw_frame(rocket::renderer_2d_i *r, rocket::render_cache_t *cache, std::shared_ptr<rocket::texture_t> checker, int frame) {
+    const float t = static_cast<float>(frame);
+    r->clear({ 20, 24, 32, 255 });
+    r->draw_rectangle({ { 10.f + t * 20.f, 10 }, { 40, 30 } }, { 230, 80, 60, 255 }, t * 15.f);
+    r->draw_circle({ 200, 100 }, 30.f + t * 5.f, { 80, 200, 255, 180 });
+    r->draw_polygon({ 300, 80 }, 40, { 250, 210, 70, 255 }, 5, t * 10.f);
+
+    r->begin_scissor_mode({ { 0, 150 }, { 320, 60 } });
+    r->draw_rectangle({ { 0, 120 }, { 640, 120 } }, { 60, 230, 120, 140 });
+    r->end_scissor_mode();
+
+    r->begin_render_mode(rocket::render_mode_t::texture_filter_none);
+    r->draw_texture(checker, { { 400, 20 }, { 64, 64 } });
+    r->draw_atlas_texture(checker, { { 480, 20 }, { 32, 32 } }, { 1, 1 }, { 1, 1 });
+    r->end_render_mode(rocket::render_mode_t::texture_filter_none);
+
+    r->draw_render_cache(cache, { 40.f * t, 250 }, r->get_viewport_size());
+    r->draw_pixel({ 630, 350 }, rocket::rgba_color::white());
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    const rocket::renderer_flags_t flags = {
+        .share_renderer_as_global = false,
+        .show_splash = false
+    };
+    constexpr int frame_count = 4;
+    int failures = 0;
+
+    rocket::headless_renderer_t headless({ 640, 360 });
+    rocket::renderer_2d_i &software = *headless.get_renderer();
+    rocket::recording_renderer_2d rec(&software);
+    auto checker = make_checker();
+
+    // Made before recording starts, the capture still has to carry its contents
+    rocket::render_cache_t *cache = rec.create_render_cache([](rocket::renderer_2d_i *ren) {
+        ren->draw_rectangle({ { 0, 0 }, { 50, 50 } }, { 255, 255, 255, 255 });
+        ren->draw_circle({ 50, 50 }, 20, { 255, 0, 255, 255 });
+    });
+
+    std::vector<std::vector<rocket::rgba_color>> expected;
+    rec.start_recording(frame_count);
+    for (int i = 0; i < frame_count + 1; ++i) {
+        rec.begin_frame();
+        draw_frame(&rec, cache, checker, i);
+        rec.end_frame();
+        expected.push_back(software.get_framebuffer());
+    }
+    if (rec.is_recording() || rec.get_recorded_frames() != frame_count) {
+        std::cerr << "recording did not stop after " << frame_count << " frames\n";
+        failures++;
+    }
+    rocket::command_stream_t stream = rec.stop_recording();
+    rec.destroy_render_cache(cache);
+
+    const std::string path = "recording_test.rgec";
+    rocket::command_stream_t loaded;
+    if (!stream.save(path) || !rocket::command_stream_t::load(path, loaded) || loaded.data != stream.data) {
+        std::cerr << "stream did not survive a save and load\n";
+        failures++;
+    }
+    std::remove(path.c_str());
+
+    {
+        rocket::headless_renderer_t replay_headless({ 640, 360 });
+        rocket::renderer_2d_i &target = *replay_headless.get_renderer();
+        rocket::command_replayer_t replayer(loaded);
+        if (!replayer.is_valid() || replayer.get_frame_count() != frame_count) {
+            std::cerr << "replayer sees " << replayer.get_frame_count() << " frames\n";
+            failures++;
+        }
+
+        for (size_t i = 0; i < replayer.get_frame_count(); ++i) {
+            if (!replayer.replay_frame(&target, i) || !rocket::compare_images(expected[i], target.get_framebuffer(), headless.get_size()).identical()) {
+                std::cerr << "replayed frame " << i << " differs\n";
+                failures++;
+            }
+        }
+        const rocket::replay_stats_t &stats = replayer.get_stats();
+        if (stats.frames != frame_count || stats.skipped != 0 || stats.commands == 0) {
+            std::cerr << "replay stats are off\n";
+            failures++;
+        }
+        replayer.release();
+    }
+
+    {
+        // Without embedded assets the texture comes from the resolver
+        rocket::recording_renderer_2d lean(&software, { .embed_assets = false });
+        lean.start_recording(1);
+        lean.begin_frame();
+        lean.draw_texture(checker, { { 0, 0 }, { 16, 16 } });
+        lean.end_frame();
+        rocket::command_stream_t lean_stream = lean.stop_recording();
+        if (lean_stream.data.size() >= stream.data.size()) {
+            std::cerr << "assets were embedded anyway\n";
+            failures++;
+        }
+
+        rocket::null_window_t replay_window = { {64, 64}, "RocketGE - Recording Test" };
+        rocket::null_renderer_2d target(&replay_window, rocket::cst::fps_uncapped, flags);
+        rocket::command_replayer_t unresolved(lean_stream);
+        if (unresolved.replay(&target).skipped != 1) {
+            std::cerr << "missing texture was not skipped\n";
+            failures++;
+        }
+        rocket::command_replayer_t resolved(lean_stream, {
+            .texture_resolver = [&](rocket::assetid_t id) { return id == checker->id ? checker : nullptr; }
+        });
+        if (resolved.replay(&target).skipped != 0) {
+            std::cerr << "texture resolver was not used\n";
+            failures++;
+        }
+    }
+
+    rocket::command_stream_t garbage;
+    garbage.data = { 'n', 'o', 'p', 'e' };
+    if (rocket::command_replayer_t(garbage).is_valid()) {
+        std::cerr << "garbage was accepted as a stream\n";
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,145 @@
+#include "rocket/headless.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <data_structures.hpp>
+#include <iostream>
+#include <optional>
+#include <rocket/runtime.hpp>
+
+// Atlas pages of the GPU backends are packed with this
+static int check_shelf_packer() {
+    int failures = 0;
+    rocket::shelf_packer_t packer({ 64, 64 });
+
+    const rocket::vec2i_t expected[] = { { 0, 0 }, { 32, 0 }, { 0, 32 }, { 32, 32 } };
+    for (rocket::vec2i_t pos : expected) {
+        std::optional<rocket::vec2i_t> at = packer.allocate({ 32, 32 });
+        if (!at || at->x != pos.x || at->y != pos.y) {
+            std::cerr << "shelf packer placed a 32x32 rect at the wrong spot\n";
+            failures++;
+        }
+    }
+    if (packer.allocate({ 32, 32 }) || packer.allocate({ 1, 1 })) {
+        std::cerr << "shelf packer allocated on a full page\n";
+        failures++;
+    }
+    if (packer.allocate({ 65, 1 })) {
+        std::cerr << "shelf packer allocated a rect larger than the page\n";
+        failures++;
+    }
+
+    // Freed space is handed out again
+    packer.free({ 32, 0 }, { 32, 32 });
+    std::optional<rocket::vec2i_t> reused = packer.allocate({ 32, 32 });
+    if (!reused || reused->x != 32 || reused->y != 0) {
+        std::cerr << "shelf packer did not reuse a freed rect\n";
+        failures++;
+    }
+
+    for (rocket::vec2i_t pos : expected) {
+        packer.free(pos, { 32, 32 });
+    }
+    if (!packer.empty()) {
+        std::cerr << "shelf packer kept shelves after everything was freed\n";
+        failures++;
+    }
+    return failures;
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    int failures = check_shelf_packer();
+
+    rocket::headless_renderer_t headless({ 160, 120 });
+    rocket::renderer_2d_i &r = *headless.get_renderer();
+
+    int sized_draws = 0;
+    int viewport_draws = 0;
+    rocket::render_cache_t *sized = r.create_render_cache([&](rocket::renderer_2d_i *ren) {
+        sized_draws++;
+        // Cache space, the cache is only 40x30
+        ren->draw_rectangle({ { 0, 0 }, { 20, 30 } }, rocket::rgba_color::red());
+        ren->draw_rectangle({ { 20, 0 }, { 20, 30 } }, rocket::rgba_color::blue());
+    }, { 40, 30 });
+    rocket::render_cache_t *full = r.create_render_cache([&](rocket::renderer_2d_i *ren) {
+        viewport_draws++;
+        ren->draw_rectangle({ { 0, 0 }, { 10, 10 } }, rocket::rgba_color::white());
+    });
+
+    if (sized->get_size().x != 40 || sized->get_size().y != 30 || sized->follows_viewport() || !full->follows_viewport()) {
+        std::cerr << "cache sizes were not kept\n";
+        failures++;
+    }
+
+    auto frame = [&]() {
+        r.begin_frame();
+        r.clear(rocket::rgba_color::black());
+        r.draw_render_cache(sized, { 50, 50 }, { 40, 30 });
+        r.draw_render_cache(full, { 0, 0 }, r.get_viewport_size());
+        r.end_frame();
+        return r.get_framebuffer();
+    };
+    // The same picture drawn straight to the screen
+    auto reference = [&]() {
+        r.begin_frame();
+        r.clear(rocket::rgba_color::black());
+        r.draw_rectangle({ { 50, 50 }, { 20, 30 } }, rocket::rgba_color::red());
+        r.draw_rectangle({ { 70, 50 }, { 20, 30 } }, rocket::rgba_color::blue());
+        r.draw_rectangle({ { 0, 0 }, { 10, 10 } }, rocket::rgba_color::white());
+        r.end_frame();
+        return r.get_framebuffer();
+    };
+    auto viewport = [&]() {
+        const rocket::vec2f_t size = r.get_viewport_size();
+        return rocket::vec2i_t { static_cast<int>(size.x), static_cast<int>(size.y) };
+    };
+
+    std::vector<rocket::rgba_color> expected = reference();
+    if (!rocket::compare_images(expected, frame(), viewport()).identical()) {
+        std::cerr << "caches were not drawn at their own size\n";
+        failures++;
+    }
+
+    frame();
+    if (sized_draws != 1 || viewport_draws != 1) {
+        std::cerr << "clean caches were redrawn\n";
+        failures++;
+    }
+
+    // Invalidating only marks the cache, the callback reruns once when it is used
+    r.invalidate_render_cache(sized);
+    r.invalidate_render_cache(sized);
+    if (!sized->is_dirty() || sized_draws != 1) {
+        std::cerr << "invalidate redrew eagerly\n";
+        failures++;
+    }
+    frame();
+    if (sized->is_dirty() || sized_draws != 2) {
+        std::cerr << "expected one redraw after invalidate, got " << sized_draws - 1 << "\n";
+        failures++;
+    }
+
+    // A viewport resize only invalidates caches that follow the viewport
+    r.set_viewport_size({ 200, 150 });
+    std::vector<rocket::rgba_color> pixels = frame();
+    if (sized_draws != 2 || viewport_draws != 2) {
+        std::cerr << "resize redrew " << sized_draws - 2 << " sized and " << viewport_draws - 1 << " viewport caches\n";
+        failures++;
+    }
+    expected = reference();
+    if (!rocket::compare_images(expected, pixels, viewport()).identical()) {
+        std::cerr << "caches are wrong after the resize\n";
+        failures++;
+    }
+
+    r.destroy_render_cache(sized);
+    r.destroy_render_cache(full);
+    r.close();
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -6,6 +6,7 @@
 #include <rocket/window.hpp>
 #include <rocket/runtime.hpp>
 #include <string>
+#include <vector>
 
 int rocket_main(int argc, char **argv, rocket_arguments_t) {
     bool test_mode = false;
@@ -27,6 +28,35 @@ int rocket_main(int argc, char **argv, rocket_arguments_t) {
 
     r.end_frame();
 
+    // Sized caches share an atlas page, clearing one must leave its neighbour
+    int failures = 0;
+    auto kept = r.create_render_cache([](rocket::renderer_2d_i *ren) {
+        ren->draw_rectangle({{0, 0}, { 64, 64 }}, rocket::rgba_color::red());
+    }, { 64, 64 });
+    auto cleared = r.create_render_cache([](rocket::renderer_2d_i *ren) {
+        ren->clear(rocket::rgba_color::blue());
+    }, { 64, 64 });
+    r.begin_frame();
+    r.update_render_cache(kept);
+    r.update_render_cache(cleared);
+    r.invalidate_render_cache(cleared);
+    r.update_render_cache(cleared);
+    r.clear(rocket::rgba_color::white());
+    // Centered so the row order of the readback does not matter
+    r.draw_render_cache(kept, {{608, 328}, { 64, 64 }});
+    const std::vector<rocket::rgba_color> pixels = r.get_framebuffer();
+    r.end_frame();
+    const rocket::vec2i_t size = window.get_size();
+    if (pixels.size() != static_cast<size_t>(size.x) * size.y) {
+        std::cerr << "framebuffer readback has the wrong size\n";
+        failures++;
+    } else if (const rocket::rgba_color center = pixels[(size.y / 2) * size.x + size.x / 2];
+               center.x != 255 || center.y != 0 || center.z != 0) {
+        std::cerr << "clear() in one packed cache wiped another\n";
+        failures++;
+    }
+    if (test_mode && failures != 0) return 1;
+
     while (window.is_running()) {
         r.begin_frame();
         r.clear(rocket::rgba_color::white());
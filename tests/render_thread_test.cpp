@@ -0,0 +1,94 @@
+#include "rocket/headless.hpp"
+#include "rocket/render_thread.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include <iostream>
+#include <memory>
+#include <rocket/runtime.hpp>
+
+static void draw_frame(rocket::renderer_2d_i *r, rocket::render_cache_t *cache, int frame) {
+    const float t = static_cast<float>(frame);
+    r->clear({ 20, 24, 32, 255 });
+    r->draw_rectangle({ { 10.f + t * 20.f, 10 }, { 40, 30 } }, { 230, 80, 60, 255 }, t * 15.f);
+    r->draw_circle({ 200, 100 }, 30.f + t * 5.f, { 80, 200, 255, 180 });
+    r->draw_polygon({ 300, 80 }, 40, { 250, 210, 70, 255 }, 5, t * 10.f);
+    r->begin_scissor_mode({ { 0, 150 }, { 320, 60 } });
+    r->draw_rectangle({ { 0, 120 }, { 640, 120 } }, { 60, 230, 120, 140 });
+    r->end_scissor_mode();
+    r->draw_render_cache(cache, { 40.f * t, 250 }, r->get_viewport_size());
+}
+
+static void draw_cache(rocket::renderer_2d_i *ren) {
+    ren->draw_rectangle({ { 0, 0 }, { 50, 50 } }, { 255, 255, 255, 255 });
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    constexpr int frame_count = 8;
+    int failures = 0;
+
+    // Same frames drawn directly, the reference
+    std::vector<std::vector<rocket::rgba_color>> expected;
+    {
+        rocket::headless_renderer_t headless({ 640, 360 });
+        rocket::renderer_2d_i &direct = *headless.get_renderer();
+        rocket::render_cache_t *cache = direct.create_render_cache(draw_cache);
+        for (int i = 0; i < frame_count; ++i) {
+            direct.begin_frame();
+            draw_frame(&direct, cache, i);
+            expected.push_back(direct.get_framebuffer());
+            direct.end_frame();
+        }
+        direct.destroy_render_cache(cache);
+    }
+
+    for (int latency = 1; latency <= 2; ++latency) {
+        rocket::headless_renderer_t headless({ 640, 360 });
+        rocket::threaded_renderer_2d r(headless.get_renderer(), { .latency = latency });
+
+        rocket::render_cache_t *cache = r.create_render_cache(draw_cache);
+        if (cache == nullptr) {
+            std::cerr << "render cache was not created\n";
+            failures++;
+            continue;
+        }
+
+        int max_in_flight = 0;
+        for (int i = 0; i < frame_count; ++i) {
+            r.begin_frame();
+            draw_frame(&r, cache, i);
+            // Waits for the render thread, the frame so far must match
+            if (!rocket::compare_images(expected[i], r.get_framebuffer(), headless.get_size()).identical()) {
+                std::cerr << "frame " << i << " differs at latency " << latency << "\n";
+                failures++;
+            }
+            r.end_frame();
+            max_in_flight = std::max(max_in_flight, r.get_frames_in_flight());
+        }
+        if (max_in_flight > latency) {
+            std::cerr << max_in_flight << " frames in flight at latency " << latency << "\n";
+            failures++;
+        }
+
+        r.wait_idle();
+        if (r.get_frames_in_flight() != 0 || r.get_framecount() != frame_count) {
+            std::cerr << "render thread did not catch up\n";
+            failures++;
+        }
+
+        r.destroy_render_cache(cache);
+        if (cache != nullptr) {
+            std::cerr << "render cache pointer was not cleared\n";
+            failures++;
+        }
+        r.close();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -0,0 +1,144 @@
+#include "rocket/renderer.hpp"
+#include "rocket/types.hpp"
+#include "rocket/window.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <rocket/runtime.hpp>
+
+static bool same(rocket::rgba_color a, rocket::rgba_color b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static bool close_to(rocket::rgba_color a, rocket::rgba_color b) {
+    return std::abs(a.x - b.x) <= 1 && std::abs(a.y - b.y) <= 1 && std::abs(a.z - b.z) <= 1;
+}
+
+static std::shared_ptr<rocket::texture_t> make_checker() {
+    // 2x2: red green / blue white
+    auto texture = std::make_shared<rocket::texture_t>();
+    texture->size = { 2, 2 };
+    texture->channels = 4;
+    texture->data = {
+        255, 0, 0, 255,     0, 255, 0, 255,
+        0, 0, 255, 255,     255, 255, 255, 255,
+    };
+    return texture;
+}
+
+static void draw_scene(rocket::renderer_2d_i &r, std::shared_ptr<rocket::texture_t> checker) {
+    r.clear(rocket::rgba_color::red());
+    r.draw_rectangle({ { 10, 10 }, { 20, 20 } }, rocket::rgba_color::blue());
+    r.draw_rectangle({ { 40, 10 }, { 20, 20 } }, { 0, 0, 255, 128 });
+    r.draw_circle({ 100, 100 }, 10, rocket::rgba_color::green());
+
+    r.begin_scissor_mode({ { 200, 0 }, { 10, 10 } });
+    r.draw_rectangle({ { 180, 0 }, { 60, 60 } }, rocket::rgba_color::green());
+    r.end_scissor_mode();
+
+    r.begin_render_mode(rocket::render_mode_t::texture_filter_none);
+    r.draw_texture(checker, { { 300, 10 }, { 20, 20 } });
+    r.end_render_mode(rocket::render_mode_t::texture_filter_none);
+
+    // Spans many tiles so the workers have something to share
+    for (int i = 0; i < 64; ++i) {
+        r.draw_rectangle({ { static_cast<float>(i * 9), 200 }, { 90, 90 } }, { static_cast<uint8_t>(i * 4), 80, 160, 100 }, static_cast<float>(i * 7), 0.3f);
+    }
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    bool test_mode = false;
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+        test_mode = true;
+    }
+
+    rocket::null_window_t window = { {640, 360}, "RocketGE - Software Renderer Test" };
+    rocket::software_renderer_2d r(&window, 60, {
+        .show_splash = !test_mode,
+        .software_threads = 4
+    });
+    auto checker = make_checker();
+    int failures = 0;
+
+    r.begin_frame();
+    const uint64_t requested_frame = r.get_framecount();
+    draw_scene(r, checker);
+    std::vector<rocket::rgba_color> pixels = r.get_framebuffer();
+    r.request_framebuffer_readback({ { 10, 10 }, { 20, 20 } });
+    r.end_frame();
+
+    const int width = static_cast<int>(r.get_viewport_size().x);
+    auto at = [&](int x, int y) { return pixels[static_cast<size_t>(y) * width + x]; };
+
+    if (!same(at(15, 15), rocket::rgba_color::blue()) || !same(at(5, 5), rocket::rgba_color::red()) || !same(at(30, 30), rocket::rgba_color::red())) {
+        std::cerr << "rectangle has the wrong coverage\n";
+        failures++;
+    }
+    if (!close_to(at(50, 20), { 127, 0, 128, 255 })) {
+        std::cerr << "alpha blending is off\n";
+        failures++;
+    }
+    if (!same(at(100, 100), rocket::rgba_color::green()) || !same(at(111, 100), rocket::rgba_color::red())) {
+        std::cerr << "circle has the wrong coverage\n";
+        failures++;
+    }
+    if (!same(at(205, 5), rocket::rgba_color::green()) || !same(at(195, 5), rocket::rgba_color::red()) || !same(at(205, 15), rocket::rgba_color::red())) {
+        std::cerr << "scissor was not applied\n";
+        failures++;
+    }
+    if (!same(at(305, 15), rocket::rgba_color::red()) || !same(at(315, 15), rocket::rgba_color::green())
+        || !same(at(305, 25), rocket::rgba_color::blue()) || !same(at(315, 25), rocket::rgba_color::white())) {
+        std::cerr << "texture was sampled wrong\n";
+        failures++;
+    }
+
+    rocket::framebuffer_readback_t readback;
+    if (!r.poll_framebuffer_readback(readback) || readback.frame != requested_frame || readback.size.x != 20 || readback.size.y != 20) {
+        std::cerr << "readback did not complete\n";
+        failures++;
+    } else if (!same(readback.pixels.front(), rocket::rgba_color::blue())) {
+        std::cerr << "readback has the wrong pixels\n";
+        failures++;
+    }
+
+    // Same scene on one thread must match pixel for pixel
+    {
+        rocket::null_window_t single_window = { {640, 360}, "RocketGE - Software Renderer Test" };
+        rocket::software_renderer_2d single(&single_window, 60, {
+            .share_renderer_as_global = false,
+            .show_splash = false,
+            .software_threads = 1
+        });
+        single.begin_frame();
+        draw_scene(single, make_checker());
+        std::vector<rocket::rgba_color> single_pixels = single.get_framebuffer();
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            if (!same(single_pixels[i], pixels[i]) || single_pixels[i].w != pixels[i].w) {
+                std::cerr << "output depends on the thread count\n";
+                failures++;
+                break;
+            }
+        }
+        single.end_frame();
+    }
+
+    rocket::render_cache_t *cache = r.create_render_cache([](rocket::renderer_2d_i *ren) {
+        ren->draw_rectangle({ { 0, 0 }, { 10, 10 } }, rocket::rgba_color::white());
+    });
+    r.begin_frame();
+    r.clear(rocket::rgba_color::black());
+    r.draw_render_cache(cache, { 50, 50 }, r.get_viewport_size());
+    pixels = r.get_framebuffer();
+    r.end_frame();
+    if (!same(at(55, 55), rocket::rgba_color::white()) || !same(at(65, 65), rocket::rgba_color::black())) {
+        std::cerr << "render cache was not drawn\n";
+        failures++;
+    }
+    r.destroy_render_cache(cache);
+
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN
@@ -23,6 +23,11 @@ int rocket_main(int argc, char **argv, rocket_arguments_t args) {
     rocket::audio::sound_engine_t se(rocket::audio::device_t::get_default());
     se.play(*sound, false);
 
+    // Same sound again reuses the uploaded buffer, limited to 2 voices at once
+    sound->max_instances = 2;
+    se.play_at(*sound, { 8, 0, 0 });
+    se.play_at(*sound, { 512, 0, 0 }); // out of range, starts virtual
+
     // auto stream_sound = se.stream("/home/noerlol/C-Projects/RocketGE/bin/resources/output.ogg");
     // se.update_music_streams();
     // se.play(stream_sound);
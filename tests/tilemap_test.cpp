@@ -0,0 +1,120 @@
+#include "rocket/camera.hpp"
+#include "rocket/headless.hpp"
+#include "rocket/renderer.hpp"
+#include "rocket/tilemap.hpp"
+#include "rocket/types.hpp"
+#include <iostream>
+#include <rocket/runtime.hpp>
+
+static std::shared_ptr<rocket::texture_t> make_atlas() {
+    // Three 4x4 tiles in a row: red, green, blue
+    auto texture = std::make_shared<rocket::texture_t>();
+    texture->size = { 12, 4 };
+    texture->channels = 4;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 12; ++x) {
+            const int tile = x / 4;
+            texture->data.push_back(tile == 0 ? 255 : 0);
+            texture->data.push_back(tile == 1 ? 255 : 0);
+            texture->data.push_back(tile == 2 ? 255 : 0);
+            texture->data.push_back(255);
+        }
+    }
+    return texture;
+}
+
+// What the tilemap replaces: one atlas draw per tile
+static void draw_tiles(rocket::renderer_2d_i &r, const rocket::tilemap_t &map, const std::shared_ptr<rocket::texture_t> &atlas, rocket::vec2f_t position) {
+    for (int y = 0; y < map.get_map_size().y; ++y) {
+        for (int x = 0; x < map.get_map_size().x; ++x) {
+            const rocket::tile_id_t tile = map.get_tile({ x, y });
+            if (tile == rocket::tile_none) {
+                continue;
+            }
+            r.draw_atlas_texture(atlas, { { position.x + x * 4.f, position.y + y * 4.f }, { 4, 4 } }, { tile * 4.f, 0 }, { 4, 4 });
+        }
+    }
+}
+
+int rocket_main(int argc, char **argv, rocket_arguments_t) {
+    rocket::init(argc, argv);
+    if (argc >= 3 && std::string(argv[2]) == "--unit-test") {
+        rocket::set_log_level(rocket::log_level_t::none);
+    }
+
+    int failures = 0;
+
+    rocket::headless_renderer_t headless({ 160, 120 });
+    rocket::renderer_2d_i &r = *headless.get_renderer();
+    auto atlas = make_atlas();
+
+    // 50x40 tiles of 4px, 8x8 tile chunks: 7x5 chunks over a 200x160 map
+    rocket::tilemap_t map(atlas, { 4, 4 }, { 50, 40 }, 8);
+    for (int y = 0; y < 40; ++y) {
+        for (int x = 0; x < 50; ++x) {
+            map.set_tile({ x, y }, (x * 7 + y * 3) % 11 == 0 ? rocket::tile_none : (x + y) % 3);
+        }
+    }
+    if (map.get_chunk_count() != 35) {
+        std::cerr << "expected 35 chunks, got " << map.get_chunk_count() << "\n";
+        failures++;
+    }
+
+    auto compare = [&](const std::string &what, rocket::vec2f_t position, bool camera) {
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        if (camera) r.begin_render_mode(rocket::render_mode_t::camera);
+        draw_tiles(r, map, atlas, position);
+        if (camera) r.end_render_mode(rocket::render_mode_t::camera);
+        r.end_frame();
+        std::vector<rocket::rgba_color> expected = r.get_framebuffer();
+
+        r.begin_frame();
+        r.clear({ 0, 0, 0, 255 });
+        if (camera) r.begin_render_mode(rocket::render_mode_t::camera);
+        map.draw(&r, position);
+        if (camera) r.end_render_mode(rocket::render_mode_t::camera);
+        r.end_frame();
+        if (!rocket::compare_images(expected, r.get_framebuffer(), headless.get_size()).identical()) {
+            std::cerr << what << ": tilemap differs from per-tile draws\n";
+            failures++;
+        }
+    };
+
+    compare("static", { 0, 0 }, false);
+    // 32px chunks over a 160x120 viewport
+    if (map.get_visible_chunk_count() != 20) {
+        std::cerr << "expected 20 visible chunks, got " << map.get_visible_chunk_count() << "\n";
+        failures++;
+    }
+
+    map.set_tile({ 3, 3 }, 2);
+    map.set_tile({ 12, 20 }, rocket::tile_none);
+    compare("edited", { 0, 0 }, false);
+    compare("offset", { -37, 13 }, false);
+
+    rocket::camera_2d cam;
+    cam.position = { 120, 90 };
+    cam.zoom = 2.f;
+    r.set_camera(&cam);
+    compare("camera", { 0, 0 }, true);
+    if (map.get_visible_chunk_count() != 9) {
+        std::cerr << "expected 9 visible chunks under the camera, got " << map.get_visible_chunk_count() << "\n";
+        failures++;
+    }
+    r.set_camera(nullptr);
+
+    r.begin_frame();
+    r.clear({ 0, 0, 0, 255 });
+    map.draw(&r, { -1000, 0 });
+    r.end_frame();
+    if (map.get_visible_chunk_count() != 0) {
+        std::cerr << "off-screen map was not culled\n";
+        failures++;
+    }
+
+    r.close();
+    return failures == 0 ? 0 : 1;
+}
+
+DEFINE_PLATFORM_MAIN